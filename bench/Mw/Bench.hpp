@@ -0,0 +1,90 @@
+/**
+ * @file   Bench.hpp
+ * @author Bastien Brunnenstein
+ *
+ * @details Small helpers shared by the benchmark cases.
+ */
+
+#ifndef MW_BENCH_HPP
+#define MW_BENCH_HPP
+
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+
+#include <boost/chrono.hpp>
+
+namespace mwbench {
+
+/**
+ * Keep the compiler from optimizing away a computed value.
+ *
+ * @param value Value to consume.
+ */
+template<typename T>
+void consume(const T & value)
+{
+#if defined(__GNUC__)
+    __asm__ __volatile__("" : : "g"(&value) : "memory");
+#else
+    static const void * volatile sink;
+    sink = &value;
+#endif
+}
+
+/**
+ * Draw a pseudo-random value with std::rand.
+ *
+ * @param range Upper bound of the values.
+ * @return Value between 0 and @c range.
+ */
+inline float random(float range)
+{
+    return static_cast<float>(std::rand()) / RAND_MAX * range;
+}
+
+/**
+ * Run a function object several times and return the best wall time.
+ *
+ * @param f Function object to run, called without arguments.
+ * @param runs Number of runs.
+ * @return Best run time, in seconds.
+ */
+template<class F>
+double measure(F f, unsigned runs = 5)
+{
+    typedef boost::chrono::steady_clock Clock;
+
+    double best = 0.0;
+    for (unsigned r = 0; r < runs; ++r)
+    {
+        Clock::time_point start = Clock::now();
+        f();
+        double elapsed = boost::chrono::duration<double>(Clock::now() - start).count();
+
+        if (r == 0 || elapsed < best)
+            best = elapsed;
+    }
+    return best;
+}
+
+/**
+ * Print a benchmark result line.
+ *
+ * @param name Name of the measured case.
+ * @param seconds Measured time.
+ * @param items Number of items processed during @c seconds.
+ */
+inline void report(const char * name, double seconds, unsigned long items)
+{
+    std::cout << std::left << std::setw(48) << name
+              << std::right << std::setw(12) << std::fixed << std::setprecision(3)
+              << seconds * 1e3 << " ms"
+              << std::setw(12) << std::setprecision(2)
+              << (seconds > 0.0 ? items / seconds / 1e6 : 0.0) << " M/s"
+              << std::endl;
+}
+
+} // namespace mwbench
+
+#endif // MW_BENCH_HPP
@@ -0,0 +1,8 @@
+/*
+ * @file   MainBench.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#define BOOST_TEST_MODULE MwBench
+
+#include <boost/test/unit_test.hpp>
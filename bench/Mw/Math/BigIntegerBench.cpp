@@ -0,0 +1,220 @@
+/**
+ * @file   BigIntegerBench.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <Mw/Bench.hpp>
+#include <Mw/Math/BigInteger.hpp>
+
+#include <cstdlib>
+#include <sstream>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+namespace {
+
+const unsigned SAMPLES = 100000;
+
+typedef boost::int64_t Int;
+typedef mw::math::BigInteger Big;
+typedef mw::math::detail::BigMagnitude Magnitude;
+
+struct NativeSums
+{
+    const std::vector<Int> & values;
+
+    void operator () () const
+    {
+        Int sum = 0;
+        for (std::size_t i = 0; i + 1 < values.size(); ++i)
+            sum += values[i] * values[i + 1] + values[i];
+        mwbench::consume(sum);
+    }
+};
+
+struct BigSums
+{
+    const std::vector<Big> & values;
+
+    void operator () () const
+    {
+        Big sum = 0;
+        for (std::size_t i = 0; i + 1 < values.size(); ++i)
+            sum += values[i] * values[i + 1] + values[i];
+        mwbench::consume(sum);
+    }
+};
+
+template<typename T>
+struct RationalSums
+{
+    const std::vector<mw::math::Rational<T> > & values;
+
+    void operator () () const
+    {
+        unsigned count = 0;
+        for (std::size_t i = 0; i + 1 < values.size(); ++i)
+        {
+            const mw::math::Rational<T> r = values[i] + values[i + 1] * values[i];
+            count += r < values[i];
+        }
+        mwbench::consume(count);
+    }
+};
+
+struct SchoolProducts
+{
+    const Magnitude::Limbs & a;
+    const Magnitude::Limbs & b;
+
+    void operator () () const
+    {
+        Magnitude::Limbs r(a.size() + b.size());
+        Magnitude::multiplySchool(&a[0], a.size(), &b[0], b.size(), &r[0]);
+        mwbench::consume(r);
+    }
+};
+
+struct KaratsubaProducts
+{
+    const Magnitude::Limbs & a;
+    const Magnitude::Limbs & b;
+
+    void operator () () const
+    {
+        Magnitude::Limbs r;
+        Magnitude::multiply(a, b, r);
+        mwbench::consume(r);
+    }
+};
+
+struct EuclidGcds
+{
+    const std::vector<Big> & values;
+
+    void operator () () const
+    {
+        for (std::size_t i = 0; i + 1 < values.size(); ++i)
+        {
+            Big a = values[i], b = values[i + 1];
+            while (b != Big())
+            {
+                const Big tmp = a % b;
+                a = b;
+                b = tmp;
+            }
+            mwbench::consume(a);
+        }
+    }
+};
+
+struct LehmerGcds
+{
+    const std::vector<Big> & values;
+
+    void operator () () const
+    {
+        for (std::size_t i = 0; i + 1 < values.size(); ++i)
+            mwbench::consume(Big::gcd(values[i], values[i + 1]));
+    }
+};
+
+Big randomBig(std::size_t limbs)
+{
+    Big value = 1 + std::rand() % 0xFFFF;
+    for (std::size_t i = 0; i < limbs; ++i)
+        value = value * Big(Int(1) << 32) + Big(static_cast<Int>(std::rand()) * 2 + std::rand() % 2);
+    return value;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(BigInteger)
+
+BOOST_AUTO_TEST_CASE(Arithmetic)
+{
+    std::srand(42);
+
+    // Small values stay inline
+    std::vector<Int> native;
+    std::vector<Big> big;
+    std::vector<mw::math::Rational<Int> > rationals;
+    std::vector<mw::math::BigRational> bigRationals;
+    for (unsigned i = 0; i < SAMPLES; ++i)
+    {
+        native.push_back(std::rand() % 100000);
+        big.push_back(native.back());
+
+        const Int n = std::rand() % 1000 - 500, d = std::rand() % 1000 + 1;
+        rationals.push_back(mw::math::Rational<Int>(n, d));
+        bigRationals.push_back(mw::math::BigRational(n, d));
+    }
+
+    NativeSums nativeSums = { native };
+    mwbench::report("int64 multiply-add (100k)", mwbench::measure(nativeSums), SAMPLES);
+
+    BigSums bigSums = { big };
+    mwbench::report("BigInteger multiply-add, inline (100k)", mwbench::measure(bigSums), SAMPLES);
+
+    RationalSums<Int> rationalSums = { rationals };
+    mwbench::report("Rational<int64> multiply-add (100k)", mwbench::measure(rationalSums), SAMPLES);
+
+    RationalSums<Big> bigRationalSums = { bigRationals };
+    mwbench::report("BigRational multiply-add, inline (100k)", mwbench::measure(bigRationalSums), SAMPLES);
+}
+
+BOOST_AUTO_TEST_CASE(Multiply)
+{
+    std::srand(42);
+
+    const std::size_t sizes[] = { 16, 64, 256, 1024 };
+    for (std::size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+    {
+        Magnitude::Limbs a(sizes[i]), b(sizes[i]);
+        for (std::size_t k = 0; k < sizes[i]; ++k)
+        {
+            a[k] = static_cast<Magnitude::Limb>(std::rand()) * 2 + 1;
+            b[k] = static_cast<Magnitude::Limb>(std::rand()) * 2 + 1;
+        }
+
+        std::ostringstream name;
+        name << "schoolbook product (" << sizes[i] << " limbs)";
+        SchoolProducts school = { a, b };
+        mwbench::report(name.str().c_str(), mwbench::measure(school), 1);
+
+        name.str("");
+        name << "Karatsuba product (" << sizes[i] << " limbs)";
+        KaratsubaProducts karatsuba = { a, b };
+        mwbench::report(name.str().c_str(), mwbench::measure(karatsuba), 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Gcd)
+{
+    std::srand(42);
+
+    const std::size_t sizes[] = { 4, 16, 64 };
+    for (std::size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+    {
+        std::vector<Big> values;
+        for (unsigned k = 0; k < 101; ++k)
+            values.push_back(randomBig(sizes[i]));
+
+        std::ostringstream name;
+        name << "Euclid gcd (100 x " << sizes[i] << " limbs)";
+        EuclidGcds euclid = { values };
+        mwbench::report(name.str().c_str(), mwbench::measure(euclid), 100);
+
+        name.str("");
+        name << "Lehmer gcd (100 x " << sizes[i] << " limbs)";
+        LehmerGcds lehmer = { values };
+        mwbench::report(name.str().c_str(), mwbench::measure(lehmer), 100);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,180 @@
+/**
+ * @file   BvhBench.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <Mw/Bench.hpp>
+#include <Mw/Math/Bvh.hpp>
+#include <Mw/Thread/TaskPool.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+#include <boost/iterator/counting_iterator.hpp>
+
+namespace {
+
+const unsigned ITEMS = 100000;
+const unsigned QUERIES = 1000;
+
+typedef mw::math::Vector<float, 3> Vec3;
+typedef mw::math::Bounds<float, 3> Box;
+
+Box randomBox(float world, float size)
+{
+    Vec3 p, s;
+    for (unsigned c = 0; c < 3; ++c)
+    {
+        p[c] = mwbench::random(world);
+        s[c] = mwbench::random(size) + 0.01f;
+    }
+    return Box(p, p + s);
+}
+
+struct BruteForce
+{
+    const std::vector<Box> & items;
+    const std::vector<Box> & queries;
+    std::vector<std::size_t> & hits;
+
+    void operator () () const
+    {
+        hits.clear();
+        for (unsigned q = 0; q < queries.size(); ++q)
+            for (unsigned i = 0; i < items.size(); ++i)
+                if (items[i].isIntersecting(queries[q]))
+                    hits.push_back(i);
+        mwbench::consume(hits.size());
+    }
+};
+
+struct BvhQuery
+{
+    const mw::math::Bvh<float, 3> & bvh;
+    const std::vector<Box> & queries;
+    std::vector<std::size_t> & hits;
+
+    void operator () () const
+    {
+        hits.clear();
+        for (unsigned q = 0; q < queries.size(); ++q)
+            bvh.queryBounds(queries[q], std::back_inserter(hits));
+        mwbench::consume(hits.size());
+    }
+};
+
+struct BvhBuild
+{
+    mw::math::Bvh<float, 3> & bvh;
+    const std::vector<Box> & items;
+
+    void operator () () const
+    {
+        bvh.build(items.begin(), items.end());
+        mwbench::consume(bvh.getNodes().size());
+    }
+};
+
+struct BvhParallelBuild
+{
+    mw::math::Bvh<float, 3> & bvh;
+    const std::vector<Box> & items;
+    mw::thread::TaskPool * pool;
+    mw::math::Bvh<float, 3>::BuildMethod method;
+
+    void operator () () const
+    {
+        if (pool)
+            bvh.build(items.begin(), items.end(), boost::counting_iterator<std::size_t>(0), *pool, method);
+        else
+            bvh.build(items.begin(), items.end(), boost::counting_iterator<std::size_t>(0), method);
+        mwbench::consume(bvh.getNodes().size());
+    }
+};
+
+struct BvhRefit
+{
+    mw::math::Bvh<float, 3> & bvh;
+    const std::vector<Box> & items;
+
+    void operator () () const
+    {
+        for (unsigned i = 0; i < items.size(); ++i)
+            bvh.setBounds(i, items[i]);
+        bvh.refit();
+        mwbench::consume(bvh.getNodes().size());
+    }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(Bvh)
+
+BOOST_AUTO_TEST_CASE(BvhVsBruteForce)
+{
+    std::srand(42);
+
+    std::vector<Box> items, queries;
+    for (unsigned i = 0; i < ITEMS; ++i)
+        items.push_back(randomBox(1000.0f, 5.0f));
+    for (unsigned q = 0; q < QUERIES; ++q)
+        queries.push_back(randomBox(1000.0f, 20.0f));
+
+    mw::math::Bvh<float, 3> bvh;
+    BvhBuild build = { bvh, items };
+    mwbench::report("Bvh build (100k boxes)", mwbench::measure(build), ITEMS);
+
+    std::vector<std::size_t> bruteHits, bvhHits;
+    BruteForce brute = { items, queries, bruteHits };
+    BvhQuery query = { bvh, queries, bvhHits };
+    mwbench::report("Brute force isIntersecting (1k queries)", mwbench::measure(brute, 1), QUERIES);
+    mwbench::report("Bvh queryBounds (1k queries)", mwbench::measure(query), QUERIES);
+    BOOST_CHECK_EQUAL(bruteHits.size(), bvhHits.size());
+
+    BvhRefit refit = { bvh, items };
+    mwbench::report("Bvh setBounds + refit (100k boxes)", mwbench::measure(refit), ITEMS);
+}
+
+BOOST_AUTO_TEST_CASE(ParallelBuild)
+{
+    typedef mw::math::Bvh<float, 3> Bvh;
+
+    const unsigned BUILD_ITEMS = 1000000;
+
+    std::srand(42);
+
+    std::vector<Box> items, queries;
+    for (unsigned i = 0; i < BUILD_ITEMS; ++i)
+        items.push_back(randomBox(10000.0f, 5.0f));
+    for (unsigned q = 0; q < QUERIES; ++q)
+        queries.push_back(randomBox(10000.0f, 50.0f));
+
+    mw::thread::TaskPool pool;
+    std::cout << "  (" << pool.getThreadCount() << " threads)" << std::endl;
+
+    Bvh bvh;
+    std::vector<std::size_t> hits;
+    BvhQuery query = { bvh, queries, hits };
+
+    const Bvh::BuildMethod methods[] = { Bvh::BUILD_SAH, Bvh::BUILD_MORTON };
+    const char * sequentialNames[] = { "Bvh build SAH, 1 thread (1M boxes)", "Bvh build Morton, 1 thread (1M boxes)" };
+    const char * parallelNames[] = { "Bvh build SAH, task pool (1M boxes)", "Bvh build Morton, task pool (1M boxes)" };
+    const char * queryNames[] = { "Bvh queryBounds, SAH tree (1k queries)", "Bvh queryBounds, Morton tree (1k queries)" };
+    for (unsigned m = 0; m < 2; ++m)
+    {
+        BvhParallelBuild sequential = { bvh, items, NULL, methods[m] };
+        BvhParallelBuild parallel = { bvh, items, &pool, methods[m] };
+
+        mwbench::report(sequentialNames[m], mwbench::measure(sequential, 3), BUILD_ITEMS);
+        mwbench::report(parallelNames[m], mwbench::measure(parallel, 3), BUILD_ITEMS);
+        mwbench::report(queryNames[m], mwbench::measure(query), QUERIES);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,166 @@
+/**
+ * @file   ComplexBench.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <Mw/Bench.hpp>
+#include <Mw/Math/Complex.hpp>
+#include <Mw/Math/ComplexArray.hpp>
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+const unsigned SAMPLES = 1000000;
+
+typedef mw::math::Complex<float> Cpx;
+
+/**
+ * Products through the polar form, as Complex used to compute them.
+ */
+Cpx polarMultiply(const Cpx & a, const Cpx & b)
+{
+    const float teta = a.getAngularCoord() + b.getAngularCoord();
+    const float r = a.getRadialCoord() * b.getRadialCoord();
+    return Cpx(r * std::cos(teta), r * std::sin(teta));
+}
+
+struct PolarProducts
+{
+    const std::vector<Cpx> & a;
+    const std::vector<Cpx> & b;
+    std::vector<Cpx> & out;
+
+    void operator () () const
+    {
+        for (std::size_t i = 0; i < a.size(); ++i)
+            out[i] = polarMultiply(a[i], b[i]);
+        mwbench::consume(out.back());
+    }
+};
+
+struct Products
+{
+    const std::vector<Cpx> & a;
+    const std::vector<Cpx> & b;
+    std::vector<Cpx> & out;
+
+    void operator () () const
+    {
+        for (std::size_t i = 0; i < a.size(); ++i)
+            out[i] = a[i] * b[i];
+        mwbench::consume(out.back());
+    }
+};
+
+struct ArrayProducts
+{
+    const mw::math::ComplexArray<float> & a;
+    const mw::math::ComplexArray<float> & b;
+    mw::math::ComplexArray<float> & out;
+
+    void operator () () const
+    {
+        mw::math::multiply(a, b, out);
+        mwbench::consume(out.realLane()[0]);
+    }
+};
+
+struct ArrayMultiplyAdd
+{
+    const mw::math::ComplexArray<float> & a;
+    const mw::math::ComplexArray<float> & b;
+    mw::math::ComplexArray<float> & acc;
+
+    void operator () () const
+    {
+        mw::math::multiplyAdd(a, b, acc);
+        mwbench::consume(acc.realLane()[0]);
+    }
+};
+
+struct Phases
+{
+    const std::vector<Cpx> & a;
+    std::vector<float> & out;
+
+    void operator () () const
+    {
+        for (std::size_t i = 0; i < a.size(); ++i)
+            out[i] = a[i].getAngularCoord();
+        mwbench::consume(out.back());
+    }
+};
+
+struct ArrayPhases
+{
+    const mw::math::ComplexArray<float> & a;
+    std::vector<float> & out;
+
+    void operator () () const
+    {
+        mw::math::getAngularCoords(a, &out[0]);
+        mwbench::consume(out.back());
+    }
+};
+
+struct ArrayMagnitudes
+{
+    const mw::math::ComplexArray<float> & a;
+    std::vector<float> & out;
+
+    void operator () () const
+    {
+        mw::math::getRadialCoords(a, &out[0]);
+        mwbench::consume(out.back());
+    }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(Complex)
+
+BOOST_AUTO_TEST_CASE(Kernels)
+{
+    std::srand(42);
+
+    std::vector<Cpx> a, b, out(SAMPLES);
+    for (unsigned i = 0; i < SAMPLES; ++i)
+    {
+        a.push_back(Cpx(mwbench::random(2.0f) - 1.0f, mwbench::random(2.0f) - 1.0f));
+        b.push_back(Cpx(mwbench::random(2.0f) - 1.0f, mwbench::random(2.0f) - 1.0f));
+    }
+
+    mw::math::ComplexArray<float> arrayA(a.begin(), a.end()), arrayB(b.begin(), b.end());
+    mw::math::ComplexArray<float> arrayOut(SAMPLES);
+    std::vector<float> scalars(SAMPLES);
+
+    PolarProducts polar = { a, b, out };
+    mwbench::report("Complex product, polar form (1M)", mwbench::measure(polar), SAMPLES);
+
+    Products products = { a, b, out };
+    mwbench::report("Complex product (1M)", mwbench::measure(products), SAMPLES);
+
+    ArrayProducts arrayProducts = { arrayA, arrayB, arrayOut };
+    mwbench::report("ComplexArray multiply (1M)", mwbench::measure(arrayProducts), SAMPLES);
+
+    ArrayMultiplyAdd multiplyAdd = { arrayA, arrayB, arrayOut };
+    mwbench::report("ComplexArray multiplyAdd (1M)", mwbench::measure(multiplyAdd), SAMPLES);
+
+    ArrayMagnitudes magnitudes = { arrayA, scalars };
+    mwbench::report("ComplexArray getRadialCoords (1M)", mwbench::measure(magnitudes), SAMPLES);
+
+    Phases phases = { a, scalars };
+    mwbench::report("Complex getAngularCoord (1M)", mwbench::measure(phases), SAMPLES);
+
+    ArrayPhases arrayPhases = { arrayA, scalars };
+    mwbench::report("ComplexArray getAngularCoords (1M)", mwbench::measure(arrayPhases), SAMPLES);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,146 @@
+/**
+ * @file   ConvolutionBench.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <Mw/Bench.hpp>
+#include <Mw/Math/Convolution.hpp>
+#include <Mw/Math/Fft.hpp>
+#include <Mw/Math/RealFft.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+const std::size_t SIGNAL = 1 << 16;
+const std::size_t KERNEL = 511;
+
+std::vector<float> makeSignal(std::size_t size)
+{
+    std::vector<float> signal(size);
+    for (std::size_t i = 0; i < size; ++i)
+        signal[i] = mwbench::random(2.0f) - 1.0f;
+    return signal;
+}
+
+struct ComplexTransform
+{
+    const mw::math::FftPlan<float> & plan;
+    const mw::math::ComplexArray<float> & in;
+    mw::math::ComplexArray<float> & out;
+
+    void operator () () const
+    {
+        plan.forward(in, out);
+        mwbench::consume(out.realLane()[0]);
+    }
+};
+
+struct RealTransform
+{
+    const mw::math::RealFftPlan<float> & plan;
+    const std::vector<float> & in;
+    mw::math::ComplexArray<float> & out;
+
+    void operator () () const
+    {
+        plan.forward(&in[0], out);
+        mwbench::consume(out.realLane()[0]);
+    }
+};
+
+struct DirectConvolution
+{
+    const std::vector<float> & signal;
+    const std::vector<float> & kernel;
+    std::vector<float> & out;
+
+    void operator () () const
+    {
+        std::fill(out.begin(), out.end(), 0.0f);
+        for (std::size_t i = 0; i < signal.size(); ++i)
+            for (std::size_t j = 0; j < kernel.size(); ++j)
+                out[i + j] += signal[i] * kernel[j];
+        mwbench::consume(out.back());
+    }
+};
+
+struct FftConvolution
+{
+    const std::vector<float> & signal;
+    const std::vector<float> & kernel;
+    std::vector<float> & out;
+
+    void operator () () const
+    {
+        mw::math::convolve(&signal[0], signal.size(), &kernel[0], kernel.size(), &out[0]);
+        mwbench::consume(out.back());
+    }
+};
+
+template<class Filter>
+struct Streaming
+{
+    Filter & filter;
+    const std::vector<float> & signal;
+    std::vector<float> & out;
+
+    void operator () () const
+    {
+        const std::size_t count = signal.size() - signal.size() % filter.getBlockSize();
+        filter.reset();
+        filter.process(&signal[0], count, &out[0]);
+        mwbench::consume(out[0]);
+    }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(Convolution)
+
+BOOST_AUTO_TEST_CASE(RealTransforms)
+{
+    std::srand(42);
+
+    const std::size_t size = 4096;
+    const std::vector<float> signal = makeSignal(size);
+
+    mw::math::ComplexArray<float> complexSignal, spectrum;
+    for (std::size_t i = 0; i < size; ++i)
+        complexSignal.push_back(mw::math::Complex<float>(signal[i], 0.0f));
+
+    ComplexTransform complexTransform = { *mw::math::FftPlan<float>::get(size), complexSignal, spectrum };
+    mwbench::report("FftPlan forward, real signal (4096)", mwbench::measure(complexTransform), size);
+
+    RealTransform realTransform = { *mw::math::RealFftPlan<float>::get(size), signal, spectrum };
+    mwbench::report("RealFftPlan forward (4096)", mwbench::measure(realTransform), size);
+}
+
+BOOST_AUTO_TEST_CASE(Filters)
+{
+    std::srand(42);
+
+    const std::vector<float> signal = makeSignal(SIGNAL), kernel = makeSignal(KERNEL);
+    std::vector<float> out(SIGNAL + KERNEL - 1);
+
+    DirectConvolution direct = { signal, kernel, out };
+    mwbench::report("direct convolution (64k x 511)", mwbench::measure(direct), SIGNAL);
+
+    FftConvolution convolution = { signal, kernel, out };
+    mwbench::report("convolve (64k x 511)", mwbench::measure(convolution), SIGNAL);
+
+    mw::math::OverlapAddFilter<float> overlapAdd(&kernel[0], kernel.size());
+    Streaming<mw::math::OverlapAddFilter<float> > add = { overlapAdd, signal, out };
+    mwbench::report("OverlapAddFilter (64k x 511)", mwbench::measure(add), SIGNAL);
+
+    mw::math::OverlapSaveFilter<float> overlapSave(&kernel[0], kernel.size());
+    Streaming<mw::math::OverlapSaveFilter<float> > save = { overlapSave, signal, out };
+    mwbench::report("OverlapSaveFilter (64k x 511)", mwbench::measure(save), SIGNAL);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,104 @@
+/**
+ * @file   CubicStepperBench.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <Mw/Bench.hpp>
+#include <Mw/Math/CubicStepper.hpp>
+#include <Mw/Math/Interpolation.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+const unsigned SAMPLES = 1000000;
+
+// Values per segment, as a 4x upsampling of audio blocks or a fine mesh
+const unsigned STEPS = 256;
+
+typedef mw::math::Vector<float, 3> Vec3;
+
+template<class T>
+struct InterpolateCalls
+{
+    const std::vector<T> & points;
+    std::vector<T> & out;
+
+    void operator () () const
+    {
+        const float step = 1.0f / STEPS;
+        for (std::size_t s = 0; s + 3 < points.size(); ++s)
+        {
+            T * values = &out[s * STEPS];
+            for (unsigned i = 0; i < STEPS; ++i)
+                values[i] = mw::math::catmullRomInterpolate(points[s], points[s + 1], points[s + 2], points[s + 3],
+                                                            static_cast<float>(i) * step);
+        }
+        mwbench::consume(out[0]);
+    }
+};
+
+template<class T>
+struct StepperFill
+{
+    const std::vector<T> & points;
+    std::vector<T> & out;
+
+    void operator () () const
+    {
+        const float step = 1.0f / STEPS;
+        for (std::size_t s = 0; s + 3 < points.size(); ++s)
+        {
+            mw::math::CubicStepper<T> stepper(points[s], points[s + 1], points[s + 2], points[s + 3],
+                                              mw::math::SPLINE_CATMULL_ROM, step);
+            stepper.fill(&out[s * STEPS], STEPS);
+        }
+        mwbench::consume(out[0]);
+    }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(CubicStepper)
+
+BOOST_AUTO_TEST_CASE(Fill)
+{
+    std::srand(42);
+
+    const unsigned segments = SAMPLES / STEPS;
+    std::vector<float> samples;
+    std::vector<Vec3> points;
+    for (unsigned i = 0; i < segments + 3; ++i)
+    {
+        samples.push_back(mwbench::random(1.0f));
+
+        Vec3 p;
+        p[0] = mwbench::random(1.0f);
+        p[1] = mwbench::random(1.0f);
+        p[2] = mwbench::random(1.0f);
+        points.push_back(p);
+    }
+
+    const unsigned count = segments * STEPS;
+    std::vector<float> out(count);
+    std::vector<Vec3> vectors(count);
+
+    InterpolateCalls<float> calls = { samples, out };
+    mwbench::report("catmullRomInterpolate float (1M)", mwbench::measure(calls), count);
+
+    StepperFill<float> fill = { samples, out };
+    mwbench::report("CubicStepper float (1M)", mwbench::measure(fill), count);
+
+    InterpolateCalls<Vec3> vectorCalls = { points, vectors };
+    mwbench::report("catmullRomInterpolate Vector3f (1M)", mwbench::measure(vectorCalls), count);
+
+    StepperFill<Vec3> vectorFill = { points, vectors };
+    mwbench::report("CubicStepper Vector3f (1M)", mwbench::measure(vectorFill), count);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,157 @@
+/**
+ * @file   FastMathBench.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <Mw/Bench.hpp>
+#include <Mw/Math/Complex.hpp>
+#include <Mw/Math/FastMath.hpp>
+#include <Mw/Math/Interpolation.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+const unsigned SAMPLES = 1000000;
+
+typedef mw::math::FastMath<mw::math::FAST_MATH_LOW> Low;
+typedef mw::math::FastMath<mw::math::FAST_MATH_MEDIUM> Medium;
+typedef mw::math::FastMath<mw::math::FAST_MATH_HIGH> High;
+
+std::vector<float> randomValues(unsigned count, float range)
+{
+    std::vector<float> values;
+    for (unsigned i = 0; i < count; ++i)
+        values.push_back(static_cast<float>(std::rand()) / RAND_MAX * range - range / 2);
+    return values;
+}
+
+template<class Math>
+struct Cosines
+{
+    const std::vector<float> & in;
+    std::vector<float> & out;
+
+    void operator () () const
+    {
+        for (std::size_t i = 0; i < in.size(); ++i)
+            out[i] = Math::cos(in[i]);
+        mwbench::consume(out.back());
+    }
+};
+
+#ifdef MW_SIMD_SSE2
+
+template<class Math>
+struct SimdCosines
+{
+    const std::vector<float> & in;
+    std::vector<float> & out;
+
+    void operator () () const
+    {
+        for (std::size_t i = 0; i + 4 <= in.size(); i += 4)
+            _mm_storeu_ps(&out[i], Math::cos(_mm_loadu_ps(&in[i])));
+        mwbench::consume(out.back());
+    }
+};
+
+#endif // MW_SIMD_SSE2
+
+template<class Math>
+struct Interpolations
+{
+    const std::vector<float> & p1;
+    const std::vector<float> & p2;
+    const std::vector<float> & mu;
+    std::vector<float> & out;
+
+    void operator () () const
+    {
+        for (std::size_t i = 0; i < out.size(); ++i)
+            out[i] = mw::math::cosineInterpolate(p1[i], p2[i], mu[i], Math());
+        mwbench::consume(out.back());
+    }
+};
+
+template<class Math>
+struct PolarCoords
+{
+    const std::vector<float> & re;
+    const std::vector<float> & im;
+    std::vector<float> & out;
+
+    void operator () () const
+    {
+        for (std::size_t i = 0; i < out.size(); ++i)
+        {
+            const mw::math::Complex<float, Math> cpx(re[i], im[i]);
+            out[i] = cpx.getRadialCoord() + cpx.getAngularCoord();
+        }
+        mwbench::consume(out.back());
+    }
+};
+
+template<class F>
+void run(const char * name, const F & f)
+{
+    mwbench::report(name, mwbench::measure(f), SAMPLES);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(FastMath)
+
+BOOST_AUTO_TEST_CASE(Cosine)
+{
+    std::srand(42);
+
+    const std::vector<float> in = randomValues(SAMPLES, 20.0f);
+    std::vector<float> out(SAMPLES);
+
+    Cosines<mw::math::ExactMath> exact = { in, out };
+    run("std::cos (1M)", exact);
+
+    Cosines<Low> low = { in, out };
+    run("FastMath<LOW>::cos (1M)", low);
+
+    Cosines<Medium> medium = { in, out };
+    run("FastMath<MEDIUM>::cos (1M)", medium);
+
+    Cosines<High> high = { in, out };
+    run("FastMath<HIGH>::cos (1M)", high);
+
+#ifdef MW_SIMD_SSE2
+    SimdCosines<High> simd = { in, out };
+    run("FastMath<HIGH>::cos SSE (1M)", simd);
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(Policies)
+{
+    std::srand(42);
+
+    const std::vector<float> a = randomValues(SAMPLES, 2.0f), b = randomValues(SAMPLES, 2.0f);
+    std::vector<float> mu = randomValues(SAMPLES, 1.0f), out(SAMPLES);
+    for (unsigned i = 0; i < SAMPLES; ++i)
+        mu[i] += 0.5f;
+
+    Interpolations<mw::math::ExactMath> exact = { a, b, mu, out };
+    run("cosineInterpolate ExactMath (1M)", exact);
+
+    Interpolations<Medium> fast = { a, b, mu, out };
+    run("cosineInterpolate FastMath<MEDIUM> (1M)", fast);
+
+    PolarCoords<mw::math::ExactMath> exactPolar = { a, b, out };
+    run("Complex polar coords ExactMath (1M)", exactPolar);
+
+    PolarCoords<Medium> fastPolar = { a, b, out };
+    run("Complex polar coords FastMath<MEDIUM> (1M)", fastPolar);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,137 @@
+/**
+ * @file   FftBench.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <Mw/Bench.hpp>
+#include <Mw/Math/Fft.hpp>
+#include <Mw/Thread/TaskPool.hpp>
+
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+typedef mw::math::Complex<float> Cpx;
+
+/**
+ * Naive DFT built from Complex operations, with a table of roots.
+ */
+struct NaiveDft
+{
+    const std::vector<Cpx> & roots;
+    const std::vector<Cpx> & in;
+    std::vector<Cpx> & out;
+
+    void operator () () const
+    {
+        const std::size_t size = in.size();
+        for (std::size_t k = 0; k < size; ++k)
+        {
+            Cpx sum;
+            std::size_t t = 0;
+            for (std::size_t n = 0; n < size; ++n)
+            {
+                sum += in[n] * roots[t];
+                t += k;
+                if (t >= size)
+                    t -= size;
+            }
+            out[k] = sum;
+        }
+        mwbench::consume(out.back());
+    }
+};
+
+struct Transform
+{
+    const mw::math::FftPlan<float> & plan;
+    const mw::math::ComplexArray<float> & in;
+    mw::math::ComplexArray<float> & out;
+
+    void operator () () const
+    {
+        plan.forward(in, out);
+        mwbench::consume(out.realLane()[0]);
+    }
+};
+
+struct ParallelTransform
+{
+    const mw::math::FftPlan<float> & plan;
+    const mw::math::ComplexArray<float> & in;
+    mw::math::ComplexArray<float> & out;
+    mw::thread::TaskPool & pool;
+
+    void operator () () const
+    {
+        plan.forward(in, out, pool);
+        mwbench::consume(out.realLane()[0]);
+    }
+};
+
+void compare(std::size_t size)
+{
+    std::vector<Cpx> signal, spectrum(size), roots;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        signal.push_back(Cpx(mwbench::random(2.0f) - 1.0f, mwbench::random(2.0f) - 1.0f));
+        const double angle = -2 * M_PI * static_cast<double>(i) / static_cast<double>(size);
+        roots.push_back(Cpx(static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle))));
+    }
+
+    const mw::math::ComplexArray<float> in(signal.begin(), signal.end());
+    mw::math::ComplexArray<float> out(size);
+    const boost::shared_ptr<const mw::math::FftPlan<float> > plan = mw::math::FftPlan<float>::get(size);
+
+    std::ostringstream name;
+    name << "naive DFT (" << size << ")";
+    NaiveDft naive = { roots, signal, spectrum };
+    mwbench::report(name.str().c_str(), mwbench::measure(naive), size);
+
+    name.str("");
+    name << "FftPlan forward (" << size << (plan->isBluestein() ? ", Bluestein)" : ")");
+    Transform transform = { *plan, in, out };
+    mwbench::report(name.str().c_str(), mwbench::measure(transform), size);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(Fft)
+
+BOOST_AUTO_TEST_CASE(Single)
+{
+    std::srand(42);
+
+    compare(1024);
+    compare(1000);
+    compare(1031);
+}
+
+BOOST_AUTO_TEST_CASE(Batch)
+{
+    std::srand(42);
+
+    const std::size_t size = 256, count = 4096;
+
+    mw::math::ComplexArray<float> in, out(size * count);
+    for (std::size_t i = 0; i < size * count; ++i)
+        in.push_back(Cpx(mwbench::random(2.0f) - 1.0f, mwbench::random(2.0f) - 1.0f));
+
+    const mw::math::FftPlan<float> plan(size);
+
+    Transform transform = { plan, in, out };
+    mwbench::report("FftPlan batch forward (4096 x 256)", mwbench::measure(transform), size * count);
+
+    mw::thread::TaskPool pool;
+    ParallelTransform parallel = { plan, in, out, pool };
+    mwbench::report("FftPlan batch forward, TaskPool (4096 x 256)", mwbench::measure(parallel), size * count);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
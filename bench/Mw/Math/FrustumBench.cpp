@@ -0,0 +1,147 @@
+/**
+ * @file   FrustumBench.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <Mw/Bench.hpp>
+#include <Mw/Math/BoundsArray.hpp>
+#include <Mw/Math/Frustum.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+const unsigned BOXES = 100000;
+
+typedef mw::math::Vector<float, 3> Vec3;
+typedef mw::math::Bounds<float, 3> Box;
+typedef mw::math::Frustum<float> ViewFrustum;
+
+bool lessX(const Box & a, const Box & b)
+{
+    return a.getLowerLimit()[0] < b.getLowerLimit()[0];
+}
+
+Vec3 vec3(float x, float y, float z)
+{
+    Vec3 v;
+    v[0] = x;
+    v[1] = y;
+    v[2] = z;
+    return v;
+}
+
+/**
+ * One Plane per side, tested point by point on the 8 corners.
+ */
+struct PlaneCorners
+{
+    const std::vector<mw::math::Plane<float, Vec3> > & planes;
+    const std::vector<Box> & boxes;
+    std::vector<std::size_t> & visible;
+
+    void operator () () const
+    {
+        visible.clear();
+        for (std::size_t i = 0; i < boxes.size(); ++i)
+        {
+            bool outside = false;
+            for (std::size_t p = 0; p < planes.size() && !outside; ++p)
+            {
+                outside = true;
+                for (unsigned k = 0; k < 8 && outside; ++k)
+                {
+                    Vec3 corner;
+                    for (unsigned c = 0; c < 3; ++c)
+                        corner[c] = (k & (1u << c)) ? boxes[i].getUpperLimit()[c] : boxes[i].getLowerLimit()[c];
+                    outside = planes[p].isUnder(corner);
+                }
+            }
+            if (!outside)
+                visible.push_back(i);
+        }
+        mwbench::consume(visible.size());
+    }
+};
+
+struct Classify
+{
+    const ViewFrustum & frustum;
+    const std::vector<Box> & boxes;
+    std::vector<std::size_t> & visible;
+
+    void operator () () const
+    {
+        visible.clear();
+        for (std::size_t i = 0; i < boxes.size(); ++i)
+            if (frustum.classify(boxes[i]) != ViewFrustum::OUTSIDE)
+                visible.push_back(i);
+        mwbench::consume(visible.size());
+    }
+};
+
+struct Cull
+{
+    const ViewFrustum & frustum;
+    const mw::math::BoundsArray<float, 3> & boxes;
+    ViewFrustum::Coherency * coherency;
+    std::vector<std::size_t> & visible;
+
+    void operator () () const
+    {
+        visible.clear();
+        if (coherency)
+            frustum.cull(boxes, *coherency, visible);
+        else
+            frustum.cull(boxes, visible);
+        mwbench::consume(visible.size());
+    }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(Frustum)
+
+BOOST_AUTO_TEST_CASE(Culling)
+{
+    std::srand(42);
+
+    std::vector<Box> boxes;
+    for (unsigned i = 0; i < BOXES; ++i)
+    {
+        Vec3 p = vec3(mwbench::random(2000.0f) - 1000.0f, mwbench::random(200.0f) - 100.0f, mwbench::random(2000.0f) - 1000.0f);
+        boxes.push_back(Box(p, p + vec3(mwbench::random(5.0f), mwbench::random(5.0f), mwbench::random(5.0f))));
+    }
+    // Scenes are usually stored with some spatial coherency
+    std::sort(boxes.begin(), boxes.end(), lessX);
+    mw::math::BoundsArray<float, 3> array(boxes.begin(), boxes.end());
+
+    ViewFrustum frustum(Vec3(), vec3(1, 0, 1), vec3(0, 1, 0), 1.0f, 16.0f / 9.0f, 0.1f, 500.0f);
+
+    std::vector<mw::math::Plane<float, Vec3> > planes;
+    for (unsigned p = 0; p < frustum.size(); ++p)
+        planes.push_back(frustum.get(p));
+
+    std::vector<std::size_t> visible;
+    PlaneCorners corners = { planes, boxes, visible };
+    mwbench::report("Plane::isUnder on box corners (100k boxes)", mwbench::measure(corners), BOXES);
+
+    Classify classify = { frustum, boxes, visible };
+    mwbench::report("Frustum classify, one box (100k boxes)", mwbench::measure(classify), BOXES);
+
+    Cull cull = { frustum, array, NULL, visible };
+    mwbench::report("Frustum cull, batch (100k boxes)", mwbench::measure(cull), BOXES);
+
+    ViewFrustum::Coherency coherency;
+    Cull coherent = { frustum, array, &coherency, visible };
+    coherent();
+    mwbench::report("Frustum cull, batch + coherency (100k boxes)", mwbench::measure(coherent), BOXES);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
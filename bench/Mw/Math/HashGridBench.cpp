@@ -0,0 +1,119 @@
+/**
+ * @file   HashGridBench.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <Mw/Bench.hpp>
+#include <Mw/Math/HashGrid.hpp>
+#include <Mw/Thread/TaskPool.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+const unsigned POINTS = 1000000;
+const unsigned QUERIES = 10000;
+const float RADIUS = 1.0f;
+
+typedef mw::math::Vector<float, 3> Vec3;
+typedef mw::math::HashGrid<float, 3> Grid;
+
+struct Rebuild
+{
+    Grid & grid;
+    const std::vector<Vec3> & points;
+    mw::thread::TaskPool * pool;
+
+    void operator () () const
+    {
+        if (pool)
+            grid.rebuild(points.begin(), points.end(), *pool);
+        else
+            grid.rebuild(points.begin(), points.end());
+        mwbench::consume(grid.size());
+    }
+};
+
+struct BatchQuery
+{
+    const Grid & grid;
+    const std::vector<Vec3> & queries;
+    mw::thread::TaskPool * pool;
+
+    void operator () () const
+    {
+        Grid::Indices offsets, neighbours;
+        if (pool)
+            grid.queryRadius(queries.begin(), queries.end(), RADIUS, offsets, neighbours, *pool);
+        else
+            grid.queryRadius(queries.begin(), queries.end(), RADIUS, offsets, neighbours);
+        mwbench::consume(neighbours.size());
+    }
+};
+
+struct BruteForce
+{
+    const std::vector<Vec3> & points;
+    const std::vector<Vec3> & queries;
+
+    void operator () () const
+    {
+        std::size_t found = 0;
+        for (std::size_t q = 0; q < queries.size(); ++q)
+            for (std::size_t i = 0; i < points.size(); ++i)
+            {
+                Vec3 d = points[i] - queries[q];
+                if (d.dot(d) <= RADIUS * RADIUS)
+                    ++found;
+            }
+        mwbench::consume(found);
+    }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(HashGrid)
+
+BOOST_AUTO_TEST_CASE(RebuildAndQuery)
+{
+    std::srand(42);
+
+    // About 4 points per cell
+    std::vector<Vec3> points;
+    for (unsigned i = 0; i < POINTS; ++i)
+    {
+        Vec3 p;
+        for (unsigned c = 0; c < 3; ++c)
+            p[c] = mwbench::random(63.0f);
+        points.push_back(p);
+    }
+    std::vector<Vec3> queries(points.begin(), points.begin() + QUERIES);
+
+    mw::thread::TaskPool pool;
+    std::cout << "  (" << pool.getThreadCount() << " threads)" << std::endl;
+
+    Grid grid(RADIUS);
+    Rebuild sequential = { grid, points, NULL };
+    Rebuild parallel = { grid, points, &pool };
+    mwbench::report("HashGrid rebuild, 1 thread (1M points)", mwbench::measure(sequential), POINTS);
+    mwbench::report("HashGrid rebuild, task pool (1M points)", mwbench::measure(parallel), POINTS);
+
+    BatchQuery batch = { grid, queries, NULL };
+    BatchQuery parallelBatch = { grid, queries, &pool };
+    mwbench::report("HashGrid queryRadius, 1 thread (10k queries)", mwbench::measure(batch), QUERIES);
+    mwbench::report("HashGrid queryRadius, task pool (10k queries)", mwbench::measure(parallelBatch), QUERIES);
+
+    // Brute force on a tenth of the points and queries
+    std::vector<Vec3> fewPoints(points.begin(), points.begin() + POINTS / 10);
+    std::vector<Vec3> fewQueries(queries.begin(), queries.begin() + QUERIES / 10);
+    BruteForce brute = { fewPoints, fewQueries };
+    mwbench::report("Brute force dot (100k points, 1k queries)", mwbench::measure(brute, 1), QUERIES / 10);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,162 @@
+/**
+ * @file   InterpolationBench.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <Mw/Bench.hpp>
+#include <Mw/Math/Interpolation.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+const unsigned SAMPLES = 1000000;
+
+std::vector<float> randomValues(unsigned count)
+{
+    std::vector<float> values;
+    for (unsigned i = 0; i < count; ++i)
+        values.push_back(static_cast<float>(std::rand()) / RAND_MAX);
+    return values;
+}
+
+struct CosineCalls
+{
+    const std::vector<float> & p1;
+    const std::vector<float> & p2;
+    const std::vector<float> & mu;
+    std::vector<float> & out;
+
+    void operator () () const
+    {
+        for (std::size_t i = 0; i < out.size(); ++i)
+            out[i] = mw::math::cosineInterpolate(p1[i], p2[i], mu[i]);
+        mwbench::consume(out.back());
+    }
+};
+
+struct CosineBatch
+{
+    const std::vector<float> & p1;
+    const std::vector<float> & p2;
+    const std::vector<float> & mu;
+    std::vector<float> & out;
+
+    void operator () () const
+    {
+        mw::math::cosineInterpolate(&p1[0], &p2[0], &mu[0], &out[0], out.size());
+        mwbench::consume(out.back());
+    }
+};
+
+struct CubicCalls
+{
+    const std::vector<float> & p;
+    const std::vector<float> & mu;
+    std::vector<float> & out;
+
+    void operator () () const
+    {
+        for (std::size_t i = 0; i < out.size(); ++i)
+            out[i] = mw::math::cubicInterpolate(p[i], p[i + 1], p[i + 2], p[i + 3], mu[i]);
+        mwbench::consume(out.back());
+    }
+};
+
+struct CubicBatch
+{
+    const std::vector<float> & p;
+    const std::vector<float> & mu;
+    std::vector<float> & out;
+
+    void operator () () const
+    {
+        mw::math::cubicInterpolate(&p[0], &p[1], &p[2], &p[3], &mu[0], &out[0], out.size());
+        mwbench::consume(out.back());
+    }
+};
+
+/**
+ * Catmull-rom resampling, one call per value.
+ */
+struct ResampleCalls
+{
+    const std::vector<float> & samples;
+    float step;
+    std::vector<float> & out;
+
+    void operator () () const
+    {
+        const std::size_t last = samples.size() - 1;
+        for (std::size_t i = 0; i < out.size(); ++i)
+        {
+            const double x = static_cast<double>(i) * step;
+            const std::size_t k = static_cast<std::size_t>(x);
+            const float mu = static_cast<float>(x - static_cast<double>(k));
+            out[i] = mw::math::catmullRomInterpolate(samples[k > 0 ? k - 1 : 0], samples[k], samples[k + 1],
+                                                     samples[k + 2 <= last ? k + 2 : last], mu);
+        }
+        mwbench::consume(out.back());
+    }
+};
+
+struct ResampleBatch
+{
+    const std::vector<float> & samples;
+    float step;
+    std::vector<float> & out;
+
+    void operator () () const
+    {
+        mw::math::catmullRomResample(&samples[0], samples.size(), 0.0f, step, &out[0], out.size());
+        mwbench::consume(out.back());
+    }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(Interpolation)
+
+BOOST_AUTO_TEST_CASE(Batch)
+{
+    std::srand(42);
+
+    const std::vector<float> p1 = randomValues(SAMPLES), p2 = randomValues(SAMPLES);
+    const std::vector<float> p = randomValues(SAMPLES + 3), mu = randomValues(SAMPLES);
+    std::vector<float> out(SAMPLES);
+
+    CosineCalls cosineCalls = { p1, p2, mu, out };
+    mwbench::report("cosineInterpolate per call (1M)", mwbench::measure(cosineCalls), SAMPLES);
+
+    CosineBatch cosineBatch = { p1, p2, mu, out };
+    mwbench::report("cosineInterpolate batch (1M)", mwbench::measure(cosineBatch), SAMPLES);
+
+    CubicCalls cubicCalls = { p, mu, out };
+    mwbench::report("cubicInterpolate per call (1M)", mwbench::measure(cubicCalls), SAMPLES);
+
+    CubicBatch cubicBatch = { p, mu, out };
+    mwbench::report("cubicInterpolate batch (1M)", mwbench::measure(cubicBatch), SAMPLES);
+}
+
+BOOST_AUTO_TEST_CASE(Resample)
+{
+    std::srand(42);
+
+    // 44.1 kHz to 48 kHz
+    const std::vector<float> samples = randomValues(SAMPLES * 441 / 480 + 2);
+    const float step = 441.0f / 480.0f;
+    std::vector<float> out(SAMPLES);
+
+    ResampleCalls calls = { samples, step, out };
+    mwbench::report("catmullRomInterpolate per call (1M)", mwbench::measure(calls), SAMPLES);
+
+    ResampleBatch batch = { samples, step, out };
+    mwbench::report("catmullRomResample (1M)", mwbench::measure(batch), SAMPLES);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
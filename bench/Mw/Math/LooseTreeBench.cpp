@@ -0,0 +1,184 @@
+/**
+ * @file   LooseTreeBench.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <Mw/Bench.hpp>
+#include <Mw/Math/Bvh.hpp>
+#include <Mw/Math/LooseTree.hpp>
+
+#include <cstdlib>
+#include <iterator>
+#include <vector>
+
+namespace {
+
+const unsigned ITEMS = 100000;
+const unsigned QUERIES = 1000;
+const float WORLD = 1000.0f;
+
+typedef mw::math::Vector<float, 3> Vec3;
+typedef mw::math::Bounds<float, 3> Box;
+typedef mw::math::LooseTree<float, 3> Octree;
+
+Box randomBox(float world, float size)
+{
+    Vec3 p, s;
+    for (unsigned c = 0; c < 3; ++c)
+    {
+        p[c] = mwbench::random(world);
+        s[c] = mwbench::random(size) + 0.01f;
+    }
+    return Box(p, p + s);
+}
+
+/**
+ * Objects moving in straight lines, bouncing on the world limits.
+ */
+struct World
+{
+    std::vector<Box> boxes;
+    std::vector<Vec3> velocities;
+
+    void step()
+    {
+        for (std::size_t i = 0; i < boxes.size(); ++i)
+        {
+            Vec3 lower = boxes[i].getLowerLimit() + velocities[i];
+            Vec3 upper = boxes[i].getUpperLimit() + velocities[i];
+            for (unsigned c = 0; c < 3; ++c)
+                if (lower[c] < 0 || upper[c] > WORLD)
+                    velocities[i][c] = - velocities[i][c];
+            boxes[i] = Box(lower, upper);
+        }
+    }
+};
+
+struct OctreeFrame
+{
+    World & world;
+    Octree & tree;
+    const std::vector<Octree::Handle> & handles;
+    const std::vector<Box> & queries;
+    std::vector<std::size_t> & hits;
+
+    void operator () () const
+    {
+        world.step();
+        for (std::size_t i = 0; i < handles.size(); ++i)
+            tree.move(handles[i], world.boxes[i]);
+
+        hits.clear();
+        for (unsigned q = 0; q < queries.size(); ++q)
+            tree.queryBounds(queries[q], std::back_inserter(hits));
+        mwbench::consume(hits.size());
+    }
+};
+
+struct OctreeChurn
+{
+    World & world;
+    Octree & tree;
+    std::vector<Octree::Handle> & handles;
+
+    void operator () () const
+    {
+        // Replace a tenth of the objects
+        for (std::size_t i = 0; i < handles.size(); i += 10)
+        {
+            tree.remove(handles[i]);
+            handles[i] = tree.insert(world.boxes[i], i);
+        }
+        mwbench::consume(tree.size());
+    }
+};
+
+struct BvhFrame
+{
+    World & world;
+    mw::math::Bvh<float, 3> & bvh;
+    bool rebuild;
+    const std::vector<Box> & queries;
+    std::vector<std::size_t> & hits;
+
+    void operator () () const
+    {
+        world.step();
+        if (rebuild)
+            bvh.build(world.boxes.begin(), world.boxes.end());
+        else
+        {
+            for (std::size_t i = 0; i < world.boxes.size(); ++i)
+                bvh.setBounds(i, world.boxes[i]);
+            bvh.refit();
+        }
+
+        hits.clear();
+        for (unsigned q = 0; q < queries.size(); ++q)
+            bvh.queryBounds(queries[q], std::back_inserter(hits));
+        mwbench::consume(hits.size());
+    }
+};
+
+World makeWorld()
+{
+    std::srand(42);
+
+    World world;
+    for (unsigned i = 0; i < ITEMS; ++i)
+    {
+        world.boxes.push_back(randomBox(WORLD - 10.0f, 5.0f));
+        Vec3 v;
+        for (unsigned c = 0; c < 3; ++c)
+            v[c] = mwbench::random(2.0f) - 1.0f;
+        world.velocities.push_back(v);
+    }
+    return world;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(LooseTree)
+
+BOOST_AUTO_TEST_CASE(MovingObjects)
+{
+    std::vector<Box> queries;
+    std::vector<std::size_t> hits;
+
+    World world = makeWorld();
+    for (unsigned q = 0; q < QUERIES; ++q)
+        queries.push_back(randomBox(WORLD, 20.0f));
+
+    Vec3 limit;
+    for (unsigned c = 0; c < 3; ++c)
+        limit[c] = WORLD;
+    Octree tree(Box(Vec3(), limit));
+    std::vector<Octree::Handle> handles;
+    for (unsigned i = 0; i < ITEMS; ++i)
+        handles.push_back(tree.insert(world.boxes[i], i));
+
+    OctreeFrame octreeFrame = { world, tree, handles, queries, hits };
+    mwbench::report("LooseTree move + 1k queries (100k objects)", mwbench::measure(octreeFrame, 20), ITEMS);
+
+    OctreeChurn churn = { world, tree, handles };
+    mwbench::report("LooseTree remove + insert (10k objects)", mwbench::measure(churn, 20), ITEMS / 10);
+
+    // Refitting a Bvh over moving objects degrades its queries
+    world = makeWorld();
+    mw::math::Bvh<float, 3> bvh;
+    bvh.build(world.boxes.begin(), world.boxes.end());
+
+    BvhFrame refitFrame = { world, bvh, false, queries, hits };
+    for (unsigned i = 0; i < 100; ++i)
+        refitFrame();
+    mwbench::report("Bvh refit + 1k queries, after 100 frames", mwbench::measure(refitFrame, 20), ITEMS);
+
+    BvhFrame rebuildFrame = { world, bvh, true, queries, hits };
+    mwbench::report("Bvh rebuild + 1k queries (100k objects)", mwbench::measure(rebuildFrame, 5), ITEMS);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,183 @@
+/**
+ * @file   MatrixBench.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <Mw/Bench.hpp>
+#include <Mw/Math/Matrix.hpp>
+#include <Mw/Math/MatrixTransform.hpp>
+#include <Mw/Thread/TaskPool.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+const unsigned POINTS = 1000000;
+const unsigned MATRICES = 100000;
+
+typedef mw::math::Vector<float, 3> Vec3;
+typedef mw::math::Vector<float, 4> Vec4;
+typedef mw::math::Matrix<float, 4, 4> Mat4;
+
+Mat4 randomMatrix()
+{
+    Mat4 m;
+    for (unsigned r = 0; r < 4; ++r)
+        for (unsigned c = 0; c < 4; ++c)
+            m(r, c) = mwbench::random(2.0f) - 1.0f + (r == c ? 4.0f : 0.0f);
+    return m;
+}
+
+struct ScalarPoints
+{
+    const Mat4 & mat;
+    const std::vector<Vec3> & in;
+    std::vector<Vec3> & out;
+
+    void operator () () const
+    {
+        for (std::size_t i = 0; i < in.size(); ++i)
+            out[i] = mw::math::transformPoint(mat, in[i]);
+        mwbench::consume(out.back());
+    }
+};
+
+struct BatchPoints
+{
+    const Mat4 & mat;
+    const std::vector<Vec3> & in;
+    std::vector<Vec3> & out;
+
+    void operator () () const
+    {
+        mw::math::transformPoints(mat, &in[0], &out[0], in.size());
+        mwbench::consume(out.back());
+    }
+};
+
+struct ParallelPoints
+{
+    const Mat4 & mat;
+    const std::vector<Vec3> & in;
+    std::vector<Vec3> & out;
+    mw::thread::TaskPool & pool;
+
+    void operator () () const
+    {
+        mw::math::transformPoints(mat, &in[0], &out[0], in.size(), pool);
+        mwbench::consume(out.back());
+    }
+};
+
+struct ScalarVectors
+{
+    const Mat4 & mat;
+    const std::vector<Vec4> & in;
+    std::vector<Vec4> & out;
+
+    void operator () () const
+    {
+        for (std::size_t i = 0; i < in.size(); ++i)
+            out[i] = mat * in[i];
+        mwbench::consume(out.back());
+    }
+};
+
+struct BatchVectors
+{
+    const Mat4 & mat;
+    const std::vector<Vec4> & in;
+    std::vector<Vec4> & out;
+
+    void operator () () const
+    {
+        mw::math::transform(mat, &in[0], &out[0], in.size());
+        mwbench::consume(out.back());
+    }
+};
+
+struct Products
+{
+    const std::vector<Mat4> & matrices;
+
+    void operator () () const
+    {
+        Mat4 m = Mat4::identity();
+        for (std::size_t i = 0; i < matrices.size(); ++i)
+            m = matrices[i] * m * static_cast<float>(0.25f);
+        mwbench::consume(m(0, 0));
+    }
+};
+
+struct Inverses
+{
+    const std::vector<Mat4> & matrices;
+
+    void operator () () const
+    {
+        float sum = 0;
+        for (std::size_t i = 0; i < matrices.size(); ++i)
+            sum += matrices[i].getInverse()(0, 0);
+        mwbench::consume(sum);
+    }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(Matrix)
+
+BOOST_AUTO_TEST_CASE(Transform)
+{
+    std::srand(42);
+
+    const Mat4 mat = randomMatrix();
+
+    std::vector<Vec3> points(POINTS), outPoints(POINTS);
+    std::vector<Vec4> vectors(POINTS), outVectors(POINTS);
+    for (unsigned i = 0; i < POINTS; ++i)
+        for (unsigned c = 0; c < 4; ++c)
+        {
+            const float value = mwbench::random(100.0f);
+            if (c < 3)
+                points[i][c] = value;
+            vectors[i][c] = value;
+        }
+
+    ScalarPoints scalar = { mat, points, outPoints };
+    mwbench::report("transformPoint loop (1M points)", mwbench::measure(scalar), POINTS);
+
+    BatchPoints batch = { mat, points, outPoints };
+    mwbench::report("transformPoints (1M points)", mwbench::measure(batch), POINTS);
+
+    mw::thread::TaskPool pool;
+    ParallelPoints parallel = { mat, points, outPoints, pool };
+    mwbench::report("transformPoints, TaskPool (1M points)", mwbench::measure(parallel), POINTS);
+
+    ScalarVectors scalar4 = { mat, vectors, outVectors };
+    mwbench::report("Matrix * Vector loop (1M 4D vectors)", mwbench::measure(scalar4), POINTS);
+
+    BatchVectors batch4 = { mat, vectors, outVectors };
+    mwbench::report("transform (1M 4D vectors)", mwbench::measure(batch4), POINTS);
+}
+
+BOOST_AUTO_TEST_CASE(Operations)
+{
+    std::srand(42);
+
+    std::vector<Mat4> matrices;
+    for (unsigned i = 0; i < MATRICES; ++i)
+        matrices.push_back(randomMatrix());
+
+    Products products = { matrices };
+    mwbench::report("Matrix 4x4 product (100k)", mwbench::measure(products), MATRICES);
+
+    Inverses inverses = { matrices };
+    mwbench::report("Matrix 4x4 inverse (100k)", mwbench::measure(inverses), MATRICES);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,122 @@
+/**
+ * @file   QuaternionBench.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <Mw/Bench.hpp>
+#include <Mw/Math/Quaternion.hpp>
+#include <Mw/Math/QuaternionArray.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+const unsigned BONES = 50000;
+
+typedef mw::math::Quaternion<float> Quat;
+
+Quat randomRotation()
+{
+    Quat q(mwbench::random(2.0f) - 1.0f, mwbench::random(2.0f) - 1.0f, mwbench::random(2.0f) - 1.0f, mwbench::random(2.0f) - 1.0f);
+    return normalize(q + Quat::identity());
+}
+
+struct ScalarSlerp
+{
+    const std::vector<Quat> & from;
+    const std::vector<Quat> & to;
+    const std::vector<float> & mu;
+    std::vector<Quat> & out;
+
+    void operator () () const
+    {
+        for (std::size_t i = 0; i < from.size(); ++i)
+            out[i] = mw::math::slerp(from[i], to[i], mu[i]);
+        mwbench::consume(out.back());
+    }
+};
+
+struct ScalarNlerp
+{
+    const std::vector<Quat> & from;
+    const std::vector<Quat> & to;
+    const std::vector<float> & mu;
+    std::vector<Quat> & out;
+
+    void operator () () const
+    {
+        for (std::size_t i = 0; i < from.size(); ++i)
+            out[i] = mw::math::nlerp(from[i], to[i], mu[i]);
+        mwbench::consume(out.back());
+    }
+};
+
+struct BatchSlerp
+{
+    const mw::math::QuaternionArray<float> & from;
+    const mw::math::QuaternionArray<float> & to;
+    const std::vector<float> & mu;
+    mw::math::QuaternionArray<float> & out;
+
+    void operator () () const
+    {
+        mw::math::slerp(from, to, &mu[0], out);
+        mwbench::consume(out.lane(0)[0]);
+    }
+};
+
+struct BatchNlerp
+{
+    const mw::math::QuaternionArray<float> & from;
+    const mw::math::QuaternionArray<float> & to;
+    const std::vector<float> & mu;
+    mw::math::QuaternionArray<float> & out;
+
+    void operator () () const
+    {
+        mw::math::nlerp(from, to, &mu[0], out);
+        mwbench::consume(out.lane(0)[0]);
+    }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(Quaternion)
+
+BOOST_AUTO_TEST_CASE(Sampling)
+{
+    std::srand(42);
+
+    // Key frames of the bones, and the position of the sample between them
+    std::vector<Quat> from, to, out(BONES);
+    std::vector<float> mu;
+    for (unsigned i = 0; i < BONES; ++i)
+    {
+        from.push_back(randomRotation());
+        to.push_back(randomRotation());
+        mu.push_back(mwbench::random(1.0f));
+    }
+
+    mw::math::QuaternionArray<float> fromArray(from.begin(), from.end());
+    mw::math::QuaternionArray<float> toArray(to.begin(), to.end());
+    mw::math::QuaternionArray<float> outArray(BONES);
+
+    ScalarSlerp slerp = { from, to, mu, out };
+    mwbench::report("slerp loop (50k bones)", mwbench::measure(slerp), BONES);
+
+    ScalarNlerp nlerp = { from, to, mu, out };
+    mwbench::report("nlerp loop (50k bones)", mwbench::measure(nlerp), BONES);
+
+    BatchSlerp batchSlerp = { fromArray, toArray, mu, outArray };
+    mwbench::report("QuaternionArray slerp (50k bones)", mwbench::measure(batchSlerp), BONES);
+
+    BatchNlerp batchNlerp = { fromArray, toArray, mu, outArray };
+    mwbench::report("QuaternionArray nlerp (50k bones)", mwbench::measure(batchNlerp), BONES);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
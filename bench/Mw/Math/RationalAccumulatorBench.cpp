@@ -0,0 +1,102 @@
+/**
+ * @file   RationalAccumulatorBench.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <Mw/Bench.hpp>
+#include <Mw/Math/RationalAccumulator.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+namespace {
+
+const unsigned SAMPLES = 100000;
+
+typedef mw::math::Rational<boost::int64_t> Rat;
+
+struct EagerSum
+{
+    const std::vector<Rat> & values;
+
+    void operator () () const
+    {
+        Rat sum;
+        for (std::size_t i = 0; i < values.size(); ++i)
+            sum += values[i];
+        mwbench::consume(sum);
+    }
+};
+
+struct AccumulatedSum
+{
+    const std::vector<Rat> & values;
+
+    void operator () () const
+    {
+        mwbench::consume(mw::math::sum(&values[0], values.size()));
+    }
+};
+
+struct EagerDot
+{
+    const std::vector<Rat> & a;
+    const std::vector<Rat> & b;
+
+    void operator () () const
+    {
+        Rat sum;
+        for (std::size_t i = 0; i < a.size(); ++i)
+            sum += a[i] * b[i];
+        mwbench::consume(sum);
+    }
+};
+
+struct AccumulatedDot
+{
+    const std::vector<Rat> & a;
+    const std::vector<Rat> & b;
+
+    void operator () () const
+    {
+        mwbench::consume(mw::math::dot(&a[0], &b[0], a.size()));
+    }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(RationalAccumulator)
+
+BOOST_AUTO_TEST_CASE(Sums)
+{
+    std::srand(42);
+
+    // Denominators dividing 360, so that the sums fit
+    const boost::int64_t denominators[] = { 1, 2, 3, 4, 5, 6, 8, 9, 10, 12, 15, 18, 20, 24, 30, 36 };
+    std::vector<Rat> a, b;
+    for (unsigned i = 0; i < SAMPLES; ++i)
+    {
+        a.push_back(Rat(std::rand() % 2001 - 1000, denominators[std::rand() % 16]));
+        b.push_back(Rat(std::rand() % 2001 - 1000, denominators[std::rand() % 16]));
+    }
+
+    EagerSum eagerSum = { a };
+    mwbench::report("Rational<int64> += (100k)", mwbench::measure(eagerSum), SAMPLES);
+
+    AccumulatedSum accumulatedSum = { a };
+    mwbench::report("RationalAccumulator sum (100k)", mwbench::measure(accumulatedSum), SAMPLES);
+
+    EagerDot eagerDot = { a, b };
+    mwbench::report("Rational<int64> += a * b (100k)", mwbench::measure(eagerDot), SAMPLES);
+
+    AccumulatedDot accumulatedDot = { a, b };
+    mwbench::report("RationalAccumulator dot (100k)", mwbench::measure(accumulatedDot), SAMPLES);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,221 @@
+/**
+ * @file   RationalBench.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <Mw/Bench.hpp>
+#include <Mw/Math/Rational.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+namespace {
+
+const unsigned SAMPLES = 100000;
+
+typedef boost::int64_t Int;
+
+/**
+ * Random value of 1 to @c bits bits.
+ */
+Int random(unsigned bits)
+{
+    boost::uint64_t value = 0;
+    for (int i = 0; i < 4; ++i)
+        value = (value << 16) ^ static_cast<boost::uint64_t>(std::rand());
+    return static_cast<Int>(value >> (64 - 1 - std::rand() % bits));
+}
+
+/**
+ * Modulo-based Euclid, as Rational used to compute gcds.
+ */
+Int euclidGcd(Int a, Int b)
+{
+    a = a >= 0 ? a : - a;
+    b = b >= 0 ? b : - b;
+    while (b)
+    {
+        const Int tmp = a % b;
+        a = b;
+        b = tmp;
+    }
+    return a;
+}
+
+struct EuclidGcds
+{
+    const std::vector<Int> & a;
+    const std::vector<Int> & b;
+
+    void operator () () const
+    {
+        Int sum = 0;
+        for (std::size_t i = 0; i < a.size(); ++i)
+            sum += euclidGcd(a[i], b[i]);
+        mwbench::consume(sum);
+    }
+};
+
+struct BinaryGcds
+{
+    const std::vector<Int> & a;
+    const std::vector<Int> & b;
+
+    void operator () () const
+    {
+        Int sum = 0;
+        for (std::size_t i = 0; i < a.size(); ++i)
+            sum += mw::math::detail::RationalBase<Int>::gcd(a[i], b[i]);
+        mwbench::consume(sum);
+    }
+};
+
+/**
+ * Sum of fractions with the Euclid gcd, as Rational used to compute them.
+ */
+struct EuclidSums
+{
+    const std::vector<Int> & n;
+    const std::vector<Int> & d;
+
+    void operator () () const
+    {
+        Int sum = 0;
+        for (std::size_t i = 0; i + 1 < n.size(); ++i)
+        {
+            const Int n1 = n[i], d1 = d[i], n2 = n[i + 1], d2 = d[i + 1];
+            const Int g1 = euclidGcd(d1, d2);
+            if (g1 == 1)
+                sum += n1 * d2 + d1 * n2 + d1 * d2;
+            else
+            {
+                const Int t = n1 * (d2 / g1) + (d1 / g1) * n2;
+                const Int g2 = euclidGcd(t, g1);
+                sum += t / g2 + (d1 / g1) * (d2 / g2);
+            }
+        }
+        mwbench::consume(sum);
+    }
+};
+
+template<class Policy>
+struct Sums
+{
+    const std::vector<mw::math::Rational<Int, Policy> > & values;
+
+    void operator () () const
+    {
+        Int sum = 0;
+        for (std::size_t i = 0; i + 1 < values.size(); ++i)
+        {
+            const mw::math::Rational<Int, Policy> r = values[i] + values[i + 1];
+            sum += r.getNumerator() + r.getDenominator();
+        }
+        mwbench::consume(sum);
+    }
+};
+
+template<class Policy>
+struct Products
+{
+    const std::vector<mw::math::Rational<Int, Policy> > & values;
+
+    void operator () () const
+    {
+        Int sum = 0;
+        for (std::size_t i = 0; i + 1 < values.size(); ++i)
+        {
+            const mw::math::Rational<Int, Policy> r = values[i] * values[i + 1];
+            sum += r.getNumerator() + r.getDenominator();
+        }
+        mwbench::consume(sum);
+    }
+};
+
+template<class Policy>
+struct Comparisons
+{
+    const std::vector<mw::math::Rational<Int, Policy> > & values;
+
+    void operator () () const
+    {
+        unsigned count = 0;
+        for (std::size_t i = 0; i + 1 < values.size(); ++i)
+            count += values[i] < values[i + 1];
+        mwbench::consume(count);
+    }
+};
+
+struct NarrowComparisons
+{
+    const std::vector<Int> & n;
+    const std::vector<Int> & d;
+
+    void operator () () const
+    {
+        unsigned count = 0;
+        for (std::size_t i = 0; i + 1 < n.size(); ++i)
+            count += mw::math::detail::RationalArithmetic<Int, false>::less(n[i], d[i], n[i + 1], d[i + 1]);
+        mwbench::consume(count);
+    }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(Rational)
+
+BOOST_AUTO_TEST_CASE(Arithmetic)
+{
+    std::srand(42);
+
+    // Mixed magnitudes, from 1 to 31 bits, so that products fit
+    std::vector<Int> a, b, n, d;
+    std::vector<mw::math::Rational<Int> > values;
+    std::vector<mw::math::Rational<Int, mw::math::ThrowOnOverflow> > checked;
+    for (unsigned i = 0; i < SAMPLES; ++i)
+    {
+        a.push_back(random(62));
+        b.push_back(random(62));
+
+        values.push_back(mw::math::Rational<Int>(random(31) - random(31), random(31) + 1));
+        checked.push_back(mw::math::Rational<Int, mw::math::ThrowOnOverflow>(values.back().getNumerator(),
+                                                                            values.back().getDenominator()));
+        n.push_back(values.back().getNumerator());
+        d.push_back(values.back().getDenominator());
+    }
+
+    EuclidGcds euclid = { a, b };
+    mwbench::report("Euclid gcd, mixed 64 bits (100k)", mwbench::measure(euclid), SAMPLES);
+
+    BinaryGcds binary = { a, b };
+    mwbench::report("binary gcd, mixed 64 bits (100k)", mwbench::measure(binary), SAMPLES);
+
+    EuclidSums euclidSums = { n, d };
+    mwbench::report("sum with Euclid gcd (100k)", mwbench::measure(euclidSums), SAMPLES);
+
+    Sums<mw::math::IgnoreOverflow> sums = { values };
+    mwbench::report("Rational<int64> sum (100k)", mwbench::measure(sums), SAMPLES);
+
+    Sums<mw::math::ThrowOnOverflow> checkedSums = { checked };
+    mwbench::report("Rational<int64> sum, ThrowOnOverflow (100k)", mwbench::measure(checkedSums), SAMPLES);
+
+    Products<mw::math::IgnoreOverflow> products = { values };
+    mwbench::report("Rational<int64> product (100k)", mwbench::measure(products), SAMPLES);
+
+    Products<mw::math::ThrowOnOverflow> checkedProducts = { checked };
+    mwbench::report("Rational<int64> product, ThrowOnOverflow (100k)", mwbench::measure(checkedProducts), SAMPLES);
+
+    Comparisons<mw::math::IgnoreOverflow> comparisons = { values };
+    mwbench::report("Rational<int64> compare (100k)", mwbench::measure(comparisons), SAMPLES);
+
+    NarrowComparisons narrowComparisons = { n, d };
+    mwbench::report("continued fraction compare (100k)", mwbench::measure(narrowComparisons), SAMPLES);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
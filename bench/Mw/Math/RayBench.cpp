@@ -0,0 +1,206 @@
+/**
+ * @file   RayBench.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <Mw/Bench.hpp>
+#include <Mw/Math/BoundsArray.hpp>
+#include <Mw/Math/Bvh.hpp>
+#include <Mw/Math/Ray.hpp>
+#include <Mw/Math/RayPacket.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace {
+
+const unsigned ARRAY_BOXES = 10000;
+const unsigned ARRAY_RAYS = 1000;
+const unsigned BVH_BOXES = 100000;
+const unsigned SCREEN = 128;
+
+typedef mw::math::Vector<float, 3> Vec3;
+typedef mw::math::Bounds<float, 3> Box;
+typedef mw::math::Ray<float, 3> Ray3;
+
+std::vector<Box> makeBoxes(unsigned count, float world, float size)
+{
+    std::vector<Box> boxes;
+    for (unsigned i = 0; i < count; ++i)
+    {
+        Vec3 p, s;
+        for (unsigned c = 0; c < 3; ++c)
+        {
+            p[c] = mwbench::random(world);
+            s[c] = mwbench::random(size) + 0.01f;
+        }
+        boxes.push_back(Box(p, p + s));
+    }
+    return boxes;
+}
+
+/**
+ * Rays through the pixels of a screen, row by row.
+ */
+std::vector<Ray3> makeScreenRays(float world)
+{
+    std::vector<Ray3> rays;
+    Vec3 eye;
+    eye[0] = eye[1] = world / 2;
+    eye[2] = - world / 2;
+    for (unsigned y = 0; y < SCREEN; ++y)
+        for (unsigned x = 0; x < SCREEN; ++x)
+        {
+            Vec3 direction;
+            direction[0] = static_cast<float>(x) / SCREEN - 0.5f;
+            direction[1] = static_cast<float>(y) / SCREEN - 0.5f;
+            direction[2] = 1;
+            rays.push_back(Ray3(eye, direction));
+        }
+    return rays;
+}
+
+struct ScalarRays
+{
+    const std::vector<Box> & boxes;
+    const std::vector<Ray3> & rays;
+    float maxDistance;
+
+    void operator () () const
+    {
+        std::size_t hits = 0;
+        for (std::size_t r = 0; r < rays.size(); ++r)
+            for (std::size_t i = 0; i < boxes.size(); ++i)
+                hits += rays[r].isIntersecting(boxes[i], maxDistance);
+        mwbench::consume(hits);
+    }
+};
+
+struct ArrayRays
+{
+    const mw::math::BoundsArray<float, 3> & boxes;
+    const std::vector<Ray3> & rays;
+    float maxDistance;
+    std::vector<std::size_t> & hits;
+
+    void operator () () const
+    {
+        hits.clear();
+        for (std::size_t r = 0; r < rays.size(); ++r)
+            boxes.findRayIntersecting(rays[r], maxDistance, hits);
+        mwbench::consume(hits.size());
+    }
+};
+
+struct BvhRays
+{
+    const mw::math::Bvh<float, 3> & bvh;
+    const std::vector<Ray3> & rays;
+    float maxDistance;
+    std::vector<std::size_t> & hits;
+
+    void operator () () const
+    {
+        hits.clear();
+        for (std::size_t r = 0; r < rays.size(); ++r)
+            bvh.queryRay(rays[r], maxDistance, std::back_inserter(hits));
+        mwbench::consume(hits.size());
+    }
+};
+
+template<unsigned W>
+struct BvhPackets
+{
+    const mw::math::Bvh<float, 3> & bvh;
+    const std::vector<mw::math::RayPacket<float, 3, W> > & packets;
+    float maxDistance;
+    std::vector<std::pair<unsigned, std::size_t> > & hits;
+
+    void operator () () const
+    {
+        float maxDistances[W];
+        std::fill(maxDistances, maxDistances + W, maxDistance);
+
+        hits.clear();
+        for (std::size_t p = 0; p < packets.size(); ++p)
+            bvh.queryRays(packets[p], maxDistances, std::back_inserter(hits));
+        mwbench::consume(hits.size());
+    }
+};
+
+template<unsigned W>
+std::vector<mw::math::RayPacket<float, 3, W> > makePackets(const std::vector<Ray3> & rays)
+{
+    // Packets of neighbour pixels on a row
+    std::vector<mw::math::RayPacket<float, 3, W> > packets(rays.size() / W);
+    for (std::size_t r = 0; r < packets.size() * W; ++r)
+        packets[r / W].set(r % W, rays[r]);
+    return packets;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(Ray)
+
+BOOST_AUTO_TEST_CASE(BoundsArray)
+{
+    std::srand(42);
+
+    std::vector<Box> boxes = makeBoxes(ARRAY_BOXES, 100.0f, 2.0f);
+    mw::math::BoundsArray<float, 3> array(boxes.begin(), boxes.end());
+
+    std::vector<Ray3> rays;
+    for (unsigned r = 0; r < ARRAY_RAYS; ++r)
+    {
+        Vec3 origin, direction;
+        for (unsigned c = 0; c < 3; ++c)
+        {
+            origin[c] = mwbench::random(100.0f);
+            direction[c] = mwbench::random(2.0f) - 1.0f;
+        }
+        rays.push_back(Ray3(origin, direction));
+    }
+
+    std::vector<std::size_t> hits;
+    ScalarRays scalar = { boxes, rays, 50.0f };
+    mwbench::report("Ray::isIntersecting (1k rays x 10k boxes)", mwbench::measure(scalar),
+                    ARRAY_BOXES * ARRAY_RAYS);
+
+    ArrayRays batch = { array, rays, 50.0f, hits };
+    mwbench::report("BoundsArray::findRayIntersecting (1k rays x 10k boxes)", mwbench::measure(batch),
+                    ARRAY_BOXES * ARRAY_RAYS);
+}
+
+BOOST_AUTO_TEST_CASE(BvhTraversal)
+{
+    std::srand(42);
+
+    std::vector<Box> boxes = makeBoxes(BVH_BOXES, 1000.0f, 5.0f);
+    mw::math::Bvh<float, 3> bvh;
+    bvh.build(boxes.begin(), boxes.end());
+
+    std::vector<Ray3> rays = makeScreenRays(1000.0f);
+    std::vector<mw::math::RayPacket<float, 3, 4> > packets4 = makePackets<4>(rays);
+    std::vector<mw::math::RayPacket<float, 3, 8> > packets8 = makePackets<8>(rays);
+
+    std::vector<std::size_t> hits;
+    std::vector<std::pair<unsigned, std::size_t> > packetHits;
+
+    BvhRays single = { bvh, rays, 2000.0f, hits };
+    mwbench::report("Bvh::queryRay (16k rays, 100k boxes)", mwbench::measure(single), SCREEN * SCREEN);
+
+    BvhPackets<4> quad = { bvh, packets4, 2000.0f, packetHits };
+    mwbench::report("Bvh::queryRays, 4 rays (16k rays, 100k boxes)", mwbench::measure(quad), SCREEN * SCREEN);
+
+    BvhPackets<8> octo = { bvh, packets8, 2000.0f, packetHits };
+    mwbench::report("Bvh::queryRays, 8 rays (16k rays, 100k boxes)", mwbench::measure(octo), SCREEN * SCREEN);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,127 @@
+/**
+ * @file   SplineBench.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <Mw/Bench.hpp>
+#include <Mw/Math/Interpolation.hpp>
+#include <Mw/Math/Spline.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+const unsigned SAMPLES = 1000000;
+const unsigned POINTS = 1000;
+
+typedef mw::math::Vector<float, 3> Vec3;
+typedef mw::math::Spline<Vec3> Curve;
+
+/**
+ * Catmull-rom interpolation of the control points for each value.
+ */
+struct InterpolateCalls
+{
+    const std::vector<Vec3> & points;
+    const std::vector<float> & t;
+    std::vector<Vec3> & out;
+
+    void operator () () const
+    {
+        const std::size_t last = points.size() - 1;
+        for (std::size_t i = 0; i < t.size(); ++i)
+        {
+            const std::size_t k = static_cast<std::size_t>(t[i]);
+            out[i] = mw::math::catmullRomInterpolate(points[k > 0 ? k - 1 : 0], points[k], points[k + 1],
+                                                     points[k + 2 <= last ? k + 2 : last], t[i] - k);
+        }
+        mwbench::consume(out.back()[0]);
+    }
+};
+
+struct SplineEvaluate
+{
+    const Curve & curve;
+    const std::vector<float> & t;
+    std::vector<Vec3> & out;
+
+    void operator () () const
+    {
+        curve.evaluate(&t[0], &out[0], t.size());
+        mwbench::consume(out.back()[0]);
+    }
+};
+
+/**
+ * Arc length table searched for each distance.
+ */
+struct DistanceSearch
+{
+    const Curve & curve;
+    const std::vector<float> & distances;
+    std::vector<Vec3> & out;
+
+    void operator () () const
+    {
+        for (std::size_t i = 0; i < distances.size(); ++i)
+            out[i] = curve.evaluateAt(distances[i]);
+        mwbench::consume(out.back()[0]);
+    }
+};
+
+struct DistanceCursor
+{
+    const Curve & curve;
+    const std::vector<float> & distances;
+    std::vector<Vec3> & out;
+
+    void operator () () const
+    {
+        curve.evaluateAt(&distances[0], &out[0], distances.size());
+        mwbench::consume(out.back()[0]);
+    }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(Spline)
+
+BOOST_AUTO_TEST_CASE(Evaluate)
+{
+    std::srand(42);
+
+    std::vector<Vec3> points(POINTS);
+    for (unsigned i = 0; i < POINTS; ++i)
+        for (unsigned j = 0; j < 3; ++j)
+            points[i][j] = static_cast<float>(std::rand()) / RAND_MAX;
+
+    const Curve curve(&points[0], POINTS);
+
+    // Sorted parameters, a thousand values per segment
+    std::vector<float> t, distances;
+    for (unsigned i = 0; i < SAMPLES; ++i)
+    {
+        t.push_back(static_cast<float>(i) * (POINTS - 1) / SAMPLES);
+        distances.push_back(static_cast<float>(i) * curve.getLength() / SAMPLES);
+    }
+    std::vector<Vec3> out(SAMPLES);
+
+    InterpolateCalls calls = { points, t, out };
+    mwbench::report("catmullRomInterpolate per call (1M)", mwbench::measure(calls), SAMPLES);
+
+    SplineEvaluate evaluate = { curve, t, out };
+    mwbench::report("Spline evaluate (1M)", mwbench::measure(evaluate), SAMPLES);
+
+    DistanceSearch search = { curve, distances, out };
+    mwbench::report("Spline evaluateAt, bisection (1M)", mwbench::measure(search), SAMPLES);
+
+    DistanceCursor cursor = { curve, distances, out };
+    mwbench::report("Spline evaluateAt, cursor (1M)", mwbench::measure(cursor), SAMPLES);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,146 @@
+/**
+ * @file   TimebaseBench.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <Mw/Bench.hpp>
+#include <Mw/Math/Timebase.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+namespace {
+
+const unsigned SAMPLES = 1000000;
+
+typedef boost::int64_t Int;
+typedef mw::math::Rational<Int> Rat;
+
+/**
+ * Rational product and division per timestamp.
+ */
+struct RationalRescale
+{
+    const Rat & ratio;
+    const std::vector<Int> & in;
+    std::vector<Int> & out;
+
+    void operator () () const
+    {
+        for (std::size_t i = 0; i < in.size(); ++i)
+        {
+            const Rat r = Rat(in[i]) * ratio;
+            out[i] = r.getNumerator() / r.getDenominator();
+        }
+        mwbench::consume(out[0]);
+    }
+};
+
+#ifdef MW_HAS_INT128
+
+/**
+ * 128 bits division per timestamp.
+ */
+struct WideRescale
+{
+    Int b;
+    Int c;
+    const std::vector<Int> & in;
+    std::vector<Int> & out;
+
+    void operator () () const
+    {
+        for (std::size_t i = 0; i < in.size(); ++i)
+            out[i] = static_cast<Int>(static_cast<mw::math::int128_t>(in[i]) * b / c);
+        mwbench::consume(out[0]);
+    }
+};
+
+#endif // MW_HAS_INT128
+
+struct SingleRescale
+{
+    const mw::math::TimebaseRescaler<> & rescaler;
+    const std::vector<Int> & in;
+    std::vector<Int> & out;
+
+    void operator () () const
+    {
+        for (std::size_t i = 0; i < in.size(); ++i)
+            out[i] = rescaler.rescale(in[i]);
+        mwbench::consume(out[0]);
+    }
+};
+
+struct BatchRescale
+{
+    const mw::math::TimebaseRescaler<> & rescaler;
+    const std::vector<Int> & in;
+    std::vector<Int> & out;
+
+    void operator () () const
+    {
+        rescaler.rescale(&in[0], &out[0], in.size());
+        mwbench::consume(out[0]);
+    }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(Timebase)
+
+BOOST_AUTO_TEST_CASE(Rescale)
+{
+    std::srand(42);
+
+    // 90 kHz ticks to 29.97 fps frames, timestamps up to a few hours
+    const Rat from(1, 90000), to(1001, 30000);
+    std::vector<Int> in, out(SAMPLES);
+    for (unsigned i = 0; i < SAMPLES; ++i)
+        in.push_back(static_cast<Int>(std::rand()) % 1000000000);
+
+    const Rat ratio = from / to;
+    RationalRescale rational = { ratio, in, out };
+    mwbench::report("Rational<int64> product (1M)", mwbench::measure(rational), SAMPLES);
+
+#ifdef MW_HAS_INT128
+    WideRescale wide = { ratio.getNumerator(), ratio.getDenominator(), in, out };
+    mwbench::report("int128 division (1M)", mwbench::measure(wide), SAMPLES);
+#endif
+
+    const mw::math::TimebaseRescaler<> rescaler(from, to, mw::math::ROUND_TOWARD_ZERO);
+    SingleRescale single = { rescaler, in, out };
+    mwbench::report("TimebaseRescaler (1M)", mwbench::measure(single), SAMPLES);
+
+    BatchRescale batch = { rescaler, in, out };
+    mwbench::report("TimebaseRescaler batch (1M)", mwbench::measure(batch), SAMPLES);
+}
+
+BOOST_AUTO_TEST_CASE(WideProducts)
+{
+    std::srand(42);
+
+    // 48 kHz samples to 1 / 2^30 s ticks, the products exceed 64 bits
+    const Rat from(1, 48000), to(1, 1 << 30);
+    std::vector<Int> in, out(SAMPLES);
+    for (unsigned i = 0; i < SAMPLES; ++i)
+        in.push_back((static_cast<Int>(std::rand()) << 24) ^ std::rand());
+
+#ifdef MW_HAS_INT128
+    const Rat ratio = from / to;
+    WideRescale wide = { ratio.getNumerator(), ratio.getDenominator(), in, out };
+    mwbench::report("int128 division, wide products (1M)", mwbench::measure(wide), SAMPLES);
+#endif
+
+    const mw::math::TimebaseRescaler<> rescaler(from, to, mw::math::ROUND_TOWARD_ZERO);
+    BatchRescale batch = { rescaler, in, out };
+    mwbench::report("TimebaseRescaler batch, wide products (1M)", mwbench::measure(batch), SAMPLES);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,125 @@
+/**
+ * @file   VectorBench.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <Mw/Bench.hpp>
+#include <Mw/Math/Vector.hpp>
+
+#include <vector>
+
+namespace {
+
+const unsigned COUNT = 1 << 20;
+
+/**
+ * Hand-written reference for the generated code.
+ */
+struct Float3
+{
+    float v[3];
+};
+
+typedef mw::math::Vector<float, 3> Vec3;
+
+struct VectorIntegrate
+{
+    std::vector<Vec3> & pos;
+    const std::vector<Vec3> & vel;
+
+    void operator () () const
+    {
+        for (unsigned i = 0; i < COUNT; ++i)
+            pos[i] += vel[i] * 0.016f;
+        mwbench::consume(pos[0]);
+    }
+};
+
+struct Float3Integrate
+{
+    std::vector<Float3> & pos;
+    const std::vector<Float3> & vel;
+
+    void operator () () const
+    {
+        for (unsigned i = 0; i < COUNT; ++i)
+            for (unsigned c = 0; c < 3; ++c)
+                pos[i].v[c] += vel[i].v[c] * 0.016f;
+        mwbench::consume(pos[0]);
+    }
+};
+
+struct VectorDot
+{
+    const std::vector<Vec3> & a;
+    float & out;
+
+    void operator () () const
+    {
+        float sum = 0.0f;
+        for (unsigned i = 0; i < COUNT; ++i)
+            sum += a[i].dot(a[COUNT - 1 - i]);
+        out = sum;
+        mwbench::consume(out);
+    }
+};
+
+struct Float3Dot
+{
+    const std::vector<Float3> & a;
+    float & out;
+
+    void operator () () const
+    {
+        float sum = 0.0f;
+        for (unsigned i = 0; i < COUNT; ++i)
+        {
+            const Float3 & l = a[i];
+            const Float3 & r = a[COUNT - 1 - i];
+            sum += l.v[0] * r.v[0] + l.v[1] * r.v[1] + l.v[2] * r.v[2];
+        }
+        out = sum;
+        mwbench::consume(out);
+    }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(Vector)
+
+BOOST_AUTO_TEST_CASE(VectorVsFloat3)
+{
+    std::vector<Vec3> vpos(COUNT), vvel(COUNT);
+    std::vector<Float3> fpos(COUNT), fvel(COUNT);
+
+    for (unsigned i = 0; i < COUNT; ++i)
+        for (unsigned c = 0; c < 3; ++c)
+        {
+            float value = static_cast<float>((i * 3 + c) % 17) - 8.0f;
+            vpos[i][c] = fpos[i].v[c] = value;
+            vvel[i][c] = fvel[i].v[c] = value * 0.5f;
+        }
+
+    VectorIntegrate vi = { vpos, vvel };
+    Float3Integrate fi = { fpos, fvel };
+    mwbench::report("Vector<float,3> integrate", mwbench::measure(vi), COUNT);
+    mwbench::report("float[3] integrate", mwbench::measure(fi), COUNT);
+
+    for (unsigned i = 0; i < COUNT; ++i)
+        for (unsigned c = 0; c < 3; ++c)
+            BOOST_REQUIRE_EQUAL(vpos[i][c], fpos[i].v[c]);
+
+    float vsum = 0.0f, fsum = 0.0f;
+    VectorDot vd = { vpos, vsum };
+    Float3Dot fd = { fpos, fsum };
+    mwbench::report("Vector<float,3> dot", mwbench::measure(vd), COUNT);
+    mwbench::report("float[3] dot", mwbench::measure(fd), COUNT);
+
+    BOOST_CHECK_EQUAL(vsum, fsum);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,123 @@
+/**
+ * @file   TweenerBench.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <Mw/Bench.hpp>
+#include <Mw/Math/Interpolation.hpp>
+#include <Mw/Tween/Tweener.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+const unsigned TWEENS = 1000000;
+
+// Small enough that no tween finishes during the measures
+const float TICK = 1e-6f;
+
+typedef mw::math::Vector<float, 3> Vec3;
+
+/**
+ * Tween as an object, the way ad-hoc wrappers over linearInterpolate do.
+ */
+struct AdHocTween
+{
+    float * target;
+    float from;
+    float to;
+    float elapsed;
+    float duration;
+    mw::tween::Easing easing;
+    bool finished;
+
+    void update(float dt)
+    {
+        if (finished)
+            return;
+
+        elapsed += dt;
+        if (elapsed >= duration)
+        {
+            elapsed = duration;
+            finished = true;
+        }
+        *target = mw::math::linearInterpolate(from, to, mw::tween::ease(easing, elapsed / duration));
+    }
+};
+
+struct AdHocTick
+{
+    std::vector<AdHocTween> & tweens;
+
+    void operator () () const
+    {
+        for (std::size_t i = 0; i < tweens.size(); ++i)
+            tweens[i].update(TICK);
+        mwbench::consume(*tweens[0].target);
+    }
+};
+
+template<class T>
+struct TweenerTick
+{
+    mw::tween::Tweener<T> & tweener;
+
+    void operator () () const
+    {
+        tweener.tick(TICK);
+        mwbench::consume(tweener);
+    }
+};
+
+mw::tween::Easing randomEasing()
+{
+    return static_cast<mw::tween::Easing>(std::rand() % mw::tween::EASING_COUNT);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Tween)
+BOOST_AUTO_TEST_SUITE(Tweener)
+
+BOOST_AUTO_TEST_CASE(Tick)
+{
+    std::srand(42);
+
+    std::vector<float> values(TWEENS), adHocValues(TWEENS);
+    std::vector<Vec3> vectors(TWEENS);
+
+    std::vector<AdHocTween> adHoc(TWEENS);
+    mw::tween::Tweener<float> tweener;
+    mw::tween::Tweener<Vec3> vectorTweener;
+    for (unsigned i = 0; i < TWEENS; ++i)
+    {
+        const float from = mwbench::random(1.0f), to = mwbench::random(1.0f), duration = 1 + mwbench::random(1.0f);
+        const mw::tween::Easing easing = randomEasing();
+
+        AdHocTween tween = { &adHocValues[i], from, to, 0.0f, duration, easing, false };
+        adHoc[i] = tween;
+        tweener.start(values[i], from, to, duration, easing);
+
+        Vec3 end;
+        end[0] = to;
+        end[1] = from;
+        end[2] = to - from;
+        vectorTweener.start(vectors[i], Vec3(), end, duration, easing);
+    }
+
+    AdHocTick adHocTick = { adHoc };
+    mwbench::report("Ad-hoc tweens float (1M)", mwbench::measure(adHocTick), TWEENS);
+
+    TweenerTick<float> tick = { tweener };
+    mwbench::report("Tweener float (1M)", mwbench::measure(tick), TWEENS);
+
+    TweenerTick<Vec3> vectorTick = { vectorTweener };
+    mwbench::report("Tweener Vector3f (1M)", mwbench::measure(vectorTick), TWEENS);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
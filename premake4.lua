@@ -116,3 +116,25 @@ project "Test"
   includedirs { "src" }
 
   use_Boost ( BOOST_LIBS )
+
+  -- TaskPool uses std::thread
+  configuration "linux"
+    links { "pthread" }
+
+-- ///////////////////////////////////////////////////// --
+
+project "Bench"
+  language "C++"
+  location (MAKE_DIR)
+  kind     "ConsoleApp"
+
+  BOOST_LIBS = { "unit_test_framework", "chrono", "system" }
+
+  files       { "bench/Mw/**.cpp" }
+  includedirs { "src", "bench" }
+
+  use_Boost ( BOOST_LIBS )
+
+  -- TaskPool uses std::thread
+  configuration "linux"
+    links { "pthread" }
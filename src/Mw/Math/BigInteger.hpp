@@ -0,0 +1,1102 @@
+/**
+ * @file   BigInteger.hpp
+ * @author Bastien Brunnenstein
+ *
+ * @details Arbitrary precision integers.
+ *
+ * Values that fit in 64 bits are stored inline and computed with native
+ * operations, larger values spill to a vector of 32 bits limbs. Products of
+ * large values use Karatsuba's algorithm, divisions Knuth's algorithm D and
+ * gcds Lehmer's algorithm.
+ *
+ * Rational<BigInteger>, or BigRational, never overflows.
+ */
+
+#ifndef MW_BIGINTEGER_HPP
+#define MW_BIGINTEGER_HPP
+
+#include <Mw/Config.hpp>
+
+#include <Mw/Math/Bits.hpp>
+#include <Mw/Math/Overflow.hpp>
+#include <Mw/Math/Rational.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+#include <boost/operators.hpp>
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/vector.hpp>
+
+MW_BEGIN_NAMESPACE(math)
+
+namespace detail
+{
+
+/**
+ * Operations on magnitudes.
+ *
+ * Magnitudes are little endian vectors of limbs, without leading zero
+ * limbs. Zero is the empty vector.
+ */
+struct BigMagnitude
+{
+    typedef boost::uint32_t Limb;
+    typedef boost::uint64_t DoubleLimb;
+    typedef std::vector<Limb> Limbs;
+
+    static const unsigned LIMB_BITS = 32;
+
+    /**
+     * Limbs of the smaller operand from which Karatsuba's algorithm is used.
+     */
+    static const std::size_t KARATSUBA_THRESHOLD = 32;
+
+    static void trim(Limbs & a)
+    {
+        while (!a.empty() && !a.back())
+            a.pop_back();
+    }
+
+    static void fromUint64(boost::uint64_t value, Limbs & out)
+    {
+        out.clear();
+        if (value)
+            out.push_back(static_cast<Limb>(value));
+        if (value >> LIMB_BITS)
+            out.push_back(static_cast<Limb>(value >> LIMB_BITS));
+    }
+
+    /**
+     * Value of a magnitude of at most 2 limbs.
+     */
+    static boost::uint64_t toUint64(const Limbs & a)
+    {
+        boost::uint64_t value = 0;
+        for (std::size_t i = a.size(); i--; )
+            value = (value << LIMB_BITS) | a[i];
+        return value;
+    }
+
+    static unsigned countLeadingZeros(Limb limb)
+    {
+        return math::countLeadingZeros(static_cast<boost::uint64_t>(limb)) - LIMB_BITS;
+    }
+
+    static std::size_t getBitLength(const Limbs & a)
+    {
+        if (a.empty())
+            return 0;
+        return a.size() * LIMB_BITS - countLeadingZeros(a.back());
+    }
+
+    static int compare(const Limbs & a, const Limbs & b)
+    {
+        if (a.size() != b.size())
+            return a.size() < b.size() ? -1 : 1;
+        for (std::size_t i = a.size(); i--; )
+            if (a[i] != b[i])
+                return a[i] < b[i] ? -1 : 1;
+        return 0;
+    }
+
+    /**
+     * <tt>r = a + b</tt> with <tt>na >= nb</tt>, @c r has @c na limbs.
+     *
+     * @return Carry.
+     */
+    static Limb addRaw(Limb * r, const Limb * a, std::size_t na, const Limb * b, std::size_t nb)
+    {
+        DoubleLimb carry = 0;
+        for (std::size_t i = 0; i < nb; ++i)
+        {
+            carry += static_cast<DoubleLimb>(a[i]) + b[i];
+            r[i] = static_cast<Limb>(carry);
+            carry >>= LIMB_BITS;
+        }
+        for (std::size_t i = nb; i < na; ++i)
+        {
+            carry += a[i];
+            r[i] = static_cast<Limb>(carry);
+            carry >>= LIMB_BITS;
+        }
+        return static_cast<Limb>(carry);
+    }
+
+    /**
+     * <tt>r = a - b</tt> with <tt>na >= nb</tt>, @c r has @c na limbs.
+     *
+     * @return Borrow.
+     */
+    static Limb subtractRaw(Limb * r, const Limb * a, std::size_t na, const Limb * b, std::size_t nb)
+    {
+        Limb borrow = 0;
+        for (std::size_t i = 0; i < na; ++i)
+        {
+            const DoubleLimb d = static_cast<DoubleLimb>(a[i]) - (i < nb ? b[i] : 0) - borrow;
+            r[i] = static_cast<Limb>(d);
+            borrow = static_cast<Limb>(d >> 63);
+        }
+        return borrow;
+    }
+
+    static void add(const Limbs & a, const Limbs & b, Limbs & out)
+    {
+        const Limbs & longer = a.size() >= b.size() ? a : b;
+        const Limbs & shorter = a.size() >= b.size() ? b : a;
+
+        Limbs r(longer.size() + 1);
+        r[longer.size()] = addRaw(&r[0], longer.empty() ? NULL : &longer[0], longer.size(),
+                                  shorter.empty() ? NULL : &shorter[0], shorter.size());
+        trim(r);
+        out.swap(r);
+    }
+
+    /**
+     * <tt>out = a - b</tt> with <tt>a >= b</tt>.
+     */
+    static void subtract(const Limbs & a, const Limbs & b, Limbs & out)
+    {
+        Limbs r(a.size());
+        if (!a.empty())
+            subtractRaw(&r[0], &a[0], a.size(), b.empty() ? NULL : &b[0], b.size());
+        trim(r);
+        out.swap(r);
+    }
+
+    static void multiplySmall(const Limbs & a, Limb m, Limbs & out)
+    {
+        Limbs r(a.size() + 1);
+        DoubleLimb carry = 0;
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            carry += static_cast<DoubleLimb>(a[i]) * m;
+            r[i] = static_cast<Limb>(carry);
+            carry >>= LIMB_BITS;
+        }
+        r[a.size()] = static_cast<Limb>(carry);
+        trim(r);
+        out.swap(r);
+    }
+
+    /**
+     * Schoolbook product, @c r has <tt>na + nb</tt> limbs.
+     */
+    static void multiplySchool(const Limb * a, std::size_t na, const Limb * b, std::size_t nb, Limb * r)
+    {
+        std::fill(r, r + na + nb, static_cast<Limb>(0));
+        for (std::size_t i = 0; i < na; ++i)
+        {
+            const DoubleLimb ai = a[i];
+            if (!ai)
+                continue;
+
+            DoubleLimb carry = 0;
+            for (std::size_t j = 0; j < nb; ++j)
+            {
+                carry += ai * b[j] + r[i + j];
+                r[i + j] = static_cast<Limb>(carry);
+                carry >>= LIMB_BITS;
+            }
+            r[i + nb] = static_cast<Limb>(carry);
+        }
+    }
+
+    /**
+     * Scratch limbs of multiplyKaratsuba().
+     */
+    static std::size_t getKaratsubaScratch(std::size_t n)
+    {
+        std::size_t size = 0;
+        while (n >= KARATSUBA_THRESHOLD)
+        {
+            const std::size_t high = n - n / 2;
+            size += 4 * (high + 1);
+            n = high + 1;
+        }
+        return size;
+    }
+
+    /**
+     * Karatsuba product of two values of @c n limbs, @c r has <tt>2 n</tt>
+     * limbs.
+     */
+    static void multiplyKaratsuba(const Limb * a, const Limb * b, std::size_t n, Limb * r, Limb * scratch)
+    {
+        if (n < KARATSUBA_THRESHOLD)
+        {
+            multiplySchool(a, n, b, n, r);
+            return;
+        }
+
+        // a = a1 B + a0, b = b1 B + b0
+        // a b = z2 B^2 + z1 B + z0, with z1 = (a0 + a1) (b0 + b1) - z0 - z2
+        const std::size_t low = n / 2, high = n - low;
+        multiplyKaratsuba(a, b, low, r, scratch);
+        multiplyKaratsuba(a + low, b + low, high, r + 2 * low, scratch);
+
+        Limb * sa = scratch;
+        Limb * sb = sa + high + 1;
+        Limb * z1 = sb + high + 1;
+        sa[high] = addRaw(sa, a + low, high, a, low);
+        sb[high] = addRaw(sb, b + low, high, b, low);
+        multiplyKaratsuba(sa, sb, high + 1, z1, z1 + 2 * (high + 1));
+
+        subtractRaw(z1, z1, 2 * (high + 1), r, 2 * low);
+        subtractRaw(z1, z1, 2 * (high + 1), r + 2 * low, 2 * high);
+        addRaw(r + low, r + low, 2 * n - low, z1, 2 * (high + 1));
+    }
+
+    static void multiply(const Limbs & a, const Limbs & b, Limbs & out)
+    {
+        const Limbs & longer = a.size() >= b.size() ? a : b;
+        const Limbs & shorter = a.size() >= b.size() ? b : a;
+        const std::size_t nl = longer.size(), ns = shorter.size();
+
+        if (ns == 0)
+        {
+            out.clear();
+            return;
+        }
+
+        Limbs r(nl + ns);
+        if (ns < KARATSUBA_THRESHOLD)
+            multiplySchool(&longer[0], nl, &shorter[0], ns, &r[0]);
+        else
+        {
+            // Products of slices of the longer operand, of the size of the
+            // shorter one
+            Limbs scratch(getKaratsubaScratch(ns)), product(2 * ns), slice;
+            for (std::size_t offset = 0; offset < nl; offset += ns)
+            {
+                const std::size_t count = std::min(ns, nl - offset);
+                if (count == ns)
+                    multiplyKaratsuba(&longer[offset], &shorter[0], ns, &product[0], &scratch[0]);
+                else
+                {
+                    slice.assign(longer.begin() + offset, longer.end());
+                    multiply(shorter, slice, product);
+                    product.resize(2 * ns);
+                }
+                addRaw(&r[offset], &r[offset], nl + ns - offset, &product[0], count + ns);
+            }
+        }
+        trim(r);
+        out.swap(r);
+    }
+
+    /**
+     * Division by a limb.
+     *
+     * @return Remainder.
+     */
+    static Limb divideSmall(const Limbs & a, Limb d, Limbs & quotient)
+    {
+        Limbs q(a.size());
+        DoubleLimb remainder = 0;
+        for (std::size_t i = a.size(); i--; )
+        {
+            const DoubleLimb current = (remainder << LIMB_BITS) | a[i];
+            q[i] = static_cast<Limb>(current / d);
+            remainder = current % d;
+        }
+        trim(q);
+        quotient.swap(q);
+        return static_cast<Limb>(remainder);
+    }
+
+    /**
+     * Division with remainder, Knuth's algorithm D.
+     *
+     * @param a Dividend.
+     * @param b Divisor, not zero.
+     */
+    static void divide(const Limbs & a, const Limbs & b, Limbs & quotient, Limbs & remainder)
+    {
+        if (compare(a, b) < 0)
+        {
+            remainder = a;
+            quotient.clear();
+            return;
+        }
+
+        if (b.size() == 1)
+        {
+            const Limb r = divideSmall(a, b[0], quotient);
+            fromUint64(r, remainder);
+            return;
+        }
+
+        const std::size_t m = a.size(), n = b.size();
+        const unsigned s = countLeadingZeros(b.back());
+
+        // Normalized so that the top limb of the divisor has its high bit set
+        Limbs u(m + 1), v(n);
+        for (std::size_t i = n; i--; )
+            v[i] = static_cast<Limb>((static_cast<DoubleLimb>(b[i]) << s)
+                                   | (i ? static_cast<DoubleLimb>(b[i - 1]) >> (LIMB_BITS - s) : 0));
+        u[m] = static_cast<Limb>(static_cast<DoubleLimb>(a[m - 1]) >> (LIMB_BITS - s));
+        for (std::size_t i = m; i--; )
+            u[i] = static_cast<Limb>((static_cast<DoubleLimb>(a[i]) << s)
+                                   | (i ? static_cast<DoubleLimb>(a[i - 1]) >> (LIMB_BITS - s) : 0));
+
+        Limbs q(m - n + 1);
+        const DoubleLimb base = static_cast<DoubleLimb>(1) << LIMB_BITS;
+        for (std::size_t j = m - n + 1; j--; )
+        {
+            // Estimate the quotient limb from the top limbs, at most 2 too big
+            const DoubleLimb top = (static_cast<DoubleLimb>(u[j + n]) << LIMB_BITS) | u[j + n - 1];
+            DoubleLimb qhat = top / v[n - 1];
+            DoubleLimb rhat = top % v[n - 1];
+            while (qhat >= base || qhat * v[n - 2] > ((rhat << LIMB_BITS) | u[j + n - 2]))
+            {
+                --qhat;
+                rhat += v[n - 1];
+                if (rhat >= base)
+                    break;
+            }
+
+            // Multiply and subtract
+            boost::int64_t borrow = 0, t;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                const DoubleLimb p = qhat * v[i];
+                t = static_cast<boost::int64_t>(u[i + j]) - borrow - static_cast<boost::int64_t>(p & 0xFFFFFFFFu);
+                u[i + j] = static_cast<Limb>(t);
+                borrow = static_cast<boost::int64_t>(p >> LIMB_BITS) - (t >> LIMB_BITS);
+            }
+            t = static_cast<boost::int64_t>(u[j + n]) - borrow;
+            u[j + n] = static_cast<Limb>(t);
+
+            // Add back if the estimate was one too big
+            q[j] = static_cast<Limb>(qhat);
+            if (t < 0)
+            {
+                --q[j];
+                DoubleLimb carry = 0;
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    carry += static_cast<DoubleLimb>(u[i + j]) + v[i];
+                    u[i + j] = static_cast<Limb>(carry);
+                    carry >>= LIMB_BITS;
+                }
+                u[j + n] = static_cast<Limb>(u[j + n] + carry);
+            }
+        }
+
+        Limbs r(n);
+        for (std::size_t i = 0; i < n; ++i)
+            r[i] = static_cast<Limb>((static_cast<DoubleLimb>(u[i]) >> s)
+                                   | (static_cast<DoubleLimb>(u[i + 1]) << (LIMB_BITS - s)));
+
+        trim(q);
+        trim(r);
+        quotient.swap(q);
+        remainder.swap(r);
+    }
+
+    /**
+     * Limb of the bits <tt>[position, position + 32)</tt>.
+     */
+    static Limb getBits(const Limbs & a, std::size_t position)
+    {
+        const std::size_t i = position / LIMB_BITS;
+        const unsigned s = position % LIMB_BITS;
+        if (i >= a.size())
+            return 0;
+
+        DoubleLimb value = a[i];
+        if (i + 1 < a.size())
+            value |= static_cast<DoubleLimb>(a[i + 1]) << LIMB_BITS;
+        return static_cast<Limb>(value >> s);
+    }
+
+    /**
+     * <tt>out = p x + q y</tt>, with cofactors of opposite signs and a
+     * positive result.
+     */
+    static void combine(const Limbs & x, const Limbs & y, boost::int64_t p, boost::int64_t q, Limbs & out)
+    {
+        Limbs first, second;
+        if (q <= 0)
+        {
+            multiplySmall(x, static_cast<Limb>(p), first);
+            multiplySmall(y, static_cast<Limb>(- q), second);
+        }
+        else
+        {
+            multiplySmall(y, static_cast<Limb>(q), first);
+            multiplySmall(x, static_cast<Limb>(- p), second);
+        }
+        subtract(first, second, out);
+    }
+
+    /**
+     * Greatest common divisor, Lehmer's algorithm.
+     *
+     * Euclid's steps are run on the leading limbs of the values while they
+     * give the same quotients as the full values would, then applied to the
+     * full values at once.
+     */
+    static void gcd(Limbs x, Limbs y, Limbs & out)
+    {
+        if (compare(x, y) < 0)
+            x.swap(y);
+
+        Limbs a, b;
+        while (y.size() > 2)
+        {
+            const std::size_t position = getBitLength(x) - LIMB_BITS;
+            boost::int64_t xh = getBits(x, position), yh = getBits(y, position);
+
+            // Knuth's algorithm L
+            boost::int64_t p = 1, q = 0, r = 0, s = 1;
+            while (yh + r != 0 && yh + s != 0)
+            {
+                const boost::int64_t quotient = (xh + p) / (yh + r);
+                if (quotient != (xh + q) / (yh + s))
+                    break;
+
+                boost::int64_t t = p - quotient * r;
+                p = r;
+                r = t;
+                t = q - quotient * s;
+                q = s;
+                s = t;
+                t = xh - quotient * yh;
+                xh = yh;
+                yh = t;
+            }
+
+            if (q == 0)
+            {
+                // No step from the leading limbs, one full step
+                divide(x, y, a, b);
+                x.swap(y);
+                y.swap(b);
+            }
+            else
+            {
+                combine(x, y, p, q, a);
+                combine(x, y, r, s, b);
+                x.swap(a);
+                y.swap(b);
+            }
+        }
+
+        if (y.empty())
+        {
+            out.swap(x);
+            return;
+        }
+        if (x.size() > 2)
+        {
+            divide(x, y, a, b);
+            x.swap(y);
+            y.swap(b);
+        }
+        fromUint64(binaryGcd(toUint64(x), toUint64(y)), out);
+    }
+};
+
+} // namespace detail
+
+
+/**
+ * Arbitrary precision integer.
+ *
+ * Values that fit in a 64 bits integer are stored inline, without heap
+ * memory, and computed with native operations. Operations spill to limbs
+ * only when their result does not fit.
+ *
+ * Divisions are truncated toward zero, like the native integers.
+ */
+class BigInteger : boost::arithmetic<BigInteger>,
+                   boost::modable<BigInteger>,
+                   boost::totally_ordered<BigInteger>
+{
+    typedef detail::BigMagnitude Magnitude;
+    typedef Magnitude::Limb Limb;
+    typedef Magnitude::Limbs Limbs;
+
+    /**
+     * Value, when it fits.
+     */
+    boost::int64_t _small;
+
+    /**
+     * Sign of the value, when it does not fit.
+     */
+    bool _negative;
+
+    /**
+     * Magnitude of the value, empty when it fits.
+     */
+    Limbs _limbs;
+
+    bool isNegative() const
+    {
+        return _limbs.empty() ? _small < 0 : _negative;
+    }
+
+    void getMagnitude(Limbs & out) const
+    {
+        if (!_limbs.empty())
+            out = _limbs;
+        else
+            Magnitude::fromUint64(_small < 0 ? static_cast<boost::uint64_t>(0) - static_cast<boost::uint64_t>(_small)
+                                             : static_cast<boost::uint64_t>(_small), out);
+    }
+
+    /**
+     * Set the value, stored inline if it fits.
+     */
+    void assign(bool negative, Limbs & magnitude)
+    {
+        Magnitude::trim(magnitude);
+
+        if (magnitude.size() <= 2)
+        {
+            const boost::uint64_t value = Magnitude::toUint64(magnitude);
+            const boost::uint64_t max = static_cast<boost::uint64_t>(std::numeric_limits<boost::int64_t>::max());
+            if (value <= max || (negative && value == max + 1))
+            {
+                _small = static_cast<boost::int64_t>(negative ? static_cast<boost::uint64_t>(0) - value : value);
+                _negative = false;
+                _limbs.clear();
+                return;
+            }
+        }
+
+        _small = 0;
+        _negative = negative;
+        _limbs.swap(magnitude);
+    }
+
+    void add(const BigInteger & value, bool subtract)
+    {
+        const bool na = isNegative(), nb = value.isNegative() != subtract;
+
+        Limbs a, b, r;
+        getMagnitude(a);
+        value.getMagnitude(b);
+
+        bool negative = na;
+        if (na == nb)
+            Magnitude::add(a, b, r);
+        else if (Magnitude::compare(a, b) >= 0)
+            Magnitude::subtract(a, b, r);
+        else
+        {
+            Magnitude::subtract(b, a, r);
+            negative = nb;
+        }
+        assign(negative, r);
+    }
+
+public:
+
+    // Constructors
+
+    /**
+     * Constructor.
+     *
+     * @param value Initial value.
+     */
+    BigInteger(boost::int64_t value = 0)
+        : _small(value), _negative(false)
+    {}
+
+    /**
+     * Parse a decimal number.
+     *
+     * @param decimal Digits, with an optional leading sign.
+     * @return Value.
+     * @throw std::invalid_argument The string is not a decimal number.
+     */
+    static BigInteger fromString(const std::string & decimal)
+    {
+        std::size_t i = 0;
+        if (!decimal.empty() && (decimal[0] == '-' || decimal[0] == '+'))
+            i = 1;
+        if (i == decimal.size())
+            throw std::invalid_argument("Mw.Math.BigInteger: Invalid number");
+
+        Limbs magnitude, chunk;
+        for (; i < decimal.size(); )
+        {
+            // 9 digits at once
+            Limb value = 0, scale = 1;
+            for (unsigned d = 0; d < 9 && i < decimal.size(); ++d, ++i)
+            {
+                if (decimal[i] < '0' || decimal[i] > '9')
+                    throw std::invalid_argument("Mw.Math.BigInteger: Invalid number");
+                value = value * 10 + static_cast<Limb>(decimal[i] - '0');
+                scale *= 10;
+            }
+
+            Magnitude::multiplySmall(magnitude, scale, magnitude);
+            Magnitude::fromUint64(value, chunk);
+            Magnitude::add(magnitude, chunk, magnitude);
+        }
+
+        BigInteger result;
+        result.assign(decimal[0] == '-', magnitude);
+        return result;
+    }
+
+
+    // Getters
+
+    /**
+     * Check if the value is stored inline.
+     *
+     * @return @c true if the value fits in a 64 bits integer.
+     */
+    bool isInline() const
+    {
+        return _limbs.empty();
+    }
+
+    /**
+     * Get the value as a 64 bits integer.
+     *
+     * @return Value.
+     * @throw std::overflow_error The value does not fit.
+     */
+    boost::int64_t toInt64() const
+    {
+        if (!_limbs.empty())
+            throw std::overflow_error("Mw.Math.BigInteger: Value does not fit in 64 bits");
+        return _small;
+    }
+
+    /**
+     * Get the value as a double.
+     *
+     * @return Nearest double.
+     */
+    double toDouble() const
+    {
+        int exponent;
+        const double mantissa = frexp(*this, &exponent);
+        return std::ldexp(mantissa, exponent);
+    }
+
+    /**
+     * Split the value in a mantissa and a power of two, as std::frexp.
+     *
+     * @param value Value.
+     * @param exponent Power of two.
+     * @return Mantissa, in <tt>[0.5, 1)</tt> in magnitude, or 0.
+     */
+    friend double frexp(const BigInteger & value, int * exponent)
+    {
+        if (value._limbs.empty())
+            return std::frexp(static_cast<double>(value._small), exponent);
+
+        // Leading 64 bits, with a sticky bit for the lower ones so that the
+        // conversion rounds once
+        const Limbs & limbs = value._limbs;
+        const std::size_t shift = Magnitude::getBitLength(limbs) - 64;
+        boost::uint64_t top = Magnitude::getBits(limbs, shift)
+                            | static_cast<boost::uint64_t>(Magnitude::getBits(limbs, shift + 32)) << 32;
+
+        const std::size_t low = shift / Magnitude::LIMB_BITS;
+        bool sticky = (limbs[low] & ((static_cast<Limb>(1) << (shift % Magnitude::LIMB_BITS)) - 1)) != 0;
+        for (std::size_t i = 0; !sticky && i < low; ++i)
+            sticky = limbs[i] != 0;
+        top |= sticky ? 1 : 0;
+
+        const double magnitude = static_cast<double>(top);
+        const double mantissa = std::frexp(value._negative ? - magnitude : magnitude, exponent);
+        *exponent += static_cast<int>(shift);
+        return mantissa;
+    }
+
+    /**
+     * Get the decimal representation.
+     *
+     * @return Digits, with a leading '-' for negative values.
+     */
+    std::string toString() const
+    {
+        Limbs magnitude;
+        getMagnitude(magnitude);
+        if (magnitude.empty())
+            return "0";
+
+        // Chunks of 9 digits, least significant first
+        std::vector<Limb> chunks;
+        while (!magnitude.empty())
+            chunks.push_back(Magnitude::divideSmall(magnitude, 1000000000u, magnitude));
+
+        std::string digits = isNegative() ? "-" : "";
+        for (std::size_t i = chunks.size(); i--; )
+        {
+            char buffer[10];
+            Limb chunk = chunks[i];
+            int count = 0;
+            do
+            {
+                buffer[count++] = static_cast<char>('0' + chunk % 10);
+                chunk /= 10;
+            }
+            while (chunk);
+
+            // Inner chunks have all their leading zeros
+            if (i + 1 != chunks.size())
+                while (count < 9)
+                    buffer[count++] = '0';
+
+            while (count)
+                digits += buffer[--count];
+        }
+        return digits;
+    }
+
+
+    // Operators
+
+    BigInteger operator - () const
+    {
+        if (_limbs.empty() && _small != std::numeric_limits<boost::int64_t>::min())
+            return BigInteger(- _small);
+
+        // -2^63 and 2^63 are not stored the same way
+        Limbs magnitude;
+        getMagnitude(magnitude);
+        BigInteger result;
+        result.assign(!isNegative(), magnitude);
+        return result;
+    }
+
+    BigInteger & operator += (const BigInteger & value)
+    {
+        boost::int64_t sum;
+        if (_limbs.empty() && value._limbs.empty() && detail::checkedAdd(_small, value._small, sum))
+        {
+            _small = sum;
+            return *this;
+        }
+
+        add(value, false);
+        return *this;
+    }
+
+    BigInteger & operator -= (const BigInteger & value)
+    {
+        boost::int64_t difference;
+        if (_limbs.empty() && value._limbs.empty() && detail::checkedSubtract(_small, value._small, difference))
+        {
+            _small = difference;
+            return *this;
+        }
+
+        add(value, true);
+        return *this;
+    }
+
+    BigInteger & operator *= (const BigInteger & value)
+    {
+        boost::int64_t product;
+        if (_limbs.empty() && value._limbs.empty() && detail::checkedMultiply(_small, value._small, product))
+        {
+            _small = product;
+            return *this;
+        }
+
+        Limbs a, b, r;
+        getMagnitude(a);
+        value.getMagnitude(b);
+        Magnitude::multiply(a, b, r);
+        assign(isNegative() != value.isNegative(), r);
+        return *this;
+    }
+
+    /**
+     * @throw std::domain_error Division by zero
+     */
+    BigInteger & operator /= (const BigInteger & value)
+    {
+        divide(*this, value, this, NULL);
+        return *this;
+    }
+
+    /**
+     * @throw std::domain_error Division by zero
+     */
+    BigInteger & operator %= (const BigInteger & value)
+    {
+        divide(*this, value, NULL, this);
+        return *this;
+    }
+
+    bool operator == (const BigInteger & value) const
+    {
+        if (_limbs.empty() || value._limbs.empty())
+            return _limbs.empty() && value._limbs.empty() && _small == value._small;
+        return _negative == value._negative && _limbs == value._limbs;
+    }
+
+    bool operator < (const BigInteger & value) const
+    {
+        if (_limbs.empty() && value._limbs.empty())
+            return _small < value._small;
+
+        const bool negative = isNegative();
+        if (negative != value.isNegative())
+            return negative;
+
+        // Values stored inline have smaller magnitudes
+        int order;
+        if (_limbs.empty())
+            order = -1;
+        else if (value._limbs.empty())
+            order = 1;
+        else
+            order = Magnitude::compare(_limbs, value._limbs);
+        return negative ? order > 0 : order < 0;
+    }
+
+
+    // Computations
+
+    /**
+     * Division with remainder.
+     *
+     * @param dividend Dividend.
+     * @param divisor Divisor.
+     * @param quotient Quotient, truncated toward zero, or NULL.
+     * @param remainder Remainder, of the sign of the dividend, or NULL.
+     * @throw std::domain_error Division by zero
+     */
+    static void divide(const BigInteger & dividend, const BigInteger & divisor,
+                       BigInteger * quotient, BigInteger * remainder)
+    {
+        if (divisor._limbs.empty() && divisor._small == 0)
+            throw std::domain_error("Mw.Math.BigInteger: Division by zero");
+
+        if (dividend._limbs.empty() && divisor._limbs.empty()
+            && !(dividend._small == std::numeric_limits<boost::int64_t>::min() && divisor._small == -1))
+        {
+            const boost::int64_t q = dividend._small / divisor._small, r = dividend._small % divisor._small;
+            if (quotient)
+                *quotient = BigInteger(q);
+            if (remainder)
+                *remainder = BigInteger(r);
+            return;
+        }
+
+        const bool na = dividend.isNegative(), nb = divisor.isNegative();
+        Limbs a, b, q, r;
+        dividend.getMagnitude(a);
+        divisor.getMagnitude(b);
+        Magnitude::divide(a, b, q, r);
+
+        if (quotient)
+            quotient->assign(na != nb, q);
+        if (remainder)
+            remainder->assign(na, r);
+    }
+
+    /**
+     * Compute the greatest common divisor.
+     *
+     * @param a First number.
+     * @param b Second number.
+     * @return Positive greatest common divisor, 0 if both numbers are 0.
+     */
+    static BigInteger gcd(const BigInteger & a, const BigInteger & b)
+    {
+        Limbs r;
+        if (a._limbs.empty() && b._limbs.empty())
+        {
+            const boost::uint64_t x = a._small < 0 ? static_cast<boost::uint64_t>(0) - static_cast<boost::uint64_t>(a._small)
+                                                   : static_cast<boost::uint64_t>(a._small);
+            const boost::uint64_t y = b._small < 0 ? static_cast<boost::uint64_t>(0) - static_cast<boost::uint64_t>(b._small)
+                                                   : static_cast<boost::uint64_t>(b._small);
+            const boost::uint64_t g = binaryGcd(x, y);
+            if (g <= static_cast<boost::uint64_t>(std::numeric_limits<boost::int64_t>::max()))
+                return BigInteger(static_cast<boost::int64_t>(g));
+            Magnitude::fromUint64(g, r);
+        }
+        else
+        {
+            Limbs x, y;
+            a.getMagnitude(x);
+            b.getMagnitude(y);
+            Magnitude::gcd(x, y, r);
+        }
+
+        BigInteger result;
+        result.assign(false, r);
+        return result;
+    }
+
+
+private:
+    // Serialization
+    friend class boost::serialization::access;
+    template<class Archive>
+    void serialize(Archive & ar, const unsigned int version)
+    {
+        using namespace boost::serialization;
+
+        ar & make_nvp("small", _small);
+        ar & make_nvp("negative", _negative);
+        ar & make_nvp("limbs", _limbs);
+    }
+
+};
+// class BigInteger
+
+
+/**
+ * Rational number of arbitrary precision.
+ */
+typedef Rational<BigInteger> BigRational;
+
+
+namespace detail
+{
+
+/**
+ * Operations on fractions of big integers.
+ *
+ * Fractions of inline values use the 64 bits operations first, the
+ * operations on big integers only when the result does not fit.
+ */
+template<>
+struct RationalArithmetic<BigInteger, false>
+{
+    typedef RationalArithmetic<boost::int64_t> Small;
+
+    static bool isInline(const BigInteger & a, const BigInteger & b)
+    {
+        return a.isInline() && b.isInline();
+    }
+
+    template<typename S>
+    static S toScalar(const BigInteger & numerator, const BigInteger & denominator)
+    {
+        int en, ed;
+        const double mn = frexp(numerator, &en), md = frexp(denominator, &ed);
+        return static_cast<S>(std::ldexp(mn / md, en - ed));
+    }
+
+    static bool reduce(BigInteger & numerator, BigInteger & denominator)
+    {
+        if (isInline(numerator, denominator))
+        {
+            boost::int64_t n = numerator.toInt64(), d = denominator.toInt64();
+            if (Small::reduce(n, d))
+            {
+                numerator = n;
+                denominator = d;
+                return true;
+            }
+        }
+
+        if (denominator < BigInteger())
+        {
+            numerator = - numerator;
+            denominator = - denominator;
+        }
+
+        const BigInteger g = BigInteger::gcd(numerator, denominator);
+        if (g != BigInteger(1))
+        {
+            numerator /= g;
+            denominator /= g;
+        }
+        return true;
+    }
+
+    static bool add(const BigInteger & n1, const BigInteger & d1, const BigInteger & n2, const BigInteger & d2,
+                    bool subtract, BigInteger & numerator, BigInteger & denominator)
+    {
+        if (isInline(n1, d1) && isInline(n2, d2))
+        {
+            boost::int64_t n, d;
+            if (Small::add(n1.toInt64(), d1.toInt64(), n2.toInt64(), d2.toInt64(), subtract, n, d))
+            {
+                numerator = n;
+                denominator = d;
+                return true;
+            }
+        }
+
+        const BigInteger g1 = BigInteger::gcd(d1, d2);
+        const BigInteger a = d1 / g1, b = d2 / g1;
+        const BigInteger t = subtract ? n1 * b - a * n2 : n1 * b + a * n2;
+        const BigInteger g2 = BigInteger::gcd(t, g1);
+
+        // The results may be the operands
+        const BigInteger d = a * (d2 / g2);
+        numerator = t / g2;
+        denominator = d;
+        return true;
+    }
+
+    static bool multiply(const BigInteger & n1, const BigInteger & d1, const BigInteger & n2, const BigInteger & d2,
+                         BigInteger & numerator, BigInteger & denominator)
+    {
+        if (isInline(n1, d1) && isInline(n2, d2))
+        {
+            boost::int64_t n, d;
+            if (Small::multiply(n1.toInt64(), d1.toInt64(), n2.toInt64(), d2.toInt64(), n, d))
+            {
+                numerator = n;
+                denominator = d;
+                return true;
+            }
+        }
+
+        const BigInteger g1 = BigInteger::gcd(n1, d2);
+        const BigInteger g2 = BigInteger::gcd(d1, n2);
+        BigInteger n = (n1 / g1) * (n2 / g2);
+        BigInteger d = (d1 / g2) * (d2 / g1);
+        if (d < BigInteger())
+        {
+            n = - n;
+            d = - d;
+        }
+        numerator = n;
+        denominator = d;
+        return true;
+    }
+
+    static bool less(const BigInteger & n1, const BigInteger & d1, const BigInteger & n2, const BigInteger & d2)
+    {
+        if (isInline(n1, d1) && isInline(n2, d2))
+            return Small::less(n1.toInt64(), d1.toInt64(), n2.toInt64(), d2.toInt64());
+        return n1 * d2 < n2 * d1;
+    }
+};
+
+} // namespace detail
+
+
+/**
+ * Stream insertion operator overload.
+ *
+ * @param ostr Output stream.
+ * @param value BigInteger to insert into the stream.
+ * @return @c ostr Output stream.
+ */
+inline std::ostream & operator << (std::ostream & ostr, const BigInteger & value)
+{
+    return ostr << value.toString();
+}
+
+MW_END_NAMESPACE(math)
+
+#endif // MW_BIGINTEGER_HPP
@@ -0,0 +1,227 @@
+/**
+ * @file   Bits.hpp
+ * @author Bastien Brunnenstein
+ *
+ * @details Bit manipulation helpers.
+ */
+
+#ifndef MW_BITS_HPP
+#define MW_BITS_HPP
+
+#include <Mw/Config.hpp>
+
+#include <boost/assert.hpp>
+#include <boost/cstdint.hpp>
+
+#ifdef _MSC_VER
+#   include <intrin.h>
+#endif
+
+/**
+ * @def MW_HAS_INT128
+ * Defined when the compiler provides 128 bits integers.
+ */
+#if defined __SIZEOF_INT128__ && !defined MW_HAS_INT128
+#   define MW_HAS_INT128
+#endif
+
+MW_BEGIN_NAMESPACE(math)
+
+#ifdef MW_HAS_INT128
+__extension__ typedef __int128 int128_t;
+__extension__ typedef unsigned __int128 uint128_t;
+#endif
+
+/**
+ * Count the trailing zero bits of a word.
+ *
+ * @param word Word, must not be 0.
+ * @return Index of the lowest set bit.
+ */
+inline unsigned countTrailingZeros(boost::uint32_t word)
+{
+    BOOST_ASSERT(word);
+
+#if defined __GNUC__
+    return static_cast<unsigned>(__builtin_ctz(word));
+#elif defined _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, word);
+    return static_cast<unsigned>(index);
+#else
+    unsigned n = 0;
+    while (!(word & 1u))
+    {
+        word >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+/**
+ * Count the trailing zero bits of a word.
+ *
+ * @param word Word, must not be 0.
+ * @return Index of the lowest set bit.
+ */
+inline unsigned countTrailingZeros(boost::uint64_t word)
+{
+    BOOST_ASSERT(word);
+
+#if defined __GNUC__
+    return static_cast<unsigned>(__builtin_ctzll(word));
+#elif defined _MSC_VER && defined _M_X64
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<unsigned>(index);
+#else
+    boost::uint32_t low = static_cast<boost::uint32_t>(word);
+    if (low)
+        return countTrailingZeros(low);
+    return 32 + countTrailingZeros(static_cast<boost::uint32_t>(word >> 32));
+#endif
+}
+
+#ifdef MW_HAS_INT128
+
+/**
+ * Count the trailing zero bits of a word.
+ *
+ * @param word Word, must not be 0.
+ * @return Index of the lowest set bit.
+ */
+inline unsigned countTrailingZeros(uint128_t word)
+{
+    BOOST_ASSERT(word);
+
+    const boost::uint64_t low = static_cast<boost::uint64_t>(word);
+    if (low)
+        return countTrailingZeros(low);
+    return 64 + countTrailingZeros(static_cast<boost::uint64_t>(word >> 64));
+}
+
+#endif // MW_HAS_INT128
+
+/**
+ * Count the leading zero bits of a word.
+ *
+ * @param word Word, must not be 0.
+ * @return 63 minus the index of the highest set bit.
+ */
+inline unsigned countLeadingZeros(boost::uint64_t word)
+{
+    BOOST_ASSERT(word);
+
+#if defined __GNUC__
+    return static_cast<unsigned>(__builtin_clzll(word));
+#elif defined _MSC_VER && defined _M_X64
+    unsigned long index;
+    _BitScanReverse64(&index, word);
+    return 63 - static_cast<unsigned>(index);
+#else
+    unsigned n = 0;
+    while (!(word & (static_cast<boost::uint64_t>(1) << 63)))
+    {
+        word <<= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+/**
+ * Compute the full product of two 64 bits words.
+ *
+ * @param a First word.
+ * @param b Second word.
+ * @param high High 64 bits of the product.
+ * @return Low 64 bits of the product.
+ */
+inline boost::uint64_t multiplyWide(boost::uint64_t a, boost::uint64_t b, boost::uint64_t & high)
+{
+#if defined MW_HAS_INT128
+    const uint128_t product = static_cast<uint128_t>(a) * b;
+    high = static_cast<boost::uint64_t>(product >> 64);
+    return static_cast<boost::uint64_t>(product);
+#elif defined _MSC_VER && defined _M_X64
+    return _umul128(a, b, &high);
+#else
+    const boost::uint64_t mask = 0xFFFFFFFFu;
+    const boost::uint64_t p0 = (a & mask) * (b & mask), p1 = (a & mask) * (b >> 32);
+    const boost::uint64_t p2 = (a >> 32) * (b & mask), p3 = (a >> 32) * (b >> 32);
+
+    const boost::uint64_t middle = (p0 >> 32) + (p1 & mask) + (p2 & mask);
+    high = p3 + (p1 >> 32) + (p2 >> 32) + (middle >> 32);
+    return (middle << 32) | (p0 & mask);
+#endif
+}
+
+namespace detail
+{
+
+template<typename U>
+unsigned countTrailingZerosOf(U word)
+{
+#ifdef MW_HAS_INT128
+    if (sizeof(U) > 8)
+        return countTrailingZeros(static_cast<uint128_t>(word));
+#endif
+    if (sizeof(U) > 4)
+        return countTrailingZeros(static_cast<boost::uint64_t>(word));
+    return countTrailingZeros(static_cast<boost::uint32_t>(word));
+}
+
+} // namespace detail
+
+/**
+ * Compute the greatest common divisor of two unsigned integers.
+ *
+ * Stein's algorithm: common factors of 2 are removed with a trailing zero
+ * count, then the difference of the odd values is reduced until they are
+ * equal. The loop has no division and no unpredictable branch. Operands of
+ * very different magnitudes are first reduced by a single modulo.
+ *
+ * @tparam U Unsigned integer type.
+ * @param a First number.
+ * @param b Second number.
+ * @return Greatest common divisor, 0 if both numbers are 0.
+ */
+template<typename U>
+U binaryGcd(U a, U b)
+{
+    if (!a)
+        return b;
+    if (!b)
+        return a;
+
+    if (a < b)
+    {
+        const U tmp = a;
+        a = b;
+        b = tmp;
+    }
+    if (static_cast<U>(a >> 8) >= b)
+    {
+        a %= b;
+        if (!a)
+            return b;
+    }
+
+    const unsigned shift = detail::countTrailingZerosOf(static_cast<U>(a | b));
+    a >>= detail::countTrailingZerosOf(a);
+    b >>= detail::countTrailingZerosOf(b);
+
+    while (a != b)
+    {
+        const U diff = a > b ? static_cast<U>(a - b) : static_cast<U>(b - a);
+        b = a < b ? a : b;
+        a = diff >> detail::countTrailingZerosOf(diff);
+    }
+
+    return a << shift;
+}
+
+MW_END_NAMESPACE(math)
+
+#endif // MW_BITS_HPP
@@ -213,7 +213,7 @@ public:
      * @param bounds Other bounds to compute the intersection with.
      * @return
      */
-    Bounds getIntersection(const Bounds & bounds)
+    Bounds getIntersection(const Bounds & bounds) const
     {
         Bounds copy(*this);
         copy.intersect(bounds);
@@ -259,12 +259,30 @@ public:
     /**
      * Check if another bounds is intersecting with this bounds.
      *
+     * Same result as @c !getIntersection(bounds).isEmpty(), without
+     * building the intersection.
+     *
      * @param bounds Other bounds to check the intersection with.
      * @return
      */
-    bool isIntersecting(const Bounds & bounds)
+    bool isIntersecting(const Bounds & bounds) const
     {
-        return !getIntersection(bounds).isEmpty();
+        for (unsigned i = 0; i < N; ++i)
+        {
+            T upper = getUpperLimit().get(i);
+            T lower = getLowerLimit().get(i);
+
+            if (bounds.getUpperLimit().get(i) < upper)
+                upper = bounds.getUpperLimit().get(i);
+
+            if (bounds.getLowerLimit().get(i) > lower)
+                lower = bounds.getLowerLimit().get(i);
+
+            if (upper <= lower)
+                return false;
+        }
+
+        return true;
     }
 
 
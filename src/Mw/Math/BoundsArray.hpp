@@ -0,0 +1,666 @@
+/**
+ * @file   BoundsArray.hpp
+ * @author Bastien Brunnenstein
+ */
+
+#ifndef MW_BOUNDSARRAY_HPP
+#define MW_BOUNDSARRAY_HPP
+
+#include <Mw/Config.hpp>
+
+#include <Mw/Math/Bits.hpp>
+#include <Mw/Math/Bounds.hpp>
+#include <Mw/Math/HitMask.hpp>
+#include <Mw/Math/Ray.hpp>
+#include <Mw/Math/Simd.hpp>
+#include <Mw/Math/VectorArray.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <boost/assert.hpp>
+#include <boost/cstdint.hpp>
+
+MW_BEGIN_NAMESPACE(math)
+
+namespace detail
+{
+
+/**
+ * Slab test of one ray against consecutive boxes of a BoundsArray, one box
+ * at a time.
+ */
+template<typename T, unsigned N>
+boost::uint32_t intersectRayLanes(const T * origin, const T * invDirection,
+                                  const T * const * lower, const T * const * upper,
+                                  std::size_t begin, std::size_t end, T maxDistance, T * distances)
+{
+    boost::uint32_t word = 0;
+    for (std::size_t j = begin; j < end; ++j)
+    {
+        T tmin = static_cast<T>(0), tmax = maxDistance;
+        for (unsigned c = 0; c < N; ++c)
+            Ray<T, N>::clipSlab(lower[c][j], upper[c][j], origin[c], invDirection[c], tmin, tmax);
+
+        distances[j] = tmin;
+        word |= static_cast<boost::uint32_t>(tmin <= tmax) << j;
+    }
+    return word;
+}
+
+/**
+ * Slab test of one ray against up to 32 consecutive boxes of a BoundsArray.
+ *
+ * The generic kernel is a plain loop. Float lanes get SSE and AVX kernels,
+ * with the same NaN handling as Ray::clipSlab.
+ *
+ * @tparam T Scalar type.
+ * @tparam N Dimension (number of components).
+ */
+template<typename T, unsigned N>
+struct RayLanesKernel
+{
+    static boost::uint32_t intersect(const T * origin, const T * invDirection,
+                                     const T * const * lower, const T * const * upper,
+                                     std::size_t count, T maxDistance, T * distances)
+    {
+        return intersectRayLanes<T, N>(origin, invDirection, lower, upper, 0, count, maxDistance, distances);
+    }
+};
+
+#ifdef MW_SIMD_SSE
+
+template<unsigned N>
+struct RayLanesKernel<float, N>
+{
+    static boost::uint32_t intersect(const float * origin, const float * invDirection,
+                                     const float * const * lower, const float * const * upper,
+                                     std::size_t count, float maxDistance, float * distances)
+    {
+        boost::uint32_t word = 0;
+        std::size_t j = 0;
+
+#ifdef MW_SIMD_AVX
+        for (; j + 8 <= count; j += 8)
+        {
+            __m256 tmin = _mm256_setzero_ps();
+            __m256 tmax = _mm256_set1_ps(maxDistance);
+
+            for (unsigned c = 0; c < N; ++c)
+            {
+                const __m256 o = _mm256_set1_ps(origin[c]);
+                const __m256 inv = _mm256_set1_ps(invDirection[c]);
+                const __m256 t0 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(lower[c] + j), o), inv);
+                const __m256 t1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(upper[c] + j), o), inv);
+
+                tmin = _mm256_max_ps(_mm256_min_ps(t1, t0), tmin);
+                tmax = _mm256_min_ps(_mm256_max_ps(t0, t1), tmax);
+            }
+
+            _mm256_storeu_ps(distances + j, tmin);
+            word |= static_cast<boost::uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(tmin, tmax, _CMP_LE_OQ))) << j;
+        }
+#endif
+
+        for (; j + 4 <= count; j += 4)
+        {
+            __m128 tmin = _mm_setzero_ps();
+            __m128 tmax = _mm_set1_ps(maxDistance);
+
+            for (unsigned c = 0; c < N; ++c)
+            {
+                const __m128 o = _mm_set1_ps(origin[c]);
+                const __m128 inv = _mm_set1_ps(invDirection[c]);
+                const __m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(lower[c] + j), o), inv);
+                const __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(upper[c] + j), o), inv);
+
+                // minps / maxps return their second operand on NaN
+                tmin = _mm_max_ps(_mm_min_ps(t1, t0), tmin);
+                tmax = _mm_min_ps(_mm_max_ps(t0, t1), tmax);
+            }
+
+            _mm_storeu_ps(distances + j, tmin);
+            word |= static_cast<boost::uint32_t>(_mm_movemask_ps(_mm_cmple_ps(tmin, tmax))) << j;
+        }
+
+        return word | intersectRayLanes<float, N>(origin, invDirection, lower, upper,
+                                                  j, count, maxDistance, distances);
+    }
+};
+
+#endif // MW_SIMD_SSE
+
+} // namespace detail
+
+
+/**
+ * Array of bounds stored as a structure of arrays.
+ *
+ * Lower and upper limits are stored in two VectorArray, so the queries can
+ * test a block of bounds per SIMD instruction.
+ *
+ * Query results are given either as bit masks (bit @c i%32 of word
+ * @c i/32 is set when bounds @c i matches) or as lists of indices.
+ * The tests give the same results as the equivalent Bounds functions.
+ *
+ * @tparam T Scalar type.
+ * @tparam N Dimension (number of components).
+ */
+template<typename T, unsigned N>
+class BoundsArray
+{
+public:
+
+    /**
+     * Bit mask, 32 bounds per word.
+     */
+    typedef std::vector<boost::uint32_t> Mask;
+
+    /**
+     * List of indices.
+     */
+    typedef std::vector<std::size_t> Indices;
+
+    /**
+     * List of index pairs.
+     */
+    typedef std::vector<std::pair<std::size_t, std::size_t> > Pairs;
+
+private:
+
+    /**
+     * Number of bounds tested per mask word.
+     */
+    static const unsigned BLOCK = 32;
+
+    /**
+     * Lower limits.
+     */
+    VectorArray<T, N> _lower;
+
+    /**
+     * Upper limits.
+     */
+    VectorArray<T, N> _upper;
+
+public:
+
+    // Constructors
+
+    /**
+     * Default constructor.
+     *
+     * The array is empty.
+     */
+    BoundsArray()
+    {}
+
+    /**
+     * Range constructor.
+     *
+     * @param first Beginning of a range of Bounds.
+     * @param last End of the range.
+     */
+    template<class InputIterator>
+    BoundsArray(InputIterator first, InputIterator last)
+    {
+        assign(first, last);
+    }
+
+
+    // Getters / setters
+
+    /**
+     * Get the number of bounds in the array.
+     *
+     * @return Number of bounds.
+     */
+    std::size_t size() const
+    {
+        return _lower.size();
+    }
+
+    /**
+     * Check if the array is empty.
+     *
+     * @return @c true if the array has no bounds.
+     */
+    bool empty() const
+    {
+        return _lower.empty();
+    }
+
+    /**
+     * Reserve memory for a number of bounds.
+     *
+     * @param capacity Number of bounds.
+     */
+    void reserve(std::size_t capacity)
+    {
+        _lower.reserve(capacity);
+        _upper.reserve(capacity);
+    }
+
+    /**
+     * Remove all the bounds.
+     */
+    void clear()
+    {
+        _lower.clear();
+        _upper.clear();
+    }
+
+    /**
+     * Append bounds at the end of the array.
+     *
+     * @param bounds Bounds to append.
+     */
+    template<class V>
+    void push_back(const Bounds<T, N, V> & bounds)
+    {
+        Vector<T, N> lower, upper;
+        for (unsigned c = 0; c < N; ++c)
+        {
+            lower[c] = bounds.getLowerLimit().get(c);
+            upper[c] = bounds.getUpperLimit().get(c);
+        }
+        _lower.push_back(lower);
+        _upper.push_back(upper);
+    }
+
+    /**
+     * Replace the content of the array by a range of Bounds.
+     *
+     * @param first Beginning of the range.
+     * @param last End of the range.
+     */
+    template<class InputIterator>
+    void assign(InputIterator first, InputIterator last)
+    {
+        clear();
+        for (; first != last; ++first)
+            push_back(*first);
+    }
+
+    /**
+     * Get bounds.
+     *
+     * @param index Bounds' index.
+     * @return Copy of the bounds at position @c index.
+     */
+    Bounds<T, N> get(std::size_t index) const
+    {
+        if (index >= size())
+            throw std::out_of_range("Mw.Math.BoundsArray: Out of range");
+
+        Bounds<T, N> bounds;
+        bounds.setLowerLimit(_lower[index]);
+        bounds.setUpperLimit(_upper[index]);
+        return bounds;
+    }
+
+    /**
+     * Set bounds.
+     *
+     * @param index Bounds' index.
+     * @param bounds New value.
+     */
+    template<class V>
+    void set(std::size_t index, const Bounds<T, N, V> & bounds)
+    {
+        if (index >= size())
+            throw std::out_of_range("Mw.Math.BoundsArray: Out of range");
+
+        for (unsigned c = 0; c < N; ++c)
+        {
+            _lower.lane(c)[index] = bounds.getLowerLimit().get(c);
+            _upper.lane(c)[index] = bounds.getUpperLimit().get(c);
+        }
+    }
+
+    /**
+     * Get the lower limits.
+     *
+     * @return Lower limits of all the bounds.
+     */
+    const VectorArray<T, N> & getLowerLimits() const
+    {
+        return _lower;
+    }
+
+    /**
+     * Get the upper limits.
+     *
+     * @return Upper limits of all the bounds.
+     */
+    const VectorArray<T, N> & getUpperLimits() const
+    {
+        return _upper;
+    }
+
+
+    // Queries
+
+    /**
+     * Check which bounds are intersecting with given bounds.
+     *
+     * @param bounds Bounds to check the intersection with.
+     * @param mask Output bit mask.
+     */
+    template<class V>
+    void testIntersecting(const Bounds<T, N, V> & bounds, Mask & mask) const
+    {
+        Query query(bounds);
+        const std::size_t count = size();
+
+        mask.resize((count + BLOCK - 1) / BLOCK);
+        for (std::size_t base = 0, w = 0; base < count; base += BLOCK, ++w)
+            mask[w] = testIntersectingBlock(query, base, std::min<std::size_t>(BLOCK, count - base));
+    }
+
+    /**
+     * Find the bounds intersecting with given bounds.
+     *
+     * @param bounds Bounds to check the intersection with.
+     * @param indices Indices of the intersecting bounds are appended to it.
+     * @return Number of intersecting bounds.
+     */
+    template<class V>
+    std::size_t findIntersecting(const Bounds<T, N, V> & bounds, Indices & indices) const
+    {
+        Query query(bounds);
+        const std::size_t count = size();
+        const std::size_t before = indices.size();
+
+        for (std::size_t base = 0; base < count; base += BLOCK)
+        {
+            const std::size_t block = std::min<std::size_t>(BLOCK, count - base);
+            detail::appendHitIndices(testIntersectingBlock(query, base, block), base, indices);
+        }
+
+        return indices.size() - before;
+    }
+
+    /**
+     * Find all the intersecting pairs between the bounds of two arrays.
+     *
+     * @param queries Bounds to check, @c first of each pair.
+     * @param pairs Pairs of intersecting bounds are appended to it.
+     * @return Number of intersecting pairs.
+     */
+    std::size_t findIntersecting(const BoundsArray & queries, Pairs & pairs) const
+    {
+        const std::size_t count = size();
+        const std::size_t before = pairs.size();
+
+        for (std::size_t q = 0; q < queries.size(); ++q)
+        {
+            Query query(queries, q);
+
+            for (std::size_t base = 0; base < count; base += BLOCK)
+            {
+                boost::uint32_t word = testIntersectingBlock(query, base, std::min<std::size_t>(BLOCK, count - base));
+                while (word)
+                {
+                    pairs.push_back(std::make_pair(q, base + countTrailingZeros(word)));
+                    word &= word - 1;
+                }
+            }
+        }
+
+        return pairs.size() - before;
+    }
+
+    /**
+     * Check which bounds intersect with the bounds at the same position in
+     * another array.
+     *
+     * @param other Array of the same size.
+     * @param mask Output bit mask.
+     */
+    void testIntersecting(const BoundsArray & other, Mask & mask) const
+    {
+        BOOST_ASSERT(other.size() == size());
+
+        const std::size_t count = size();
+
+        mask.resize((count + BLOCK - 1) / BLOCK);
+        for (std::size_t base = 0, w = 0; base < count; base += BLOCK, ++w)
+        {
+            const std::size_t block = std::min<std::size_t>(BLOCK, count - base);
+            unsigned char hits[BLOCK];
+            std::fill(hits, hits + block, 1);
+
+            for (unsigned c = 0; c < N; ++c)
+            {
+                const T * lo = _lower.lane(c) + base;
+                const T * up = _upper.lane(c) + base;
+                const T * olo = other._lower.lane(c) + base;
+                const T * oup = other._upper.lane(c) + base;
+
+                for (std::size_t j = 0; j < block; ++j)
+                    hits[j] &= (std::min(up[j], oup[j]) > std::max(lo[j], olo[j]));
+            }
+
+            mask[w] = detail::packHits(hits, block);
+        }
+    }
+
+    /**
+     * Check which bounds have a point inside.
+     *
+     * @param point A point.
+     * @param mask Output bit mask.
+     */
+    template<class V>
+    void testPointInside(const V & point, Mask & mask) const
+    {
+        const std::size_t count = size();
+
+        mask.resize((count + BLOCK - 1) / BLOCK);
+        for (std::size_t base = 0, w = 0; base < count; base += BLOCK, ++w)
+            mask[w] = testPointInsideBlock(point, base, std::min<std::size_t>(BLOCK, count - base));
+    }
+
+    /**
+     * Find the bounds having a point inside.
+     *
+     * @param point A point.
+     * @param indices Indices of the bounds are appended to it.
+     * @return Number of bounds found.
+     */
+    template<class V>
+    std::size_t findPointInside(const V & point, Indices & indices) const
+    {
+        const std::size_t count = size();
+        const std::size_t before = indices.size();
+
+        for (std::size_t base = 0; base < count; base += BLOCK)
+        {
+            const std::size_t block = std::min<std::size_t>(BLOCK, count - base);
+            detail::appendHitIndices(testPointInsideBlock(point, base, block), base, indices);
+        }
+
+        return indices.size() - before;
+    }
+
+    /**
+     * Check which bounds are crossed by a ray.
+     *
+     * Same test as Ray::isIntersecting.
+     *
+     * @param ray A ray.
+     * @param maxDistance Length of the tested segment.
+     * @param mask Output bit mask.
+     */
+    void testRayIntersecting(const Ray<T, N> & ray, T maxDistance, Mask & mask) const
+    {
+        const std::size_t count = size();
+        T distances[BLOCK];
+
+        mask.resize((count + BLOCK - 1) / BLOCK);
+        for (std::size_t base = 0, w = 0; base < count; base += BLOCK, ++w)
+            mask[w] = testRayBlock(ray, maxDistance, base, std::min<std::size_t>(BLOCK, count - base), distances);
+    }
+
+    /**
+     * Find the bounds crossed by a ray.
+     *
+     * @param ray A ray.
+     * @param maxDistance Length of the tested segment.
+     * @param indices Indices of the crossed bounds are appended to it.
+     * @return Number of crossed bounds.
+     */
+    std::size_t findRayIntersecting(const Ray<T, N> & ray, T maxDistance, Indices & indices) const
+    {
+        const std::size_t count = size();
+        const std::size_t before = indices.size();
+        T distances[BLOCK];
+
+        for (std::size_t base = 0; base < count; base += BLOCK)
+        {
+            const std::size_t block = std::min<std::size_t>(BLOCK, count - base);
+            detail::appendHitIndices(testRayBlock(ray, maxDistance, base, block, distances), base, indices);
+        }
+
+        return indices.size() - before;
+    }
+
+    /**
+     * Find the first bounds crossed by a ray.
+     *
+     * On equal entry distances, the lowest index is found.
+     *
+     * @param ray A ray.
+     * @param index Output, index of the bounds.
+     * @param distance Output, entry distance in the bounds.
+     * @param maxDistance Length of the tested segment.
+     * @return @c true if bounds were found.
+     */
+    bool findNearest(const Ray<T, N> & ray, std::size_t & index, T & distance,
+                     T maxDistance = std::numeric_limits<T>::max()) const
+    {
+        const std::size_t count = size();
+        bool found = false;
+        T distances[BLOCK];
+
+        for (std::size_t base = 0; base < count; base += BLOCK)
+        {
+            // The segment gets shorter with each hit
+            boost::uint32_t word = testRayBlock(ray, maxDistance, base, std::min<std::size_t>(BLOCK, count - base),
+                                                distances);
+            for (; word; word &= word - 1)
+            {
+                const unsigned j = countTrailingZeros(word);
+                if (!found || distances[j] < maxDistance)
+                {
+                    found = true;
+                    index = base + j;
+                    maxDistance = distance = distances[j];
+                }
+            }
+        }
+
+        return found;
+    }
+
+
+private:
+
+    /**
+     * Limits of queried bounds, extracted once per query.
+     */
+    struct Query
+    {
+        T lower[N];
+        T upper[N];
+
+        template<class V>
+        explicit Query(const Bounds<T, N, V> & bounds)
+        {
+            for (unsigned c = 0; c < N; ++c)
+            {
+                lower[c] = bounds.getLowerLimit().get(c);
+                upper[c] = bounds.getUpperLimit().get(c);
+            }
+        }
+
+        Query(const BoundsArray & array, std::size_t index)
+        {
+            for (unsigned c = 0; c < N; ++c)
+            {
+                lower[c] = array._lower.lane(c)[index];
+                upper[c] = array._upper.lane(c)[index];
+            }
+        }
+    };
+
+    boost::uint32_t testIntersectingBlock(const Query & query, std::size_t base, std::size_t block) const
+    {
+        unsigned char hits[BLOCK];
+        std::fill(hits, hits + block, 1);
+
+        // Same test as Bounds::isIntersecting
+        for (unsigned c = 0; c < N; ++c)
+        {
+            const T * lo = _lower.lane(c) + base;
+            const T * up = _upper.lane(c) + base;
+            const T qlo = query.lower[c];
+            const T qup = query.upper[c];
+
+            for (std::size_t j = 0; j < block; ++j)
+                hits[j] &= (std::min(up[j], qup) > std::max(lo[j], qlo));
+        }
+
+        return detail::packHits(hits, block);
+    }
+
+    boost::uint32_t testRayBlock(const Ray<T, N> & ray, T maxDistance, std::size_t base, std::size_t block,
+                                 T * distances) const
+    {
+        T origin[N], invDirection[N];
+        const T * lower[N];
+        const T * upper[N];
+        for (unsigned c = 0; c < N; ++c)
+        {
+            origin[c] = ray.getOrigin()[c];
+            invDirection[c] = ray.getInverseDirection()[c];
+            lower[c] = _lower.lane(c) + base;
+            upper[c] = _upper.lane(c) + base;
+        }
+
+        // Same test as Ray::intersect
+        return detail::RayLanesKernel<T, N>::intersect(origin, invDirection, lower, upper,
+                                                       block, maxDistance, distances);
+    }
+
+    template<class V>
+    boost::uint32_t testPointInsideBlock(const V & point, std::size_t base, std::size_t block) const
+    {
+        unsigned char hits[BLOCK];
+        std::fill(hits, hits + block, 1);
+
+        // Same test as Bounds::hasPointInside
+        for (unsigned c = 0; c < N; ++c)
+        {
+            const T * lo = _lower.lane(c) + base;
+            const T * up = _upper.lane(c) + base;
+            const T p = point.get(c);
+
+            for (std::size_t j = 0; j < block; ++j)
+                hits[j] &= (p <= up[j]) & (p >= lo[j]);
+        }
+
+        return detail::packHits(hits, block);
+    }
+
+};
+// class BoundsArray
+
+MW_END_NAMESPACE(math)
+
+#endif // MW_BOUNDSARRAY_HPP
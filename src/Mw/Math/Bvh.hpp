@@ -0,0 +1,1394 @@
+/**
+ * @file   Bvh.hpp
+ * @author Bastien Brunnenstein
+ */
+
+#ifndef MW_BVH_HPP
+#define MW_BVH_HPP
+
+#include <Mw/Config.hpp>
+
+#include <Mw/Math/Bits.hpp>
+#include <Mw/Math/Bounds.hpp>
+#include <Mw/Math/Ray.hpp>
+#include <Mw/Math/RayPacket.hpp>
+#include <Mw/Math/Vector.hpp>
+#include <Mw/Thread/TaskPool.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <boost/assert.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+
+MW_BEGIN_NAMESPACE(math)
+
+/**
+ * Bounding volume hierarchy.
+ *
+ * Spatial index over a set of Bounds, each associated with a payload.
+ *
+ * The tree is built with a binned surface area heuristic, or from the Morton
+ * order of the items (faster to build, slower to query), and stored as a
+ * flat array of nodes in depth-first order: the left child of a node
+ * directly follows it. Traversals use a small fixed-size stack.
+ *
+ * Given a TaskPool, large subtrees are built in parallel, and the bounds,
+ * bins and partition of large nodes are computed by parallel chunks. The
+ * result does not depend on the number of threads.
+ *
+ * Moving objects can be updated with setBounds() followed by refit(),
+ * which keeps the tree topology and only recomputes the node bounds.
+ *
+ * @tparam T Scalar type.
+ * @tparam N Dimension (number of components).
+ * @tparam P Payload type.
+ */
+template<typename T, unsigned N, class P = std::size_t>
+class Bvh
+{
+public:
+
+    /**
+     * Node of the tree.
+     */
+    struct Node
+    {
+        T lower[N];
+        T upper[N];
+
+        /**
+         * Index of the right child for inner nodes, of the first item for
+         * leaves. The left child of an inner node is the next node.
+         */
+        boost::uint32_t offset;
+
+        /**
+         * Number of items in a leaf, 0 for inner nodes.
+         */
+        boost::uint32_t count;
+
+        bool isLeaf() const
+        {
+            return count != 0;
+        }
+    };
+
+    /**
+     * Maximum depth of the tree, and size of the traversal stack.
+     */
+    static const unsigned MAX_DEPTH = 64;
+
+    /**
+     * Construction algorithm.
+     */
+    enum BuildMethod
+    {
+        /**
+         * Binned surface area heuristic.
+         */
+        BUILD_SAH,
+
+        /**
+         * Split at the highest differing bit of the centroids Morton codes.
+         */
+        BUILD_MORTON
+    };
+
+private:
+
+    /**
+     * Maximum number of items in a leaf.
+     */
+    static const unsigned LEAF_SIZE = 4;
+
+    /**
+     * Number of bins used to evaluate the split candidates.
+     */
+    static const unsigned BINS = 16;
+
+    /**
+     * Depth after which nodes are split at the median, to bound the depth.
+     */
+    static const unsigned SAH_DEPTH = MAX_DEPTH / 2;
+
+    /**
+     * Flat array of nodes, the root is the first one.
+     */
+    std::vector<Node> _nodes;
+
+    /**
+     * Items bounds, in leaf order.
+     */
+    std::vector<Bounds<T, N> > _bounds;
+
+    /**
+     * Items payloads, in leaf order.
+     */
+    std::vector<P> _payloads;
+
+    /**
+     * Position in leaf order of each item, by insertion index.
+     */
+    std::vector<boost::uint32_t> _slots;
+
+public:
+
+    // Constructors
+
+    /**
+     * Default constructor.
+     *
+     * The tree is empty.
+     */
+    Bvh()
+    {}
+
+    /**
+     * Constructor.
+     *
+     * @see build
+     */
+    template<class BoundsIterator, class PayloadIterator>
+    Bvh(BoundsIterator first, BoundsIterator last, PayloadIterator payloads)
+    {
+        build(first, last, payloads);
+    }
+
+
+    // Getters
+
+    /**
+     * Get the number of items in the tree.
+     *
+     * @return Number of items.
+     */
+    std::size_t size() const
+    {
+        return _bounds.size();
+    }
+
+    /**
+     * Check if the tree is empty.
+     *
+     * @return @c true if the tree has no items.
+     */
+    bool empty() const
+    {
+        return _bounds.empty();
+    }
+
+    /**
+     * Get the nodes of the tree.
+     *
+     * @return Nodes, in depth-first order.
+     */
+    const std::vector<Node> & getNodes() const
+    {
+        return _nodes;
+    }
+
+    /**
+     * Get the bounds of an item.
+     *
+     * @param index Item's insertion index.
+     * @return Bounds of the item.
+     */
+    const Bounds<T, N> & getBounds(std::size_t index) const
+    {
+        if (index >= _slots.size())
+            throw std::out_of_range("Mw.Math.Bvh: Out of range");
+
+        return _bounds[_slots[index]];
+    }
+
+
+    // Construction
+
+    /**
+     * Build the tree.
+     *
+     * @param first Beginning of a range of Bounds.
+     * @param last End of the range.
+     * @param payloads Beginning of a range of payloads, one per bounds.
+     * @param method Construction algorithm.
+     */
+    template<class BoundsIterator, class PayloadIterator>
+    void build(BoundsIterator first, BoundsIterator last, PayloadIterator payloads,
+               BuildMethod method = BUILD_SAH)
+    {
+        buildItems(first, last, payloads, NULL, method);
+    }
+
+    /**
+     * Build the tree using the threads of a task pool.
+     *
+     * Large subtrees are built by parallel tasks. The tree is the same as
+     * the one built without a pool, whatever the number of threads.
+     *
+     * @param first Beginning of a range of Bounds.
+     * @param last End of the range.
+     * @param payloads Beginning of a range of payloads, one per bounds.
+     * @param pool Task pool running the build.
+     * @param method Construction algorithm.
+     */
+    template<class BoundsIterator, class PayloadIterator>
+    void build(BoundsIterator first, BoundsIterator last, PayloadIterator payloads,
+               thread::TaskPool & pool, BuildMethod method = BUILD_SAH)
+    {
+        buildItems(first, last, payloads, &pool, method);
+    }
+
+    /**
+     * Build the tree, using the bounds indices as payloads.
+     *
+     * @param first Beginning of a range of Bounds.
+     * @param last End of the range.
+     * @param method Construction algorithm.
+     */
+    template<class BoundsIterator>
+    void build(BoundsIterator first, BoundsIterator last, BuildMethod method = BUILD_SAH)
+    {
+        buildIndices(first, last, NULL, method);
+    }
+
+    /**
+     * Build the tree using the threads of a task pool, using the bounds
+     * indices as payloads.
+     *
+     * @param first Beginning of a range of Bounds.
+     * @param last End of the range.
+     * @param pool Task pool running the build.
+     * @param method Construction algorithm.
+     */
+    template<class BoundsIterator>
+    void build(BoundsIterator first, BoundsIterator last, thread::TaskPool & pool,
+               BuildMethod method = BUILD_SAH)
+    {
+        buildIndices(first, last, &pool, method);
+    }
+
+
+    /**
+     * Change the bounds of an item.
+     *
+     * The tree is invalid until refit() is called.
+     *
+     * @param index Item's insertion index.
+     * @param bounds New bounds.
+     */
+    void setBounds(std::size_t index, const Bounds<T, N> & bounds)
+    {
+        if (index >= _slots.size())
+            throw std::out_of_range("Mw.Math.Bvh: Out of range");
+
+        _bounds[_slots[index]] = bounds;
+    }
+
+    /**
+     * Recompute the nodes bounds after items have moved.
+     *
+     * The topology of the tree is kept, the queries stay exact but may
+     * become slower as the items move away from their original position.
+     */
+    void refit()
+    {
+        // Children are always stored after their parent
+        for (std::size_t n = _nodes.size(); n-- > 0; )
+        {
+            Node & node = _nodes[n];
+
+            if (node.isLeaf())
+                fitItems(node, node.offset, node.offset + node.count);
+            else
+            {
+                const Node & left = _nodes[n + 1];
+                const Node & right = _nodes[node.offset];
+                for (unsigned c = 0; c < N; ++c)
+                {
+                    node.lower[c] = std::min(left.lower[c], right.lower[c]);
+                    node.upper[c] = std::max(left.upper[c], right.upper[c]);
+                }
+            }
+        }
+    }
+
+
+    // Queries
+
+    /**
+     * Find the items having a point inside.
+     *
+     * Same test as Bounds::hasPointInside.
+     *
+     * @param point A point.
+     * @param out Output iterator receiving the payloads.
+     * @return End of the output range.
+     */
+    template<class OutputIterator>
+    OutputIterator queryPoint(const Vector<T, N> & point, OutputIterator out) const
+    {
+        PointTest test = { point };
+        return traverse(test, out);
+    }
+
+    /**
+     * Find the items intersecting with given bounds.
+     *
+     * Same test as Bounds::isIntersecting.
+     *
+     * @param bounds Bounds to check the intersection with.
+     * @param out Output iterator receiving the payloads.
+     * @return End of the output range.
+     */
+    template<class OutputIterator>
+    OutputIterator queryBounds(const Bounds<T, N> & bounds, OutputIterator out) const
+    {
+        BoundsTest test = { bounds };
+        return traverse(test, out);
+    }
+
+    /**
+     * Find the items whose bounds are crossed by a ray segment.
+     *
+     * @param origin Origin of the ray.
+     * @param direction Direction of the ray, need not be normalized.
+     * @param maxDistance Length of the segment, in @c direction units.
+     * @param out Output iterator receiving the payloads.
+     * @return End of the output range.
+     */
+    template<class OutputIterator>
+    OutputIterator queryRay(const Vector<T, N> & origin, const Vector<T, N> & direction,
+                            T maxDistance, OutputIterator out) const
+    {
+        return queryRay(Ray<T, N>(origin, direction), maxDistance, out);
+    }
+
+    /**
+     * Find the items whose bounds are crossed by a ray.
+     *
+     * Same test as Ray::isIntersecting.
+     *
+     * @param ray A ray.
+     * @param maxDistance Length of the tested segment.
+     * @param out Output iterator receiving the payloads.
+     * @return End of the output range.
+     */
+    template<class OutputIterator>
+    OutputIterator queryRay(const Ray<T, N> & ray, T maxDistance, OutputIterator out) const
+    {
+        RayTest test = { ray, maxDistance };
+        return traverse(test, out);
+    }
+
+    /**
+     * Find the items whose bounds are crossed by a packet of rays.
+     *
+     * The rays share the traversal: a node is visited once for all the rays
+     * crossing its parent, and tested against them at once. This pays off
+     * for coherent packets (see RayPacket::isCoherent).
+     *
+     * @param rays Packet of rays.
+     * @param maxDistances Length of the tested segment of each ray.
+     * @param out Output iterator receiving <tt>std::pair<unsigned, P></tt>,
+     *            the lane of the ray and the payload.
+     * @return End of the output range.
+     */
+    template<unsigned W, class OutputIterator>
+    OutputIterator queryRays(const RayPacket<T, N, W> & rays, const T * maxDistances, OutputIterator out) const
+    {
+        if (_nodes.empty())
+            return out;
+
+        // Nodes to visit, with the rays crossing their parent
+        boost::uint32_t stack[MAX_DEPTH];
+        unsigned masks[MAX_DEPTH];
+        unsigned top = 0;
+        boost::uint32_t current = 0;
+        unsigned active = W == 32 ? ~0u : (1u << W) - 1;
+
+        T distances[W];
+
+        for (;;)
+        {
+            const Node & node = _nodes[current];
+            const unsigned mask = active & rays.intersect(node.lower, node.upper, maxDistances, distances);
+
+            if (mask)
+            {
+                if (node.isLeaf())
+                {
+                    for (boost::uint32_t i = node.offset; i < node.offset + node.count; ++i)
+                    {
+                        for (unsigned hits = mask & rays.intersect(_bounds[i], maxDistances, distances);
+                             hits; hits &= hits - 1)
+                            *out++ = std::make_pair(countTrailingZeros(hits), _payloads[i]);
+                    }
+                }
+                else
+                {
+                    BOOST_ASSERT(top < MAX_DEPTH);
+                    stack[top] = node.offset;
+                    masks[top++] = mask;
+                    current = current + 1;
+                    active = mask;
+                    continue;
+                }
+            }
+
+            if (top == 0)
+                break;
+            --top;
+            current = stack[top];
+            active = masks[top];
+        }
+
+        return out;
+    }
+
+
+private:
+
+    // Tests used by the traversal, on nodes and on items
+
+    struct PointTest
+    {
+        const Vector<T, N> & point;
+
+        bool operator () (const T * lower, const T * upper) const
+        {
+            for (unsigned c = 0; c < N; ++c)
+                if (point[c] > upper[c] || point[c] < lower[c])
+                    return false;
+            return true;
+        }
+
+        bool operator () (const Bounds<T, N> & bounds) const
+        {
+            return bounds.hasPointInside(point);
+        }
+    };
+
+    struct BoundsTest
+    {
+        const Bounds<T, N> & bounds;
+
+        bool operator () (const T * lower, const T * upper) const
+        {
+            for (unsigned c = 0; c < N; ++c)
+                if (std::min(upper[c], bounds.getUpperLimit()[c])
+                        <= std::max(lower[c], bounds.getLowerLimit()[c]))
+                    return false;
+            return true;
+        }
+
+        bool operator () (const Bounds<T, N> & item) const
+        {
+            return item.isIntersecting(bounds);
+        }
+    };
+
+    struct RayTest
+    {
+        const Ray<T, N> & ray;
+        T maxDistance;
+
+        bool operator () (const T * lower, const T * upper) const
+        {
+            T tmin = static_cast<T>(0), tmax = maxDistance;
+            for (unsigned c = 0; c < N; ++c)
+                Ray<T, N>::clipSlab(lower[c], upper[c], ray.getOrigin()[c], ray.getInverseDirection()[c],
+                                    tmin, tmax);
+            return tmin <= tmax;
+        }
+
+        bool operator () (const Bounds<T, N> & item) const
+        {
+            return ray.isIntersecting(item, maxDistance);
+        }
+    };
+
+    template<class Test, class OutputIterator>
+    OutputIterator traverse(const Test & test, OutputIterator out) const
+    {
+        if (_nodes.empty())
+            return out;
+
+        boost::uint32_t stack[MAX_DEPTH];
+        unsigned top = 0;
+        boost::uint32_t current = 0;
+
+        for (;;)
+        {
+            const Node & node = _nodes[current];
+
+            if (test(node.lower, node.upper))
+            {
+                if (node.isLeaf())
+                {
+                    for (boost::uint32_t i = node.offset; i < node.offset + node.count; ++i)
+                        if (test(_bounds[i]))
+                            *out++ = _payloads[i];
+                }
+                else
+                {
+                    BOOST_ASSERT(top < MAX_DEPTH);
+                    stack[top++] = node.offset;
+                    current = current + 1;
+                    continue;
+                }
+            }
+
+            if (top == 0)
+                break;
+            current = stack[--top];
+        }
+
+        return out;
+    }
+
+    void fitItems(Node & node, boost::uint32_t begin, boost::uint32_t end) const
+    {
+        for (unsigned c = 0; c < N; ++c)
+        {
+            node.lower[c] = std::numeric_limits<T>::max();
+            node.upper[c] = - std::numeric_limits<T>::max();
+        }
+
+        for (boost::uint32_t i = begin; i < end; ++i)
+        {
+            const Bounds<T, N> & b = _bounds[i];
+            for (unsigned c = 0; c < N; ++c)
+            {
+                node.lower[c] = std::min(node.lower[c], b.getLowerLimit()[c]);
+                node.upper[c] = std::max(node.upper[c], b.getUpperLimit()[c]);
+            }
+        }
+    }
+
+    static T halfArea(const T * lower, const T * upper)
+    {
+        if (N == 1)
+            return upper[0] - lower[0];
+
+        // Sum of the products of each pair of extents
+        T area = static_cast<T>(0);
+        for (unsigned a = 0; a < N; ++a)
+            for (unsigned b = a + 1; b < N; ++b)
+                area += (upper[a] - lower[a]) * (upper[b] - lower[b]);
+        return area;
+    }
+
+    struct Bin
+    {
+        T lower[N];
+        T upper[N];
+        boost::uint32_t count;
+
+        void reset()
+        {
+            for (unsigned c = 0; c < N; ++c)
+            {
+                lower[c] = std::numeric_limits<T>::max();
+                upper[c] = - std::numeric_limits<T>::max();
+            }
+            count = 0;
+        }
+
+        void grow(const Bin & bin)
+        {
+            for (unsigned c = 0; c < N; ++c)
+            {
+                lower[c] = std::min(lower[c], bin.lower[c]);
+                upper[c] = std::max(upper[c], bin.upper[c]);
+            }
+            count += bin.count;
+        }
+
+        void grow(const T * point)
+        {
+            for (unsigned c = 0; c < N; ++c)
+            {
+                lower[c] = std::min(lower[c], point[c]);
+                upper[c] = std::max(upper[c], point[c]);
+            }
+            ++count;
+        }
+
+        template<class V>
+        void grow(const Bounds<T, N, V> & bounds)
+        {
+            for (unsigned c = 0; c < N; ++c)
+            {
+                lower[c] = std::min(lower[c], bounds.getLowerLimit()[c]);
+                upper[c] = std::max(upper[c], bounds.getUpperLimit()[c]);
+            }
+            ++count;
+        }
+    };
+
+
+    // Construction
+
+    /**
+     * Minimum number of items of a subtree built by its own task.
+     */
+    static const boost::uint32_t TASK_GRAIN = 4096;
+
+    /**
+     * Number of items per chunk of the parallel loops.
+     */
+    static const boost::uint32_t CHUNK_GRAIN = 16384;
+
+    /**
+     * State shared by the construction tasks.
+     *
+     * Items are referenced by their position in @c order, each task owns a
+     * disjoint range of it, and the same range of @c scratch.
+     */
+    struct Builder
+    {
+        const std::vector<Bounds<T, N> > & bounds;
+        std::vector<T> & centroids;
+        std::vector<boost::uint32_t> & order;
+        std::vector<boost::uint32_t> & scratch;
+
+        /**
+         * Sorted Morton codes, by position in @c order. Empty for BUILD_SAH.
+         */
+        const std::vector<boost::uint64_t> & codes;
+
+        /**
+         * Task pool, NULL for a sequential build.
+         */
+        thread::TaskPool * pool;
+
+        const T * centroid(boost::uint32_t item) const
+        {
+            return &centroids[static_cast<std::size_t>(item) * N];
+        }
+    };
+
+    /**
+     * Part of the tree built by a task.
+     *
+     * Either a subtree built sequentially, whose inner nodes offsets are
+     * relative to the first node, or a single inner node whose children are
+     * built by other tasks.
+     */
+    struct Fragment : boost::noncopyable
+    {
+        std::vector<Node> nodes;
+        boost::scoped_ptr<Fragment> left;
+        boost::scoped_ptr<Fragment> right;
+
+        boost::uint32_t getNodeCount() const
+        {
+            if (!left)
+                return static_cast<boost::uint32_t>(nodes.size());
+            return 1 + left->getNodeCount() + right->getNodeCount();
+        }
+    };
+
+    template<class BoundsIterator>
+    void buildIndices(BoundsIterator first, BoundsIterator last, thread::TaskPool * pool, BuildMethod method)
+    {
+        std::vector<P> payloads;
+        for (std::size_t i = 0, n = std::distance(first, last); i < n; ++i)
+            payloads.push_back(static_cast<P>(i));
+
+        buildItems(first, last, payloads.begin(), pool, method);
+    }
+
+    template<class BoundsIterator, class PayloadIterator>
+    void buildItems(BoundsIterator first, BoundsIterator last, PayloadIterator payloads,
+                    thread::TaskPool * pool, BuildMethod method)
+    {
+        std::vector<Bounds<T, N> > bounds(first, last);
+
+        if (bounds.size() > std::numeric_limits<boost::uint32_t>::max() / 2)
+            throw std::length_error("Mw.Math.Bvh: Too many items");
+
+        const boost::uint32_t count = static_cast<boost::uint32_t>(bounds.size());
+
+        std::vector<P> payloadsIn;
+        payloadsIn.reserve(count);
+        for (boost::uint32_t i = 0; i < count; ++i, ++payloads)
+            payloadsIn.push_back(*payloads);
+
+        std::vector<T> centroids(static_cast<std::size_t>(count) * N);
+        std::vector<boost::uint32_t> order(count);
+        std::vector<boost::uint32_t> scratch(count);
+        std::vector<boost::uint64_t> codes;
+        Builder builder = { bounds, centroids, order, scratch, codes, pool };
+
+        CentroidTask centroidTask = { &builder };
+        forChunks(builder, 0, count, centroidTask);
+
+        if (method == BUILD_MORTON && count)
+            sortMorton(builder, codes);
+
+        Fragment root;
+        if (count)
+            buildFragment(builder, root, 0, count, 0);
+
+        _nodes.clear();
+        if (!root.left)
+            _nodes.swap(root.nodes);
+        else
+        {
+            _nodes.resize(root.getNodeCount());
+            flatten(root, 0);
+        }
+
+        // Store items in leaf order
+        _bounds.resize(count);
+        _payloads.clear();
+        _payloads.reserve(count);
+        _slots.resize(count);
+        for (boost::uint32_t s = 0; s < count; ++s)
+        {
+            _bounds[s] = bounds[order[s]];
+            _payloads.push_back(payloadsIn[order[s]]);
+            _slots[order[s]] = s;
+        }
+    }
+
+    /**
+     * Run a chunked loop on items [begin, end), in parallel when it is
+     * large enough. Chunk @c k covers items from begin + k * CHUNK_GRAIN.
+     */
+    template<class Task>
+    static void forChunks(const Builder & builder, boost::uint32_t begin, boost::uint32_t end, const Task & task)
+    {
+        if (builder.pool && end - begin > 2 * CHUNK_GRAIN)
+            thread::parallelFor(*builder.pool, begin, end, CHUNK_GRAIN, task);
+        else
+            task(begin, end);
+    }
+
+    static std::size_t chunkCount(const Builder & builder, boost::uint32_t begin, boost::uint32_t end)
+    {
+        if (builder.pool && end - begin > 2 * CHUNK_GRAIN)
+            return (end - begin + CHUNK_GRAIN - 1) / CHUNK_GRAIN;
+        return 1;
+    }
+
+    /**
+     * Compute the centroids, and fill @c order with the identity.
+     */
+    struct CentroidTask
+    {
+        const Builder * builder;
+
+        void operator () (std::size_t first, std::size_t last) const
+        {
+            for (std::size_t i = first; i < last; ++i)
+            {
+                const Bounds<T, N> & b = builder->bounds[i];
+                for (unsigned c = 0; c < N; ++c)
+                    builder->centroids[i * N + c] = (b.getLowerLimit()[c] + b.getUpperLimit()[c]) / 2;
+                builder->order[i] = static_cast<boost::uint32_t>(i);
+            }
+        }
+    };
+
+    /**
+     * Compute the bounds and the centroids extent of the items of a range.
+     */
+    struct FitTask
+    {
+        const Builder * builder;
+        boost::uint32_t begin;
+        Bin * boxes;
+        Bin * centroidBoxes;
+
+        void operator () (std::size_t first, std::size_t last) const
+        {
+            const std::size_t chunk = (first - begin) / CHUNK_GRAIN;
+            Bin & box = boxes[chunk];
+            Bin & centroidBox = centroidBoxes[chunk];
+            box.reset();
+            centroidBox.reset();
+
+            for (std::size_t i = first; i < last; ++i)
+            {
+                const boost::uint32_t item = builder->order[i];
+                box.grow(builder->bounds[item]);
+                centroidBox.grow(builder->centroid(item));
+            }
+        }
+    };
+
+    /**
+     * Fill the SAH bins with the items of a range.
+     */
+    struct BinTask
+    {
+        const Builder * builder;
+        boost::uint32_t begin;
+        unsigned axis;
+        T cmin;
+        T scale;
+        Bin * bins;
+
+        void operator () (std::size_t first, std::size_t last) const
+        {
+            Bin * chunkBins = bins + (first - begin) / CHUNK_GRAIN * BINS;
+            for (unsigned b = 0; b < BINS; ++b)
+                chunkBins[b].reset();
+
+            for (std::size_t i = first; i < last; ++i)
+            {
+                const boost::uint32_t item = builder->order[i];
+                chunkBins[binIndex(builder->centroid(item)[axis], cmin, scale)].grow(builder->bounds[item]);
+            }
+        }
+    };
+
+    /**
+     * Count the items of each chunk of a range matching a predicate.
+     */
+    template<class Predicate>
+    struct CountTask
+    {
+        const Builder * builder;
+        boost::uint32_t begin;
+        Predicate pred;
+        boost::uint32_t * counts;
+
+        void operator () (std::size_t first, std::size_t last) const
+        {
+            boost::uint32_t count = 0;
+            for (std::size_t i = first; i < last; ++i)
+                if (pred(builder->order[i]))
+                    ++count;
+            counts[(first - begin) / CHUNK_GRAIN] = count;
+        }
+    };
+
+    /**
+     * Move the items of each chunk of a range to their partitioned
+     * position in @c scratch.
+     */
+    template<class Predicate>
+    struct ScatterTask
+    {
+        const Builder * builder;
+        boost::uint32_t begin;
+        Predicate pred;
+        const boost::uint32_t * leftOffsets;
+        const boost::uint32_t * rightOffsets;
+
+        void operator () (std::size_t first, std::size_t last) const
+        {
+            const std::size_t chunk = (first - begin) / CHUNK_GRAIN;
+            boost::uint32_t left = leftOffsets[chunk];
+            boost::uint32_t right = rightOffsets[chunk];
+            for (std::size_t i = first; i < last; ++i)
+            {
+                const boost::uint32_t item = builder->order[i];
+                if (pred(item))
+                    builder->scratch[left++] = item;
+                else
+                    builder->scratch[right++] = item;
+            }
+        }
+    };
+
+    /**
+     * Copy a range of @c scratch back to @c order.
+     */
+    struct CopyTask
+    {
+        const Builder * builder;
+
+        void operator () (std::size_t first, std::size_t last) const
+        {
+            std::copy(builder->scratch.begin() + first, builder->scratch.begin() + last,
+                      builder->order.begin() + first);
+        }
+    };
+
+    /**
+     * Compute the Morton codes of the centroids.
+     */
+    struct MortonTask
+    {
+        const Builder * builder;
+        const Bin * centroidBox;
+        std::pair<boost::uint64_t, boost::uint32_t> * keys;
+
+        void operator () (std::size_t first, std::size_t last) const
+        {
+            const unsigned bits = MORTON_BITS < 32 ? MORTON_BITS : 32;
+            const boost::uint64_t cells = (static_cast<boost::uint64_t>(1) << bits) - 1;
+
+            T scale[N];
+            for (unsigned c = 0; c < N; ++c)
+            {
+                const T extent = centroidBox->upper[c] - centroidBox->lower[c];
+                scale[c] = extent > static_cast<T>(0) ? static_cast<T>(cells) / extent : static_cast<T>(0);
+            }
+
+            for (std::size_t i = first; i < last; ++i)
+            {
+                const T * centroid = builder->centroid(static_cast<boost::uint32_t>(i));
+
+                boost::uint64_t cell[N];
+                for (unsigned c = 0; c < N; ++c)
+                    cell[c] = std::min(cells, static_cast<boost::uint64_t>((centroid[c] - centroidBox->lower[c]) * scale[c]));
+
+                // Interleave the bits, highest first
+                boost::uint64_t code = 0;
+                for (unsigned b = bits; b-- > 0; )
+                    for (unsigned c = 0; c < N; ++c)
+                        code = (code << 1) | ((cell[c] >> b) & 1);
+
+                keys[i] = std::make_pair(code, static_cast<boost::uint32_t>(i));
+            }
+        }
+    };
+
+    /**
+     * Sort a range of keys, or merge its two sorted halves.
+     */
+    struct SortTask
+    {
+        std::pair<boost::uint64_t, boost::uint32_t> * keys;
+        std::size_t half;
+
+        void operator () (std::size_t first, std::size_t last) const
+        {
+            if (half == 0)
+                std::sort(keys + first, keys + last);
+            else if (first + half < last)
+                std::inplace_merge(keys + first, keys + first + half, keys + last);
+        }
+    };
+
+    /**
+     * Bits per axis of the Morton codes.
+     */
+    static const unsigned MORTON_BITS = 63 / N;
+
+    /**
+     * Sort the items by the Morton code of their centroid.
+     *
+     * Codes are unique once paired with the item index, so the order does
+     * not depend on the sort chunks.
+     */
+    static void sortMorton(const Builder & builder, std::vector<boost::uint64_t> & codes)
+    {
+        const boost::uint32_t count = static_cast<boost::uint32_t>(builder.order.size());
+
+        Bin centroidBox;
+        centroidBox.reset();
+        for (boost::uint32_t i = 0; i < count; ++i)
+            centroidBox.grow(builder.centroid(i));
+
+        std::vector<std::pair<boost::uint64_t, boost::uint32_t> > keys(count);
+        MortonTask mortonTask = { &builder, &centroidBox, &keys[0] };
+        forChunks(builder, 0, count, mortonTask);
+
+        if (builder.pool && count > 2 * CHUNK_GRAIN)
+        {
+            // Sort the chunks, then merge them two by two
+            SortTask sortTask = { &keys[0], 0 };
+            thread::parallelFor(*builder.pool, 0, count, CHUNK_GRAIN, sortTask);
+            for (std::size_t width = CHUNK_GRAIN; width < count; width *= 2)
+            {
+                sortTask.half = width;
+                thread::parallelFor(*builder.pool, 0, count, 2 * width, sortTask);
+            }
+        }
+        else
+            std::sort(keys.begin(), keys.end());
+
+        codes.resize(count);
+        for (boost::uint32_t i = 0; i < count; ++i)
+        {
+            codes[i] = keys[i].first;
+            builder.order[i] = keys[i].second;
+        }
+    }
+
+    /**
+     * Partition the items [begin, end) of @c order.
+     *
+     * Large ranges get a stable partition, in parallel when there is a
+     * pool: each chunk counts its matching items, a prefix sum gives the
+     * chunks offsets, and the chunks scatter their items to @c scratch.
+     * A stable partition is unique, so the result does not depend on the
+     * chunks. Small ranges use std::partition in both cases.
+     *
+     * @return Position of the first item not matching @c pred.
+     */
+    template<class Predicate>
+    static boost::uint32_t partitionItems(const Builder & builder, boost::uint32_t begin, boost::uint32_t end,
+                                          const Predicate & pred)
+    {
+        if (end - begin <= 2 * CHUNK_GRAIN)
+        {
+            boost::uint32_t * first = &builder.order[0];
+            return static_cast<boost::uint32_t>(std::partition(first + begin, first + end, pred) - first);
+        }
+
+        const std::size_t chunks = chunkCount(builder, begin, end);
+
+        if (chunks == 1)
+        {
+            // Matching items are compacted in place, the others wait in scratch
+            boost::uint32_t mid = begin, right = begin;
+            for (boost::uint32_t i = begin; i < end; ++i)
+            {
+                const boost::uint32_t item = builder.order[i];
+                if (pred(item))
+                    builder.order[mid++] = item;
+                else
+                    builder.scratch[right++] = item;
+            }
+            std::copy(builder.scratch.begin() + begin, builder.scratch.begin() + right,
+                      builder.order.begin() + mid);
+            return mid;
+        }
+
+        std::vector<boost::uint32_t> counts(chunks), leftOffsets(chunks), rightOffsets(chunks);
+        CountTask<Predicate> countTask = { &builder, begin, pred, &counts[0] };
+        forChunks(builder, begin, end, countTask);
+
+        boost::uint32_t mid = begin;
+        for (std::size_t k = 0; k < chunks; ++k)
+            mid += counts[k];
+
+        boost::uint32_t left = begin, right = mid;
+        for (std::size_t k = 0; k < chunks; ++k)
+        {
+            const boost::uint32_t first = begin + static_cast<boost::uint32_t>(k) * CHUNK_GRAIN;
+            const boost::uint32_t size = end - first < CHUNK_GRAIN ? end - first : CHUNK_GRAIN;
+            leftOffsets[k] = left;
+            rightOffsets[k] = right;
+            left += counts[k];
+            right += size - counts[k];
+        }
+
+        ScatterTask<Predicate> scatterTask = { &builder, begin, pred, &leftOffsets[0], &rightOffsets[0] };
+        forChunks(builder, begin, end, scatterTask);
+
+        CopyTask copyTask = { &builder };
+        forChunks(builder, begin, end, copyTask);
+
+        return mid;
+    }
+
+    /**
+     * Move the item of rank @c mid along @c axis to its sorted position,
+     * smaller items before it and larger ones after it.
+     *
+     * Large ranges are narrowed by quickselect steps using partitionItems.
+     * The steps depend only on the range, so the result is the same with
+     * or without a pool.
+     */
+    static void selectItem(const Builder & builder, boost::uint32_t begin, boost::uint32_t end,
+                           boost::uint32_t mid, unsigned axis)
+    {
+        while (end - begin > 2 * CHUNK_GRAIN)
+        {
+            // Median of three
+            const T a = builder.centroid(builder.order[begin])[axis];
+            const T b = builder.centroid(builder.order[begin + (end - begin) / 2])[axis];
+            const T c = builder.centroid(builder.order[end - 1])[axis];
+            const T pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+
+            CentroidBelow below = { builder.centroids, axis, pivot, false };
+            const boost::uint32_t lower = partitionItems(builder, begin, end, below);
+            if (mid < lower)
+            {
+                end = lower;
+                continue;
+            }
+
+            CentroidBelow notAbove = { builder.centroids, axis, pivot, true };
+            const boost::uint32_t upper = partitionItems(builder, lower, end, notAbove);
+            if (mid < upper)
+                return;
+            begin = upper;
+        }
+
+        CentroidLess less = { builder.centroids, axis };
+        std::nth_element(&builder.order[0] + begin, &builder.order[0] + mid, &builder.order[0] + end, less);
+    }
+
+    /**
+     * Compute the bounds of the node for items [begin, end) of @c order,
+     * and choose where to split it.
+     *
+     * @return Position of the split, the node is a leaf if it has no split.
+     */
+    static boost::uint32_t splitNode(const Builder & builder, Node & node,
+                                     boost::uint32_t begin, boost::uint32_t end, unsigned depth)
+    {
+        const boost::uint32_t count = end - begin;
+
+        // Bounds and centroids extent, the split axis is the largest one
+        const std::size_t chunks = chunkCount(builder, begin, end);
+        std::vector<Bin> boxes(2 * chunks);
+        FitTask fitTask = { &builder, begin, &boxes[0], &boxes[chunks] };
+        forChunks(builder, begin, end, fitTask);
+
+        Bin box = boxes[0], centroidBox = boxes[chunks];
+        for (std::size_t k = 1; k < chunks; ++k)
+        {
+            box.grow(boxes[k]);
+            centroidBox.grow(boxes[chunks + k]);
+        }
+
+        for (unsigned c = 0; c < N; ++c)
+        {
+            node.lower[c] = box.lower[c];
+            node.upper[c] = box.upper[c];
+        }
+
+        if (count <= LEAF_SIZE)
+        {
+            node.offset = begin;
+            node.count = count;
+            return end;
+        }
+
+        node.offset = 0;
+        node.count = 0;
+
+        const T * cmin = centroidBox.lower;
+        const T * cmax = centroidBox.upper;
+
+        unsigned axis = 0;
+        for (unsigned c = 1; c < N; ++c)
+            if (cmax[c] - cmin[c] > cmax[axis] - cmin[axis])
+                axis = c;
+
+        boost::uint32_t mid = begin + count / 2;
+        const T extent = cmax[axis] - cmin[axis];
+
+        if (!builder.codes.empty())
+        {
+            // Morton order, split at the highest differing bit
+            const boost::uint64_t * codes = &builder.codes[0];
+            if (depth < SAH_DEPTH && codes[begin] != codes[end - 1])
+            {
+                const unsigned bit = 63 - countLeadingZeros(codes[begin] ^ codes[end - 1]);
+                const boost::uint64_t pivot = (codes[end - 1] >> bit) << bit;
+                mid = static_cast<boost::uint32_t>(std::lower_bound(codes + begin, codes + end, pivot) - codes);
+            }
+        }
+        else if (extent <= static_cast<T>(0))
+        {
+            // All centroids are equal, split in two halves
+        }
+        else if (depth < SAH_DEPTH)
+        {
+            // Binned SAH
+            const T scale = static_cast<T>(BINS) / extent;
+
+            std::vector<Bin> chunkBins(chunks * BINS);
+            BinTask binTask = { &builder, begin, axis, cmin[axis], scale, &chunkBins[0] };
+            forChunks(builder, begin, end, binTask);
+
+            Bin bins[BINS];
+            for (unsigned b = 0; b < BINS; ++b)
+            {
+                bins[b] = chunkBins[b];
+                for (std::size_t k = 1; k < chunks; ++k)
+                    bins[b].grow(chunkBins[k * BINS + b]);
+            }
+
+            // Sweep from the right, then from the left
+            T rightCost[BINS];
+            Bin acc;
+            acc.reset();
+            for (unsigned b = BINS - 1; b > 0; --b)
+            {
+                acc.grow(bins[b]);
+                rightCost[b] = acc.count ? halfArea(acc.lower, acc.upper) * acc.count : static_cast<T>(0);
+            }
+
+            unsigned bestSplit = 0;
+            T bestCost = std::numeric_limits<T>::max();
+            acc.reset();
+            for (unsigned b = 0; b < BINS - 1; ++b)
+            {
+                acc.grow(bins[b]);
+                if (acc.count == 0 || acc.count == count)
+                    continue;
+
+                T cost = halfArea(acc.lower, acc.upper) * acc.count + rightCost[b + 1];
+                if (cost < bestCost)
+                {
+                    bestCost = cost;
+                    bestSplit = b + 1;
+                }
+            }
+
+            if (bestSplit != 0)
+            {
+                BinPredicate pred = { builder.centroids, axis, cmin[axis], scale, bestSplit };
+                mid = partitionItems(builder, begin, end, pred);
+            }
+        }
+        else
+        {
+            // Too deep, split at the median to bound the depth
+            selectItem(builder, begin, end, mid, axis);
+        }
+
+        if (mid == begin || mid == end)
+            mid = begin + count / 2;
+
+        return mid;
+    }
+
+    /**
+     * Recursively build the subtree for items [begin, end) of @c order.
+     *
+     * Inner nodes offsets are relative to the first node of @c nodes.
+     */
+    static void buildNode(const Builder & builder, std::vector<Node> & nodes,
+                          boost::uint32_t begin, boost::uint32_t end, unsigned depth)
+    {
+        const std::size_t index = nodes.size();
+        nodes.push_back(Node());
+
+        const boost::uint32_t mid = splitNode(builder, nodes[index], begin, end, depth);
+        if (nodes[index].isLeaf())
+            return;
+
+        buildNode(builder, nodes, begin, mid, depth + 1);
+        nodes[index].offset = static_cast<boost::uint32_t>(nodes.size());
+        buildNode(builder, nodes, mid, end, depth + 1);
+    }
+
+    struct FragmentTask
+    {
+        const Builder * builder;
+        Fragment * fragment;
+        boost::uint32_t begin;
+        boost::uint32_t end;
+        unsigned depth;
+
+        void operator () () const
+        {
+            buildFragment(*builder, *fragment, begin, end, depth);
+        }
+    };
+
+    /**
+     * Build the subtree for items [begin, end) of @c order, the large
+     * subtrees are split between parallel tasks.
+     */
+    static void buildFragment(const Builder & builder, Fragment & fragment,
+                              boost::uint32_t begin, boost::uint32_t end, unsigned depth)
+    {
+        if (!builder.pool || end - begin <= TASK_GRAIN)
+        {
+            fragment.nodes.reserve(2 * (end - begin));
+            buildNode(builder, fragment.nodes, begin, end, depth);
+            return;
+        }
+
+        Node node;
+        const boost::uint32_t mid = splitNode(builder, node, begin, end, depth);
+        fragment.nodes.push_back(node);
+
+        fragment.left.reset(new Fragment);
+        fragment.right.reset(new Fragment);
+
+        thread::TaskPool::TaskGroup group(*builder.pool);
+        FragmentTask task = { &builder, fragment.left.get(), begin, mid, depth + 1 };
+        group.run(task);
+        buildFragment(builder, *fragment.right, mid, end, depth + 1);
+        group.wait();
+    }
+
+    /**
+     * Copy the nodes of a fragment to their final position.
+     */
+    void flatten(const Fragment & fragment, boost::uint32_t base)
+    {
+        if (!fragment.left)
+        {
+            for (std::size_t i = 0; i < fragment.nodes.size(); ++i)
+            {
+                Node & node = _nodes[base + i];
+                node = fragment.nodes[i];
+                if (!node.isLeaf())
+                    node.offset += base;
+            }
+            return;
+        }
+
+        const boost::uint32_t right = base + 1 + fragment.left->getNodeCount();
+        _nodes[base] = fragment.nodes[0];
+        _nodes[base].offset = right;
+        flatten(*fragment.left, base + 1);
+        flatten(*fragment.right, right);
+    }
+
+    static unsigned binIndex(T centroid, T cmin, T scale)
+    {
+        unsigned b = static_cast<unsigned>((centroid - cmin) * scale);
+        return b < BINS ? b : BINS - 1;
+    }
+
+    struct BinPredicate
+    {
+        const std::vector<T> & centroids;
+        unsigned axis;
+        T cmin;
+        T scale;
+        unsigned split;
+
+        bool operator () (boost::uint32_t item) const
+        {
+            return binIndex(centroids[static_cast<std::size_t>(item) * N + axis], cmin, scale) < split;
+        }
+    };
+
+    struct CentroidBelow
+    {
+        const std::vector<T> & centroids;
+        unsigned axis;
+        T pivot;
+        bool orEqual;
+
+        bool operator () (boost::uint32_t item) const
+        {
+            const T c = centroids[static_cast<std::size_t>(item) * N + axis];
+            return c < pivot || (orEqual && c == pivot);
+        }
+    };
+
+    struct CentroidLess
+    {
+        const std::vector<T> & centroids;
+        unsigned axis;
+
+        bool operator () (boost::uint32_t a, boost::uint32_t b) const
+        {
+            return centroids[static_cast<std::size_t>(a) * N + axis]
+                 < centroids[static_cast<std::size_t>(b) * N + axis];
+        }
+    };
+
+};
+// class Bvh
+
+MW_END_NAMESPACE(math)
+
+#endif // MW_BVH_HPP
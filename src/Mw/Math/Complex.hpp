@@ -8,8 +8,11 @@
 
 #include <Mw/Config.hpp>
 
+#include <Mw/Math/FastMath.hpp>
+
 #include <ostream>
 #include <cmath>
+#include <stdexcept>
 
 #include <boost/serialization/nvp.hpp>
 #include <boost/operators.hpp>
@@ -20,10 +23,12 @@ MW_BEGIN_NAMESPACE(math)
  * Representation of a complex number.
  *
  * @tparam T Scalar type.
+ * @tparam Math Math policy of the polar coordinates, ExactMath or
+ *              FastMath.
  */
-template<class T>
-class Complex : boost::arithmetic<Complex<T> >,
-                boost::equality_comparable<Complex<T> >
+template<class T, class Math = ExactMath>
+class Complex : boost::arithmetic<Complex<T, Math> >,
+                boost::equality_comparable<Complex<T, Math> >
 {
     /**
      * Real part.
@@ -61,8 +66,8 @@ public:
      *
      * @param cpx Complex number to copy.
      */
-    template <typename U>
-    Complex(const Complex<U> & cpx)
+    template <typename U, class M>
+    Complex(const Complex<U, M> & cpx)
         : _a(cpx.getRealPart()), _b(cpx.getImaginaryPart())
     {}
 
@@ -81,12 +86,17 @@ public:
 
     T getRadialCoord() const
     {
-        return std::sqrt(_a * _a + _b * _b);
+        return Math::sqrt(_a * _a + _b * _b);
     }
 
     T getAngularCoord() const
     {
-        return std::atan2(_b, _a);
+        return Math::atan2(_b, _a);
+    }
+
+    Complex getConjugate() const
+    {
+        return Complex(_a, - _b);
     }
 
     void set(T a, T b)
@@ -129,21 +139,45 @@ public:
 
     Complex & operator *= (const Complex & cpx)
     {
-        T teta = getAngularCoord() + cpx.getAngularCoord();
-        T r = getRadialCoord() * cpx.getRadialCoord();
-
-        _a = r * std::cos(teta);
-        _b = r * std::sin(teta);
+        const T a = _a * cpx._a - _b * cpx._b;
+        _b = _a * cpx._b + _b * cpx._a;
+        _a = a;
         return *this;
     }
 
+    /**
+     * Division operator.
+     *
+     * Uses Smith's algorithm: the divisor is scaled by its largest part, so
+     * the intermediate products do not overflow or underflow.
+     *
+     * @param cpx Divisor.
+     * @return
+     * @throw std::domain_error Division by zero
+     */
     Complex & operator /= (const Complex & cpx)
     {
-        T teta = getAngularCoord() - cpx.getAngularCoord();
-        T r = getRadialCoord() / cpx.getRadialCoord();
-
-        _a = r * std::cos(teta);
-        _b = r * std::sin(teta);
+        const T c = cpx._a, d = cpx._b;
+
+        if (c == static_cast<T>(0) && d == static_cast<T>(0))
+            throw std::domain_error("Mw.Math.Complex: Division by zero");
+
+        if (std::abs(c) >= std::abs(d))
+        {
+            const T r = d / c;
+            const T den = c + d * r;
+            const T a = (_a + _b * r) / den;
+            _b = (_b - _a * r) / den;
+            _a = a;
+        }
+        else
+        {
+            const T r = c / d;
+            const T den = c * r + d;
+            const T a = (_a * r + _b) / den;
+            _b = (_b * r - _a) / den;
+            _a = a;
+        }
         return *this;
     }
 
@@ -175,8 +209,8 @@ private:
  * @param vec Complex number to insert into the stream.
  * @return @c ostr Output stream.
  */
-template <typename T>
-std::ostream & operator << (std::ostream & ostr, const Complex<T> & cpx)
+template <typename T, class Math>
+std::ostream & operator << (std::ostream & ostr, const Complex<T, Math> & cpx)
 {
     ostr << "Complex[";
     if (cpx.getRealPart())
@@ -0,0 +1,522 @@
+/**
+ * @file   ComplexArray.hpp
+ * @author Bastien Brunnenstein
+ */
+
+#ifndef MW_COMPLEXARRAY_HPP
+#define MW_COMPLEXARRAY_HPP
+
+#include <Mw/Config.hpp>
+
+#include <Mw/Math/Complex.hpp>
+#include <Mw/Math/FastMath.hpp>
+#include <Mw/Math/Simd.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/align/aligned_allocator.hpp>
+#include <boost/assert.hpp>
+
+MW_BEGIN_NAMESPACE(math)
+
+namespace detail
+{
+
+/**
+ * Kernels over split real and imaginary lanes.
+ *
+ * Outputs may alias the inputs. The generic kernels are plain loops with
+ * the same operations as Complex.
+ *
+ * @tparam T Scalar type.
+ */
+template<typename T>
+struct ComplexLoops
+{
+    static void multiply(const T * ar, const T * ai, const T * br, const T * bi, T * outr, T * outi,
+                         std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            const T r = ar[i] * br[i] - ai[i] * bi[i];
+            const T im = ar[i] * bi[i] + ai[i] * br[i];
+            outr[i] = r;
+            outi[i] = im;
+        }
+    }
+
+    static void multiplyConjugate(const T * ar, const T * ai, const T * br, const T * bi, T * outr, T * outi,
+                                  std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            const T r = ar[i] * br[i] + ai[i] * bi[i];
+            const T im = ai[i] * br[i] - ar[i] * bi[i];
+            outr[i] = r;
+            outi[i] = im;
+        }
+    }
+
+    static void multiplyAdd(const T * ar, const T * ai, const T * br, const T * bi, T * accr, T * acci,
+                            std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            const T r = ar[i] * br[i] - ai[i] * bi[i];
+            const T im = ar[i] * bi[i] + ai[i] * br[i];
+            accr[i] += r;
+            acci[i] += im;
+        }
+    }
+
+    static void getRadialCoords(const T * re, const T * im, T * out, std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+            out[i] = std::sqrt(re[i] * re[i] + im[i] * im[i]);
+    }
+
+    static void getAngularCoords(const T * re, const T * im, T * out, std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+            out[i] = std::atan2(im[i], re[i]);
+    }
+};
+
+/**
+ * Batch kernels of ComplexArray.
+ *
+ * Float gets SSE kernels. Products and magnitudes give the same results as
+ * the generic loops, phases use a polynomial arctangent.
+ *
+ * @tparam T Scalar type.
+ */
+template<typename T>
+struct ComplexKernels : ComplexLoops<T>
+{};
+
+#ifdef MW_SIMD_SSE
+
+template<>
+struct ComplexKernels<float>
+{
+    static void multiply(const float * ar, const float * ai, const float * br, const float * bi,
+                         float * outr, float * outi, std::size_t begin, std::size_t end)
+    {
+        std::size_t i = begin;
+        for (; i + 4 <= end; i += 4)
+        {
+            const __m128 a = _mm_loadu_ps(ar + i), b = _mm_loadu_ps(ai + i);
+            const __m128 c = _mm_loadu_ps(br + i), d = _mm_loadu_ps(bi + i);
+            _mm_storeu_ps(outr + i, _mm_sub_ps(_mm_mul_ps(a, c), _mm_mul_ps(b, d)));
+            _mm_storeu_ps(outi + i, _mm_add_ps(_mm_mul_ps(a, d), _mm_mul_ps(b, c)));
+        }
+        ComplexLoops<float>::multiply(ar, ai, br, bi, outr, outi, i, end);
+    }
+
+    static void multiplyConjugate(const float * ar, const float * ai, const float * br, const float * bi,
+                                  float * outr, float * outi, std::size_t begin, std::size_t end)
+    {
+        std::size_t i = begin;
+        for (; i + 4 <= end; i += 4)
+        {
+            const __m128 a = _mm_loadu_ps(ar + i), b = _mm_loadu_ps(ai + i);
+            const __m128 c = _mm_loadu_ps(br + i), d = _mm_loadu_ps(bi + i);
+            _mm_storeu_ps(outr + i, _mm_add_ps(_mm_mul_ps(a, c), _mm_mul_ps(b, d)));
+            _mm_storeu_ps(outi + i, _mm_sub_ps(_mm_mul_ps(b, c), _mm_mul_ps(a, d)));
+        }
+        ComplexLoops<float>::multiplyConjugate(ar, ai, br, bi, outr, outi, i, end);
+    }
+
+    static void multiplyAdd(const float * ar, const float * ai, const float * br, const float * bi,
+                            float * accr, float * acci, std::size_t begin, std::size_t end)
+    {
+        std::size_t i = begin;
+        for (; i + 4 <= end; i += 4)
+        {
+            const __m128 a = _mm_loadu_ps(ar + i), b = _mm_loadu_ps(ai + i);
+            const __m128 c = _mm_loadu_ps(br + i), d = _mm_loadu_ps(bi + i);
+            const __m128 r = _mm_sub_ps(_mm_mul_ps(a, c), _mm_mul_ps(b, d));
+            const __m128 im = _mm_add_ps(_mm_mul_ps(a, d), _mm_mul_ps(b, c));
+            _mm_storeu_ps(accr + i, _mm_add_ps(_mm_loadu_ps(accr + i), r));
+            _mm_storeu_ps(acci + i, _mm_add_ps(_mm_loadu_ps(acci + i), im));
+        }
+        ComplexLoops<float>::multiplyAdd(ar, ai, br, bi, accr, acci, i, end);
+    }
+
+    static void getRadialCoords(const float * re, const float * im, float * out,
+                                std::size_t begin, std::size_t end)
+    {
+        std::size_t i = begin;
+        for (; i + 4 <= end; i += 4)
+        {
+            const __m128 a = _mm_loadu_ps(re + i), b = _mm_loadu_ps(im + i);
+            _mm_storeu_ps(out + i, _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(a, a), _mm_mul_ps(b, b))));
+        }
+        ComplexLoops<float>::getRadialCoords(re, im, out, i, end);
+    }
+
+    static void getAngularCoords(const float * re, const float * im, float * out,
+                                 std::size_t begin, std::size_t end)
+    {
+        std::size_t i = begin;
+        for (; i + 4 <= end; i += 4)
+            _mm_storeu_ps(out + i, FastMath<FAST_MATH_HIGH>::atan2(_mm_loadu_ps(im + i), _mm_loadu_ps(re + i)));
+        ComplexLoops<float>::getAngularCoords(re, im, out, i, end);
+    }
+};
+
+#endif // MW_SIMD_SSE
+
+} // namespace detail
+
+
+/**
+ * Array of complex numbers stored as a structure of arrays.
+ *
+ * Real and imaginary parts are stored in their own contiguous and aligned
+ * lanes, so the batch kernels can process several numbers per SIMD
+ * instruction.
+ *
+ * @tparam T Scalar type.
+ */
+template<typename T>
+class ComplexArray
+{
+public:
+
+    /**
+     * Aligned storage of a lane.
+     */
+    typedef std::vector<T, boost::alignment::aligned_allocator<T, MW_SIMD_ALIGNMENT> > Lane;
+
+private:
+
+    /**
+     * Real parts.
+     */
+    Lane _real;
+
+    /**
+     * Imaginary parts.
+     */
+    Lane _imaginary;
+
+public:
+
+    // Constructors
+
+    /**
+     * Default constructor.
+     *
+     * The array is empty.
+     */
+    ComplexArray()
+    {}
+
+    /**
+     * Constructor.
+     *
+     * @param size Number of null complex numbers in the array.
+     */
+    explicit ComplexArray(std::size_t size)
+    {
+        resize(size);
+    }
+
+    /**
+     * Range constructor.
+     *
+     * Convert a range of Complex (array of structures) into this layout.
+     *
+     * @param first Beginning of the range.
+     * @param last End of the range.
+     */
+    template<class InputIterator>
+    ComplexArray(InputIterator first, InputIterator last)
+    {
+        assign(first, last);
+    }
+
+
+    // Getters / setters
+
+    /**
+     * Get the number of complex numbers in the array.
+     *
+     * @return Number of complex numbers.
+     */
+    std::size_t size() const
+    {
+        return _real.size();
+    }
+
+    /**
+     * Check if the array is empty.
+     *
+     * @return @c true if the array has no complex numbers.
+     */
+    bool empty() const
+    {
+        return _real.empty();
+    }
+
+    /**
+     * Change the number of complex numbers in the array.
+     *
+     * New complex numbers are null.
+     *
+     * @param size New number of complex numbers.
+     */
+    void resize(std::size_t size)
+    {
+        _real.resize(size, static_cast<T>(0));
+        _imaginary.resize(size, static_cast<T>(0));
+    }
+
+    /**
+     * Reserve memory for a number of complex numbers.
+     *
+     * @param capacity Number of complex numbers.
+     */
+    void reserve(std::size_t capacity)
+    {
+        _real.reserve(capacity);
+        _imaginary.reserve(capacity);
+    }
+
+    /**
+     * Remove all the complex numbers.
+     */
+    void clear()
+    {
+        _real.clear();
+        _imaginary.clear();
+    }
+
+    /**
+     * Append a complex number at the end of the array.
+     *
+     * @param cpx Complex number to append.
+     */
+    void push_back(const Complex<T> & cpx)
+    {
+        _real.push_back(cpx.getRealPart());
+        _imaginary.push_back(cpx.getImaginaryPart());
+    }
+
+    /**
+     * Get the lane of the real parts.
+     *
+     * @return Pointer to the first real part.
+     */
+    T * realLane()
+    {
+        return _real.empty() ? NULL : &_real[0];
+    }
+
+    /**
+     * Get the lane of the real parts.
+     *
+     * @return Pointer to the first real part.
+     */
+    const T * realLane() const
+    {
+        return _real.empty() ? NULL : &_real[0];
+    }
+
+    /**
+     * Get the lane of the imaginary parts.
+     *
+     * @return Pointer to the first imaginary part.
+     */
+    T * imaginaryLane()
+    {
+        return _imaginary.empty() ? NULL : &_imaginary[0];
+    }
+
+    /**
+     * Get the lane of the imaginary parts.
+     *
+     * @return Pointer to the first imaginary part.
+     */
+    const T * imaginaryLane() const
+    {
+        return _imaginary.empty() ? NULL : &_imaginary[0];
+    }
+
+    /**
+     * Get a complex number.
+     *
+     * @param index Complex number's index.
+     * @return Copy of the complex number at position @c index.
+     */
+    Complex<T> get(std::size_t index) const
+    {
+        if (index >= size())
+            throw std::out_of_range("Mw.Math.ComplexArray: Out of range");
+
+        return (*this)[index];
+    }
+
+    /**
+     * Set a complex number.
+     *
+     * @param index Complex number's index.
+     * @param cpx New value.
+     */
+    void set(std::size_t index, const Complex<T> & cpx)
+    {
+        if (index >= size())
+            throw std::out_of_range("Mw.Math.ComplexArray: Out of range");
+
+        _real[index] = cpx.getRealPart();
+        _imaginary[index] = cpx.getImaginaryPart();
+    }
+
+    /**
+     * Access a complex number without bounds checking.
+     *
+     * @param index Complex number's index, must be lower than size().
+     * @return Copy of the complex number at position @c index.
+     */
+    Complex<T> operator [] (std::size_t index) const
+    {
+        BOOST_ASSERT_MSG(index < size(), "Mw.Math.ComplexArray: Out of range");
+
+        return Complex<T>(_real[index], _imaginary[index]);
+    }
+
+
+    // Conversions
+
+    /**
+     * Replace the content of the array by a range of Complex.
+     *
+     * @param first Beginning of the range.
+     * @param last End of the range.
+     */
+    template<class InputIterator>
+    void assign(InputIterator first, InputIterator last)
+    {
+        clear();
+        for (; first != last; ++first)
+            push_back(*first);
+    }
+
+    /**
+     * Copy the complex numbers to a range of Complex (array of structures).
+     *
+     * @param out Beginning of the output range.
+     * @return End of the output range.
+     */
+    template<class OutputIterator>
+    OutputIterator copyTo(OutputIterator out) const
+    {
+        const std::size_t count = size();
+        for (std::size_t i = 0; i < count; ++i, ++out)
+            *out = (*this)[i];
+
+        return out;
+    }
+
+};
+// class ComplexArray
+
+
+/**
+ * Multiply the complex numbers of two arrays, one by one.
+ *
+ * @param first First operands.
+ * @param second Second operands, same size as @c first.
+ * @param out Products, may be @c first or @c second.
+ */
+template<typename T>
+void multiply(const ComplexArray<T> & first, const ComplexArray<T> & second, ComplexArray<T> & out)
+{
+    BOOST_ASSERT(first.size() == second.size());
+
+    const std::size_t count = first.size();
+    out.resize(count);
+    detail::ComplexKernels<T>::multiply(first.realLane(), first.imaginaryLane(),
+                                        second.realLane(), second.imaginaryLane(),
+                                        out.realLane(), out.imaginaryLane(), 0, count);
+}
+
+/**
+ * Multiply the complex numbers of an array by the conjugates of another
+ * array, one by one.
+ *
+ * This is the product used by correlations and cross spectra.
+ *
+ * @param first First operands.
+ * @param second Operands to conjugate, same size as @c first.
+ * @param out Products <tt>first * conj(second)</tt>, may be @c first or
+ *            @c second.
+ */
+template<typename T>
+void multiplyConjugate(const ComplexArray<T> & first, const ComplexArray<T> & second, ComplexArray<T> & out)
+{
+    BOOST_ASSERT(first.size() == second.size());
+
+    const std::size_t count = first.size();
+    out.resize(count);
+    detail::ComplexKernels<T>::multiplyConjugate(first.realLane(), first.imaginaryLane(),
+                                                 second.realLane(), second.imaginaryLane(),
+                                                 out.realLane(), out.imaginaryLane(), 0, count);
+}
+
+/**
+ * Accumulate the products of the complex numbers of two arrays.
+ *
+ * @param first First operands.
+ * @param second Second operands, same size as @c first.
+ * @param acc Accumulators, same size as @c first, receive
+ *            <tt>acc + first * second</tt>.
+ */
+template<typename T>
+void multiplyAdd(const ComplexArray<T> & first, const ComplexArray<T> & second, ComplexArray<T> & acc)
+{
+    BOOST_ASSERT(first.size() == second.size());
+    BOOST_ASSERT(first.size() == acc.size());
+
+    detail::ComplexKernels<T>::multiplyAdd(first.realLane(), first.imaginaryLane(),
+                                           second.realLane(), second.imaginaryLane(),
+                                           acc.realLane(), acc.imaginaryLane(), 0, first.size());
+}
+
+/**
+ * Compute the magnitude of each complex number of an array.
+ *
+ * @param array Array of complex numbers.
+ * @param out Output, one value per complex number of @c array.
+ * @see Complex::getRadialCoord
+ */
+template<typename T>
+void getRadialCoords(const ComplexArray<T> & array, T * out)
+{
+    detail::ComplexKernels<T>::getRadialCoords(array.realLane(), array.imaginaryLane(), out, 0, array.size());
+}
+
+/**
+ * Compute the phase of each complex number of an array.
+ *
+ * The float SIMD kernel uses a polynomial arctangent, within 3 ulps of
+ * Complex::getAngularCoord for finite values.
+ *
+ * @param array Array of complex numbers.
+ * @param out Output, one value per complex number of @c array, in
+ *            [-pi, pi].
+ * @see Complex::getAngularCoord
+ */
+template<typename T>
+void getAngularCoords(const ComplexArray<T> & array, T * out)
+{
+    detail::ComplexKernels<T>::getAngularCoords(array.realLane(), array.imaginaryLane(), out, 0, array.size());
+}
+
+MW_END_NAMESPACE(math)
+
+#endif // MW_COMPLEXARRAY_HPP
@@ -0,0 +1,451 @@
+/**
+ * @file   Convolution.hpp
+ * @author Bastien Brunnenstein
+ *
+ * @details Convolution and correlation of real signals through FFTs.
+ *
+ * convolve() and correlate() transform whole signals at once. The
+ * OverlapAddFilter and OverlapSaveFilter classes filter streams block by
+ * block, with memory bounded by the kernel size.
+ */
+
+#ifndef MW_CONVOLUTION_HPP
+#define MW_CONVOLUTION_HPP
+
+#include <Mw/Config.hpp>
+
+#include <Mw/Math/ComplexArray.hpp>
+#include <Mw/Math/Fft.hpp>
+#include <Mw/Math/RealFft.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+
+#include <boost/shared_ptr.hpp>
+
+MW_BEGIN_NAMESPACE(math)
+
+namespace detail
+{
+
+/**
+ * Even transform size for circular convolutions of @c size values.
+ */
+inline std::size_t getConvolutionSize(std::size_t size)
+{
+    return 2 * getFastFftSize((size + 1) / 2);
+}
+
+/**
+ * Linear convolution, or correlation, of two signals with one FFT size.
+ */
+template<typename T>
+void convolveSignals(const T * first, std::size_t firstSize, const T * second, std::size_t secondSize,
+                     T * out, bool correlation)
+{
+    if (firstSize == 0 || secondSize == 0)
+        throw std::invalid_argument("Mw.Math.Convolution: Signals must not be empty");
+
+    const std::size_t outSize = firstSize + secondSize - 1;
+    const boost::shared_ptr<const RealFftPlan<T> > plan =
+            RealFftPlan<T>::get(getConvolutionSize(outSize));
+
+    const std::size_t size = plan->size();
+    const std::size_t spectrum = plan->getSpectrumSize();
+
+    typename RealFftPlan<T>::Lane padded(size), workRe(plan->getWorkSize()), workIm(plan->getWorkSize());
+    typename RealFftPlan<T>::Lane aRe(spectrum), aIm(spectrum), bRe(spectrum), bIm(spectrum);
+
+    std::copy(first, first + firstSize, padded.begin());
+    plan->transform(&padded[0], &aRe[0], &aIm[0], &workRe[0], &workIm[0]);
+
+    std::fill(padded.begin(), padded.end(), static_cast<T>(0));
+    std::copy(second, second + secondSize, padded.begin());
+    plan->transform(&padded[0], &bRe[0], &bIm[0], &workRe[0], &workIm[0]);
+
+    // The product with the conjugate gives the circular correlation,
+    // negative lags at the end
+    if (correlation)
+        ComplexKernels<T>::multiplyConjugate(&aRe[0], &aIm[0], &bRe[0], &bIm[0], &aRe[0], &aIm[0], 0, spectrum);
+    else
+        ComplexKernels<T>::multiply(&aRe[0], &aIm[0], &bRe[0], &bIm[0], &aRe[0], &aIm[0], 0, spectrum);
+
+    plan->inverseTransform(&aRe[0], &aIm[0], &padded[0], &workRe[0], &workIm[0]);
+
+    const T factor = static_cast<T>(1) / static_cast<T>(size);
+    for (std::size_t j = 0; j < outSize; ++j)
+    {
+        const std::size_t index = correlation ? (j + size - (secondSize - 1)) % size : j;
+        out[j] = padded[index] * factor;
+    }
+}
+
+/**
+ * Circular convolution with a fixed kernel, for the block filters.
+ */
+template<typename T>
+class FftFilter
+{
+public:
+
+    typedef typename RealFftPlan<T>::Lane Lane;
+
+private:
+
+    boost::shared_ptr<const RealFftPlan<T> > _plan;
+
+    /**
+     * Spectrum of the kernel, divided by the transform size.
+     */
+    Lane _kernelRe, _kernelIm;
+
+    mutable Lane _spectrumRe, _spectrumIm;
+    mutable Lane _workRe, _workIm;
+
+public:
+
+    FftFilter(const T * kernel, std::size_t kernelSize, std::size_t size)
+        : _plan(RealFftPlan<T>::get(size)),
+          _kernelRe(_plan->getSpectrumSize()), _kernelIm(_plan->getSpectrumSize()),
+          _spectrumRe(_plan->getSpectrumSize()), _spectrumIm(_plan->getSpectrumSize()),
+          _workRe(_plan->getWorkSize()), _workIm(_plan->getWorkSize())
+    {
+        Lane padded(size);
+        std::copy(kernel, kernel + kernelSize, padded.begin());
+        _plan->transform(&padded[0], &_kernelRe[0], &_kernelIm[0], &_workRe[0], &_workIm[0]);
+
+        const T factor = static_cast<T>(1) / static_cast<T>(size);
+        for (std::size_t k = 0; k < _kernelRe.size(); ++k)
+        {
+            _kernelRe[k] *= factor;
+            _kernelIm[k] *= factor;
+        }
+    }
+
+    std::size_t size() const
+    {
+        return _plan->size();
+    }
+
+    /**
+     * Convolve size() values, @c out may be @c in.
+     */
+    void apply(const T * in, T * out) const
+    {
+        _plan->transform(in, &_spectrumRe[0], &_spectrumIm[0], &_workRe[0], &_workIm[0]);
+        ComplexKernels<T>::multiply(&_spectrumRe[0], &_spectrumIm[0], &_kernelRe[0], &_kernelIm[0],
+                                    &_spectrumRe[0], &_spectrumIm[0], 0, _spectrumRe.size());
+        _plan->inverseTransform(&_spectrumRe[0], &_spectrumIm[0], out, &_workRe[0], &_workIm[0]);
+    }
+};
+
+/**
+ * Transform size of a block filter.
+ */
+inline std::size_t getBlockFilterSize(std::size_t kernelSize, std::size_t blockSize)
+{
+    if (kernelSize == 0)
+        throw std::invalid_argument("Mw.Math.Convolution: Kernel must not be empty");
+
+    // About 4 times the kernel by default, a good balance between the
+    // cost of the transforms and the number of blocks
+    if (blockSize == 0)
+        return getConvolutionSize(std::max<std::size_t>(4 * kernelSize, 64));
+    return getConvolutionSize(blockSize + kernelSize - 1);
+}
+
+} // namespace detail
+
+
+/**
+ * Compute the linear convolution of two real signals.
+ *
+ * <tt>out[j] = sum first[n] * second[j - n]</tt>.
+ *
+ * @param first First signal.
+ * @param firstSize Number of samples of @c first.
+ * @param second Second signal.
+ * @param secondSize Number of samples of @c second.
+ * @param out Convolution, <tt>firstSize + secondSize - 1</tt> values.
+ * @throw std::invalid_argument if a signal is empty.
+ */
+template<typename T>
+void convolve(const T * first, std::size_t firstSize, const T * second, std::size_t secondSize, T * out)
+{
+    detail::convolveSignals(first, firstSize, second, secondSize, out, false);
+}
+
+/**
+ * Compute the cross-correlation of two real signals.
+ *
+ * <tt>out[j] = sum signal[n + j - (kernelSize - 1)] * kernel[n]</tt>, the
+ * first value is the correlation at lag <tt>1 - kernelSize</tt>.
+ *
+ * @param signal Signal.
+ * @param signalSize Number of samples of @c signal.
+ * @param kernel Kernel, searched in the signal.
+ * @param kernelSize Number of samples of @c kernel.
+ * @param out Correlation, <tt>signalSize + kernelSize - 1</tt> values.
+ * @throw std::invalid_argument if a signal is empty.
+ */
+template<typename T>
+void correlate(const T * signal, std::size_t signalSize, const T * kernel, std::size_t kernelSize, T * out)
+{
+    detail::convolveSignals(signal, signalSize, kernel, kernelSize, out, true);
+}
+
+
+/**
+ * Streaming FIR filter using the overlap-add method.
+ *
+ * Each block is convolved with the kernel, the last <tt>kernelSize - 1</tt>
+ * values of the convolution are added to the next blocks. The output is
+ * the convolution of the stream with the kernel, without delay.
+ *
+ * @tparam T Scalar type.
+ */
+template<typename T>
+class OverlapAddFilter
+{
+public:
+
+    typedef typename detail::FftFilter<T>::Lane Lane;
+
+private:
+
+    detail::FftFilter<T> _filter;
+
+    std::size_t _blockSize;
+
+    /**
+     * Tail of the previous blocks.
+     */
+    Lane _overlap;
+
+    Lane _block;
+
+public:
+
+    // Constructors
+
+    /**
+     * Constructor.
+     *
+     * @param kernel Impulse response of the filter.
+     * @param kernelSize Number of samples of @c kernel.
+     * @param blockSize Number of samples per block, 0 to use a size fitted
+     *                  to the kernel.
+     * @throw std::invalid_argument if the kernel is empty.
+     */
+    OverlapAddFilter(const T * kernel, std::size_t kernelSize, std::size_t blockSize = 0)
+        : _filter(kernel, kernelSize, detail::getBlockFilterSize(kernelSize, blockSize)),
+          _blockSize(blockSize ? blockSize : _filter.size() - kernelSize + 1),
+          _overlap(kernelSize - 1), _block(_filter.size())
+    {}
+
+
+    // Getters
+
+    /**
+     * Get the number of samples processed at once.
+     *
+     * @return Block size.
+     */
+    std::size_t getBlockSize() const
+    {
+        return _blockSize;
+    }
+
+    /**
+     * Get the number of samples of the kernel.
+     *
+     * @return Kernel size.
+     */
+    std::size_t getKernelSize() const
+    {
+        return _overlap.size() + 1;
+    }
+
+
+    // Filtering
+
+    /**
+     * Filter one block.
+     *
+     * @param in getBlockSize() samples of the stream.
+     * @param out getBlockSize() filtered samples, may be @c in.
+     */
+    void process(const T * in, T * out)
+    {
+        const std::size_t overlap = _overlap.size();
+
+        std::copy(in, in + _blockSize, _block.begin());
+        std::fill(_block.begin() + _blockSize, _block.end(), static_cast<T>(0));
+        _filter.apply(&_block[0], &_block[0]);
+
+        for (std::size_t i = 0; i < _blockSize; ++i)
+            out[i] = i < overlap ? _block[i] + _overlap[i] : _block[i];
+
+        for (std::size_t i = 0; i < overlap; ++i)
+            _overlap[i] = i + _blockSize < overlap ? _block[i + _blockSize] + _overlap[i + _blockSize]
+                                                   : _block[i + _blockSize];
+    }
+
+    /**
+     * Filter consecutive blocks.
+     *
+     * @param in Samples of the stream.
+     * @param count Number of samples, a multiple of getBlockSize().
+     * @param out Filtered samples, may be @c in.
+     * @throw std::invalid_argument if @c count is not a multiple of
+     *        getBlockSize().
+     */
+    void process(const T * in, std::size_t count, T * out)
+    {
+        if (count % _blockSize)
+            throw std::invalid_argument("Mw.Math.OverlapAddFilter: Count is not a multiple of the block size");
+
+        for (std::size_t i = 0; i < count; i += _blockSize)
+            process(in + i, out + i);
+    }
+
+    /**
+     * Forget the previous blocks.
+     */
+    void reset()
+    {
+        std::fill(_overlap.begin(), _overlap.end(), static_cast<T>(0));
+    }
+
+};
+// class OverlapAddFilter
+
+
+/**
+ * Streaming FIR filter using the overlap-save method.
+ *
+ * Each block is convolved with the kernel along with the previous samples
+ * of the stream, the values corrupted by the circular convolution are
+ * dropped. The output is the convolution of the stream with the kernel,
+ * without delay.
+ *
+ * @tparam T Scalar type.
+ */
+template<typename T>
+class OverlapSaveFilter
+{
+public:
+
+    typedef typename detail::FftFilter<T>::Lane Lane;
+
+private:
+
+    detail::FftFilter<T> _filter;
+
+    std::size_t _kernelSize;
+
+    std::size_t _blockSize;
+
+    /**
+     * Previous samples of the stream, then the current block.
+     */
+    Lane _history;
+
+    Lane _block;
+
+public:
+
+    // Constructors
+
+    /**
+     * Constructor.
+     *
+     * @param kernel Impulse response of the filter.
+     * @param kernelSize Number of samples of @c kernel.
+     * @param blockSize Number of samples per block, 0 to use a size fitted
+     *                  to the kernel.
+     * @throw std::invalid_argument if the kernel is empty.
+     */
+    OverlapSaveFilter(const T * kernel, std::size_t kernelSize, std::size_t blockSize = 0)
+        : _filter(kernel, kernelSize, detail::getBlockFilterSize(kernelSize, blockSize)),
+          _kernelSize(kernelSize),
+          _blockSize(blockSize ? blockSize : _filter.size() - kernelSize + 1),
+          _history(_filter.size()), _block(_filter.size())
+    {}
+
+
+    // Getters
+
+    /**
+     * Get the number of samples processed at once.
+     *
+     * @return Block size.
+     */
+    std::size_t getBlockSize() const
+    {
+        return _blockSize;
+    }
+
+    /**
+     * Get the number of samples of the kernel.
+     *
+     * @return Kernel size.
+     */
+    std::size_t getKernelSize() const
+    {
+        return _kernelSize;
+    }
+
+
+    // Filtering
+
+    /**
+     * Filter one block.
+     *
+     * @param in getBlockSize() samples of the stream.
+     * @param out getBlockSize() filtered samples, may be @c in.
+     */
+    void process(const T * in, T * out)
+    {
+        const std::size_t saved = _history.size() - _blockSize;
+
+        std::copy(in, in + _blockSize, _history.begin() + saved);
+        _filter.apply(&_history[0], &_block[0]);
+
+        std::copy(_block.begin() + saved, _block.end(), out);
+        std::copy(_history.begin() + _blockSize, _history.end(), _history.begin());
+    }
+
+    /**
+     * Filter consecutive blocks.
+     *
+     * @param in Samples of the stream.
+     * @param count Number of samples, a multiple of getBlockSize().
+     * @param out Filtered samples, may be @c in.
+     * @throw std::invalid_argument if @c count is not a multiple of
+     *        getBlockSize().
+     */
+    void process(const T * in, std::size_t count, T * out)
+    {
+        if (count % _blockSize)
+            throw std::invalid_argument("Mw.Math.OverlapSaveFilter: Count is not a multiple of the block size");
+
+        for (std::size_t i = 0; i < count; i += _blockSize)
+            process(in + i, out + i);
+    }
+
+    /**
+     * Forget the previous blocks.
+     */
+    void reset()
+    {
+        std::fill(_history.begin(), _history.end(), static_cast<T>(0));
+    }
+
+};
+// class OverlapSaveFilter
+
+MW_END_NAMESPACE(math)
+
+#endif // MW_CONVOLUTION_HPP
@@ -0,0 +1,272 @@
+/**
+ * @file   CubicStepper.hpp
+ * @author Bastien Brunnenstein
+ *
+ * @details Evaluation of cubic and catmull-rom interpolations at evenly
+ * spaced positions, by forward differencing.
+ *
+ * The third difference of a cubic polynomial is constant, so each value
+ * after the first is three additions away from the previous one. The sums
+ * accumulate rounding errors, the differences are recomputed from the
+ * polynomial at a fixed interval to bound them.
+ */
+
+#ifndef MW_CUBICSTEPPER_HPP
+#define MW_CUBICSTEPPER_HPP
+
+#include <Mw/Config.hpp>
+
+#include <Mw/Math/Spline.hpp>
+
+#include <cstddef>
+
+#include <boost/assert.hpp>
+
+MW_BEGIN_NAMESPACE(math)
+
+/**
+ * Values of a cubic or catmull-rom interpolation at evenly spaced positions.
+ *
+ * The position @c mu of the value @c k is <tt>start + k * step</tt>,
+ * positions out of [0, 1] extrapolate the polynomial.
+ *
+ * @tparam T Value's type, a scalar or a Vector.
+ * @tparam U Scalar type, the scalar type of @a T by default.
+ */
+template<class T, typename U = typename detail::SplinePoint<T>::Scalar>
+class CubicStepper
+{
+    detail::CubicSegment<T> _polynomial;
+
+    U _start;
+    U _step;
+
+    /**
+     * Value and forward differences at the current position.
+     */
+    T _value, _d1, _d2, _d3;
+
+    std::size_t _index;
+
+    unsigned _interval;
+    unsigned _countdown;
+
+public:
+
+    // Constructors
+
+    /**
+     * Constructor.
+     *
+     * @param p0 Point before first sample.
+     * @param p1 First sample.
+     * @param p2 Second sample.
+     * @param p3 Point after second sample.
+     * @param type SPLINE_CUBIC as cubicInterpolate(), SPLINE_CATMULL_ROM as
+     *             catmullRomInterpolate().
+     * @param step Distance between the positions.
+     * @param start Position of the first value.
+     * @param interval Number of steps between two synchronizations with the
+     *                 polynomial, 0 to never synchronize.
+     */
+    CubicStepper(const T & p0, const T & p1, const T & p2, const T & p3, SplineType type,
+                 U step, U start = static_cast<U>(0), unsigned interval = 64)
+        : _polynomial(p0, p1, p2, p3, type, step), _start(start), _step(step),
+          _index(0), _interval(interval), _countdown(interval)
+    {
+        initialize();
+    }
+
+    /**
+     * Constructor.
+     *
+     * @param segment Polynomial of a Spline segment.
+     * @param step Distance between the positions.
+     * @param start Position of the first value.
+     * @param interval Number of steps between two synchronizations with the
+     *                 polynomial, 0 to never synchronize.
+     */
+    CubicStepper(const detail::CubicSegment<T> & segment, U step, U start = static_cast<U>(0),
+                 unsigned interval = 64)
+        : _polynomial(segment), _start(start), _step(step),
+          _index(0), _interval(interval), _countdown(interval)
+    {
+        initialize();
+    }
+
+
+    // Getters
+
+    /**
+     * Get the current value.
+     */
+    const T & get() const
+    {
+        return _value;
+    }
+
+    /**
+     * Get the position of the current value.
+     */
+    U getPosition() const
+    {
+        return _start + static_cast<U>(_index) * _step;
+    }
+
+    /**
+     * Get the index of the current value.
+     */
+    std::size_t getIndex() const
+    {
+        return _index;
+    }
+
+
+    // Stepping
+
+    /**
+     * Step to the next value.
+     */
+    void next()
+    {
+        ++_index;
+        if (_countdown == 1)
+        {
+            _countdown = _interval;
+            synchronize();
+            return;
+        }
+        // Still 0 when never synchronized
+        _countdown -= _countdown ? 1 : 0;
+
+        _value += _d1;
+        _d1 += _d2;
+        _d2 += _d3;
+    }
+
+    /**
+     * Write the current value and the next ones.
+     *
+     * The stepper ends on the value after the last one written.
+     *
+     * @param out Values.
+     * @param count Number of values.
+     */
+    void fill(T * out, std::size_t count)
+    {
+        while (count > 0)
+        {
+            // Values before the next synchronization
+            const std::size_t run = (_countdown == 0 || _countdown > count) ? count : _countdown - 1;
+            advance(out, run);
+            out += run;
+            count -= run;
+            _index += run;
+            _countdown -= _countdown ? static_cast<unsigned>(run) : 0;
+
+            if (count > 0)
+            {
+                *out++ = _value;
+                --count;
+                next();
+            }
+        }
+    }
+
+    /**
+     * Jump to a value.
+     *
+     * @param index Index of the value.
+     */
+    void seek(std::size_t index)
+    {
+        _index = index;
+        _countdown = _interval;
+        synchronize();
+    }
+
+private:
+
+    /**
+     * Write the current value and step by additions, @a count times.
+     *
+     * The state is copied to locals so it stays in registers, stepping the
+     * members directly makes the compiler spill it at every step.
+     */
+    void advance(T * out, std::size_t count)
+    {
+        T value = _value, d1 = _d1, d2 = _d2;
+        const T d3 = _d3;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            out[i] = value;
+            value += d1;
+            d1 += d2;
+            d2 += d3;
+        }
+        _value = value;
+        _d1 = d1;
+        _d2 = d2;
+    }
+
+    void initialize()
+    {
+        // The third difference never changes
+        const U h3 = _step * _step * _step;
+        _d3 = _polynomial.c3 * (static_cast<U>(6) * h3);
+
+        synchronize();
+    }
+
+    /**
+     * Compute the value and differences at the current position from the
+     * polynomial.
+     */
+    void synchronize()
+    {
+        const U x = getPosition(), h = _step;
+        const U h2 = h * h;
+        const U h3 = h2 * h;
+
+        const detail::CubicSegment<T> & p = _polynomial;
+        _value = p.evaluate(x);
+
+        // f(x + h) - f(x), and the difference of that
+        _d1 = p.c3 * (static_cast<U>(3) * x * x * h + static_cast<U>(3) * x * h2 + h3)
+            + p.c2 * (static_cast<U>(2) * x * h + h2) + p.c1 * h;
+        _d2 = p.c3 * (static_cast<U>(6) * x * h2 + static_cast<U>(6) * h3) + p.c2 * (static_cast<U>(2) * h2);
+    }
+
+};
+// class CubicStepper
+
+
+/**
+ * Compute points of a curve at evenly spaced parameters, by forward
+ * differencing.
+ *
+ * @param spline Curve.
+ * @param out Points, <tt>steps * spline.getEnd() + 1</tt> of them, from the
+ *            start to the end of the curve.
+ * @param steps Number of points per segment, at least 1.
+ */
+template<class T, typename U>
+void tessellate(const Spline<T, U> & spline, T * out, unsigned steps)
+{
+    BOOST_ASSERT(steps > 0);
+
+    typedef typename Spline<T, U>::SegmentArray Segments;
+    const Segments & segments = spline.getSegments();
+
+    const U step = static_cast<U>(1) / static_cast<U>(steps);
+    for (std::size_t i = 0; i < segments.size(); ++i)
+    {
+        CubicStepper<T, U> stepper(segments[i], step);
+        stepper.fill(out + i * steps, steps);
+    }
+    out[segments.size() * steps] = segments.back().evaluate(static_cast<U>(1));
+}
+
+MW_END_NAMESPACE(math)
+
+#endif // MW_CUBICSTEPPER_HPP
@@ -0,0 +1,490 @@
+/**
+ * @file   FastMath.hpp
+ * @author Bastien Brunnenstein
+ *
+ * @details Math policies for the templates evaluating trigonometric
+ * functions and square roots.
+ *
+ * ExactMath calls the standard library. FastMath evaluates minimax
+ * polynomials and refined reciprocal square root estimates, with an
+ * accuracy tier selected by a template parameter. Both have scalar
+ * versions, for any floating point type, and SSE versions on 4 floats.
+ *
+ * Maximum errors of the FastMath tiers, measured with float against
+ * double results, for x in [-1000, 1000]:
+ *
+ * Tier                | cos / sin | atan2  | sqrt / rsqrt (relative)
+ * ------------------- | --------- | ------ | -----------------------
+ * FAST_MATH_LOW       | 2.8e-4    | 1.1e-3 | 1.8e-3
+ * FAST_MATH_MEDIUM    | 1.1e-5    | 7.3e-6 | 5e-6
+ * FAST_MATH_HIGH      | 8.3e-8    | 2.8e-7 | 1.9e-7
+ *
+ * The float results of the standard library are within 3.3e-8, 2.5e-7 and
+ * 9e-8 on the same inputs. cos and sin are reduced to [-pi/4, pi/4] with
+ * pi/2 in 3 parts. Errors are absolute, doubles get the accuracy of the
+ * tier, not the accuracy of a double.
+ */
+
+#ifndef MW_FASTMATH_HPP
+#define MW_FASTMATH_HPP
+
+#include <Mw/Config.hpp>
+
+#include <Mw/Math/Simd.hpp>
+
+#include <cmath>
+#include <cstring>
+
+#include <boost/cstdint.hpp>
+
+MW_BEGIN_NAMESPACE(math)
+
+/**
+ * Math policy calling the standard library.
+ */
+struct ExactMath
+{
+    template<typename T>
+    static T cos(T x)
+    {
+        return std::cos(x);
+    }
+
+    template<typename T>
+    static T sin(T x)
+    {
+        return std::sin(x);
+    }
+
+    template<typename T>
+    static T atan2(T y, T x)
+    {
+        return std::atan2(y, x);
+    }
+
+    template<typename T>
+    static T sqrt(T x)
+    {
+        return std::sqrt(x);
+    }
+
+    template<typename T>
+    static T rsqrt(T x)
+    {
+        return static_cast<T>(1) / std::sqrt(x);
+    }
+
+#ifdef MW_SIMD_SSE
+
+    static __m128 cos(__m128 x)
+    {
+        BOOST_ALIGNMENT(16) float v[4];
+        _mm_store_ps(v, x);
+        return _mm_setr_ps(std::cos(v[0]), std::cos(v[1]), std::cos(v[2]), std::cos(v[3]));
+    }
+
+    static __m128 sin(__m128 x)
+    {
+        BOOST_ALIGNMENT(16) float v[4];
+        _mm_store_ps(v, x);
+        return _mm_setr_ps(std::sin(v[0]), std::sin(v[1]), std::sin(v[2]), std::sin(v[3]));
+    }
+
+    static __m128 atan2(__m128 y, __m128 x)
+    {
+        BOOST_ALIGNMENT(16) float a[4], b[4];
+        _mm_store_ps(a, y);
+        _mm_store_ps(b, x);
+        return _mm_setr_ps(std::atan2(a[0], b[0]), std::atan2(a[1], b[1]),
+                           std::atan2(a[2], b[2]), std::atan2(a[3], b[3]));
+    }
+
+    static __m128 sqrt(__m128 x)
+    {
+        return _mm_sqrt_ps(x);
+    }
+
+    static __m128 rsqrt(__m128 x)
+    {
+        return _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(x));
+    }
+
+#endif // MW_SIMD_SSE
+};
+
+
+/**
+ * Accuracy tiers of FastMath.
+ */
+enum FastMathAccuracy
+{
+    FAST_MATH_LOW,
+    FAST_MATH_MEDIUM,
+    FAST_MATH_HIGH
+};
+
+namespace detail
+{
+
+/**
+ * Polynomials of a FastMath tier.
+ *
+ * Each polynomial is <tt>c0 x + x^3 P(x^2)</tt> for sin and atan, and
+ * <tt>c0 + x^2 P(x^2)</tt> for cos, with the coefficients of P listed from
+ * the highest degree.
+ */
+template<FastMathAccuracy Accuracy>
+struct FastMathTier;
+
+template<>
+struct FastMathTier<FAST_MATH_LOW>
+{
+    // Minimax on [0, pi/4], degrees 3 and 4
+    static const unsigned SIN_TERMS = 1;
+    static const unsigned COS_TERMS = 2;
+
+    static double sin0() { return 9.9922170582e-1; }
+    static const double * sin() { static const double c[] = { -1.6033937839e-1 }; return c; }
+
+    static double cos0() { return 9.9999003496e-1; }
+    static const double * cos() { static const double c[] = { 4.0398535969e-2, -4.9970814036e-1 }; return c; }
+
+    // Minimax on [0, 1], degree 5
+    static const bool ATAN_REDUCED = false;
+    static const unsigned ATAN_TERMS = 2;
+
+    static double atan0() { return 9.9807414605e-1; }
+    static const double * atan() { static const double c[] = { 8.3067641559e-2, -2.9574362421e-1 }; return c; }
+
+    static const unsigned NEWTON_STEPS = 0;
+};
+
+template<>
+struct FastMathTier<FAST_MATH_MEDIUM>
+{
+    // Minimax on [0, pi/4], degrees 5 and 4
+    static const unsigned SIN_TERMS = 2;
+    static const unsigned COS_TERMS = 2;
+
+    static double sin0() { return 9.9999838540e-1; }
+    static const double * sin() { static const double c[] = { 8.1365119623e-3, -1.6661749354e-1 }; return c; }
+
+    static double cos0() { return 9.9999003496e-1; }
+    static const double * cos() { static const double c[] = { 4.0398535969e-2, -4.9970814036e-1 }; return c; }
+
+    // Minimax on [0, tan(pi/8)], degree 5
+    static const bool ATAN_REDUCED = true;
+    static const unsigned ATAN_TERMS = 2;
+
+    static double atan0() { return 9.9997932367e-1; }
+    static const double * atan() { static const double c[] = { 1.6577967840e-1, -3.3105450212e-1 }; return c; }
+
+    static const unsigned NEWTON_STEPS = 1;
+};
+
+template<>
+struct FastMathTier<FAST_MATH_HIGH>
+{
+    // Cephes sinf and cosf, degrees 7 and 6
+    static const unsigned SIN_TERMS = 3;
+    static const unsigned COS_TERMS = 4;
+
+    static double sin0() { return 1.0; }
+    static const double * sin()
+    {
+        static const double c[] = { -1.9515295891e-4, 8.3321608736e-3, -1.6666654611e-1 };
+        return c;
+    }
+
+    static double cos0() { return 1.0; }
+    static const double * cos()
+    {
+        static const double c[] = { 2.443315711809948e-5, -1.388731625493765e-3, 4.166664568298827e-2, -0.5 };
+        return c;
+    }
+
+    // Cephes atanf on [0, tan(pi/8)], degree 9
+    static const bool ATAN_REDUCED = true;
+    static const unsigned ATAN_TERMS = 4;
+
+    static double atan0() { return 1.0; }
+    static const double * atan()
+    {
+        static const double c[] = { 8.05374449538e-2, -1.38776856032e-1, 1.99777106478e-1, -3.33329491539e-1 };
+        return c;
+    }
+
+    static const unsigned NEWTON_STEPS = 2;
+};
+
+/**
+ * Sign bit test, true for -0.
+ */
+template<typename T>
+bool isNegative(T x)
+{
+    return x < static_cast<T>(0) || (x == static_cast<T>(0) && static_cast<T>(1) / x < static_cast<T>(0));
+}
+
+template<typename T>
+T evaluatePolynomial(const double * c, unsigned terms, T x)
+{
+    T p = static_cast<T>(c[0]);
+    for (unsigned i = 1; i < terms; ++i)
+        p = p * x + static_cast<T>(c[i]);
+    return p;
+}
+
+/**
+ * Estimate of the reciprocal square root, within 3.5% (Lomont).
+ */
+inline float rsqrtEstimate(float x)
+{
+    boost::uint32_t i;
+    std::memcpy(&i, &x, sizeof(i));
+    i = 0x5F375A86u - (i >> 1);
+    std::memcpy(&x, &i, sizeof(i));
+    return x;
+}
+
+inline double rsqrtEstimate(double x)
+{
+    boost::uint64_t i;
+    std::memcpy(&i, &x, sizeof(i));
+    i = ((static_cast<boost::uint64_t>(0x5FE6EB50u) << 32) | 0xC7B537A9u) - (i >> 1);
+    std::memcpy(&x, &i, sizeof(i));
+    return x;
+}
+
+template<typename T>
+T rsqrtEstimate(T x)
+{
+    return static_cast<T>(rsqrtEstimate(static_cast<double>(x)));
+}
+
+#ifdef MW_SIMD_SSE
+
+inline __m128 evaluatePolynomial(const double * c, unsigned terms, __m128 x)
+{
+    __m128 p = _mm_set1_ps(static_cast<float>(c[0]));
+    for (unsigned i = 1; i < terms; ++i)
+        p = _mm_add_ps(_mm_mul_ps(p, x), _mm_set1_ps(static_cast<float>(c[i])));
+    return p;
+}
+
+#endif // MW_SIMD_SSE
+
+} // namespace detail
+
+
+/**
+ * Math policy evaluating polynomial approximations.
+ *
+ * @tparam Accuracy Accuracy tier, see the table at the top of this file.
+ */
+template<FastMathAccuracy Accuracy = FAST_MATH_HIGH>
+struct FastMath
+{
+    typedef detail::FastMathTier<Accuracy> Tier;
+
+    template<typename T>
+    static T cos(T x)
+    {
+        // cos(x) = sin(x + pi/2), one quadrant further
+        return sinQuadrant(x, 1);
+    }
+
+    template<typename T>
+    static T sin(T x)
+    {
+        return sinQuadrant(x, 0);
+    }
+
+    /**
+     * Arctangent of @c y / @c x, in [-pi, pi], as std::atan2 for signed
+     * zeros.
+     */
+    template<typename T>
+    static T atan2(T y, T x)
+    {
+        const T ax = std::abs(x), ay = std::abs(y);
+        const T hi = ax > ay ? ax : ay, lo = ax > ay ? ay : ax;
+
+        T z = hi == static_cast<T>(0) ? static_cast<T>(0) : lo / hi;
+        T r = static_cast<T>(0);
+        if (Tier::ATAN_REDUCED && z > static_cast<T>(0.4142135623730950))
+        {
+            // atan(z) = pi/4 + atan((z - 1) / (z + 1))
+            z = (z - static_cast<T>(1)) / (z + static_cast<T>(1));
+            r = static_cast<T>(0.7853981633974483);
+        }
+        const T z2 = z * z;
+        r += static_cast<T>(Tier::atan0()) * z + detail::evaluatePolynomial(Tier::atan(), Tier::ATAN_TERMS, z2) * z2 * z;
+
+        if (ay > ax)
+            r = static_cast<T>(1.5707963267948966) - r;
+        if (detail::isNegative(x))
+            r = static_cast<T>(3.1415926535897932) - r;
+        return detail::isNegative(y) ? - r : r;
+    }
+
+    /**
+     * Square root, @c x must be positive or zero.
+     */
+    template<typename T>
+    static T sqrt(T x)
+    {
+        return x > static_cast<T>(0) ? x * rsqrt(x) : static_cast<T>(0);
+    }
+
+    /**
+     * Reciprocal square root, @c x must be positive.
+     */
+    template<typename T>
+    static T rsqrt(T x)
+    {
+        // One more step than SSE, the estimate has 4 bits
+        T y = detail::rsqrtEstimate(x);
+        for (unsigned i = Tier::NEWTON_STEPS + 1; i > 0; --i)
+            y = y * (static_cast<T>(1.5) - static_cast<T>(0.5) * x * y * y);
+        return y;
+    }
+
+#ifdef MW_SIMD_SSE2
+
+    static __m128 cos(__m128 x)
+    {
+        return sinQuadrant(x, _mm_set1_epi32(1));
+    }
+
+    static __m128 sin(__m128 x)
+    {
+        return sinQuadrant(x, _mm_setzero_si128());
+    }
+
+#endif // MW_SIMD_SSE2
+
+#ifdef MW_SIMD_SSE
+
+    static __m128 atan2(__m128 y, __m128 x)
+    {
+        const __m128 signBit = _mm_set1_ps(-0.0f);
+        const __m128 ax = _mm_andnot_ps(signBit, x);
+        const __m128 ay = _mm_andnot_ps(signBit, y);
+
+        // z in [0, 1], 0 when both parts are null
+        const __m128 hi = _mm_max_ps(ax, ay);
+        const __m128 lo = _mm_min_ps(ax, ay);
+        const __m128 null = _mm_cmpeq_ps(hi, _mm_setzero_ps());
+        __m128 z = _mm_andnot_ps(null, _mm_div_ps(lo, _mm_or_ps(hi, null)));
+
+        // atan(z) = pi/4 + atan((z - 1) / (z + 1)) above tan(pi/8)
+        const __m128 one = _mm_set1_ps(1.0f);
+        __m128 reduce = _mm_setzero_ps();
+        if (Tier::ATAN_REDUCED)
+        {
+            reduce = _mm_cmpgt_ps(z, _mm_set1_ps(0.4142135623730950f));
+            z = _mm_or_ps(_mm_and_ps(reduce, _mm_div_ps(_mm_sub_ps(z, one), _mm_add_ps(z, one))),
+                          _mm_andnot_ps(reduce, z));
+        }
+
+        const __m128 z2 = _mm_mul_ps(z, z);
+        const __m128 p = detail::evaluatePolynomial(Tier::atan(), Tier::ATAN_TERMS, z2);
+        __m128 r = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(p, z2), z), _mm_mul_ps(_mm_set1_ps(static_cast<float>(Tier::atan0())), z));
+        r = _mm_add_ps(r, _mm_and_ps(reduce, _mm_set1_ps(0.7853981633974483f)));
+
+        // Octant: pi/2 - r above the diagonal, pi - r for negative x
+        const __m128 halfPi = _mm_set1_ps(1.5707963267948966f);
+        const __m128 swap = _mm_cmpgt_ps(ay, ax);
+        r = _mm_or_ps(_mm_and_ps(swap, _mm_sub_ps(halfPi, r)), _mm_andnot_ps(swap, r));
+
+        // Sign of x applied to 1, so that -0 is negative
+        const __m128 negative = _mm_cmplt_ps(_mm_or_ps(_mm_and_ps(x, signBit), one), _mm_setzero_ps());
+        r = _mm_or_ps(_mm_and_ps(negative, _mm_sub_ps(_mm_set1_ps(3.1415926535897932f), r)),
+                      _mm_andnot_ps(negative, r));
+
+        return _mm_or_ps(r, _mm_and_ps(y, signBit));
+    }
+
+    /**
+     * Square roots, @c x must be positive or zero.
+     */
+    static __m128 sqrt(__m128 x)
+    {
+        // rsqrt(0) is infinite
+        const __m128 positive = _mm_cmpgt_ps(x, _mm_setzero_ps());
+        return _mm_and_ps(positive, _mm_mul_ps(x, rsqrt(x)));
+    }
+
+    /**
+     * Reciprocal square roots, @c x must be positive.
+     */
+    static __m128 rsqrt(__m128 x)
+    {
+        // 12 bits estimate, each step doubles the bits
+        __m128 y = _mm_rsqrt_ps(x);
+        const __m128 half = _mm_mul_ps(_mm_set1_ps(0.5f), x);
+        for (unsigned i = Tier::NEWTON_STEPS; i > 0; --i)
+            y = _mm_mul_ps(y, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(half, _mm_mul_ps(y, y))));
+        return y;
+    }
+
+#endif // MW_SIMD_SSE
+
+private:
+
+    /**
+     * sin(x + quadrant pi/2).
+     */
+    template<typename T>
+    static T sinQuadrant(T x, int quadrant)
+    {
+        // x = q pi/2 + r, pi/2 in 3 parts so that r is exact for large q
+        const T scaled = x * static_cast<T>(0.63661977236758134);
+        const long n = static_cast<long>(scaled + (scaled < static_cast<T>(0) ? static_cast<T>(-0.5) : static_cast<T>(0.5)));
+        const T q = static_cast<T>(n);
+        const T r = ((x - q * static_cast<T>(1.5703125)) - q * static_cast<T>(4.837512969970703125e-4))
+                  - q * static_cast<T>(7.54978995489188216e-8);
+        const T r2 = r * r;
+
+        // Both polynomials and a lookup, quadrants are not predictable
+        const T values[2] = {
+            static_cast<T>(Tier::sin0()) * r + detail::evaluatePolynomial(Tier::sin(), Tier::SIN_TERMS, r2) * r2 * r,
+            static_cast<T>(Tier::cos0()) + detail::evaluatePolynomial(Tier::cos(), Tier::COS_TERMS, r2) * r2
+        };
+        quadrant += static_cast<int>(n & 3);
+        return values[quadrant & 1] * static_cast<T>(1 - (quadrant & 2));
+    }
+
+#ifdef MW_SIMD_SSE2
+
+    static __m128 sinQuadrant(__m128 x, __m128i quadrant)
+    {
+        const __m128i q = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(0.63661977236758134f)));
+        const __m128 qf = _mm_cvtepi32_ps(q);
+        __m128 r = _mm_sub_ps(x, _mm_mul_ps(qf, _mm_set1_ps(1.5703125f)));
+        r = _mm_sub_ps(r, _mm_mul_ps(qf, _mm_set1_ps(4.837512969970703125e-4f)));
+        r = _mm_sub_ps(r, _mm_mul_ps(qf, _mm_set1_ps(7.54978995489188216e-8f)));
+        const __m128 r2 = _mm_mul_ps(r, r);
+
+        const __m128 c = _mm_add_ps(_mm_set1_ps(static_cast<float>(Tier::cos0())),
+            _mm_mul_ps(detail::evaluatePolynomial(Tier::cos(), Tier::COS_TERMS, r2), r2));
+        const __m128 s = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(static_cast<float>(Tier::sin0())), r),
+            _mm_mul_ps(_mm_mul_ps(detail::evaluatePolynomial(Tier::sin(), Tier::SIN_TERMS, r2), r2), r));
+
+        // Odd quadrants take the cosine, the 2 bit flips the sign
+        const __m128i n = _mm_add_epi32(q, quadrant);
+        const __m128 odd = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(n, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+        const __m128 sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(n, _mm_set1_epi32(2)), 30));
+        const __m128 value = _mm_or_ps(_mm_and_ps(odd, c), _mm_andnot_ps(odd, s));
+        return _mm_xor_ps(value, sign);
+    }
+
+#endif // MW_SIMD_SSE2
+
+};
+// struct FastMath
+
+MW_END_NAMESPACE(math)
+
+#endif // MW_FASTMATH_HPP
@@ -0,0 +1,588 @@
+/**
+ * @file   Fft.hpp
+ * @author Bastien Brunnenstein
+ *
+ * @details Fast Fourier transforms of complex signals.
+ *
+ * Sizes with small prime factors (up to 31) are transformed by a Stockham
+ * autosort FFT: radix 4 and 2 stages, then one generic stage per odd
+ * prime factor. Other sizes use Bluestein's algorithm, which turns the
+ * transform into a convolution computed with power of two FFTs.
+ *
+ * The forward transform is <tt>X[k] = sum x[n] exp(-2 pi i n k / N)</tt>,
+ * the inverse transform is scaled by <tt>1 / N</tt>.
+ */
+
+#ifndef MW_FFT_HPP
+#define MW_FFT_HPP
+
+#include <Mw/Config.hpp>
+
+#include <Mw/Math/Complex.hpp>
+#include <Mw/Math/ComplexArray.hpp>
+#include <Mw/Math/FftKernels.hpp>
+#include <Mw/Thread/TaskPool.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#ifndef MW_NO_THREADS
+#   include <mutex>
+#endif
+
+MW_BEGIN_NAMESPACE(math)
+
+namespace detail
+{
+
+/**
+ * Get a plan from the cache of its type, built on first use.
+ *
+ * @tparam Plan Plan type, constructible from a size.
+ */
+template<class Plan>
+boost::shared_ptr<const Plan> getCachedFftPlan(std::size_t size)
+{
+    typedef std::map<std::size_t, boost::shared_ptr<const Plan> > Cache;
+    static Cache cache;
+
+#ifndef MW_NO_THREADS
+    static std::mutex mutex;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+#endif
+        typename Cache::const_iterator it = cache.find(size);
+        if (it != cache.end())
+            return it->second;
+#ifndef MW_NO_THREADS
+    }
+#endif
+
+    // Built unlocked, plans may get other plans from the cache
+    boost::shared_ptr<const Plan> plan(new Plan(size));
+
+#ifndef MW_NO_THREADS
+    std::lock_guard<std::mutex> lock(mutex);
+#endif
+    return cache.insert(typename Cache::value_type(size, plan)).first->second;
+}
+
+} // namespace detail
+
+/**
+ * Get the smallest size of the form <tt>2^a 3^b 5^c</tt> not less than
+ * @c size.
+ *
+ * Transforms of these sizes are the fastest, signals can be padded to
+ * them before convolutions.
+ *
+ * @param size Minimum size.
+ * @return Fast transform size.
+ */
+inline std::size_t getFastFftSize(std::size_t size)
+{
+    std::size_t best = 1;
+    while (best < size)
+        best *= 2;
+
+    for (std::size_t p5 = 1; p5 < best; p5 *= 5)
+        for (std::size_t p35 = p5; p35 < best; p35 *= 3)
+        {
+            std::size_t n = p35;
+            while (n < size)
+                n *= 2;
+            best = std::min(best, n);
+        }
+    return best;
+}
+
+/**
+ * Precomputed FFT of a given size.
+ *
+ * A plan holds the twiddle factors of its stages. Plans are immutable and
+ * can be used by several threads at once; get() shares them by size.
+ *
+ * Signals are given as split real and imaginary lanes (see ComplexArray).
+ * Input and output may be the same lanes.
+ *
+ * @tparam T Scalar type.
+ */
+template<typename T>
+class FftPlan : boost::noncopyable
+{
+public:
+
+    /**
+     * Aligned storage of a lane.
+     */
+    typedef typename ComplexArray<T>::Lane Lane;
+
+private:
+
+    /**
+     * Signals per task of the batch transforms, times the size.
+     */
+    static const std::size_t BATCH_GRAIN = 16384;
+
+    std::size_t _size;
+
+    /**
+     * Stockham stages, empty with Bluestein's algorithm.
+     */
+    std::vector<detail::FftStage<T> > _stages;
+
+    /**
+     * Plan of the convolutions of Bluestein's algorithm.
+     */
+    boost::shared_ptr<const FftPlan> _convolution;
+
+    /**
+     * Chirp <tt>exp(-pi i n^2 / N)</tt>.
+     */
+    Lane _chirpRe, _chirpIm;
+
+    /**
+     * Transform of the conjugate chirp, divided by the convolution size.
+     */
+    Lane _filterRe, _filterIm;
+
+public:
+
+    // Constructors
+
+    /**
+     * Constructor.
+     *
+     * @param size Number of samples of the signals.
+     * @throw std::invalid_argument if @c size is 0.
+     */
+    explicit FftPlan(std::size_t size)
+        : _size(size)
+    {
+        if (size == 0)
+            throw std::invalid_argument("Mw.Math.FftPlan: Size must not be 0");
+
+        std::vector<unsigned> radices;
+        if (factorize(size, radices))
+            buildStages(radices);
+        else
+            buildBluestein();
+    }
+
+    /**
+     * Get a shared plan.
+     *
+     * Plans are built on first use and kept for the lifetime of the program.
+     *
+     * @param size Number of samples of the signals.
+     * @return Plan for @c size.
+     * @throw std::invalid_argument if @c size is 0.
+     */
+    static boost::shared_ptr<const FftPlan> get(std::size_t size)
+    {
+        return detail::getCachedFftPlan<FftPlan>(size);
+    }
+
+
+    // Getters
+
+    /**
+     * Get the number of samples of the signals.
+     *
+     * @return Size.
+     */
+    std::size_t size() const
+    {
+        return _size;
+    }
+
+    /**
+     * Check if the plan uses Bluestein's algorithm.
+     *
+     * @return @c true if the size has a prime factor larger than 31.
+     */
+    bool isBluestein() const
+    {
+        return _convolution.get() != NULL;
+    }
+
+    /**
+     * Get the size of the work lanes of transform().
+     *
+     * @return Number of values of each work lane.
+     */
+    std::size_t getWorkSize() const
+    {
+        if (_convolution)
+            return _convolution->size() + _convolution->getWorkSize();
+        return 2 * _size;
+    }
+
+
+    // Transforms
+
+    /**
+     * Compute the transform of a signal, with caller provided work memory.
+     *
+     * @param inRe Real parts of the signal.
+     * @param inIm Imaginary parts of the signal.
+     * @param outRe Real parts of the unscaled transform, may be @c inRe.
+     * @param outIm Imaginary parts of the unscaled transform, may be @c inIm.
+     * @param workRe Work lane of getWorkSize() values.
+     * @param workIm Work lane of getWorkSize() values.
+     * @param inverse Compute the inverse transform, without the @c 1/N scale.
+     */
+    void transform(const T * inRe, const T * inIm, T * outRe, T * outIm, T * workRe, T * workIm,
+                   bool inverse) const
+    {
+        // The inverse transform is the forward transform with real and
+        // imaginary parts swapped
+        if (inverse)
+            execute(inIm, inRe, outIm, outRe, workIm, workRe);
+        else
+            execute(inRe, inIm, outRe, outIm, workRe, workIm);
+    }
+
+    /**
+     * Compute the forward transform of a signal.
+     *
+     * @param inRe Real parts of the signal.
+     * @param inIm Imaginary parts of the signal.
+     * @param outRe Real parts of the transform, may be @c inRe.
+     * @param outIm Imaginary parts of the transform, may be @c inIm.
+     */
+    void forward(const T * inRe, const T * inIm, T * outRe, T * outIm) const
+    {
+        Lane workRe(getWorkSize()), workIm(getWorkSize());
+        transform(inRe, inIm, outRe, outIm, &workRe[0], &workIm[0], false);
+    }
+
+    /**
+     * Compute the inverse transform of a signal.
+     *
+     * @param inRe Real parts of the transform.
+     * @param inIm Imaginary parts of the transform.
+     * @param outRe Real parts of the signal, may be @c inRe.
+     * @param outIm Imaginary parts of the signal, may be @c inIm.
+     */
+    void inverse(const T * inRe, const T * inIm, T * outRe, T * outIm) const
+    {
+        Lane workRe(getWorkSize()), workIm(getWorkSize());
+        transform(inRe, inIm, outRe, outIm, &workRe[0], &workIm[0], true);
+        scale(outRe, outIm, _size);
+    }
+
+    /**
+     * Compute the forward transforms of consecutive signals.
+     *
+     * @param in Signals, a multiple of size() samples.
+     * @param out Transforms, may be @c in.
+     * @throw std::invalid_argument if the size of @c in is not a multiple
+     *        of size().
+     */
+    void forward(const ComplexArray<T> & in, ComplexArray<T> & out) const
+    {
+        BatchTask task = prepareBatch(in, out, false);
+        task(0, task.count);
+    }
+
+    /**
+     * Compute the inverse transforms of consecutive signals.
+     *
+     * @see forward
+     */
+    void inverse(const ComplexArray<T> & in, ComplexArray<T> & out) const
+    {
+        BatchTask task = prepareBatch(in, out, true);
+        task(0, task.count);
+    }
+
+    /**
+     * Compute the forward transforms of consecutive signals in parallel.
+     *
+     * The results do not depend on the number of threads.
+     *
+     * @see forward
+     */
+    void forward(const ComplexArray<T> & in, ComplexArray<T> & out, thread::TaskPool & pool) const
+    {
+        BatchTask task = prepareBatch(in, out, false);
+        thread::parallelFor(pool, 0, task.count, getBatchGrain(), task);
+    }
+
+    /**
+     * Compute the inverse transforms of consecutive signals in parallel.
+     *
+     * @see forward
+     */
+    void inverse(const ComplexArray<T> & in, ComplexArray<T> & out, thread::TaskPool & pool) const
+    {
+        BatchTask task = prepareBatch(in, out, true);
+        thread::parallelFor(pool, 0, task.count, getBatchGrain(), task);
+    }
+
+    /**
+     * Compute the forward transform of an array of Complex.
+     *
+     * @param in First sample of the signal.
+     * @param out First value of the transform, may be @c in.
+     */
+    void forward(const Complex<T> * in, Complex<T> * out) const
+    {
+        ComplexArray<T> array(in, in + _size);
+        forward(array, array);
+        array.copyTo(out);
+    }
+
+    /**
+     * Compute the inverse transform of an array of Complex.
+     *
+     * @see forward
+     */
+    void inverse(const Complex<T> * in, Complex<T> * out) const
+    {
+        ComplexArray<T> array(in, in + _size);
+        inverse(array, array);
+        array.copyTo(out);
+    }
+
+
+private:
+
+    /**
+     * Transform of a range of signals of a batch.
+     */
+    struct BatchTask
+    {
+        const FftPlan * plan;
+        const T * inRe;
+        const T * inIm;
+        T * outRe;
+        T * outIm;
+        std::size_t count;
+        bool inverse;
+
+        void operator () (std::size_t begin, std::size_t end) const
+        {
+            const std::size_t size = plan->size();
+            Lane workRe(plan->getWorkSize()), workIm(plan->getWorkSize());
+
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                const std::size_t offset = i * size;
+                plan->transform(inRe + offset, inIm + offset, outRe + offset, outIm + offset,
+                                &workRe[0], &workIm[0], inverse);
+                if (inverse)
+                    scale(outRe + offset, outIm + offset, size);
+            }
+        }
+    };
+
+    BatchTask prepareBatch(const ComplexArray<T> & in, ComplexArray<T> & out, bool inverse) const
+    {
+        if (in.size() % _size)
+            throw std::invalid_argument("Mw.Math.FftPlan: Signal size is not a multiple of the plan size");
+
+        out.resize(in.size());
+        const BatchTask task = { this, in.realLane(), in.imaginaryLane(), out.realLane(), out.imaginaryLane(),
+                                 in.size() / _size, inverse };
+        return task;
+    }
+
+    std::size_t getBatchGrain() const
+    {
+        return std::max<std::size_t>(1, BATCH_GRAIN / _size);
+    }
+
+    static void scale(T * re, T * im, std::size_t size)
+    {
+        const T factor = static_cast<T>(1) / static_cast<T>(size);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            re[i] *= factor;
+            im[i] *= factor;
+        }
+    }
+
+    /**
+     * Split a size in radices, 4 first, then 2, then odd primes.
+     *
+     * @return @c false if a prime factor is larger than the largest radix.
+     */
+    static bool factorize(std::size_t size, std::vector<unsigned> & radices)
+    {
+        while (size % 4 == 0)
+        {
+            radices.push_back(4);
+            size /= 4;
+        }
+        if (size % 2 == 0)
+        {
+            radices.push_back(2);
+            size /= 2;
+        }
+        for (unsigned p = 3; p <= detail::FFT_MAX_RADIX && size > 1; p += 2)
+            while (size % p == 0)
+            {
+                radices.push_back(p);
+                size /= p;
+            }
+        return size == 1;
+    }
+
+    /**
+     * Root of unity <tt>exp(-2 pi i num / den)</tt>, in double precision.
+     */
+    static void root(std::size_t num, std::size_t den, T & re, T & im)
+    {
+        const double angle = -2.0 * M_PI * static_cast<double>(num % den) / static_cast<double>(den);
+        re = static_cast<T>(std::cos(angle));
+        im = static_cast<T>(std::sin(angle));
+    }
+
+    void buildStages(const std::vector<unsigned> & radices)
+    {
+        std::size_t n = _size, s = 1;
+
+        _stages.resize(radices.size());
+        for (std::size_t i = 0; i < radices.size(); ++i)
+        {
+            detail::FftStage<T> & stage = _stages[i];
+            const unsigned radix = radices[i];
+
+            stage.radix = radix;
+            stage.m = n / radix;
+            stage.s = s;
+
+            stage.twiddleRe.resize((radix - 1) * stage.m);
+            stage.twiddleIm.resize((radix - 1) * stage.m);
+            for (unsigned j = 1; j < radix; ++j)
+                for (std::size_t p = 0; p < stage.m; ++p)
+                    root(j * p, n, stage.twiddleRe[(j - 1) * stage.m + p], stage.twiddleIm[(j - 1) * stage.m + p]);
+
+            stage.rootRe.resize(radix);
+            stage.rootIm.resize(radix);
+            for (unsigned t = 0; t < radix; ++t)
+                root(t, radix, stage.rootRe[t], stage.rootIm[t]);
+
+            n = stage.m;
+            s *= radix;
+        }
+    }
+
+    void buildBluestein()
+    {
+        std::size_t padded = 1;
+        while (padded < 2 * _size - 1)
+            padded *= 2;
+
+        _convolution = get(padded);
+
+        // n^2 is reduced modulo 2N, the period of the chirp
+        _chirpRe.resize(_size);
+        _chirpIm.resize(_size);
+        for (std::size_t n = 0; n < _size; ++n)
+        {
+            const unsigned long long sq = static_cast<unsigned long long>(n) * n % (2 * _size);
+            root(static_cast<std::size_t>(sq), 2 * _size, _chirpRe[n], _chirpIm[n]);
+        }
+
+        _filterRe.assign(padded, static_cast<T>(0));
+        _filterIm.assign(padded, static_cast<T>(0));
+        const T factor = static_cast<T>(1) / static_cast<T>(padded);
+        for (std::size_t n = 0; n < _size; ++n)
+        {
+            _filterRe[n] = _chirpRe[n] * factor;
+            _filterIm[n] = - _chirpIm[n] * factor;
+            if (n)
+            {
+                _filterRe[padded - n] = _filterRe[n];
+                _filterIm[padded - n] = _filterIm[n];
+            }
+        }
+
+        Lane workRe(_convolution->getWorkSize()), workIm(_convolution->getWorkSize());
+        _convolution->transform(&_filterRe[0], &_filterIm[0], &_filterRe[0], &_filterIm[0],
+                                &workRe[0], &workIm[0], false);
+    }
+
+    void execute(const T * inRe, const T * inIm, T * outRe, T * outIm, T * workRe, T * workIm) const
+    {
+        if (_convolution)
+            executeBluestein(inRe, inIm, outRe, outIm, workRe, workIm);
+        else
+            executeStages(inRe, inIm, outRe, outIm, workRe, workIm);
+    }
+
+    void executeStages(const T * inRe, const T * inIm, T * outRe, T * outIm, T * workRe, T * workIm) const
+    {
+        const std::size_t count = _stages.size();
+
+        if (count == 0)
+        {
+            std::copy(inRe, inRe + _size, outRe);
+            std::copy(inIm, inIm + _size, outIm);
+            return;
+        }
+
+        // Stages alternate between the output and the work lanes, so that
+        // the last one writes the output. The input is copied first if it
+        // would be overwritten by the first stage.
+        const T * srcRe = inRe;
+        const T * srcIm = inIm;
+        if (count % 2 && (inRe == outRe || inIm == outIm))
+        {
+            std::copy(inRe, inRe + _size, workRe + _size);
+            std::copy(inIm, inIm + _size, workIm + _size);
+            srcRe = workRe + _size;
+            srcIm = workIm + _size;
+        }
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const bool toOutput = (count - 1 - i) % 2 == 0;
+            T * dstRe = toOutput ? outRe : workRe;
+            T * dstIm = toOutput ? outIm : workIm;
+
+            detail::runFftStage(_stages[i], srcRe, srcIm, dstRe, dstIm);
+
+            srcRe = dstRe;
+            srcIm = dstIm;
+        }
+    }
+
+    void executeBluestein(const T * inRe, const T * inIm, T * outRe, T * outIm, T * workRe, T * workIm) const
+    {
+        const std::size_t padded = _convolution->size();
+        T * aRe = workRe;
+        T * aIm = workIm;
+        T * subRe = workRe + padded;
+        T * subIm = workIm + padded;
+
+        // a = x * chirp, padded with zeros
+        detail::ComplexKernels<T>::multiply(inRe, inIm, &_chirpRe[0], &_chirpIm[0], aRe, aIm, 0, _size);
+        std::fill(aRe + _size, aRe + padded, static_cast<T>(0));
+        std::fill(aIm + _size, aIm + padded, static_cast<T>(0));
+
+        // Circular convolution with the conjugate chirp
+        _convolution->transform(aRe, aIm, aRe, aIm, subRe, subIm, false);
+        detail::ComplexKernels<T>::multiply(aRe, aIm, &_filterRe[0], &_filterIm[0], aRe, aIm, 0, padded);
+        _convolution->transform(aRe, aIm, aRe, aIm, subRe, subIm, true);
+
+        // X = chirp * convolution
+        detail::ComplexKernels<T>::multiply(aRe, aIm, &_chirpRe[0], &_chirpIm[0], outRe, outIm, 0, _size);
+    }
+
+};
+// class FftPlan
+
+MW_END_NAMESPACE(math)
+
+#endif // MW_FFT_HPP
@@ -0,0 +1,333 @@
+/**
+ * @file   FftKernels.hpp
+ * @author Bastien Brunnenstein
+ *
+ * @details Butterflies of the FFT, over split real and imaginary lanes.
+ *
+ * The butterflies are written once against a small pack interface: the
+ * scalar pack processes one value, the SIMD packs process 4 or 8 floats
+ * (SSE, AVX) and 2 or 4 doubles (SSE2, AVX) with the same operations.
+ */
+
+#ifndef MW_FFTKERNELS_HPP
+#define MW_FFTKERNELS_HPP
+
+#include <Mw/Config.hpp>
+
+#include <Mw/Math/Simd.hpp>
+
+#include <cstddef>
+#include <vector>
+
+#include <boost/align/aligned_allocator.hpp>
+
+MW_BEGIN_NAMESPACE(math)
+
+namespace detail
+{
+
+/**
+ * Largest radix of a Stockham stage, larger prime factors use Bluestein's
+ * algorithm.
+ */
+const unsigned FFT_MAX_RADIX = 31;
+
+/**
+ * Scalar pack.
+ */
+template<typename T>
+struct FftScalar
+{
+    typedef T Type;
+
+    static const unsigned WIDTH = 1;
+
+    static Type load(const T * p) { return *p; }
+    static void store(T * p, Type v) { *p = v; }
+    static Type set1(T v) { return v; }
+    static Type add(Type a, Type b) { return a + b; }
+    static Type sub(Type a, Type b) { return a - b; }
+    static Type mul(Type a, Type b) { return a * b; }
+};
+
+/**
+ * Widest pack available for a scalar type.
+ */
+template<typename T>
+struct FftPack : FftScalar<T>
+{};
+
+#if defined MW_SIMD_AVX
+
+template<>
+struct FftPack<float>
+{
+    typedef __m256 Type;
+
+    static const unsigned WIDTH = 8;
+
+    static Type load(const float * p) { return _mm256_loadu_ps(p); }
+    static void store(float * p, Type v) { _mm256_storeu_ps(p, v); }
+    static Type set1(float v) { return _mm256_set1_ps(v); }
+    static Type add(Type a, Type b) { return _mm256_add_ps(a, b); }
+    static Type sub(Type a, Type b) { return _mm256_sub_ps(a, b); }
+    static Type mul(Type a, Type b) { return _mm256_mul_ps(a, b); }
+};
+
+template<>
+struct FftPack<double>
+{
+    typedef __m256d Type;
+
+    static const unsigned WIDTH = 4;
+
+    static Type load(const double * p) { return _mm256_loadu_pd(p); }
+    static void store(double * p, Type v) { _mm256_storeu_pd(p, v); }
+    static Type set1(double v) { return _mm256_set1_pd(v); }
+    static Type add(Type a, Type b) { return _mm256_add_pd(a, b); }
+    static Type sub(Type a, Type b) { return _mm256_sub_pd(a, b); }
+    static Type mul(Type a, Type b) { return _mm256_mul_pd(a, b); }
+};
+
+#elif defined MW_SIMD_SSE
+
+template<>
+struct FftPack<float>
+{
+    typedef __m128 Type;
+
+    static const unsigned WIDTH = 4;
+
+    static Type load(const float * p) { return _mm_loadu_ps(p); }
+    static void store(float * p, Type v) { _mm_storeu_ps(p, v); }
+    static Type set1(float v) { return _mm_set1_ps(v); }
+    static Type add(Type a, Type b) { return _mm_add_ps(a, b); }
+    static Type sub(Type a, Type b) { return _mm_sub_ps(a, b); }
+    static Type mul(Type a, Type b) { return _mm_mul_ps(a, b); }
+};
+
+#   ifdef MW_SIMD_SSE2
+
+template<>
+struct FftPack<double>
+{
+    typedef __m128d Type;
+
+    static const unsigned WIDTH = 2;
+
+    static Type load(const double * p) { return _mm_loadu_pd(p); }
+    static void store(double * p, Type v) { _mm_storeu_pd(p, v); }
+    static Type set1(double v) { return _mm_set1_pd(v); }
+    static Type add(Type a, Type b) { return _mm_add_pd(a, b); }
+    static Type sub(Type a, Type b) { return _mm_sub_pd(a, b); }
+    static Type mul(Type a, Type b) { return _mm_mul_pd(a, b); }
+};
+
+#   endif // MW_SIMD_SSE2
+
+#endif
+
+
+/**
+ * Stage of a Stockham FFT.
+ *
+ * A stage splits sub-transforms of length <tt>n = radix * m</tt>, repeated
+ * with a stride @c s: for each @c p < m and @c q < s,
+ * <tt>y[q + s * (radix * p + j)] = w^(j p) * sum_k x[q + s * (p + k m)] * r^(j k)</tt>,
+ * where @c w is the n-th root and @c r the radix-th root of unity.
+ *
+ * @tparam T Scalar type.
+ */
+template<typename T>
+struct FftStage
+{
+    typedef std::vector<T, boost::alignment::aligned_allocator<T, MW_SIMD_ALIGNMENT> > Lane;
+
+    unsigned radix;
+    std::size_t m;
+    std::size_t s;
+
+    /**
+     * Twiddles <tt>w^(j p)</tt>, at <tt>(j - 1) * m + p</tt>.
+     */
+    Lane twiddleRe, twiddleIm;
+
+    /**
+     * Roots <tt>r^t</tt> for the generic butterfly.
+     */
+    Lane rootRe, rootIm;
+};
+
+/**
+ * Butterflies over a pack type.
+ *
+ * Inputs are read every @c xs values, outputs written every @c ys values.
+ *
+ * @tparam T Scalar type.
+ * @tparam P Pack.
+ */
+template<typename T, class P>
+struct FftButterflies
+{
+    typedef typename P::Type V;
+
+    static void multiply(V ar, V ai, V br, V bi, V & r, V & i)
+    {
+        r = P::sub(P::mul(ar, br), P::mul(ai, bi));
+        i = P::add(P::mul(ar, bi), P::mul(ai, br));
+    }
+
+    static void radix2(const T * xr, const T * xi, std::size_t xs, T * yr, T * yi, std::size_t ys,
+                       const V * wr, const V * wi)
+    {
+        const V ar = P::load(xr), ai = P::load(xi);
+        const V br = P::load(xr + xs), bi = P::load(xi + xs);
+
+        P::store(yr, P::add(ar, br));
+        P::store(yi, P::add(ai, bi));
+
+        V r, i;
+        multiply(P::sub(ar, br), P::sub(ai, bi), wr[1], wi[1], r, i);
+        P::store(yr + ys, r);
+        P::store(yi + ys, i);
+    }
+
+    static void radix4(const T * xr, const T * xi, std::size_t xs, T * yr, T * yi, std::size_t ys,
+                       const V * wr, const V * wi)
+    {
+        const V a0r = P::load(xr), a0i = P::load(xi);
+        const V a1r = P::load(xr + xs), a1i = P::load(xi + xs);
+        const V a2r = P::load(xr + 2 * xs), a2i = P::load(xi + 2 * xs);
+        const V a3r = P::load(xr + 3 * xs), a3i = P::load(xi + 3 * xs);
+
+        const V t0r = P::add(a0r, a2r), t0i = P::add(a0i, a2i);
+        const V t1r = P::sub(a0r, a2r), t1i = P::sub(a0i, a2i);
+        const V t2r = P::add(a1r, a3r), t2i = P::add(a1i, a3i);
+
+        // t3 = -i (a1 - a3)
+        const V t3r = P::sub(a1i, a3i), t3i = P::sub(a3r, a1r);
+
+        P::store(yr, P::add(t0r, t2r));
+        P::store(yi, P::add(t0i, t2i));
+
+        V r, i;
+        multiply(P::add(t1r, t3r), P::add(t1i, t3i), wr[1], wi[1], r, i);
+        P::store(yr + ys, r);
+        P::store(yi + ys, i);
+
+        multiply(P::sub(t0r, t2r), P::sub(t0i, t2i), wr[2], wi[2], r, i);
+        P::store(yr + 2 * ys, r);
+        P::store(yi + 2 * ys, i);
+
+        multiply(P::sub(t1r, t3r), P::sub(t1i, t3i), wr[3], wi[3], r, i);
+        P::store(yr + 3 * ys, r);
+        P::store(yi + 3 * ys, i);
+    }
+
+    static void generic(unsigned radix, const T * xr, const T * xi, std::size_t xs, T * yr, T * yi, std::size_t ys,
+                        const V * wr, const V * wi, const V * rootr, const V * rooti)
+    {
+        V ar[FFT_MAX_RADIX], ai[FFT_MAX_RADIX];
+        for (unsigned k = 0; k < radix; ++k)
+        {
+            ar[k] = P::load(xr + k * xs);
+            ai[k] = P::load(xi + k * xs);
+        }
+
+        for (unsigned j = 0; j < radix; ++j)
+        {
+            V sr = ar[0], si = ai[0];
+            unsigned t = 0;
+            for (unsigned k = 1; k < radix; ++k)
+            {
+                t += j;
+                if (t >= radix)
+                    t -= radix;
+
+                V r, i;
+                multiply(ar[k], ai[k], rootr[t], rooti[t], r, i);
+                sr = P::add(sr, r);
+                si = P::add(si, i);
+            }
+
+            if (j)
+                multiply(sr, si, wr[j], wi[j], sr, si);
+
+            P::store(yr + j * ys, sr);
+            P::store(yi + j * ys, si);
+        }
+    }
+
+    /**
+     * Run the butterflies of one twiddle set on the values <tt>[qBegin, qEnd)</tt>.
+     */
+    static void run(const FftStage<T> & stage, std::size_t p, std::size_t qBegin, std::size_t qEnd,
+                    const T * xr, const T * xi, T * yr, T * yi, const V * rootr, const V * rooti)
+    {
+        const unsigned radix = stage.radix;
+        const std::size_t m = stage.m, s = stage.s;
+
+        V wr[FFT_MAX_RADIX], wi[FFT_MAX_RADIX];
+        for (unsigned j = 1; j < radix; ++j)
+        {
+            wr[j] = P::set1(stage.twiddleRe[(j - 1) * m + p]);
+            wi[j] = P::set1(stage.twiddleIm[(j - 1) * m + p]);
+        }
+
+        const std::size_t xs = m * s;
+        for (std::size_t q = qBegin; q < qEnd; q += P::WIDTH)
+        {
+            const std::size_t x = q + s * p;
+            const std::size_t y = q + s * radix * p;
+
+            if (radix == 4)
+                radix4(xr + x, xi + x, xs, yr + y, yi + y, s, wr, wi);
+            else if (radix == 2)
+                radix2(xr + x, xi + x, xs, yr + y, yi + y, s, wr, wi);
+            else
+                generic(radix, xr + x, xi + x, xs, yr + y, yi + y, s, wr, wi, rootr, rooti);
+        }
+    }
+};
+
+/**
+ * Run a Stockham stage.
+ *
+ * The strided values are processed by packs, the remainder and stages of
+ * small strides with the scalar butterflies. Output must not alias input.
+ */
+template<typename T>
+void runFftStage(const FftStage<T> & stage, const T * xr, const T * xi, T * yr, T * yi)
+{
+    typedef FftPack<T> P;
+    typedef FftScalar<T> S;
+
+    const unsigned radix = stage.radix;
+    const std::size_t s = stage.s;
+    const std::size_t packed = s - s % P::WIDTH;
+
+    typename P::Type prootr[FFT_MAX_RADIX], prooti[FFT_MAX_RADIX];
+    T srootr[FFT_MAX_RADIX], srooti[FFT_MAX_RADIX];
+    if (radix != 2 && radix != 4)
+        for (unsigned t = 0; t < radix; ++t)
+        {
+            prootr[t] = P::set1(stage.rootRe[t]);
+            prooti[t] = P::set1(stage.rootIm[t]);
+            srootr[t] = stage.rootRe[t];
+            srooti[t] = stage.rootIm[t];
+        }
+
+    for (std::size_t p = 0; p < stage.m; ++p)
+    {
+        if (packed)
+            FftButterflies<T, P>::run(stage, p, 0, packed, xr, xi, yr, yi, prootr, prooti);
+        if (packed != s)
+            FftButterflies<T, S>::run(stage, p, packed, s, xr, xi, yr, yi, srootr, srooti);
+    }
+}
+
+} // namespace detail
+
+MW_END_NAMESPACE(math)
+
+#endif // MW_FFTKERNELS_HPP
@@ -0,0 +1,89 @@
+/**
+ * @file   Frustum.hpp
+ * @author Bastien Brunnenstein
+ */
+
+#ifndef MW_FRUSTUM_HPP
+#define MW_FRUSTUM_HPP
+
+#include <Mw/Config.hpp>
+
+#include <Mw/Math/Plane.hpp>
+#include <Mw/Math/PlaneSet.hpp>
+#include <Mw/Math/Vector.hpp>
+
+#include <cmath>
+
+MW_BEGIN_NAMESPACE(math)
+
+/**
+ * View frustum of a perspective camera.
+ *
+ * Plane set of six planes, in this order: left, right, bottom, top, near,
+ * far.
+ *
+ * @tparam T Scalar type.
+ */
+template<typename T>
+class Frustum : public PlaneSet<T, 3>
+{
+public:
+
+    // Constructors
+
+    /**
+     * Constructor.
+     *
+     * @param position Position of the camera.
+     * @param direction Viewing direction, need not be normalized.
+     * @param up Up direction, must not be parallel to @c direction.
+     * @param fovY Vertical field of view, in radians.
+     * @param aspect Width divided by height.
+     * @param nearDistance Distance of the near plane.
+     * @param farDistance Distance of the far plane.
+     */
+    Frustum(const Vector<T, 3> & position, const Vector<T, 3> & direction, const Vector<T, 3> & up,
+            T fovY, T aspect, T nearDistance, T farDistance)
+    {
+        set(position, direction, up, fovY, aspect, nearDistance, farDistance);
+    }
+
+
+    // Setters
+
+    /**
+     * Set the camera.
+     *
+     * @see Frustum
+     */
+    void set(const Vector<T, 3> & position, const Vector<T, 3> & direction, const Vector<T, 3> & up,
+             T fovY, T aspect, T nearDistance, T farDistance)
+    {
+        typedef Plane<T, Vector<T, 3> > P;
+
+        const Vector<T, 3> f = normalize(direction);
+        const Vector<T, 3> r = normalize(f.cross(up));
+        const Vector<T, 3> u = r.cross(f);
+
+        const T tanY = std::tan(fovY / 2);
+        const T tanX = tanY * aspect;
+
+        // Side planes contain the camera position and an edge of the view
+        Vector<T, 3> left(f - r * tanX), right(f + r * tanX);
+        Vector<T, 3> bottom(f - u * tanY), top(f + u * tanY);
+
+        this->clear();
+        this->add(P(left.cross(u), position));
+        this->add(P(u.cross(right), position));
+        this->add(P(r.cross(bottom), position));
+        this->add(P(top.cross(r), position));
+        this->add(P(f, position + f * nearDistance));
+        this->add(P(-f, position + f * farDistance));
+    }
+
+};
+// class Frustum
+
+MW_END_NAMESPACE(math)
+
+#endif // MW_FRUSTUM_HPP
@@ -0,0 +1,607 @@
+/**
+ * @file   HashGrid.hpp
+ * @author Bastien Brunnenstein
+ */
+
+#ifndef MW_HASHGRID_HPP
+#define MW_HASHGRID_HPP
+
+#include <Mw/Config.hpp>
+
+#include <Mw/Math/Simd.hpp>
+#include <Mw/Math/Vector.hpp>
+#include <Mw/Thread/TaskPool.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/align/aligned_allocator.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+
+MW_BEGIN_NAMESPACE(math)
+
+/**
+ * Uniform grid over a set of points, stored in a hash table.
+ *
+ * The space is cut in cubic cells, and each cell is hashed to a bucket of
+ * a fixed-size table. The grid is rebuilt from scratch with a counting
+ * sort: the points are stored by bucket, and each bucket is a range given
+ * by its start and its count.
+ *
+ * Radius queries look in the buckets of the cells overlapping the query,
+ * and compare squared distances. A bucket may hold the points of several
+ * cells, they are filtered by the distance test.
+ *
+ * Cell coordinates must fit in 32-bit integers.
+ *
+ * @tparam T Scalar type.
+ * @tparam N Dimension (number of components).
+ */
+template<typename T, unsigned N>
+class HashGrid
+{
+    BOOST_STATIC_ASSERT_MSG(N >= 1 && N <= 4, "Mw.Math.HashGrid: Dimension must be between 1 and 4");
+
+public:
+
+    /**
+     * List of point indices.
+     */
+    typedef std::vector<boost::uint32_t> Indices;
+
+private:
+
+    typedef std::vector<Vector<T, N>, boost::alignment::aligned_allocator<Vector<T, N>, MW_SIMD_ALIGNMENT> > Points;
+
+    /**
+     * Maximum number of chunks of a parallel rebuild.
+     */
+    static const unsigned MAX_CHUNKS = 8;
+
+    /**
+     * Number of buckets a query collects without allocating: the 3^N cells
+     * overlapping a query whose radius is at most the cell size.
+     */
+    static const std::size_t LOCAL_BUCKETS = N == 1 ? 3 : N == 2 ? 9 : N == 3 ? 27 : 81;
+
+    /**
+     * Number of queries per task of a parallel batch query.
+     */
+    static const std::size_t QUERY_GRAIN = 1024;
+
+    /**
+     * Minimum number of points per chunk of a parallel rebuild.
+     */
+    static const std::size_t CHUNK_GRAIN = 65536;
+
+    /**
+     * Number of buckets per task of a parallel rebuild.
+     */
+    static const std::size_t BUCKET_GRAIN = 65536;
+
+    T _cellSize;
+    T _invCellSize;
+
+    /**
+     * Requested number of buckets, 0 to follow the number of points.
+     */
+    std::size_t _tableSize;
+
+    boost::uint32_t _mask;
+
+    /**
+     * First point of each bucket.
+     */
+    Indices _cellStart;
+
+    /**
+     * Number of points of each bucket.
+     */
+    Indices _cellCount;
+
+    /**
+     * Points, by bucket.
+     */
+    Points _points;
+
+    /**
+     * Original index of the points, by bucket.
+     */
+    Indices _indices;
+
+    /**
+     * Bucket of each point, and bucket counters of each chunk, kept between
+     * rebuilds.
+     */
+    Indices _hashes;
+    Indices _counters;
+
+public:
+
+    // Constructors
+
+    /**
+     * Constructor.
+     *
+     * @param cellSize Size of the cells, about the radius of the queries.
+     * @param tableSize Number of buckets, rounded up to a power of two.
+     *                  0 to use the number of points.
+     */
+    explicit HashGrid(T cellSize, std::size_t tableSize = 0)
+        : _cellSize(cellSize), _invCellSize(static_cast<T>(1) / cellSize),
+          _tableSize(tableSize), _mask(0)
+    {
+        if (!(cellSize > static_cast<T>(0)))
+            throw std::invalid_argument("Mw.Math.HashGrid: Cell size must be positive");
+
+        if (tableSize > (static_cast<std::size_t>(1) << 31))
+            throw std::length_error("Mw.Math.HashGrid: Table too large");
+
+        _cellStart.assign(1, 0);
+        _cellCount.assign(1, 0);
+    }
+
+
+    // Getters
+
+    /**
+     * Get the number of points in the grid.
+     *
+     * @return Number of points.
+     */
+    std::size_t size() const
+    {
+        return _points.size();
+    }
+
+    /**
+     * Check if the grid is empty.
+     *
+     * @return @c true if the grid has no points.
+     */
+    bool empty() const
+    {
+        return _points.empty();
+    }
+
+    /**
+     * Get the size of the cells.
+     *
+     * @return Size of the cells.
+     */
+    T getCellSize() const
+    {
+        return _cellSize;
+    }
+
+    /**
+     * Get the number of buckets.
+     *
+     * @return Number of buckets, a power of two.
+     */
+    std::size_t getTableSize() const
+    {
+        return _cellStart.size();
+    }
+
+
+    // Construction
+
+    /**
+     * Rebuild the grid.
+     *
+     * @param first Beginning of a range of Vector.
+     * @param last End of the range.
+     */
+    template<class RandomAccessIterator>
+    void rebuild(RandomAccessIterator first, RandomAccessIterator last)
+    {
+        rebuildPoints(first, last, NULL);
+    }
+
+    /**
+     * Rebuild the grid using the threads of a task pool.
+     *
+     * The grid is the same as the one built without a pool.
+     *
+     * @param first Beginning of a range of Vector.
+     * @param last End of the range.
+     * @param pool Task pool running the rebuild.
+     */
+    template<class RandomAccessIterator>
+    void rebuild(RandomAccessIterator first, RandomAccessIterator last, thread::TaskPool & pool)
+    {
+        rebuildPoints(first, last, &pool);
+    }
+
+
+    // Queries
+
+    /**
+     * Find the points within a distance of a point.
+     *
+     * @param point Center of the query.
+     * @param radius Maximum distance, included.
+     * @param out Output iterator receiving the indices of the points.
+     * @return End of the output range.
+     */
+    template<class OutputIterator>
+    OutputIterator queryRadius(const Vector<T, N> & point, T radius, OutputIterator out) const
+    {
+        // Only used by queries spanning more than LOCAL_BUCKETS cells
+        Indices buckets;
+        return query(point, radius, buckets, out);
+    }
+
+    /**
+     * Find the points within a distance of each point of a range.
+     *
+     * The neighbours of query @c q are
+     * <tt>neighbours[offsets[q]] .. neighbours[offsets[q + 1] - 1]</tt>.
+     *
+     * @param first Beginning of a range of Vector.
+     * @param last End of the range.
+     * @param radius Maximum distance, included.
+     * @param offsets Receives the first neighbour of each query, plus the
+     *                total number of neighbours.
+     * @param neighbours Receives the indices of the neighbours.
+     */
+    template<class RandomAccessIterator>
+    void queryRadius(RandomAccessIterator first, RandomAccessIterator last, T radius,
+                     Indices & offsets, Indices & neighbours) const
+    {
+        const std::size_t count = std::distance(first, last);
+
+        offsets.resize(count + 1);
+        neighbours.clear();
+
+        Indices buckets;
+        for (std::size_t q = 0; q < count; ++q)
+        {
+            offsets[q] = static_cast<boost::uint32_t>(neighbours.size());
+            query(first[q], radius, buckets, std::back_inserter(neighbours));
+        }
+        offsets[count] = static_cast<boost::uint32_t>(neighbours.size());
+    }
+
+    /**
+     * Find the points within a distance of each point of a range, using the
+     * threads of a task pool.
+     *
+     * @see queryRadius
+     */
+    template<class RandomAccessIterator>
+    void queryRadius(RandomAccessIterator first, RandomAccessIterator last, T radius,
+                     Indices & offsets, Indices & neighbours, thread::TaskPool & pool) const
+    {
+        const std::size_t count = std::distance(first, last);
+        const std::size_t chunks = (count + QUERY_GRAIN - 1) / QUERY_GRAIN;
+
+        offsets.resize(count + 1);
+
+        std::vector<Indices> results(chunks);
+        QueryTask<RandomAccessIterator> task = { this, first, radius, &offsets[0], &results[0] };
+        thread::parallelFor(pool, 0, count, QUERY_GRAIN, task);
+
+        // Concatenate the chunks
+        std::size_t total = 0;
+        for (std::size_t k = 0; k < chunks; ++k)
+            total += results[k].size();
+
+        neighbours.resize(total);
+        std::size_t base = 0;
+        for (std::size_t k = 0; k < chunks; ++k)
+        {
+            std::copy(results[k].begin(), results[k].end(), neighbours.begin() + base);
+            for (std::size_t q = k * QUERY_GRAIN; q < std::min(count, (k + 1) * QUERY_GRAIN); ++q)
+                offsets[q] += static_cast<boost::uint32_t>(base);
+            base += results[k].size();
+        }
+        offsets[count] = static_cast<boost::uint32_t>(total);
+    }
+
+
+private:
+
+    void cellOf(const Vector<T, N> & point, boost::int32_t * cell) const
+    {
+        // Truncate, then round towards negative infinity, cheaper than std::floor
+        for (unsigned c = 0; c < N; ++c)
+        {
+            const T x = point[c] * _invCellSize;
+            cell[c] = static_cast<boost::int32_t>(x);
+            cell[c] -= (x < static_cast<T>(cell[c]));
+        }
+    }
+
+    boost::uint32_t hash(const boost::int32_t * cell) const
+    {
+        static const boost::uint32_t primes[4] = { 73856093u, 19349663u, 83492791u, 2654435761u };
+
+        boost::uint32_t h = 0;
+        for (unsigned c = 0; c < N; ++c)
+            h ^= static_cast<boost::uint32_t>(cell[c]) * primes[c];
+        return h & _mask;
+    }
+
+    template<class OutputIterator>
+    OutputIterator query(const Vector<T, N> & point, T radius, Indices & buckets, OutputIterator out) const
+    {
+        if (_points.empty() || radius < static_cast<T>(0))
+            return out;
+
+        boost::int32_t lower[N], upper[N], cell[N];
+        Vector<T, N> corner;
+        for (unsigned c = 0; c < N; ++c)
+            corner[c] = point[c] - radius;
+        cellOf(corner, lower);
+        for (unsigned c = 0; c < N; ++c)
+            corner[c] = point[c] + radius;
+        cellOf(corner, upper);
+
+        const T squaredRadius = radius * radius;
+
+        double cells = 1;
+        for (unsigned c = 0; c < N; ++c)
+            cells *= static_cast<double>(upper[c]) - lower[c] + 1;
+
+        if (cells >= static_cast<double>(_cellStart.size()))
+        {
+            // Large query, look in every bucket
+            for (std::size_t b = 0; b < _cellStart.size(); ++b)
+                out = scanBucket(static_cast<boost::uint32_t>(b), point, squaredRadius, out);
+            return out;
+        }
+
+        // Buckets of the cells overlapping the query, each one once. Small
+        // queries keep them on the stack, larger ones in the scratch vector
+        boost::uint32_t local[LOCAL_BUCKETS];
+        boost::uint32_t * first = local;
+        if (cells > static_cast<double>(LOCAL_BUCKETS))
+        {
+            buckets.resize(static_cast<std::size_t>(cells));
+            first = &buckets[0];
+        }
+
+        boost::uint32_t * last = first;
+        std::copy(lower, lower + N, cell);
+        for (;;)
+        {
+            *last++ = hash(cell);
+
+            unsigned c = 0;
+            while (c < N && cell[c] == upper[c])
+            {
+                cell[c] = lower[c];
+                ++c;
+            }
+            if (c == N)
+                break;
+            ++cell[c];
+        }
+
+        std::sort(first, last);
+        last = std::unique(first, last);
+
+        for (; first != last; ++first)
+            out = scanBucket(*first, point, squaredRadius, out);
+
+        return out;
+    }
+
+    template<class OutputIterator>
+    OutputIterator scanBucket(boost::uint32_t bucket, const Vector<T, N> & point, T squaredRadius,
+                              OutputIterator out) const
+    {
+        const boost::uint32_t start = _cellStart[bucket];
+        const boost::uint32_t end = start + _cellCount[bucket];
+        for (boost::uint32_t s = start; s < end; ++s)
+        {
+            const Vector<T, N> d(_points[s] - point);
+            if (d.dot(d) <= squaredRadius)
+                *out++ = _indices[s];
+        }
+        return out;
+    }
+
+    template<class RandomAccessIterator>
+    struct QueryTask
+    {
+        const HashGrid * grid;
+        RandomAccessIterator first;
+        T radius;
+        boost::uint32_t * offsets;
+        Indices * results;
+
+        void operator () (std::size_t begin, std::size_t end) const
+        {
+            Indices & result = results[begin / QUERY_GRAIN];
+            Indices buckets;
+            for (std::size_t q = begin; q < end; ++q)
+            {
+                offsets[q] = static_cast<boost::uint32_t>(result.size());
+                grid->query(first[q], radius, buckets, std::back_inserter(result));
+            }
+        }
+    };
+
+    /**
+     * Hash the points of chunks, and count the points per bucket of each
+     * chunk.
+     */
+    template<class RandomAccessIterator>
+    struct CountTask
+    {
+        HashGrid * grid;
+        RandomAccessIterator first;
+        std::size_t count;
+        std::size_t chunks;
+
+        void operator () (std::size_t kbegin, std::size_t kend) const
+        {
+            const std::size_t table = grid->_cellStart.size();
+            for (std::size_t k = kbegin; k < kend; ++k)
+            {
+                boost::uint32_t * counter = &grid->_counters[k * table];
+                std::fill(counter, counter + table, 0);
+
+                boost::int32_t cell[N];
+                for (std::size_t i = k * count / chunks; i < (k + 1) * count / chunks; ++i)
+                {
+                    grid->cellOf(first[i], cell);
+                    const boost::uint32_t h = grid->hash(cell);
+                    grid->_hashes[i] = h;
+                    ++counter[h];
+                }
+            }
+        }
+    };
+
+    /**
+     * Sum the counters of the chunks, per bucket.
+     */
+    struct SumTask
+    {
+        HashGrid * grid;
+        std::size_t chunks;
+
+        void operator () (std::size_t begin, std::size_t end) const
+        {
+            const std::size_t table = grid->_cellStart.size();
+            for (std::size_t b = begin; b < end; ++b)
+            {
+                boost::uint32_t total = 0;
+                for (std::size_t k = 0; k < chunks; ++k)
+                    total += grid->_counters[k * table + b];
+                grid->_cellCount[b] = total;
+            }
+        }
+    };
+
+    /**
+     * Turn the counters of the chunks into the position of their first
+     * point in each bucket.
+     */
+    struct OffsetTask
+    {
+        HashGrid * grid;
+        std::size_t chunks;
+
+        void operator () (std::size_t begin, std::size_t end) const
+        {
+            const std::size_t table = grid->_cellStart.size();
+            for (std::size_t b = begin; b < end; ++b)
+            {
+                boost::uint32_t offset = grid->_cellStart[b];
+                for (std::size_t k = 0; k < chunks; ++k)
+                {
+                    const boost::uint32_t n = grid->_counters[k * table + b];
+                    grid->_counters[k * table + b] = offset;
+                    offset += n;
+                }
+            }
+        }
+    };
+
+    /**
+     * Move the points of chunks to their bucket.
+     */
+    template<class RandomAccessIterator>
+    struct ScatterTask
+    {
+        HashGrid * grid;
+        RandomAccessIterator first;
+        std::size_t count;
+        std::size_t chunks;
+
+        void operator () (std::size_t kbegin, std::size_t kend) const
+        {
+            const std::size_t table = grid->_cellStart.size();
+            for (std::size_t k = kbegin; k < kend; ++k)
+            {
+                boost::uint32_t * counter = &grid->_counters[k * table];
+                for (std::size_t i = k * count / chunks; i < (k + 1) * count / chunks; ++i)
+                {
+                    const boost::uint32_t s = counter[grid->_hashes[i]]++;
+                    grid->_points[s] = first[i];
+                    grid->_indices[s] = static_cast<boost::uint32_t>(i);
+                }
+            }
+        }
+    };
+
+    template<class F>
+    static void run(thread::TaskPool * pool, std::size_t begin, std::size_t end, std::size_t grain, const F & f)
+    {
+        if (pool)
+            thread::parallelFor(*pool, begin, end, grain, f);
+        else
+            f(begin, end);
+    }
+
+    /**
+     * Counting sort of the points by bucket.
+     *
+     * Each chunk places its points after the points of the previous chunks
+     * in each bucket, so the order does not depend on the number of chunks.
+     */
+    template<class RandomAccessIterator>
+    void rebuildPoints(RandomAccessIterator first, RandomAccessIterator last, thread::TaskPool * pool)
+    {
+        const std::size_t count = std::distance(first, last);
+        if (count > std::numeric_limits<boost::uint32_t>::max())
+            throw std::length_error("Mw.Math.HashGrid: Too many points");
+
+        std::size_t table = 1;
+        const std::size_t requested = _tableSize ? _tableSize : count;
+        while (table < requested)
+            table *= 2;
+
+        _cellStart.resize(table);
+        _cellCount.resize(table);
+        _mask = static_cast<boost::uint32_t>(table - 1);
+
+        std::size_t chunks = pool ? std::min<std::size_t>(pool->getThreadCount(), MAX_CHUNKS) : 1;
+        chunks = std::max<std::size_t>(1, std::min(chunks, count / CHUNK_GRAIN));
+
+        _hashes.resize(count);
+        _counters.resize(chunks * table);
+        _points.resize(count);
+        _indices.resize(count);
+
+        CountTask<RandomAccessIterator> countTask = { this, first, count, chunks };
+        run(pool, 0, chunks, 1, countTask);
+
+        if (chunks == 1)
+            std::copy(_counters.begin(), _counters.end(), _cellCount.begin());
+        else
+        {
+            SumTask sumTask = { this, chunks };
+            run(pool, 0, table, BUCKET_GRAIN, sumTask);
+        }
+
+        boost::uint32_t start = 0;
+        for (std::size_t b = 0; b < table; ++b)
+        {
+            _cellStart[b] = start;
+            start += _cellCount[b];
+        }
+
+        OffsetTask offsetTask = { this, chunks };
+        run(pool, 0, table, BUCKET_GRAIN, offsetTask);
+
+        ScatterTask<RandomAccessIterator> scatterTask = { this, first, count, chunks };
+        run(pool, 0, chunks, 1, scatterTask);
+    }
+
+};
+// class HashGrid
+
+MW_END_NAMESPACE(math)
+
+#endif // MW_HASHGRID_HPP
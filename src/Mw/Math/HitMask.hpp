@@ -0,0 +1,63 @@
+/**
+ * @file   HitMask.hpp
+ * @author Bastien Brunnenstein
+ *
+ * @details Mask words of batch test results, shared by BoundsArray and
+ * PlaneSet.
+ *
+ * The batch tests write one byte per element of a block of up to 32
+ * elements, then pack the block into a word with one bit per element.
+ */
+
+#ifndef MW_HITMASK_HPP
+#define MW_HITMASK_HPP
+
+#include <Mw/Config.hpp>
+
+#include <Mw/Math/Bits.hpp>
+
+#include <cstddef>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+MW_BEGIN_NAMESPACE(math)
+
+namespace detail
+{
+
+/**
+ * Pack a block of test results into a mask word.
+ *
+ * @param hits Results, 0 or 1.
+ * @param block Number of results, at most 32.
+ */
+inline boost::uint32_t packHits(const unsigned char * hits, std::size_t block)
+{
+    boost::uint32_t word = 0;
+    for (std::size_t j = 0; j < block; ++j)
+        word |= static_cast<boost::uint32_t>(hits[j]) << j;
+    return word;
+}
+
+/**
+ * Append the indices of the bits set in a mask word.
+ *
+ * @param word Mask word.
+ * @param base Index of the first bit.
+ * @param indices Receives the indices, in increasing order.
+ */
+inline void appendHitIndices(boost::uint32_t word, std::size_t base, std::vector<std::size_t> & indices)
+{
+    while (word)
+    {
+        indices.push_back(base + countTrailingZeros(word));
+        word &= word - 1;
+    }
+}
+
+} // namespace detail
+
+MW_END_NAMESPACE(math)
+
+#endif // MW_HITMASK_HPP
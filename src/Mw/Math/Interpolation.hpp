@@ -3,6 +3,13 @@
  * @author Bastien Brunnenstein
  *
  * @details See http://paulbourke.net/miscellaneous/interpolation/
+ *
+ * The batch overloads interpolate arrays of samples at arrays of
+ * positions, and the resample functions read a signal at evenly spaced
+ * positions. Float arrays get SSE kernels.
+ *
+ * The cosine interpolation takes an optional math policy, ExactMath or
+ * FastMath, see FastMath.hpp.
  */
 
 #ifndef MW_INTERPOLATION_HPP
@@ -10,10 +17,18 @@
 
 #include <Mw/Config.hpp>
 
+#include <Mw/Math/FastMath.hpp>
+#include <Mw/Math/Simd.hpp>
+
 #include <cmath>
+#include <cstddef>
+#include <stdexcept>
 
 MW_BEGIN_NAMESPACE(math)
 
+template<typename T, unsigned N>
+class Vector;
+
 // TODO Comments sucks
 
 /**
@@ -26,7 +41,7 @@ MW_BEGIN_NAMESPACE(math)
  * @tparam U Scalar type.
  */
 template<class T, typename U>
-T linearInterpolate(T p1, T p2, U mu)
+T linearInterpolate(const T & p1, const T & p2, U mu)
 {
     return (p1 * (static_cast<U>(1) - mu) + p2 * mu);
 }
@@ -41,7 +56,7 @@ T linearInterpolate(T p1, T p2, U mu)
  * @tparam U Scalar type.
  */
 template<class T, typename U>
-T cosineInterpolate(T p1, T p2, U mu)
+T cosineInterpolate(const T & p1, const T & p2, U mu)
 {
     U mu2;
 
@@ -49,6 +64,26 @@ T cosineInterpolate(T p1, T p2, U mu)
     return (p1 * (static_cast<U>(1) - mu2) + p2 * mu2);
 }
 
+/**
+ * Compute a value between @a p1 and @a p2 using cosine interpolation, with
+ * the cosine of a math policy.
+ *
+ * @param p1 First sample.
+ * @param p2 Second sample.
+ * @param mu Position of the value in range. Value between 0 and 1.
+ * @tparam T Value's type. Must be multipliable by @a U.
+ * @tparam U Scalar type.
+ * @tparam Math Math policy, ExactMath or FastMath.
+ */
+template<class T, typename U, class Math>
+T cosineInterpolate(const T & p1, const T & p2, U mu, Math)
+{
+    U mu2;
+
+    mu2 = (static_cast<U>(1) - Math::cos(mu * static_cast<U>(M_PI))) / 2;
+    return (p1 * (static_cast<U>(1) - mu2) + p2 * mu2);
+}
+
 /**
  * Compute a value between @a p1 and @a p2 using cubic interpolation.
  *
@@ -61,17 +96,17 @@ T cosineInterpolate(T p1, T p2, U mu)
  * @tparam U Scalar type.
  */
 template<class T, typename U>
-T cubicInterpolate(T p0, T p1, T p2, T p3, U mu)
+T cubicInterpolate(const T & p0, const T & p1, const T & p2, const T & p3, U mu)
 {
-    double a0, a1, a2, a3, mu2;
+    U mu2;
 
+    // Coefficients in T, so that float samples are not widened
     mu2 = mu * mu;
-    a0 = p3 - p2 - p0 + p1;
-    a1 = p0 - p1 - a0;
-    a2 = p2 - p0;
-    a3 = p1;
+    const T a0 = p3 - p2 - p0 + p1;
+    const T a1 = p0 - p1 - a0;
+    const T a2 = p2 - p0;
 
-    return (a0 * mu * mu2 + a1 * mu2 + a2 * mu + a3);
+    return (a0 * (mu * mu2) + a1 * mu2 + a2 * mu + p1);
 }
 
 /**
@@ -86,20 +121,468 @@ T cubicInterpolate(T p0, T p1, T p2, T p3, U mu)
  * @tparam U Scalar type.
  */
 template<class T, typename U>
-T catmullRomInterpolate(T p0, T p1, T p2, T p3, U mu)
+T catmullRomInterpolate(const T & p0, const T & p1, const T & p2, const T & p3, U mu)
 {
-    T a0, a1, a2, a3;
-    U mu2;
+    U mu2, mu3;
 
+    // Weight each sample instead of building the polynomial coefficients,
+    // so vector expressions are evaluated in a single pass.
     mu2 = mu * mu;
-    a0 = static_cast<U>(-0.5) * p0 + static_cast<U>(1.5) * p1
-            + static_cast<U>(-1.5) * p2 + static_cast<U>(0.5) * p3;
-    a1 = p0 + static_cast<U>(-2.5) * p1 + static_cast<U>(2) * p2
-            + static_cast<U>(-0.5) * p3;
-    a2 = static_cast<U>(-0.5) * p0 + static_cast<U>(0.5) * p2;
-    a3 = p1;
-
-    return (a0 * mu * mu2 + a1 * mu2 + a2 * mu + a3);
+    mu3 = mu2 * mu;
+
+    return (p0 * (static_cast<U>(-0.5) * mu3 + mu2 + static_cast<U>(-0.5) * mu)
+          + p1 * (static_cast<U>(1.5) * mu3 + static_cast<U>(-2.5) * mu2 + static_cast<U>(1))
+          + p2 * (static_cast<U>(-1.5) * mu3 + static_cast<U>(2) * mu2 + static_cast<U>(0.5) * mu)
+          + p3 * (static_cast<U>(0.5) * mu3 + static_cast<U>(-0.5) * mu2));
+}
+
+
+namespace detail
+{
+
+/**
+ * Interpolation loops over arrays.
+ *
+ * The generic loops call the functions above, outputs may alias the
+ * inputs.
+ *
+ * @tparam T Value's type.
+ * @tparam U Scalar type.
+ */
+template<class T, typename U>
+struct InterpolationLoops
+{
+    static void linear(const T * p1, const T * p2, const U * mu, T * out, std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+            out[i] = linearInterpolate(p1[i], p2[i], mu[i]);
+    }
+
+    static void cosine(const T * p1, const T * p2, const U * mu, T * out, std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+            out[i] = cosineInterpolate(p1[i], p2[i], mu[i]);
+    }
+
+    template<class Math>
+    static void cosine(const T * p1, const T * p2, const U * mu, T * out, std::size_t begin, std::size_t end,
+                       Math math)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+            out[i] = cosineInterpolate(p1[i], p2[i], mu[i], math);
+    }
+
+    static void cubic(const T * p0, const T * p1, const T * p2, const T * p3, const U * mu, T * out,
+                      std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+            out[i] = cubicInterpolate(p0[i], p1[i], p2[i], p3[i], mu[i]);
+    }
+
+    static void catmullRom(const T * p0, const T * p1, const T * p2, const T * p3, const U * mu, T * out,
+                           std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+            out[i] = catmullRomInterpolate(p0[i], p1[i], p2[i], p3[i], mu[i]);
+    }
+};
+
+/**
+ * Interpolation kernels over arrays.
+ *
+ * Float gets SSE kernels, in float. Polynomials are evaluated in Horner
+ * form, and the cosine weights with a polynomial sine accurate to a few
+ * ulps for positions between 0 and 1, or with the cosine of the math
+ * policy when one is given.
+ *
+ * @tparam T Value's type.
+ * @tparam U Scalar type.
+ */
+template<class T, typename U>
+struct InterpolationKernels : InterpolationLoops<T, U>
+{};
+
+#ifdef MW_SIMD_SSE
+
+template<>
+struct InterpolationKernels<float, float>
+{
+    typedef InterpolationLoops<float, float> Loops;
+
+    static void linear(const float * p1, const float * p2, const float * mu, float * out,
+                       std::size_t begin, std::size_t end)
+    {
+        std::size_t i = begin;
+        for (; i + 4 <= end; i += 4)
+        {
+            // p1 + (p2 - p1) mu is not exact at mu = 1, keep the weights
+            const __m128 a = _mm_loadu_ps(p1 + i), b = _mm_loadu_ps(p2 + i), t = _mm_loadu_ps(mu + i);
+            const __m128 s = _mm_sub_ps(_mm_set1_ps(1.0f), t);
+            _mm_storeu_ps(out + i, _mm_add_ps(_mm_mul_ps(a, s), _mm_mul_ps(b, t)));
+        }
+        Loops::linear(p1, p2, mu, out, i, end);
+    }
+
+    template<class Math>
+    static void cosine(const float * p1, const float * p2, const float * mu, float * out,
+                       std::size_t begin, std::size_t end, Math math)
+    {
+        std::size_t i = begin;
+#ifdef MW_SIMD_SSE2
+        for (; i + 4 <= end; i += 4)
+        {
+            const __m128 a = _mm_loadu_ps(p1 + i), b = _mm_loadu_ps(p2 + i);
+            const __m128 c = Math::cos(_mm_mul_ps(_mm_loadu_ps(mu + i), _mm_set1_ps(3.1415926535897932f)));
+            const __m128 t = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(1.0f), c), _mm_set1_ps(0.5f));
+            const __m128 s = _mm_sub_ps(_mm_set1_ps(1.0f), t);
+            _mm_storeu_ps(out + i, _mm_add_ps(_mm_mul_ps(a, s), _mm_mul_ps(b, t)));
+        }
+#endif
+        Loops::cosine(p1, p2, mu, out, i, end, math);
+    }
+
+    /**
+     * Cosine weights <tt>(1 - cos(pi mu)) / 2 = (1 + sin(pi (mu - 1/2))) / 2</tt>
+     * of 4 positions between 0 and 1.
+     *
+     * The sine is a degree 11 odd polynomial on [-pi/2, pi/2], which needs
+     * no range reduction.
+     */
+    static __m128 cosineWeight(__m128 mu)
+    {
+        const __m128 x = _mm_mul_ps(_mm_sub_ps(mu, _mm_set1_ps(0.5f)), _mm_set1_ps(3.1415926535897932f));
+        const __m128 x2 = _mm_mul_ps(x, x);
+
+        __m128 p = _mm_set1_ps(-2.5052108385e-8f);
+        p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(2.7557319224e-6f));
+        p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(-1.9841269841e-4f));
+        p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(8.3333333333e-3f));
+        p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(-1.6666666667e-1f));
+        const __m128 sine = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(p, x2), x), x);
+
+        const __m128 half = _mm_set1_ps(0.5f);
+        return _mm_add_ps(half, _mm_mul_ps(half, sine));
+    }
+
+    static void cosine(const float * p1, const float * p2, const float * mu, float * out,
+                       std::size_t begin, std::size_t end)
+    {
+        std::size_t i = begin;
+        for (; i + 4 <= end; i += 4)
+        {
+            const __m128 a = _mm_loadu_ps(p1 + i), b = _mm_loadu_ps(p2 + i);
+            const __m128 t = cosineWeight(_mm_loadu_ps(mu + i));
+            const __m128 s = _mm_sub_ps(_mm_set1_ps(1.0f), t);
+            _mm_storeu_ps(out + i, _mm_add_ps(_mm_mul_ps(a, s), _mm_mul_ps(b, t)));
+        }
+        Loops::cosine(p1, p2, mu, out, i, end);
+    }
+
+    static void cubic(const float * p0, const float * p1, const float * p2, const float * p3,
+                      const float * mu, float * out, std::size_t begin, std::size_t end)
+    {
+        std::size_t i = begin;
+        for (; i + 4 <= end; i += 4)
+        {
+            const __m128 a = _mm_loadu_ps(p0 + i), b = _mm_loadu_ps(p1 + i);
+            const __m128 c = _mm_loadu_ps(p2 + i), d = _mm_loadu_ps(p3 + i);
+            const __m128 t = _mm_loadu_ps(mu + i);
+
+            const __m128 a0 = _mm_add_ps(_mm_sub_ps(_mm_sub_ps(d, c), a), b);
+            const __m128 a1 = _mm_sub_ps(_mm_sub_ps(a, b), a0);
+            const __m128 a2 = _mm_sub_ps(c, a);
+
+            __m128 r = _mm_add_ps(_mm_mul_ps(a0, t), a1);
+            r = _mm_add_ps(_mm_mul_ps(r, t), a2);
+            _mm_storeu_ps(out + i, _mm_add_ps(_mm_mul_ps(r, t), b));
+        }
+        Loops::cubic(p0, p1, p2, p3, mu, out, i, end);
+    }
+
+    static void catmullRom(const float * p0, const float * p1, const float * p2, const float * p3,
+                           const float * mu, float * out, std::size_t begin, std::size_t end)
+    {
+        std::size_t i = begin;
+        for (; i + 4 <= end; i += 4)
+        {
+            const __m128 a = _mm_loadu_ps(p0 + i), b = _mm_loadu_ps(p1 + i);
+            const __m128 c = _mm_loadu_ps(p2 + i), d = _mm_loadu_ps(p3 + i);
+            const __m128 t = _mm_loadu_ps(mu + i);
+
+            // ((-a + 3b - 3c + d) t^3 + (2a - 5b + 4c - d) t^2 + (c - a) t) / 2 + b
+            const __m128 three = _mm_set1_ps(3.0f);
+            const __m128 a3 = _mm_add_ps(_mm_sub_ps(d, a), _mm_mul_ps(three, _mm_sub_ps(b, c)));
+            const __m128 a2 = _mm_sub_ps(_mm_add_ps(_mm_add_ps(a, a), _mm_mul_ps(_mm_set1_ps(4.0f), c)),
+                                         _mm_add_ps(_mm_mul_ps(_mm_set1_ps(5.0f), b), d));
+            const __m128 a1 = _mm_sub_ps(c, a);
+
+            __m128 r = _mm_add_ps(_mm_mul_ps(a3, t), a2);
+            r = _mm_add_ps(_mm_mul_ps(r, t), a1);
+            r = _mm_mul_ps(_mm_mul_ps(r, t), _mm_set1_ps(0.5f));
+            _mm_storeu_ps(out + i, _mm_add_ps(r, b));
+        }
+        Loops::catmullRom(p0, p1, p2, p3, mu, out, i, end);
+    }
+};
+
+#endif // MW_SIMD_SSE
+
+/**
+ * Positions of evenly spaced values of a signal, by blocks.
+ *
+ * Positions are computed in double, so that long signals keep their
+ * precision, and clamped to the signal. The samples around each position
+ * are gathered with the edge samples repeated.
+ */
+template<class T, typename U>
+struct ResampleBlock
+{
+    static const std::size_t SIZE = 64;
+
+    T p0[SIZE], p1[SIZE], p2[SIZE], p3[SIZE];
+    U mu[SIZE];
+
+    /**
+     * Gather the samples of the values @c begin to <tt>begin + count</tt>.
+     *
+     * @param neighbors Also gather the samples before and after.
+     */
+    void gather(const T * samples, std::size_t sampleCount, double start, double step,
+                std::size_t begin, std::size_t count, bool neighbors)
+    {
+        const double last = static_cast<double>(sampleCount - 1);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            double x = start + static_cast<double>(begin + i) * step;
+            x = x < 0.0 ? 0.0 : (x > last ? last : x);
+
+            // The last interval ends at the last sample
+            std::size_t index = static_cast<std::size_t>(x);
+            if (index + 1 >= sampleCount)
+                index = sampleCount >= 2 ? sampleCount - 2 : 0;
+
+            const std::size_t next = index + 1 < sampleCount ? index + 1 : index;
+            p1[i] = samples[index];
+            p2[i] = samples[next];
+            mu[i] = static_cast<U>(x - static_cast<double>(index));
+
+            if (neighbors)
+            {
+                p0[i] = samples[index > 0 ? index - 1 : 0];
+                p3[i] = samples[next + 1 < sampleCount ? next + 1 : next];
+            }
+        }
+    }
+};
+
+/**
+ * Scalar type of the positions used to resample a signal of @c T.
+ */
+template<class T>
+struct ResampleScalar
+{
+    typedef T type;
+};
+
+template<typename T, unsigned N>
+struct ResampleScalar< Vector<T, N> >
+{
+    typedef T type;
+};
+
+inline void checkSamples(std::size_t sampleCount)
+{
+    if (sampleCount == 0)
+        throw std::invalid_argument("Mw.Math.Interpolation: No samples");
+}
+
+} // namespace detail
+
+
+/**
+ * Compute values using linear interpolation, on arrays.
+ *
+ * @param p1 First samples.
+ * @param p2 Second samples.
+ * @param mu Positions of the values, between 0 and 1.
+ * @param out Values, may be one of the inputs.
+ * @param count Number of values.
+ */
+template<class T, typename U>
+void linearInterpolate(const T * p1, const T * p2, const U * mu, T * out, std::size_t count)
+{
+    detail::InterpolationKernels<T, U>::linear(p1, p2, mu, out, 0, count);
+}
+
+/**
+ * Compute values using cosine interpolation, on arrays.
+ *
+ * @param p1 First samples.
+ * @param p2 Second samples.
+ * @param mu Positions of the values, between 0 and 1.
+ * @param out Values, may be one of the inputs.
+ * @param count Number of values.
+ */
+template<class T, typename U>
+void cosineInterpolate(const T * p1, const T * p2, const U * mu, T * out, std::size_t count)
+{
+    detail::InterpolationKernels<T, U>::cosine(p1, p2, mu, out, 0, count);
+}
+
+/**
+ * Compute values using cosine interpolation, on arrays, with the cosine of
+ * a math policy.
+ *
+ * @param p1 First samples.
+ * @param p2 Second samples.
+ * @param mu Positions of the values, between 0 and 1.
+ * @param out Values, may be one of the inputs.
+ * @param count Number of values.
+ * @param math Math policy, ExactMath or FastMath.
+ */
+template<class T, typename U, class Math>
+void cosineInterpolate(const T * p1, const T * p2, const U * mu, T * out, std::size_t count, Math math)
+{
+    detail::InterpolationKernels<T, U>::cosine(p1, p2, mu, out, 0, count, math);
+}
+
+/**
+ * Compute values using cubic interpolation, on arrays.
+ *
+ * @param p0 Points before first samples.
+ * @param p1 First samples.
+ * @param p2 Second samples.
+ * @param p3 Points after second samples.
+ * @param mu Positions of the values, between 0 and 1.
+ * @param out Values, may be one of the inputs.
+ * @param count Number of values.
+ */
+template<class T, typename U>
+void cubicInterpolate(const T * p0, const T * p1, const T * p2, const T * p3, const U * mu,
+                      T * out, std::size_t count)
+{
+    detail::InterpolationKernels<T, U>::cubic(p0, p1, p2, p3, mu, out, 0, count);
+}
+
+/**
+ * Compute values using catmull-rom interpolation, on arrays.
+ *
+ * @param p0 Points before first samples.
+ * @param p1 First samples.
+ * @param p2 Second samples.
+ * @param p3 Points after second samples.
+ * @param mu Positions of the values, between 0 and 1.
+ * @param out Values, may be one of the inputs.
+ * @param count Number of values.
+ */
+template<class T, typename U>
+void catmullRomInterpolate(const T * p0, const T * p1, const T * p2, const T * p3, const U * mu,
+                           T * out, std::size_t count)
+{
+    detail::InterpolationKernels<T, U>::catmullRom(p0, p1, p2, p3, mu, out, 0, count);
+}
+
+/**
+ * Read a signal at evenly spaced positions using linear interpolation.
+ *
+ * The value @c i is at the position <tt>start + i * step</tt>, in samples.
+ * Positions are computed in double and clamped to the signal, only the
+ * position between two samples is narrowed to the scalar type of @c T.
+ *
+ * @param samples Signal.
+ * @param sampleCount Number of samples.
+ * @param start Position of the first value.
+ * @param step Distance between the values.
+ * @param out Values.
+ * @param count Number of values.
+ * @throw std::invalid_argument if @c sampleCount is 0.
+ */
+template<class T>
+void linearResample(const T * samples, std::size_t sampleCount, double start, double step, T * out,
+                    std::size_t count)
+{
+    typedef typename detail::ResampleScalar<T>::type U;
+
+    detail::checkSamples(sampleCount);
+
+    detail::ResampleBlock<T, U> block;
+    for (std::size_t i = 0; i < count; i += block.SIZE)
+    {
+        const std::size_t n = count - i < block.SIZE ? count - i : block.SIZE;
+        block.gather(samples, sampleCount, start, step, i, n, false);
+        detail::InterpolationKernels<T, U>::linear(block.p1, block.p2, block.mu, out + i, 0, n);
+    }
+}
+
+/**
+ * Read a signal at evenly spaced positions using cosine interpolation.
+ *
+ * @see linearResample()
+ */
+template<class T>
+void cosineResample(const T * samples, std::size_t sampleCount, double start, double step, T * out,
+                    std::size_t count)
+{
+    typedef typename detail::ResampleScalar<T>::type U;
+
+    detail::checkSamples(sampleCount);
+
+    detail::ResampleBlock<T, U> block;
+    for (std::size_t i = 0; i < count; i += block.SIZE)
+    {
+        const std::size_t n = count - i < block.SIZE ? count - i : block.SIZE;
+        block.gather(samples, sampleCount, start, step, i, n, false);
+        detail::InterpolationKernels<T, U>::cosine(block.p1, block.p2, block.mu, out + i, 0, n);
+    }
+}
+
+/**
+ * Read a signal at evenly spaced positions using cubic interpolation.
+ *
+ * The first and last samples are repeated outside of the signal.
+ *
+ * @see linearResample()
+ */
+template<class T>
+void cubicResample(const T * samples, std::size_t sampleCount, double start, double step, T * out,
+                   std::size_t count)
+{
+    typedef typename detail::ResampleScalar<T>::type U;
+
+    detail::checkSamples(sampleCount);
+
+    detail::ResampleBlock<T, U> block;
+    for (std::size_t i = 0; i < count; i += block.SIZE)
+    {
+        const std::size_t n = count - i < block.SIZE ? count - i : block.SIZE;
+        block.gather(samples, sampleCount, start, step, i, n, true);
+        detail::InterpolationKernels<T, U>::cubic(block.p0, block.p1, block.p2, block.p3, block.mu, out + i, 0, n);
+    }
+}
+
+/**
+ * Read a signal at evenly spaced positions using catmull-rom interpolation.
+ *
+ * The first and last samples are repeated outside of the signal.
+ *
+ * @see linearResample()
+ */
+template<class T>
+void catmullRomResample(const T * samples, std::size_t sampleCount, double start, double step, T * out,
+                        std::size_t count)
+{
+    typedef typename detail::ResampleScalar<T>::type U;
+
+    detail::checkSamples(sampleCount);
+
+    detail::ResampleBlock<T, U> block;
+    for (std::size_t i = 0; i < count; i += block.SIZE)
+    {
+        const std::size_t n = count - i < block.SIZE ? count - i : block.SIZE;
+        block.gather(samples, sampleCount, start, step, i, n, true);
+        detail::InterpolationKernels<T, U>::catmullRom(block.p0, block.p1, block.p2, block.p3, block.mu,
+                                                       out + i, 0, n);
+    }
 }
 
 MW_END_NAMESPACE(math)
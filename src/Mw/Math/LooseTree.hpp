@@ -0,0 +1,749 @@
+/**
+ * @file   LooseTree.hpp
+ * @author Bastien Brunnenstein
+ */
+
+#ifndef MW_LOOSETREE_HPP
+#define MW_LOOSETREE_HPP
+
+#include <Mw/Config.hpp>
+
+#include <Mw/Math/Bounds.hpp>
+#include <Mw/Math/Vector.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/assert.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+
+MW_BEGIN_NAMESPACE(math)
+
+/**
+ * Loose tree (quadtree for N = 2, octree for N = 3).
+ *
+ * Spatial index over a set of moving Bounds, each associated with a payload.
+ *
+ * Each node covers a cubic cell of the world, and holds the items whose
+ * center is in the cell and whose size is about the size of the cell. The
+ * bounds of a node are twice as large as its cell, so an item always fits
+ * in a node at the depth given by its size: inserting, removing or moving
+ * an item does not depend on the other items. A moving item stays in its
+ * node as long as it fits in it.
+ *
+ * Items are referenced by handles, that become invalid when the item is
+ * removed. Nodes and items are stored in pools, there is no allocation
+ * once the pools are large enough.
+ *
+ * Items whose center is outside of the world bounds are kept in the root.
+ *
+ * @tparam T Scalar type.
+ * @tparam N Dimension (number of components).
+ * @tparam P Payload type.
+ * @tparam V Vectorial type.
+ */
+template<typename T, unsigned N, class P = std::size_t, class V = Vector<T, N> >
+class LooseTree
+{
+    BOOST_STATIC_ASSERT_MSG(N >= 1 && N <= 4, "Mw.Math.LooseTree: Dimension must be between 1 and 4");
+
+public:
+
+    /**
+     * Reference to an item of the tree.
+     */
+    struct Handle
+    {
+        boost::uint32_t index;
+        boost::uint32_t generation;
+
+        bool operator == (const Handle & handle) const
+        {
+            return index == handle.index && generation == handle.generation;
+        }
+
+        bool operator != (const Handle & handle) const
+        {
+            return !(*this == handle);
+        }
+    };
+
+    /**
+     * Maximum depth of the tree.
+     */
+    static const unsigned MAX_DEPTH = 16;
+
+    /**
+     * Number of children of a node.
+     */
+    static const unsigned CHILDREN = 1u << N;
+
+private:
+
+    static const boost::uint32_t NONE = 0xFFFFFFFFu;
+
+    struct Node
+    {
+        T center[N];
+
+        /**
+         * Half size of the cell, the node bounds are twice as large.
+         */
+        T half;
+
+        unsigned depth;
+
+        boost::uint32_t parent;
+        boost::uint32_t children[CHILDREN];
+
+        /**
+         * First item of the node, the items form a doubly linked list.
+         */
+        boost::uint32_t first;
+
+        /**
+         * Number of items in the node and its descendants.
+         */
+        boost::uint32_t count;
+    };
+
+    struct Item
+    {
+        Bounds<T, N, V> bounds;
+        P payload;
+        boost::uint32_t node;
+        boost::uint32_t previous;
+        boost::uint32_t next;
+        boost::uint32_t generation;
+    };
+
+    /**
+     * Pool of nodes, the root is the first one.
+     */
+    std::vector<Node> _nodes;
+    std::vector<boost::uint32_t> _freeNodes;
+
+    /**
+     * Pool of items.
+     */
+    std::vector<Item> _items;
+    std::vector<boost::uint32_t> _freeItems;
+
+    /**
+     * Lower corner of the cubic world.
+     */
+    T _origin[N];
+
+public:
+
+    // Constructors
+
+    /**
+     * Constructor.
+     *
+     * @param world Bounds of the world, extended to a cube.
+     */
+    explicit LooseTree(const Bounds<T, N, V> & world)
+    {
+        T half = static_cast<T>(0);
+        for (unsigned c = 0; c < N; ++c)
+            half = std::max(half, (world.getUpperLimit().get(c) - world.getLowerLimit().get(c)) / 2);
+
+        if (!(half > static_cast<T>(0)))
+            throw std::invalid_argument("Mw.Math.LooseTree: Empty world bounds");
+
+        Node root;
+        for (unsigned c = 0; c < N; ++c)
+        {
+            root.center[c] = (world.getLowerLimit().get(c) + world.getUpperLimit().get(c)) / 2;
+            _origin[c] = root.center[c] - half;
+        }
+        root.half = half;
+        root.depth = 0;
+        root.parent = NONE;
+        std::fill(root.children, root.children + CHILDREN, NONE);
+        root.first = NONE;
+        root.count = 0;
+
+        _nodes.push_back(root);
+    }
+
+
+    // Getters
+
+    /**
+     * Get the number of items in the tree.
+     *
+     * @return Number of items.
+     */
+    std::size_t size() const
+    {
+        return _nodes[0].count;
+    }
+
+    /**
+     * Check if the tree is empty.
+     *
+     * @return @c true if the tree has no items.
+     */
+    bool empty() const
+    {
+        return _nodes[0].count == 0;
+    }
+
+    /**
+     * Get the number of nodes in use.
+     *
+     * @return Number of nodes, including the root.
+     */
+    std::size_t getNodeCount() const
+    {
+        return _nodes.size() - _freeNodes.size();
+    }
+
+    /**
+     * Check if a handle references an item of the tree.
+     *
+     * @param handle A handle.
+     * @return @c true if the item has not been removed.
+     */
+    bool contains(Handle handle) const
+    {
+        return handle.index < _items.size()
+            && _items[handle.index].generation == handle.generation
+            && _items[handle.index].node != NONE;
+    }
+
+    /**
+     * Get the bounds of an item.
+     *
+     * @param handle Item's handle.
+     * @return Bounds of the item.
+     */
+    const Bounds<T, N, V> & getBounds(Handle handle) const
+    {
+        return _items[check(handle)].bounds;
+    }
+
+    /**
+     * Get the payload of an item.
+     *
+     * @param handle Item's handle.
+     * @return Payload of the item.
+     */
+    const P & getPayload(Handle handle) const
+    {
+        return _items[check(handle)].payload;
+    }
+
+
+    // Modifiers
+
+    /**
+     * Insert an item.
+     *
+     * @param bounds Bounds of the item.
+     * @param payload Payload of the item.
+     * @return Handle of the item.
+     */
+    Handle insert(const Bounds<T, N, V> & bounds, const P & payload)
+    {
+        boost::uint32_t index;
+        if (_freeItems.empty())
+        {
+            index = static_cast<boost::uint32_t>(_items.size());
+            if (index == NONE)
+                throw std::length_error("Mw.Math.LooseTree: Too many items");
+
+            Item item = Item();
+            item.node = NONE;
+            item.previous = NONE;
+            item.next = NONE;
+            item.generation = 0;
+            _items.push_back(item);
+        }
+        else
+        {
+            index = _freeItems.back();
+            _freeItems.pop_back();
+        }
+
+        Item & item = _items[index];
+        item.bounds = bounds;
+        item.payload = payload;
+        link(index, findNode(bounds));
+
+        Handle handle = { index, item.generation };
+        return handle;
+    }
+
+    /**
+     * Remove an item.
+     *
+     * @param handle Item's handle, invalid after the call.
+     */
+    void remove(Handle handle)
+    {
+        const boost::uint32_t index = check(handle);
+
+        unlink(index);
+
+        ++_items[index].generation;
+        _freeItems.push_back(index);
+    }
+
+    /**
+     * Change the bounds of an item.
+     *
+     * The item stays in its node if it still fits in it.
+     *
+     * @param handle Item's handle.
+     * @param bounds New bounds.
+     */
+    void move(Handle handle, const Bounds<T, N, V> & bounds)
+    {
+        const boost::uint32_t index = check(handle);
+        Item & item = _items[index];
+        item.bounds = bounds;
+
+        const Node & node = _nodes[item.node];
+        if (item.node != 0 && node.depth == getDepth(bounds) && fits(node, bounds))
+            return;
+
+        unlink(index);
+        link(index, findNode(bounds));
+    }
+
+    /**
+     * Remove all the items.
+     *
+     * Handles of the removed items become invalid.
+     */
+    void clear()
+    {
+        for (std::size_t i = 0; i < _items.size(); ++i)
+            if (_items[i].node != NONE)
+            {
+                _items[i].node = NONE;
+                ++_items[i].generation;
+                _freeItems.push_back(static_cast<boost::uint32_t>(i));
+            }
+
+        _nodes.resize(1);
+        _freeNodes.clear();
+        std::fill(_nodes[0].children, _nodes[0].children + CHILDREN, NONE);
+        _nodes[0].first = NONE;
+        _nodes[0].count = 0;
+    }
+
+
+    // Queries
+
+    /**
+     * Find the items intersecting with given bounds.
+     *
+     * Same test as Bounds::isIntersecting.
+     *
+     * @param bounds Bounds to check the intersection with.
+     * @param out Output iterator receiving the payloads.
+     * @return End of the output range.
+     */
+    template<class OutputIterator>
+    OutputIterator queryBounds(const Bounds<T, N, V> & bounds, OutputIterator out) const
+    {
+        T lower[N], upper[N];
+        for (unsigned c = 0; c < N; ++c)
+        {
+            lower[c] = bounds.getLowerLimit().get(c);
+            upper[c] = bounds.getUpperLimit().get(c);
+        }
+
+        boost::uint32_t stack[STACK_SIZE];
+        unsigned top = 0;
+        stack[top++] = 0;
+
+        while (top)
+        {
+            const Node & node = _nodes[stack[--top]];
+
+            for (boost::uint32_t i = node.first; i != NONE; i = _items[i].next)
+                if (_items[i].bounds.isIntersecting(bounds))
+                    *out++ = _items[i].payload;
+
+            for (unsigned k = 0; k < CHILDREN; ++k)
+                if (node.children[k] != NONE && overlaps(_nodes[node.children[k]], lower, upper))
+                {
+                    BOOST_ASSERT(top < STACK_SIZE);
+                    stack[top++] = node.children[k];
+                }
+        }
+
+        return out;
+    }
+
+    /**
+     * Find the items having a point inside.
+     *
+     * Same test as Bounds::hasPointInside.
+     *
+     * @param point A point.
+     * @param out Output iterator receiving the payloads.
+     * @return End of the output range.
+     */
+    template<class OutputIterator>
+    OutputIterator queryPoint(const V & point, OutputIterator out) const
+    {
+        T p[N];
+        for (unsigned c = 0; c < N; ++c)
+            p[c] = point.get(c);
+
+        boost::uint32_t stack[STACK_SIZE];
+        unsigned top = 0;
+        stack[top++] = 0;
+
+        while (top)
+        {
+            const Node & node = _nodes[stack[--top]];
+
+            for (boost::uint32_t i = node.first; i != NONE; i = _items[i].next)
+                if (_items[i].bounds.hasPointInside(point))
+                    *out++ = _items[i].payload;
+
+            for (unsigned k = 0; k < CHILDREN; ++k)
+                if (node.children[k] != NONE && overlaps(_nodes[node.children[k]], p, p))
+                {
+                    BOOST_ASSERT(top < STACK_SIZE);
+                    stack[top++] = node.children[k];
+                }
+        }
+
+        return out;
+    }
+
+    /**
+     * Find the item nearest to a point.
+     *
+     * The distance to an item is the distance to its bounds, 0 when the
+     * point is inside.
+     *
+     * @param point A point.
+     * @param handle Receives the handle of the nearest item.
+     * @param maxDistance Items farther than this distance are ignored.
+     * @return @c true if an item was found.
+     */
+    bool findNearest(const V & point, Handle & handle,
+                     T maxDistance = std::numeric_limits<T>::max()) const
+    {
+        T p[N];
+        for (unsigned c = 0; c < N; ++c)
+            p[c] = point.get(c);
+
+        // Compare squared distances
+        T best = maxDistance < std::sqrt(std::numeric_limits<T>::max())
+               ? maxDistance * maxDistance : std::numeric_limits<T>::max();
+        boost::uint32_t found = NONE;
+
+        // Children are pushed from the farthest, so the nearest is visited first
+        boost::uint32_t stack[STACK_SIZE];
+        T distances[STACK_SIZE];
+        unsigned top = 0;
+        stack[top] = 0;
+        distances[top++] = static_cast<T>(0);
+
+        while (top)
+        {
+            --top;
+            if (distances[top] > best)
+                continue;
+
+            const Node & node = _nodes[stack[top]];
+
+            for (boost::uint32_t i = node.first; i != NONE; i = _items[i].next)
+            {
+                const T d = squaredDistance(_items[i].bounds, p);
+                if (d <= best)
+                {
+                    best = d;
+                    found = i;
+                }
+            }
+
+            boost::uint32_t children[CHILDREN];
+            T childDistances[CHILDREN];
+            unsigned count = 0;
+            for (unsigned k = 0; k < CHILDREN; ++k)
+                if (node.children[k] != NONE)
+                {
+                    const T d = squaredDistance(_nodes[node.children[k]], p);
+                    if (d > best)
+                        continue;
+
+                    // Insertion sort, farthest first
+                    unsigned j = count++;
+                    for (; j > 0 && childDistances[j - 1] < d; --j)
+                    {
+                        children[j] = children[j - 1];
+                        childDistances[j] = childDistances[j - 1];
+                    }
+                    children[j] = node.children[k];
+                    childDistances[j] = d;
+                }
+
+            for (unsigned j = 0; j < count; ++j)
+            {
+                BOOST_ASSERT(top < STACK_SIZE);
+                stack[top] = children[j];
+                distances[top++] = childDistances[j];
+            }
+        }
+
+        if (found == NONE)
+            return false;
+
+        handle.index = found;
+        handle.generation = _items[found].generation;
+        return true;
+    }
+
+
+private:
+
+    /**
+     * Size of the traversal stacks, a node and the pending siblings of its
+     * ancestors.
+     */
+    static const unsigned STACK_SIZE = (CHILDREN - 1) * MAX_DEPTH + 1;
+
+    boost::uint32_t check(Handle handle) const
+    {
+        if (!contains(handle))
+            throw std::invalid_argument("Mw.Math.LooseTree: Invalid handle");
+
+        return handle.index;
+    }
+
+    /**
+     * Get the depth of the nodes whose cell is at least as large as an item.
+     */
+    unsigned getDepth(const Bounds<T, N, V> & bounds) const
+    {
+        T size = static_cast<T>(0);
+        for (unsigned c = 0; c < N; ++c)
+            size = std::max(size, (bounds.getUpperLimit().get(c) - bounds.getLowerLimit().get(c)) / 2);
+
+        unsigned depth = 0;
+        T half = _nodes[0].half / 2;
+        while (depth < MAX_DEPTH && size <= half)
+        {
+            half /= 2;
+            ++depth;
+        }
+        return depth;
+    }
+
+    /**
+     * Check if an item fits in the bounds of a node.
+     */
+    static bool fits(const Node & node, const Bounds<T, N, V> & bounds)
+    {
+        const T loose = 2 * node.half;
+        for (unsigned c = 0; c < N; ++c)
+            if (bounds.getLowerLimit().get(c) < node.center[c] - loose
+             || bounds.getUpperLimit().get(c) > node.center[c] + loose)
+                return false;
+        return true;
+    }
+
+    /**
+     * Check if bounds overlap with the bounds of a node.
+     *
+     * Conservative test, items touching the node bounds are not skipped.
+     */
+    static bool overlaps(const Node & node, const T * lower, const T * upper)
+    {
+        const T loose = 2 * node.half;
+        for (unsigned c = 0; c < N; ++c)
+            if (lower[c] > node.center[c] + loose || upper[c] < node.center[c] - loose)
+                return false;
+        return true;
+    }
+
+    static T squaredDistance(const T * lower, const T * upper, const T * point)
+    {
+        T distance = static_cast<T>(0);
+        for (unsigned c = 0; c < N; ++c)
+        {
+            T d = static_cast<T>(0);
+            if (point[c] < lower[c])
+                d = lower[c] - point[c];
+            else if (point[c] > upper[c])
+                d = point[c] - upper[c];
+            distance += d * d;
+        }
+        return distance;
+    }
+
+    static T squaredDistance(const Bounds<T, N, V> & bounds, const T * point)
+    {
+        T lower[N], upper[N];
+        for (unsigned c = 0; c < N; ++c)
+        {
+            lower[c] = bounds.getLowerLimit().get(c);
+            upper[c] = bounds.getUpperLimit().get(c);
+        }
+        return squaredDistance(lower, upper, point);
+    }
+
+    static T squaredDistance(const Node & node, const T * point)
+    {
+        T lower[N], upper[N];
+        for (unsigned c = 0; c < N; ++c)
+        {
+            lower[c] = node.center[c] - 2 * node.half;
+            upper[c] = node.center[c] + 2 * node.half;
+        }
+        return squaredDistance(lower, upper, point);
+    }
+
+    /**
+     * Find the node of an item, creating the missing nodes on the way.
+     */
+    boost::uint32_t findNode(const Bounds<T, N, V> & bounds)
+    {
+        const unsigned depth = getDepth(bounds);
+
+        T center[N];
+        for (unsigned c = 0; c < N; ++c)
+        {
+            center[c] = (bounds.getLowerLimit().get(c) + bounds.getUpperLimit().get(c)) / 2;
+
+            // Outside of the world
+            if (!(center[c] >= _origin[c] && center[c] <= _origin[c] + 2 * _nodes[0].half))
+                return 0;
+        }
+
+        // Descend while the item fits in the child containing its center
+        boost::uint32_t current = 0;
+        while (_nodes[current].depth < depth)
+        {
+            unsigned k = 0;
+            for (unsigned c = 0; c < N; ++c)
+                if (center[c] >= _nodes[current].center[c])
+                    k |= 1u << c;
+
+            boost::uint32_t child = _nodes[current].children[k];
+            if (child == NONE)
+            {
+                Node node;
+                makeChild(_nodes[current], k, node);
+                if (!fits(node, bounds))
+                    break;
+
+                child = allocateNode(current, k, node);
+            }
+            else if (!fits(_nodes[child], bounds))
+                break;
+
+            current = child;
+        }
+
+        return current;
+    }
+
+    static void makeChild(const Node & parent, unsigned k, Node & node)
+    {
+        node.half = parent.half / 2;
+        for (unsigned c = 0; c < N; ++c)
+            node.center[c] = (k & (1u << c)) ? parent.center[c] + node.half : parent.center[c] - node.half;
+        node.depth = parent.depth + 1;
+        std::fill(node.children, node.children + CHILDREN, NONE);
+        node.first = NONE;
+        node.count = 0;
+    }
+
+    boost::uint32_t allocateNode(boost::uint32_t parent, unsigned k, const Node & node)
+    {
+        boost::uint32_t index;
+        if (_freeNodes.empty())
+        {
+            index = static_cast<boost::uint32_t>(_nodes.size());
+            _nodes.push_back(node);
+        }
+        else
+        {
+            index = _freeNodes.back();
+            _freeNodes.pop_back();
+            _nodes[index] = node;
+        }
+
+        _nodes[index].parent = parent;
+        _nodes[parent].children[k] = index;
+        return index;
+    }
+
+    void releaseNode(boost::uint32_t index)
+    {
+        BOOST_ASSERT(index != 0 && _nodes[index].count == 0);
+
+        Node & parent = _nodes[_nodes[index].parent];
+        for (unsigned k = 0; k < CHILDREN; ++k)
+            if (parent.children[k] == index)
+                parent.children[k] = NONE;
+
+        _freeNodes.push_back(index);
+    }
+
+    void link(boost::uint32_t index, boost::uint32_t node)
+    {
+        Item & item = _items[index];
+        item.node = node;
+        item.previous = NONE;
+        item.next = _nodes[node].first;
+        if (item.next != NONE)
+            _items[item.next].previous = index;
+        _nodes[node].first = index;
+
+        for (boost::uint32_t n = node; n != NONE; n = _nodes[n].parent)
+            ++_nodes[n].count;
+    }
+
+    /**
+     * Remove an item from its node, and release the nodes left empty.
+     */
+    void unlink(boost::uint32_t index)
+    {
+        Item & item = _items[index];
+
+        if (item.previous != NONE)
+            _items[item.previous].next = item.next;
+        else
+            _nodes[item.node].first = item.next;
+        if (item.next != NONE)
+            _items[item.next].previous = item.previous;
+
+        for (boost::uint32_t n = item.node; n != NONE; )
+        {
+            const boost::uint32_t parent = _nodes[n].parent;
+            if (--_nodes[n].count == 0 && n != 0)
+                releaseNode(n);
+            n = parent;
+        }
+
+        item.node = NONE;
+    }
+
+};
+// class LooseTree
+
+// NONE is bound to const references (std::fill), so it needs a definition
+template<typename T, unsigned N, class P, class V>
+const boost::uint32_t LooseTree<T, N, P, V>::NONE;
+
+MW_END_NAMESPACE(math)
+
+#endif // MW_LOOSETREE_HPP
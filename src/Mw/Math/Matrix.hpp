@@ -0,0 +1,506 @@
+/**
+ * @file   Matrix.hpp
+ * @author Bastien Brunnenstein
+ */
+
+#ifndef MW_MATRIX_HPP
+#define MW_MATRIX_HPP
+
+#include <Mw/Config.hpp>
+
+#include <Mw/Math/MatrixKernels.hpp>
+#include <Mw/Math/Vector.hpp>
+
+#include <ostream>
+#include <stdexcept>
+
+#include <boost/config.hpp>
+#include <boost/operators.hpp>
+#include <boost/serialization/nvp.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/assert.hpp>
+
+#ifndef BOOST_NO_CXX11_HDR_INITIALIZER_LIST
+#include <initializer_list>
+#endif
+
+MW_BEGIN_NAMESPACE(math)
+
+/**
+ * Generic matrix.
+ *
+ * Elements are stored row-major. Vectors are column vectors: a matrix
+ * transforms a vector with <tt>matrix * vector</tt>, and <tt>a * b</tt>
+ * applies @c b first.
+ *
+ * @tparam T Scalar type.
+ * @tparam R Number of rows.
+ * @tparam C Number of columns.
+ */
+template<typename T, unsigned R, unsigned C>
+class Matrix : boost::additive<Matrix<T, R, C> >,
+               boost::multiplicative2<Matrix<T, R, C>, T>,
+               boost::equality_comparable<Matrix<T, R, C> >
+{
+    BOOST_STATIC_ASSERT_MSG(R > 0 && C > 0, "Mw.Math.Matrix: Invalid template number of rows or columns");
+
+    template<typename U, unsigned R2, unsigned C2>
+    friend class Matrix;
+
+    /**
+     * Matrix's elements.
+     */
+    detail::MatrixStorage<T, R, C> _storage;
+
+public:
+
+    // Constructors
+
+    /**
+     * Default constructor.
+     *
+     * Matrix elements are initialized to 0 (null matrix).
+     */
+    Matrix()
+        : _storage()
+    {}
+
+    /**
+     * Copy constructor.
+     *
+     * @param mat Matrix to copy.
+     */
+    template <typename U>
+    Matrix(const Matrix<U, R, C> & mat)
+        : _storage()
+    {
+        for (unsigned r = 0; r < R; ++r)
+            for (unsigned c = 0; c < C; ++c)
+                _storage.elements[r][c] = static_cast<T>(mat(r, c));
+    }
+
+    /**
+     * Array constructor.
+     *
+     * @param elements Elements, row-major.
+     */
+    explicit Matrix(const T (&elements)[R][C])
+        : _storage()
+    {
+        for (unsigned r = 0; r < R; ++r)
+            for (unsigned c = 0; c < C; ++c)
+                _storage.elements[r][c] = elements[r][c];
+    }
+
+#ifndef BOOST_NO_CXX11_HDR_INITIALIZER_LIST
+    /**
+     * Initializer list constructor.
+     *
+     * @param list Initializer list, row-major.
+     */
+    explicit Matrix(const std::initializer_list<T> & list)
+        : _storage()
+    {
+        BOOST_ASSERT_MSG(list.size() == R * C, "Mw.Math.Matrix: Invalid initializer list size");
+
+        unsigned i = 0;
+        for (T v : list)
+        {
+            _storage.elements[i / C][i % C] = v;
+            ++i;
+        }
+    }
+#endif
+
+    /**
+     * Get an identity matrix.
+     *
+     * Only available for square matrices.
+     *
+     * @return Identity matrix.
+     */
+    static Matrix identity()
+    {
+        BOOST_STATIC_ASSERT_MSG(R == C, "Mw.Math.Matrix: Identity of a non-square matrix");
+
+        Matrix m;
+        for (unsigned i = 0; i < R; ++i)
+            m._storage.elements[i][i] = static_cast<T>(1);
+        return m;
+    }
+
+
+    // Getters / setters
+
+    /**
+     * Get an element.
+     *
+     * @param row Element's row.
+     * @param column Element's column.
+     * @return Element.
+     * @throw std::out_of_range if the row or the column is out of range.
+     */
+    T get(unsigned row, unsigned column) const
+    {
+        if (row >= R || column >= C)
+            throw std::out_of_range("Mw.Math.Matrix: Out of range");
+
+        return _storage.elements[row][column];
+    }
+
+    /**
+     * Set an element.
+     *
+     * @param row Element's row.
+     * @param column Element's column.
+     * @param value New value.
+     * @throw std::out_of_range if the row or the column is out of range.
+     */
+    void set(unsigned row, unsigned column, T value)
+    {
+        if (row >= R || column >= C)
+            throw std::out_of_range("Mw.Math.Matrix: Out of range");
+
+        _storage.elements[row][column] = value;
+    }
+
+    /**
+     * Get a row.
+     *
+     * @param row Row's index.
+     * @return Copy of the row.
+     * @throw std::out_of_range if the row is out of range.
+     */
+    Vector<T, C> getRow(unsigned row) const
+    {
+        if (row >= R)
+            throw std::out_of_range("Mw.Math.Matrix: Out of range");
+
+        Vector<T, C> v;
+        for (unsigned c = 0; c < C; ++c)
+            v[c] = _storage.elements[row][c];
+        return v;
+    }
+
+    /**
+     * Set a row.
+     *
+     * @param row Row's index.
+     * @param vec New row.
+     * @throw std::out_of_range if the row is out of range.
+     */
+    void setRow(unsigned row, const Vector<T, C> & vec)
+    {
+        if (row >= R)
+            throw std::out_of_range("Mw.Math.Matrix: Out of range");
+
+        for (unsigned c = 0; c < C; ++c)
+            _storage.elements[row][c] = vec[c];
+    }
+
+    /**
+     * Get a column.
+     *
+     * @param column Column's index.
+     * @return Copy of the column.
+     * @throw std::out_of_range if the column is out of range.
+     */
+    Vector<T, R> getColumn(unsigned column) const
+    {
+        if (column >= C)
+            throw std::out_of_range("Mw.Math.Matrix: Out of range");
+
+        Vector<T, R> v;
+        for (unsigned r = 0; r < R; ++r)
+            v[r] = _storage.elements[r][column];
+        return v;
+    }
+
+    /**
+     * Set a column.
+     *
+     * @param column Column's index.
+     * @param vec New column.
+     * @throw std::out_of_range if the column is out of range.
+     */
+    void setColumn(unsigned column, const Vector<T, R> & vec)
+    {
+        if (column >= C)
+            throw std::out_of_range("Mw.Math.Matrix: Out of range");
+
+        for (unsigned r = 0; r < R; ++r)
+            _storage.elements[r][column] = vec[r];
+    }
+
+    /**
+     * Element access operator.
+     *
+     * @param row Element's row.
+     * @param column Element's column.
+     * @return Reference to the element.
+     */
+    const T & operator () (unsigned row, unsigned column) const
+    {
+        BOOST_ASSERT_MSG(row < R && column < C, "Mw.Math.Matrix: Out of range");
+
+        return _storage.elements[row][column];
+    }
+
+    /**
+     * Element access operator.
+     *
+     * @param row Element's row.
+     * @param column Element's column.
+     * @return Reference to the element.
+     */
+    T & operator () (unsigned row, unsigned column)
+    {
+        BOOST_ASSERT_MSG(row < R && column < C, "Mw.Math.Matrix: Out of range");
+
+        return _storage.elements[row][column];
+    }
+
+
+    // Operations
+
+    Matrix & operator += (const Matrix & mat)
+    {
+        for (unsigned r = 0; r < R; ++r)
+            for (unsigned c = 0; c < C; ++c)
+                _storage.elements[r][c] += mat._storage.elements[r][c];
+
+        return *this;
+    }
+
+    Matrix & operator -= (const Matrix & mat)
+    {
+        for (unsigned r = 0; r < R; ++r)
+            for (unsigned c = 0; c < C; ++c)
+                _storage.elements[r][c] -= mat._storage.elements[r][c];
+
+        return *this;
+    }
+
+    Matrix operator - () const
+    {
+        Matrix m;
+        for (unsigned r = 0; r < R; ++r)
+            for (unsigned c = 0; c < C; ++c)
+                m._storage.elements[r][c] = - _storage.elements[r][c];
+        return m;
+    }
+
+    Matrix & operator *= (T factor)
+    {
+        for (unsigned r = 0; r < R; ++r)
+            for (unsigned c = 0; c < C; ++c)
+                _storage.elements[r][c] *= factor;
+
+        return *this;
+    }
+
+    Matrix & operator /= (T divisor)
+    {
+        if (divisor == static_cast<T>(0))
+            throw std::domain_error("Mw.Math.Matrix: Division by zero");
+
+        for (unsigned r = 0; r < R; ++r)
+            for (unsigned c = 0; c < C; ++c)
+                _storage.elements[r][c] /= divisor;
+
+        return *this;
+    }
+
+    /**
+     * Matrix product.
+     *
+     * @param mat Right operand.
+     * @return Product.
+     */
+    template<unsigned K>
+    Matrix<T, R, K> operator * (const Matrix<T, C, K> & mat) const
+    {
+        Matrix<T, R, K> m;
+        detail::MatrixProductKernel<T, R, C, K>::multiply(m._storage, _storage, mat._storage);
+        return m;
+    }
+
+    /**
+     * Matrix product, in place.
+     *
+     * @param mat Right operand.
+     * @return This matrix.
+     */
+    Matrix & operator *= (const Matrix<T, C, C> & mat)
+    {
+        return *this = *this * mat;
+    }
+
+    /**
+     * Transform a vector.
+     *
+     * @param vec Column vector.
+     * @return Transformed vector.
+     */
+    Vector<T, R> operator * (const Vector<T, C> & vec) const
+    {
+        Vector<T, R> v;
+        for (unsigned r = 0; r < R; ++r)
+        {
+            T sum = _storage.elements[r][0] * vec[0];
+            for (unsigned c = 1; c < C; ++c)
+                sum += _storage.elements[r][c] * vec[c];
+            v[r] = sum;
+        }
+        return v;
+    }
+
+    bool operator == (const Matrix & mat) const
+    {
+        for (unsigned r = 0; r < R; ++r)
+            for (unsigned c = 0; c < C; ++c)
+                if (_storage.elements[r][c] != mat._storage.elements[r][c])
+                    return false;
+
+        return true;
+    }
+
+
+    // Computations
+
+    /**
+     * Get the transposed matrix.
+     *
+     * @return Transposed matrix.
+     */
+    Matrix<T, C, R> getTransposed() const
+    {
+        Matrix<T, C, R> m;
+        for (unsigned r = 0; r < R; ++r)
+            for (unsigned c = 0; c < C; ++c)
+                m._storage.elements[c][r] = _storage.elements[r][c];
+        return m;
+    }
+
+    /**
+     * Get the determinant.
+     *
+     * Only available for square matrices.
+     *
+     * @return Determinant.
+     */
+    T getDeterminant() const
+    {
+        BOOST_STATIC_ASSERT_MSG(R == C, "Mw.Math.Matrix: Determinant of a non-square matrix");
+
+        return detail::MatrixInverseKernel<T, R>::determinant(_storage);
+    }
+
+    /**
+     * Get the inverse matrix.
+     *
+     * Only available for square matrices.
+     *
+     * @return Inverse matrix.
+     * @throw std::domain_error if the matrix is singular.
+     */
+    Matrix getInverse() const
+    {
+        BOOST_STATIC_ASSERT_MSG(R == C, "Mw.Math.Matrix: Inverse of a non-square matrix");
+
+        Matrix m;
+        if (!detail::MatrixInverseKernel<T, R>::invert(m._storage, _storage))
+            throw std::domain_error("Mw.Math.Matrix: Matrix is not invertible");
+        return m;
+    }
+
+
+private:
+    // Serialization
+    friend class boost::serialization::access;
+    template<class Archive>
+    void serialize(Archive & ar, const unsigned int version)
+    {
+        using namespace boost::serialization;
+
+        ar & make_nvp("elements", _storage.elements);
+    }
+
+};
+// class Matrix
+
+
+/**
+ * Transform a point by a homogeneous matrix.
+ *
+ * The point is extended with a weight of 1. The last row of the matrix is
+ * ignored, so the transform must be affine.
+ *
+ * @param mat Homogeneous matrix.
+ * @param point Point.
+ * @return Transformed point.
+ */
+template<typename T, unsigned N>
+Vector<T, N - 1> transformPoint(const Matrix<T, N, N> & mat, const Vector<T, N - 1> & point)
+{
+    Vector<T, N - 1> v;
+    for (unsigned r = 0; r < N - 1; ++r)
+    {
+        T sum = mat(r, 0) * point[0];
+        for (unsigned c = 1; c < N - 1; ++c)
+            sum += mat(r, c) * point[c];
+        v[r] = sum + mat(r, N - 1);
+    }
+    return v;
+}
+
+/**
+ * Transform a direction by a homogeneous matrix.
+ *
+ * The direction is extended with a weight of 0, so the translation is
+ * ignored.
+ *
+ * @param mat Homogeneous matrix.
+ * @param direction Direction.
+ * @return Transformed direction.
+ */
+template<typename T, unsigned N>
+Vector<T, N - 1> transformDirection(const Matrix<T, N, N> & mat, const Vector<T, N - 1> & direction)
+{
+    Vector<T, N - 1> v;
+    for (unsigned r = 0; r < N - 1; ++r)
+    {
+        T sum = mat(r, 0) * direction[0];
+        for (unsigned c = 1; c < N - 1; ++c)
+            sum += mat(r, c) * direction[c];
+        v[r] = sum;
+    }
+    return v;
+}
+
+/**
+ * Stream insertion operator overload.
+ *
+ * @param ostr Output stream.
+ * @param mat Matrix to insert into the stream.
+ * @return @c ostr Output stream.
+ */
+template <typename T, unsigned R, unsigned C>
+std::ostream & operator << (std::ostream & ostr, const Matrix<T, R, C> & mat)
+{
+    ostr << "Matrix<" << R << ", " << C << ">[";
+
+    for (unsigned r = 0; r < R; ++r)
+    {
+        ostr << (r ? ", [" : "[") << mat(r, 0);
+        for (unsigned c = 1; c < C; ++c)
+            ostr << ", " << mat(r, c);
+        ostr << "]";
+    }
+
+    return ostr << "]";
+}
+
+MW_END_NAMESPACE(math)
+
+#endif // MW_MATRIX_HPP
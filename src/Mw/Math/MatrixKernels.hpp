@@ -0,0 +1,449 @@
+/**
+ * @file   MatrixKernels.hpp
+ * @author Bastien Brunnenstein
+ *
+ * @details Storage layout and arithmetic kernels used by Matrix.
+ *
+ * The generic kernels are plain loops. Matrix<float, 3, 3> and
+ * Matrix<float, 4, 4> get SSE kernels for the product and the inverse when
+ * the instruction sets are enabled, see Simd.hpp.
+ *
+ * The SIMD and generic kernels agree within a few ulps of the sum of the
+ * absolute terms. They are not bit-identical: the compiler may contract
+ * the generic loops into fused multiply-adds.
+ */
+
+#ifndef MW_MATRIXKERNELS_HPP
+#define MW_MATRIXKERNELS_HPP
+
+#include <Mw/Config.hpp>
+
+#include <Mw/Math/Simd.hpp>
+
+#include <cmath>
+#include <cstddef>
+
+#include <boost/config.hpp>
+
+MW_BEGIN_NAMESPACE(math)
+
+namespace detail
+{
+
+/**
+ * Elements storage of a Matrix, row-major.
+ *
+ * @tparam T Scalar type.
+ * @tparam R Number of rows.
+ * @tparam C Number of columns.
+ */
+template<typename T, unsigned R, unsigned C>
+struct MatrixStorage
+{
+    T elements[R][C];
+};
+
+/**
+ * Product of two matrices.
+ *
+ * @tparam T Scalar type.
+ * @tparam R Number of rows of the left matrix.
+ * @tparam K Number of columns of the left matrix, and of rows of the right one.
+ * @tparam C Number of columns of the right matrix.
+ */
+template<typename T, unsigned R, unsigned K, unsigned C>
+struct MatrixProductKernel
+{
+    static void multiply(MatrixStorage<T, R, C> & out,
+                         const MatrixStorage<T, R, K> & a, const MatrixStorage<T, K, C> & b)
+    {
+        // Each row is a linear combination of the rows of b
+        for (unsigned r = 0; r < R; ++r)
+        {
+            for (unsigned c = 0; c < C; ++c)
+                out.elements[r][c] = a.elements[r][0] * b.elements[0][c];
+
+            for (unsigned k = 1; k < K; ++k)
+                for (unsigned c = 0; c < C; ++c)
+                    out.elements[r][c] += a.elements[r][k] * b.elements[k][c];
+        }
+    }
+};
+
+/**
+ * Inverse and determinant of a square matrix by Gauss-Jordan elimination
+ * with partial pivoting.
+ *
+ * @tparam T Scalar type.
+ * @tparam N Number of rows and columns.
+ */
+template<typename T, unsigned N>
+struct MatrixElimination
+{
+    typedef MatrixStorage<T, N, N> Storage;
+
+    /**
+     * @return @c false if the matrix is singular.
+     */
+    static bool invert(Storage & out, const Storage & in)
+    {
+        Storage m = in;
+
+        for (unsigned r = 0; r < N; ++r)
+            for (unsigned c = 0; c < N; ++c)
+                out.elements[r][c] = r == c ? static_cast<T>(1) : static_cast<T>(0);
+
+        for (unsigned c = 0; c < N; ++c)
+        {
+            const unsigned p = pivot(m, c);
+            if (m.elements[p][c] == static_cast<T>(0))
+                return false;
+
+            swapRows(m, p, c);
+            swapRows(out, p, c);
+
+            const T inv = static_cast<T>(1) / m.elements[c][c];
+            for (unsigned k = 0; k < N; ++k)
+            {
+                m.elements[c][k] *= inv;
+                out.elements[c][k] *= inv;
+            }
+
+            for (unsigned r = 0; r < N; ++r)
+            {
+                if (r == c)
+                    continue;
+
+                const T f = m.elements[r][c];
+                for (unsigned k = 0; k < N; ++k)
+                {
+                    m.elements[r][k] -= f * m.elements[c][k];
+                    out.elements[r][k] -= f * out.elements[c][k];
+                }
+            }
+        }
+
+        return true;
+    }
+
+    static T determinant(const Storage & in)
+    {
+        Storage m = in;
+        T det = static_cast<T>(1);
+
+        for (unsigned c = 0; c < N; ++c)
+        {
+            const unsigned p = pivot(m, c);
+            if (m.elements[p][c] == static_cast<T>(0))
+                return static_cast<T>(0);
+
+            if (p != c)
+            {
+                swapRows(m, p, c);
+                det = - det;
+            }
+
+            det *= m.elements[c][c];
+            for (unsigned r = c + 1; r < N; ++r)
+            {
+                const T f = m.elements[r][c] / m.elements[c][c];
+                for (unsigned k = c; k < N; ++k)
+                    m.elements[r][k] -= f * m.elements[c][k];
+            }
+        }
+
+        return det;
+    }
+
+private:
+
+    static unsigned pivot(const Storage & m, unsigned c)
+    {
+        unsigned p = c;
+        for (unsigned r = c + 1; r < N; ++r)
+            if (std::abs(m.elements[r][c]) > std::abs(m.elements[p][c]))
+                p = r;
+        return p;
+    }
+
+    static void swapRows(Storage & m, unsigned a, unsigned b)
+    {
+        if (a == b)
+            return;
+
+        for (unsigned k = 0; k < N; ++k)
+        {
+            const T t = m.elements[a][k];
+            m.elements[a][k] = m.elements[b][k];
+            m.elements[b][k] = t;
+        }
+    }
+};
+
+/**
+ * Inverse and determinant of a square matrix.
+ *
+ * @tparam T Scalar type.
+ * @tparam N Number of rows and columns.
+ */
+template<typename T, unsigned N>
+struct MatrixInverseKernel : MatrixElimination<T, N>
+{};
+
+
+#ifdef MW_SIMD_SSE
+
+/**
+ * Load a row of 3 floats, with a junk fourth lane.
+ *
+ * The last row of a 3x3 matrix is loaded one float earlier, so no load
+ * goes past the matrix.
+ */
+inline __m128 loadRow3(const float (&elements)[3][3], unsigned r)
+{
+    if (r < 2)
+        return _mm_loadu_ps(elements[r]);
+
+    const __m128 v = _mm_loadu_ps(&elements[1][2]);
+    return _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 2, 1));
+}
+
+/**
+ * Store three rows of 3 floats.
+ */
+inline void storeRows3(float (&elements)[3][3], __m128 r0, __m128 r1, __m128 r2)
+{
+    BOOST_ALIGNMENT(16) float rows[3][4];
+    _mm_store_ps(rows[0], r0);
+    _mm_store_ps(rows[1], r1);
+    _mm_store_ps(rows[2], r2);
+
+    for (unsigned r = 0; r < 3; ++r)
+        for (unsigned c = 0; c < 3; ++c)
+            elements[r][c] = rows[r][c];
+}
+
+/**
+ * Cross product of the first three lanes.
+ */
+inline __m128 cross3(__m128 a, __m128 b)
+{
+    // a.yzx * b.zxy - a.zxy * b.yzx
+    __m128 a_yzx = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+    __m128 b_yzx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+    __m128 a_zxy = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 0, 2));
+    __m128 b_zxy = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 1, 0, 2));
+
+    return _mm_sub_ps(_mm_mul_ps(a_yzx, b_zxy), _mm_mul_ps(a_zxy, b_yzx));
+}
+
+template<>
+struct MatrixProductKernel<float, 3, 3, 3>
+{
+    typedef MatrixStorage<float, 3, 3> Storage;
+
+    static void multiply(Storage & out, const Storage & a, const Storage & b)
+    {
+        const __m128 b0 = loadRow3(b.elements, 0);
+        const __m128 b1 = loadRow3(b.elements, 1);
+        const __m128 b2 = loadRow3(b.elements, 2);
+
+        __m128 rows[3];
+        for (unsigned r = 0; r < 3; ++r)
+        {
+            __m128 row = _mm_mul_ps(_mm_set1_ps(a.elements[r][0]), b0);
+            row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a.elements[r][1]), b1));
+            rows[r] = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a.elements[r][2]), b2));
+        }
+
+        storeRows3(out.elements, rows[0], rows[1], rows[2]);
+    }
+};
+
+template<>
+struct MatrixInverseKernel<float, 3>
+{
+    typedef MatrixStorage<float, 3, 3> Storage;
+
+    static bool invert(Storage & out, const Storage & in)
+    {
+        const __m128 r0 = loadRow3(in.elements, 0);
+        const __m128 r1 = loadRow3(in.elements, 1);
+        const __m128 r2 = loadRow3(in.elements, 2);
+
+        // The columns of the inverse are the cross products of the rows
+        __m128 c0 = cross3(r1, r2);
+        __m128 c1 = cross3(r2, r0);
+        __m128 c2 = cross3(r0, r1);
+        __m128 c3 = _mm_setzero_ps();
+
+        const float det = sumLanes3(_mm_mul_ps(r0, c0));
+        if (det == 0.0f)
+            return false;
+
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+        const __m128 d = _mm_set1_ps(det);
+        storeRows3(out.elements, _mm_div_ps(c0, d), _mm_div_ps(c1, d), _mm_div_ps(c2, d));
+        return true;
+    }
+
+    static float determinant(const Storage & in)
+    {
+        return sumLanes3(_mm_mul_ps(loadRow3(in.elements, 0),
+                                    cross3(loadRow3(in.elements, 1), loadRow3(in.elements, 2))));
+    }
+
+private:
+
+    static float sumLanes3(__m128 v)
+    {
+        __m128 y = _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1));
+        __m128 z = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
+        return _mm_cvtss_f32(_mm_add_ss(_mm_add_ss(v, y), z));
+    }
+};
+
+template<>
+struct MatrixStorage<float, 4, 4>
+{
+    BOOST_ALIGNMENT(16) float elements[4][4];
+};
+
+template<>
+struct MatrixProductKernel<float, 4, 4, 4>
+{
+    typedef MatrixStorage<float, 4, 4> Storage;
+
+    static void multiply(Storage & out, const Storage & a, const Storage & b)
+    {
+        const __m128 b0 = _mm_load_ps(b.elements[0]);
+        const __m128 b1 = _mm_load_ps(b.elements[1]);
+        const __m128 b2 = _mm_load_ps(b.elements[2]);
+        const __m128 b3 = _mm_load_ps(b.elements[3]);
+
+        for (unsigned r = 0; r < 4; ++r)
+        {
+            __m128 row = _mm_mul_ps(_mm_set1_ps(a.elements[r][0]), b0);
+            row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a.elements[r][1]), b1));
+            row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a.elements[r][2]), b2));
+            _mm_store_ps(out.elements[r], _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a.elements[r][3]), b3)));
+        }
+    }
+};
+
+/**
+ * Shuffle of the lanes of one register.
+ */
+#define MW_MATRIX_SWIZZLE(v, x, y, z, w) _mm_shuffle_ps((v), (v), _MM_SHUFFLE(w, z, y, x))
+
+template<>
+struct MatrixInverseKernel<float, 4>
+{
+    typedef MatrixStorage<float, 4, 4> Storage;
+
+    /**
+     * Inverse by 2x2 blocks.
+     *
+     * The matrix is split in four 2x2 blocks A B / C D, each held in one
+     * register, and inverted with their adjugates (noted X#).
+     */
+    static bool invert(Storage & out, const Storage & in)
+    {
+        const __m128 r0 = _mm_load_ps(in.elements[0]);
+        const __m128 r1 = _mm_load_ps(in.elements[1]);
+        const __m128 r2 = _mm_load_ps(in.elements[2]);
+        const __m128 r3 = _mm_load_ps(in.elements[3]);
+
+        const __m128 a = _mm_movelh_ps(r0, r1);
+        const __m128 b = _mm_movehl_ps(r1, r0);
+        const __m128 c = _mm_movelh_ps(r2, r3);
+        const __m128 d = _mm_movehl_ps(r3, r2);
+
+        // Determinants of the blocks: |A| |B| |C| |D|
+        const __m128 detSub = _mm_sub_ps(
+            _mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(3, 1, 3, 1))),
+            _mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(2, 0, 2, 0))));
+        const __m128 detA = MW_MATRIX_SWIZZLE(detSub, 0, 0, 0, 0);
+        const __m128 detB = MW_MATRIX_SWIZZLE(detSub, 1, 1, 1, 1);
+        const __m128 detC = MW_MATRIX_SWIZZLE(detSub, 2, 2, 2, 2);
+        const __m128 detD = MW_MATRIX_SWIZZLE(detSub, 3, 3, 3, 3);
+
+        const __m128 dc = adjMul(d, c);
+        const __m128 ab = adjMul(a, b);
+
+        // Adjugates of the blocks of the inverse
+        __m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), mul(b, dc));
+        __m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), mul(c, ab));
+        __m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), mulAdj(d, ab));
+        __m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), mulAdj(a, dc));
+
+        // |M| = |A| |D| + |B| |C| - tr(A#B D#C)
+        __m128 tr = _mm_mul_ps(ab, MW_MATRIX_SWIZZLE(dc, 0, 2, 1, 3));
+        tr = _mm_add_ps(tr, MW_MATRIX_SWIZZLE(tr, 2, 3, 0, 1));
+        tr = _mm_add_ps(tr, MW_MATRIX_SWIZZLE(tr, 1, 0, 3, 2));
+        const __m128 det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), tr);
+
+        if (_mm_cvtss_f32(det) == 0.0f)
+            return false;
+
+        const __m128 rdet = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det);
+        x = _mm_mul_ps(x, rdet);
+        y = _mm_mul_ps(y, rdet);
+        z = _mm_mul_ps(z, rdet);
+        w = _mm_mul_ps(w, rdet);
+
+        // Adjugate of each block, back to rows
+        _mm_store_ps(out.elements[0], _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3)));
+        _mm_store_ps(out.elements[1], _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2)));
+        _mm_store_ps(out.elements[2], _mm_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3)));
+        _mm_store_ps(out.elements[3], _mm_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2)));
+        return true;
+    }
+
+    static float determinant(const Storage & in)
+    {
+        return MatrixElimination<float, 4>::determinant(in);
+    }
+
+private:
+
+    // 2x2 row-major blocks
+
+    /**
+     * A * B
+     */
+    static __m128 mul(__m128 a, __m128 b)
+    {
+        return _mm_add_ps(_mm_mul_ps(a, MW_MATRIX_SWIZZLE(b, 0, 3, 0, 3)),
+                          _mm_mul_ps(MW_MATRIX_SWIZZLE(a, 1, 0, 3, 2), MW_MATRIX_SWIZZLE(b, 2, 1, 2, 1)));
+    }
+
+    /**
+     * A# * B
+     */
+    static __m128 adjMul(__m128 a, __m128 b)
+    {
+        return _mm_sub_ps(_mm_mul_ps(MW_MATRIX_SWIZZLE(a, 3, 3, 0, 0), b),
+                          _mm_mul_ps(MW_MATRIX_SWIZZLE(a, 1, 1, 2, 2), MW_MATRIX_SWIZZLE(b, 2, 3, 0, 1)));
+    }
+
+    /**
+     * A * B#
+     */
+    static __m128 mulAdj(__m128 a, __m128 b)
+    {
+        return _mm_sub_ps(_mm_mul_ps(a, MW_MATRIX_SWIZZLE(b, 3, 0, 3, 0)),
+                          _mm_mul_ps(MW_MATRIX_SWIZZLE(a, 1, 0, 3, 2), MW_MATRIX_SWIZZLE(b, 2, 1, 2, 1)));
+    }
+};
+
+#undef MW_MATRIX_SWIZZLE
+
+#endif // MW_SIMD_SSE
+
+} // namespace detail
+
+MW_END_NAMESPACE(math)
+
+#endif // MW_MATRIXKERNELS_HPP
@@ -0,0 +1,222 @@
+/**
+ * @file   MatrixTransform.hpp
+ * @author Bastien Brunnenstein
+ *
+ * @details Batch transforms of contiguous arrays of vectors.
+ *
+ * The arrays are processed by blocks: each block of vectors is transposed
+ * to a small structure of arrays that stays in the L1 cache, transformed
+ * with loops the compiler can vectorize, and written back. Given a
+ * TaskPool, large arrays are split in chunks transformed in parallel.
+ *
+ * The results agree with the single vector functions of Matrix.hpp within
+ * a few ulps, and do not depend on the number of threads. Input and output
+ * may be the same array.
+ */
+
+#ifndef MW_MATRIXTRANSFORM_HPP
+#define MW_MATRIXTRANSFORM_HPP
+
+#include <Mw/Config.hpp>
+
+#include <Mw/Math/Matrix.hpp>
+#include <Mw/Math/Simd.hpp>
+#include <Mw/Math/Vector.hpp>
+#include <Mw/Thread/TaskPool.hpp>
+
+#include <cstddef>
+
+MW_BEGIN_NAMESPACE(math)
+
+namespace detail
+{
+
+/**
+ * Transform a range of vectors by blocks.
+ *
+ * Output component @c r is <tt>sum(m[r][c] * v[c]) + m[r][N]</tt>, the last
+ * term only when @c TRANSLATE is set.
+ *
+ * @tparam T Scalar type.
+ * @tparam N Dimension of the vectors.
+ * @tparam TRANSLATE Add the last column of the matrix (points).
+ */
+template<typename T, unsigned N, bool TRANSLATE>
+struct TransformTask
+{
+    /**
+     * Number of vectors per block.
+     */
+    static const std::size_t BLOCK = 64;
+
+    /**
+     * First N rows of the matrix.
+     */
+    T matrix[N][N + 1];
+
+    const Vector<T, N> * in;
+    Vector<T, N> * out;
+
+    template<unsigned C>
+    TransformTask(const Matrix<T, C, C> & mat, const Vector<T, N> * in, Vector<T, N> * out)
+        : in(in), out(out)
+    {
+        for (unsigned r = 0; r < N; ++r)
+        {
+            for (unsigned c = 0; c < N; ++c)
+                matrix[r][c] = mat(r, c);
+            matrix[r][N] = TRANSLATE ? mat(r, N) : static_cast<T>(0);
+        }
+    }
+
+    void operator () (std::size_t begin, std::size_t end) const
+    {
+        for (std::size_t base = begin; base < end; base += BLOCK)
+        {
+            if (end - base >= BLOCK)
+                transformBlock(base, BLOCK);
+            else
+                transformBlock(base, end - base);
+        }
+    }
+
+    /**
+     * Transform a block, the constant size of full blocks lets the compiler
+     * unroll and vectorize the loops.
+     */
+    void transformBlock(std::size_t base, std::size_t count) const
+    {
+        T src[N][BLOCK];
+        T dst[N][BLOCK];
+
+        for (std::size_t j = 0; j < count; ++j)
+            for (unsigned c = 0; c < N; ++c)
+                src[c][j] = in[base + j][c];
+
+        for (unsigned r = 0; r < N; ++r)
+        {
+            T * MW_RESTRICT d = dst[r];
+
+            const T m0 = matrix[r][0];
+            const T * MW_RESTRICT s0 = src[0];
+            for (std::size_t j = 0; j < count; ++j)
+                d[j] = m0 * s0[j];
+
+            for (unsigned c = 1; c < N; ++c)
+            {
+                const T m = matrix[r][c];
+                const T * MW_RESTRICT s = src[c];
+                for (std::size_t j = 0; j < count; ++j)
+                    d[j] += m * s[j];
+            }
+
+            if (TRANSLATE)
+            {
+                const T t = matrix[r][N];
+                for (std::size_t j = 0; j < count; ++j)
+                    d[j] += t;
+            }
+        }
+
+        for (std::size_t j = 0; j < count; ++j)
+            for (unsigned r = 0; r < N; ++r)
+                out[base + j][r] = dst[r][j];
+    }
+};
+
+/**
+ * Number of vectors transformed per task.
+ */
+const std::size_t TRANSFORM_GRAIN = 16384;
+
+} // namespace detail
+
+
+/**
+ * Transform an array of vectors.
+ *
+ * @param mat Matrix.
+ * @param in First input vector.
+ * @param out First output vector, may be @c in.
+ * @param count Number of vectors.
+ */
+template<typename T, unsigned N>
+void transform(const Matrix<T, N, N> & mat, const Vector<T, N> * in, Vector<T, N> * out, std::size_t count)
+{
+    detail::TransformTask<T, N, false> task(mat, in, out);
+    task(0, count);
+}
+
+/**
+ * Transform an array of vectors in parallel.
+ *
+ * @see transform
+ */
+template<typename T, unsigned N>
+void transform(const Matrix<T, N, N> & mat, const Vector<T, N> * in, Vector<T, N> * out, std::size_t count,
+               thread::TaskPool & pool)
+{
+    thread::parallelFor(pool, 0, count, detail::TRANSFORM_GRAIN, detail::TransformTask<T, N, false>(mat, in, out));
+}
+
+/**
+ * Transform an array of points by a homogeneous matrix.
+ *
+ * @param mat Homogeneous matrix, affine.
+ * @param in First input point.
+ * @param out First output point, may be @c in.
+ * @param count Number of points.
+ * @see transformPoint
+ */
+template<typename T, unsigned N>
+void transformPoints(const Matrix<T, N, N> & mat, const Vector<T, N - 1> * in, Vector<T, N - 1> * out,
+                     std::size_t count)
+{
+    detail::TransformTask<T, N - 1, true> task(mat, in, out);
+    task(0, count);
+}
+
+/**
+ * Transform an array of points in parallel.
+ *
+ * @see transformPoints
+ */
+template<typename T, unsigned N>
+void transformPoints(const Matrix<T, N, N> & mat, const Vector<T, N - 1> * in, Vector<T, N - 1> * out,
+                     std::size_t count, thread::TaskPool & pool)
+{
+    thread::parallelFor(pool, 0, count, detail::TRANSFORM_GRAIN, detail::TransformTask<T, N - 1, true>(mat, in, out));
+}
+
+/**
+ * Transform an array of directions by a homogeneous matrix.
+ *
+ * @param mat Homogeneous matrix.
+ * @param in First input direction.
+ * @param out First output direction, may be @c in.
+ * @param count Number of directions.
+ * @see transformDirection
+ */
+template<typename T, unsigned N>
+void transformDirections(const Matrix<T, N, N> & mat, const Vector<T, N - 1> * in, Vector<T, N - 1> * out,
+                         std::size_t count)
+{
+    detail::TransformTask<T, N - 1, false> task(mat, in, out);
+    task(0, count);
+}
+
+/**
+ * Transform an array of directions in parallel.
+ *
+ * @see transformDirections
+ */
+template<typename T, unsigned N>
+void transformDirections(const Matrix<T, N, N> & mat, const Vector<T, N - 1> * in, Vector<T, N - 1> * out,
+                         std::size_t count, thread::TaskPool & pool)
+{
+    thread::parallelFor(pool, 0, count, detail::TRANSFORM_GRAIN, detail::TransformTask<T, N - 1, false>(mat, in, out));
+}
+
+MW_END_NAMESPACE(math)
+
+#endif // MW_MATRIXTRANSFORM_HPP
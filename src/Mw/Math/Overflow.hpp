@@ -0,0 +1,186 @@
+/**
+ * @file   Overflow.hpp
+ * @author Bastien Brunnenstein
+ *
+ * @details Integer overflow policies and helpers.
+ *
+ * A policy is called when the result of an operation does not fit its
+ * integer type. IgnoreOverflow keeps the wrapped result, which costs
+ * nothing, ThrowOnOverflow and AssertOnOverflow report it.
+ */
+
+#ifndef MW_OVERFLOW_HPP
+#define MW_OVERFLOW_HPP
+
+#include <Mw/Config.hpp>
+
+#include <Mw/Math/Bits.hpp>
+
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+
+#include <boost/assert.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/type_traits/make_unsigned.hpp>
+
+MW_BEGIN_NAMESPACE(math)
+
+/**
+ * Overflow policy keeping wrapped results.
+ */
+struct IgnoreOverflow
+{
+    static void overflow(const char * /*message*/)
+    {}
+};
+
+/**
+ * Overflow policy throwing std::overflow_error.
+ */
+struct ThrowOnOverflow
+{
+    /**
+     * @throw std::overflow_error Always.
+     */
+    static void overflow(const char * message)
+    {
+        throw std::overflow_error(message);
+    }
+};
+
+/**
+ * Overflow policy asserting in debug builds, wrapped results otherwise.
+ */
+struct AssertOnOverflow
+{
+    static void overflow(const char * message)
+    {
+        BOOST_ASSERT_MSG(false, message);
+        (void) message;
+    }
+};
+
+
+namespace detail
+{
+
+/**
+ * Signed integer type at least twice as wide as @c T.
+ *
+ * @c EXISTS is false when there is none, @c Type is then @c T.
+ */
+template<typename T, std::size_t Size = sizeof(T), bool Integral = boost::is_integral<T>::value>
+struct WideInteger
+{
+    static const bool EXISTS = false;
+    typedef T Type;
+};
+
+template<typename T>
+struct WideInteger<T, 1, true>
+{
+    static const bool EXISTS = true;
+    typedef boost::int64_t Type;
+};
+
+template<typename T>
+struct WideInteger<T, 2, true>
+{
+    static const bool EXISTS = true;
+    typedef boost::int64_t Type;
+};
+
+template<typename T>
+struct WideInteger<T, 4, true>
+{
+    static const bool EXISTS = true;
+    typedef boost::int64_t Type;
+};
+
+#ifdef MW_HAS_INT128
+
+template<typename T>
+struct WideInteger<T, 8, true>
+{
+    static const bool EXISTS = true;
+    typedef int128_t Type;
+};
+
+#endif // MW_HAS_INT128
+
+/**
+ * Check that a value fits in a narrower integer type.
+ */
+template<typename T, typename W>
+bool fits(W value)
+{
+    return value >= static_cast<W>(std::numeric_limits<T>::min())
+        && value <= static_cast<W>(std::numeric_limits<T>::max());
+}
+
+/**
+ * Multiplication reporting overflows.
+ *
+ * @return @c false if the product does not fit, @c out is then the wrapped
+ *         product.
+ */
+template<typename T>
+bool checkedMultiply(T a, T b, T & out)
+{
+#if defined __clang__ || (defined __GNUC__ && __GNUC__ >= 5)
+    return !__builtin_mul_overflow(a, b, &out);
+#else
+    const T max = std::numeric_limits<T>::max(), min = std::numeric_limits<T>::min();
+    bool ok = true;
+    if (a > 0)
+        ok = b > 0 ? a <= max / b : b >= min / a;
+    else if (a < 0)
+        ok = b > 0 ? a >= min / b : b >= max / a;
+    out = ok ? a * b : static_cast<T>(static_cast<typename boost::make_unsigned<T>::type>(a)
+                                    * static_cast<typename boost::make_unsigned<T>::type>(b));
+    return ok;
+#endif
+}
+
+/**
+ * Addition reporting overflows.
+ *
+ * @return @c false if the sum does not fit, @c out is then the wrapped sum.
+ */
+template<typename T>
+bool checkedAdd(T a, T b, T & out)
+{
+#if defined __clang__ || (defined __GNUC__ && __GNUC__ >= 5)
+    return !__builtin_add_overflow(a, b, &out);
+#else
+    typedef typename boost::make_unsigned<T>::type U;
+    out = static_cast<T>(static_cast<U>(a) + static_cast<U>(b));
+    return b >= 0 ? out >= a : out < a;
+#endif
+}
+
+/**
+ * Subtraction reporting overflows.
+ *
+ * @return @c false if the difference does not fit, @c out is then the
+ *         wrapped difference.
+ */
+template<typename T>
+bool checkedSubtract(T a, T b, T & out)
+{
+#if defined __clang__ || (defined __GNUC__ && __GNUC__ >= 5)
+    return !__builtin_sub_overflow(a, b, &out);
+#else
+    typedef typename boost::make_unsigned<T>::type U;
+    out = static_cast<T>(static_cast<U>(a) - static_cast<U>(b));
+    return b >= 0 ? out <= a : out > a;
+#endif
+}
+
+} // namespace detail
+
+MW_END_NAMESPACE(math)
+
+#endif // MW_OVERFLOW_HPP
@@ -44,8 +44,8 @@ public:
      * @param point A point on the plane.
      */
     Plane(const V & normal, const V & point)
-        : _normal(normal.getNormalization()),
-          _origin(point.getScalarProjection(_normal))
+        : _normal(normalize(normal)),
+          _origin(point.dot(_normal))
     {}
 
 
@@ -79,8 +79,8 @@ public:
      */
     void set(const V & normal, const V & point)
     {
-        _normal = normal.getNormalization();
-        _origin = point.getScalarProjection(_normal);
+        _normal = normalize(normal);
+        _origin = point.dot(_normal);
     }
 
     /**
@@ -91,7 +91,7 @@ public:
      */
     bool isOn(const V & point) const
     {
-        return point.getScalarProjection(_normal) == _origin;
+        return point.dot(_normal) == _origin;
     }
 
     /**
@@ -102,7 +102,7 @@ public:
      */
     bool isOver(const V & point) const
     {
-        return point.getScalarProjection(_normal) > _origin;
+        return point.dot(_normal) > _origin;
     }
 
     /**
@@ -113,12 +113,23 @@ public:
      */
     bool isUnder(const V & point) const
     {
-        return point.getScalarProjection(_normal) < _origin;
+        return point.dot(_normal) < _origin;
     }
 
 
     // Computations
 
+    /**
+     * Get the signed distance between this plane and given point.
+     *
+     * @param point A point.
+     * @return Distance, positive if the point is over the plane.
+     */
+    T getSignedDistance(const V & point) const
+    {
+        return point.dot(_normal) - _origin;
+    }
+
     /**
      * Get the distance between this plane and given point.
      *
@@ -129,7 +140,7 @@ public:
      */
     T getDistance(const V & point) const
     {
-        T d = point.getScalarProjection(_normal);
+        T d = point.dot(_normal);
 
         if (d > _origin) return d - _origin;
         return _origin - d;
@@ -143,9 +154,9 @@ public:
      */
     V getProjection(const V & point) const
     {
-        T d = point.getScalarProjection(_normal);
+        T d = point.dot(_normal) - _origin;
 
-        return point - _normal * d; // TODO d - origin?
+        return point - _normal * d;
     }
 
 
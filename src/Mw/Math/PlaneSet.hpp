@@ -0,0 +1,515 @@
+/**
+ * @file   PlaneSet.hpp
+ * @author Bastien Brunnenstein
+ */
+
+#ifndef MW_PLANESET_HPP
+#define MW_PLANESET_HPP
+
+#include <Mw/Config.hpp>
+
+#include <Mw/Math/Bits.hpp>
+#include <Mw/Math/Bounds.hpp>
+#include <Mw/Math/BoundsArray.hpp>
+#include <Mw/Math/HitMask.hpp>
+#include <Mw/Math/Plane.hpp>
+#include <Mw/Math/Vector.hpp>
+#include <Mw/Math/VectorArray.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/assert.hpp>
+#include <boost/cstdint.hpp>
+
+MW_BEGIN_NAMESPACE(math)
+
+/**
+ * Convex volume bounded by a set of planes.
+ *
+ * A point is inside the volume when it is over or on every plane, so the
+ * normals point towards the inside. The planes are stored as a structure of
+ * arrays.
+ *
+ * Boxes are classified with the p-vertex / n-vertex test: for each plane,
+ * only the corner farthest along the normal (p-vertex) and the nearest one
+ * (n-vertex) are tested. The batch functions test blocks of boxes stored in
+ * a BoundsArray against one plane at a time, and stop as soon as the whole
+ * block is rejected.
+ *
+ * @tparam T Scalar type.
+ * @tparam N Dimension (number of components).
+ */
+template<typename T, unsigned N>
+class PlaneSet
+{
+public:
+
+    /**
+     * Position of a volume relative to the plane set.
+     */
+    enum Classification
+    {
+        OUTSIDE,
+        INTERSECTING,
+        INSIDE
+    };
+
+    /**
+     * List of indices.
+     */
+    typedef std::vector<std::size_t> Indices;
+
+    /**
+     * Per-object index of the last plane that rejected it.
+     */
+    typedef std::vector<unsigned char> Coherency;
+
+    /**
+     * Maximum number of planes.
+     */
+    static const unsigned MAX_PLANES = 32;
+
+private:
+
+    /**
+     * Number of boxes tested per block.
+     */
+    static const unsigned BLOCK = 32;
+
+    /**
+     * Normals, one lane per component.
+     */
+    T _normals[N][MAX_PLANES];
+
+    /**
+     * Distance of each plane from the origin.
+     */
+    T _origins[MAX_PLANES];
+
+    unsigned _count;
+
+public:
+
+    // Constructors
+
+    /**
+     * Default constructor.
+     *
+     * The set has no planes, everything is inside.
+     */
+    PlaneSet()
+        : _count(0)
+    {}
+
+
+    // Getters / setters
+
+    /**
+     * Get the number of planes.
+     *
+     * @return Number of planes.
+     */
+    unsigned size() const
+    {
+        return _count;
+    }
+
+    /**
+     * Remove all the planes.
+     */
+    void clear()
+    {
+        _count = 0;
+    }
+
+    /**
+     * Add a plane to the set.
+     *
+     * @param plane Plane, its normal pointing inside.
+     */
+    void add(const Plane<T, Vector<T, N> > & plane)
+    {
+        if (_count == MAX_PLANES)
+            throw std::length_error("Mw.Math.PlaneSet: Too many planes");
+
+        for (unsigned c = 0; c < N; ++c)
+            _normals[c][_count] = plane.getNormal()[c];
+        _origins[_count] = plane.getDistanceFromOrigin();
+        ++_count;
+    }
+
+    /**
+     * Get a plane.
+     *
+     * @param index Plane's index.
+     * @return Copy of the plane.
+     */
+    Plane<T, Vector<T, N> > get(unsigned index) const
+    {
+        if (index >= _count)
+            throw std::out_of_range("Mw.Math.PlaneSet: Out of range");
+
+        Vector<T, N> normal;
+        for (unsigned c = 0; c < N; ++c)
+            normal[c] = _normals[c][index];
+        return Plane<T, Vector<T, N> >(normal, normal * _origins[index]);
+    }
+
+
+    // Single tests
+
+    /**
+     * Check if a point is inside.
+     *
+     * @param point A point.
+     * @return @c true if the point is over or on every plane.
+     */
+    bool hasPointInside(const Vector<T, N> & point) const
+    {
+        for (unsigned p = 0; p < _count; ++p)
+        {
+            T d = - _origins[p];
+            for (unsigned c = 0; c < N; ++c)
+                d += _normals[c][p] * point[c];
+            if (d < static_cast<T>(0))
+                return false;
+        }
+        return true;
+    }
+
+    /**
+     * Classify bounds.
+     *
+     * @param bounds Bounds to classify.
+     * @return Position of the bounds.
+     */
+    Classification classify(const Bounds<T, N> & bounds) const
+    {
+        Classification result = INSIDE;
+        for (unsigned p = 0; p < _count; ++p)
+        {
+            switch (classifyPlane(bounds, p))
+            {
+            case OUTSIDE:
+                return OUTSIDE;
+            case INTERSECTING:
+                result = INTERSECTING;
+                break;
+            default:
+                break;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Classify bounds, testing first the plane that rejected it last time.
+     *
+     * @param bounds Bounds to classify.
+     * @param lastPlane Index of the last rejecting plane, updated when the
+     *                  bounds are outside.
+     * @return Position of the bounds.
+     */
+    Classification classify(const Bounds<T, N> & bounds, unsigned char & lastPlane) const
+    {
+        if (lastPlane < _count && classifyPlane(bounds, lastPlane) == OUTSIDE)
+            return OUTSIDE;
+
+        Classification result = INSIDE;
+        for (unsigned p = 0; p < _count; ++p)
+        {
+            switch (classifyPlane(bounds, p))
+            {
+            case OUTSIDE:
+                lastPlane = static_cast<unsigned char>(p);
+                return OUTSIDE;
+            case INTERSECTING:
+                result = INTERSECTING;
+                break;
+            default:
+                break;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Classify a sphere.
+     *
+     * @param center Center of the sphere.
+     * @param radius Radius of the sphere.
+     * @return Position of the sphere.
+     */
+    Classification classify(const Vector<T, N> & center, T radius) const
+    {
+        Classification result = INSIDE;
+        for (unsigned p = 0; p < _count; ++p)
+        {
+            T d = - _origins[p];
+            for (unsigned c = 0; c < N; ++c)
+                d += _normals[c][p] * center[c];
+
+            if (d < - radius)
+                return OUTSIDE;
+            if (d < radius)
+                result = INTERSECTING;
+        }
+        return result;
+    }
+
+
+    // Batch tests
+
+    /**
+     * Find the visible boxes (inside or intersecting).
+     *
+     * @param boxes Boxes to test.
+     * @param visible Indices of the visible boxes are appended to it.
+     * @return Number of visible boxes.
+     */
+    std::size_t cull(const BoundsArray<T, N> & boxes, Indices & visible) const
+    {
+        return cullBoxes(boxes, NULL, visible);
+    }
+
+    /**
+     * Find the visible boxes, testing first for each box the plane that
+     * rejected it last time.
+     *
+     * Boxes that move a little between calls are usually rejected by the
+     * same plane.
+     *
+     * @param boxes Boxes to test.
+     * @param coherency Last rejecting plane of each box, resized and
+     *                  updated.
+     * @param visible Indices of the visible boxes are appended to it.
+     * @return Number of visible boxes.
+     */
+    std::size_t cull(const BoundsArray<T, N> & boxes, Coherency & coherency, Indices & visible) const
+    {
+        coherency.resize(boxes.size(), 0);
+        return cullBoxes(boxes, coherency.empty() ? NULL : &coherency[0], visible);
+    }
+
+    /**
+     * Find the visible spheres (inside or intersecting).
+     *
+     * @param centers Centers of the spheres.
+     * @param radii Radius of each sphere.
+     * @param visible Indices of the visible spheres are appended to it.
+     * @return Number of visible spheres.
+     */
+    std::size_t cull(const VectorArray<T, N> & centers, const T * radii, Indices & visible) const
+    {
+        const std::size_t count = centers.size();
+        const std::size_t before = visible.size();
+
+        for (std::size_t base = 0; base < count; base += BLOCK)
+        {
+            const std::size_t block = std::min<std::size_t>(BLOCK, count - base);
+            unsigned char hits[BLOCK];
+            std::fill(hits, hits + block, 1);
+
+            for (unsigned p = 0; p < _count; ++p)
+            {
+                T d[BLOCK];
+                std::fill(d, d + block, - _origins[p]);
+                for (unsigned c = 0; c < N; ++c)
+                {
+                    const T * x = centers.lane(c) + base;
+                    const T n = _normals[c][p];
+                    for (std::size_t j = 0; j < block; ++j)
+                        d[j] += n * x[j];
+                }
+
+                const T * r = radii + base;
+                for (std::size_t j = 0; j < block; ++j)
+                    hits[j] &= (d[j] >= - r[j]);
+
+                if (!detail::packHits(hits, block))
+                    break;
+            }
+
+            detail::appendHitIndices(detail::packHits(hits, block), base, visible);
+        }
+
+        return visible.size() - before;
+    }
+
+    /**
+     * Classify boxes.
+     *
+     * @param boxes Boxes to classify.
+     * @param out Output, one Classification per box.
+     */
+    void classify(const BoundsArray<T, N> & boxes, Classification * out) const
+    {
+        const std::size_t count = boxes.size();
+
+        for (std::size_t base = 0; base < count; base += BLOCK)
+        {
+            const std::size_t block = std::min<std::size_t>(BLOCK, count - base);
+            unsigned char outside[BLOCK], intersecting[BLOCK];
+            std::fill(outside, outside + block, 0);
+            std::fill(intersecting, intersecting + block, 0);
+
+            for (unsigned p = 0; p < _count; ++p)
+            {
+                T pd[BLOCK], nd[BLOCK];
+                vertexDistances(boxes, base, block, p, pd, nd);
+
+                for (std::size_t j = 0; j < block; ++j)
+                {
+                    outside[j] |= (pd[j] < static_cast<T>(0));
+                    intersecting[j] |= (nd[j] < static_cast<T>(0));
+                }
+            }
+
+            for (std::size_t j = 0; j < block; ++j)
+                out[base + j] = outside[j] ? OUTSIDE : (intersecting[j] ? INTERSECTING : INSIDE);
+        }
+    }
+
+
+private:
+
+    /**
+     * Classify bounds against one plane.
+     */
+    Classification classifyPlane(const Bounds<T, N> & bounds, unsigned p) const
+    {
+        // Signed distances of the p-vertex and of the n-vertex
+        T pd = - _origins[p], nd = - _origins[p];
+        for (unsigned c = 0; c < N; ++c)
+        {
+            const T n = _normals[c][p];
+            const T lo = bounds.getLowerLimit()[c];
+            const T up = bounds.getUpperLimit()[c];
+            pd += n * (n >= static_cast<T>(0) ? up : lo);
+            nd += n * (n >= static_cast<T>(0) ? lo : up);
+        }
+
+        if (pd < static_cast<T>(0))
+            return OUTSIDE;
+        if (nd < static_cast<T>(0))
+            return INTERSECTING;
+        return INSIDE;
+    }
+
+    /**
+     * Compute the signed distances of the p-vertices and of the n-vertices
+     * of a block of boxes to a plane.
+     *
+     * The sign of each normal component is the same for the whole block,
+     * so the vertices are picked by lane and the loops have no branch.
+     */
+    void vertexDistances(const BoundsArray<T, N> & boxes, std::size_t base, std::size_t block,
+                         unsigned p, T * pd, T * nd) const
+    {
+        std::fill(pd, pd + block, - _origins[p]);
+        std::fill(nd, nd + block, - _origins[p]);
+
+        for (unsigned c = 0; c < N; ++c)
+        {
+            const T n = _normals[c][p];
+            const T * lo = boxes.getLowerLimits().lane(c) + base;
+            const T * up = boxes.getUpperLimits().lane(c) + base;
+            const T * pv = n >= static_cast<T>(0) ? up : lo;
+            const T * nv = n >= static_cast<T>(0) ? lo : up;
+
+            for (std::size_t j = 0; j < block; ++j)
+            {
+                pd[j] += n * pv[j];
+                nd[j] += n * nv[j];
+            }
+        }
+    }
+
+    /**
+     * Same as vertexDistances, p-vertices only.
+     */
+    void pVertexDistances(const BoundsArray<T, N> & boxes, std::size_t base, std::size_t block,
+                          unsigned p, T * pd) const
+    {
+        std::fill(pd, pd + block, - _origins[p]);
+
+        for (unsigned c = 0; c < N; ++c)
+        {
+            const T n = _normals[c][p];
+            const T * pv = (n >= static_cast<T>(0) ? boxes.getUpperLimits() : boxes.getLowerLimits()).lane(c) + base;
+
+            for (std::size_t j = 0; j < block; ++j)
+                pd[j] += n * pv[j];
+        }
+    }
+
+    std::size_t cullBoxes(const BoundsArray<T, N> & boxes, unsigned char * coherency, Indices & visible) const
+    {
+        const std::size_t count = boxes.size();
+        const std::size_t before = visible.size();
+
+        for (std::size_t base = 0; base < count; base += BLOCK)
+        {
+            const std::size_t block = std::min<std::size_t>(BLOCK, count - base);
+            unsigned char hits[BLOCK];
+            std::fill(hits, hits + block, 1);
+
+            // Last rejecting planes first
+            if (coherency)
+            {
+                for (std::size_t j = 0; j < block; ++j)
+                {
+                    const unsigned p = coherency[base + j];
+                    if (p < _count)
+                        hits[j] = pVertexDistance(boxes, base + j, p) >= static_cast<T>(0);
+                }
+
+                if (!detail::packHits(hits, block))
+                    continue;
+            }
+
+            boost::uint32_t word = detail::packHits(hits, block);
+            for (unsigned p = 0; p < _count && word; ++p)
+            {
+                T pd[BLOCK];
+                pVertexDistances(boxes, base, block, p, pd);
+
+                for (std::size_t j = 0; j < block; ++j)
+                    hits[j] &= (pd[j] >= static_cast<T>(0));
+
+                const boost::uint32_t before = word;
+                word = detail::packHits(hits, block);
+                if (coherency)
+                {
+                    for (boost::uint32_t rejected = before & ~word; rejected; rejected &= rejected - 1)
+                        coherency[base + countTrailingZeros(rejected)] = static_cast<unsigned char>(p);
+                }
+            }
+
+            detail::appendHitIndices(word, base, visible);
+        }
+
+        return visible.size() - before;
+    }
+
+    T pVertexDistance(const BoundsArray<T, N> & boxes, std::size_t index, unsigned p) const
+    {
+        T pd = - _origins[p];
+        for (unsigned c = 0; c < N; ++c)
+        {
+            const T n = _normals[c][p];
+            pd += n * (n >= static_cast<T>(0) ? boxes.getUpperLimits().lane(c)[index]
+                                              : boxes.getLowerLimits().lane(c)[index]);
+        }
+        return pd;
+    }
+
+};
+// class PlaneSet
+
+MW_END_NAMESPACE(math)
+
+#endif // MW_PLANESET_HPP
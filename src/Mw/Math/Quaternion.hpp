@@ -0,0 +1,402 @@
+/**
+ * @file   Quaternion.hpp
+ * @author Bastien Brunnenstein
+ */
+
+#ifndef MW_QUATERNION_HPP
+#define MW_QUATERNION_HPP
+
+#include <Mw/Config.hpp>
+
+#include <Mw/Math/Matrix.hpp>
+#include <Mw/Math/Vector.hpp>
+
+#include <ostream>
+#include <cmath>
+#include <stdexcept>
+
+#include <boost/serialization/nvp.hpp>
+#include <boost/operators.hpp>
+
+MW_BEGIN_NAMESPACE(math)
+
+/**
+ * Representation of a quaternion <tt>w + xi + yj + zk</tt>.
+ *
+ * Unit quaternions represent rotations in 3D space. The product
+ * <tt>q1 * q2</tt> is the rotation @c q2 followed by @c q1.
+ *
+ * @tparam T Scalar type.
+ */
+template<class T>
+class Quaternion : boost::additive<Quaternion<T> >,
+                   boost::multipliable<Quaternion<T> >,
+                   boost::multiplicative2<Quaternion<T>, T>,
+                   boost::equality_comparable<Quaternion<T> >
+{
+    /**
+     * Scalar part.
+     */
+    T _w;
+
+    /**
+     * Vector part.
+     */
+    T _x, _y, _z;
+
+public:
+
+    // Constructors
+
+    /**
+     * Default constructor.
+     *
+     * The quaternion is null, use identity() for the null rotation.
+     */
+    Quaternion()
+        : _w(static_cast<T>(0)), _x(static_cast<T>(0)), _y(static_cast<T>(0)), _z(static_cast<T>(0))
+    {}
+
+    /**
+     * Constructor.
+     *
+     * @param w Scalar part.
+     * @param x First component of the vector part.
+     * @param y Second component of the vector part.
+     * @param z Third component of the vector part.
+     */
+    Quaternion(T w, T x, T y, T z)
+        : _w(w), _x(x), _y(y), _z(z)
+    {}
+
+    /**
+     * Copy constructor.
+     *
+     * @param quat Quaternion to copy.
+     */
+    template <typename U>
+    Quaternion(const Quaternion<U> & quat)
+        : _w(quat.getW()), _x(quat.getX()), _y(quat.getY()), _z(quat.getZ())
+    {}
+
+    /**
+     * Get the null rotation.
+     *
+     * @return Identity quaternion.
+     */
+    static Quaternion identity()
+    {
+        return Quaternion(static_cast<T>(1), static_cast<T>(0), static_cast<T>(0), static_cast<T>(0));
+    }
+
+    /**
+     * Build a rotation around an axis.
+     *
+     * @param axis Rotation axis, must not be null.
+     * @param angle Angle in radians.
+     * @return Unit quaternion.
+     * @throw std::domain_error The axis is null.
+     */
+    static Quaternion fromAxisAngle(const Vector<T, 3> & axis, T angle)
+    {
+        const Vector<T, 3> u = normalize(axis) * std::sin(angle / 2);
+        return Quaternion(std::cos(angle / 2), u[0], u[1], u[2]);
+    }
+
+
+    // Getters / Setters
+
+    T getW() const
+    {
+        return _w;
+    }
+
+    T getX() const
+    {
+        return _x;
+    }
+
+    T getY() const
+    {
+        return _y;
+    }
+
+    T getZ() const
+    {
+        return _z;
+    }
+
+    /**
+     * Get the vector part.
+     *
+     * @return <tt>(x, y, z)</tt>.
+     */
+    Vector<T, 3> getVectorPart() const
+    {
+        Vector<T, 3> v;
+        v[0] = _x;
+        v[1] = _y;
+        v[2] = _z;
+        return v;
+    }
+
+    void set(T w, T x, T y, T z)
+    {
+        _w = w;
+        _x = x;
+        _y = y;
+        _z = z;
+    }
+
+
+    // Operators
+
+    Quaternion & operator += (const Quaternion & quat)
+    {
+        _w += quat._w;
+        _x += quat._x;
+        _y += quat._y;
+        _z += quat._z;
+        return *this;
+    }
+
+    Quaternion & operator -= (const Quaternion & quat)
+    {
+        _w -= quat._w;
+        _x -= quat._x;
+        _y -= quat._y;
+        _z -= quat._z;
+        return *this;
+    }
+
+    Quaternion operator - () const
+    {
+        return Quaternion(- _w, - _x, - _y, - _z);
+    }
+
+    /**
+     * Hamilton product.
+     *
+     * @param quat Right operand.
+     * @return
+     */
+    Quaternion & operator *= (const Quaternion & quat)
+    {
+        const T w = _w * quat._w - _x * quat._x - _y * quat._y - _z * quat._z;
+        const T x = _w * quat._x + _x * quat._w + _y * quat._z - _z * quat._y;
+        const T y = _w * quat._y - _x * quat._z + _y * quat._w + _z * quat._x;
+        const T z = _w * quat._z + _x * quat._y - _y * quat._x + _z * quat._w;
+        set(w, x, y, z);
+        return *this;
+    }
+
+    Quaternion & operator *= (T factor)
+    {
+        _w *= factor;
+        _x *= factor;
+        _y *= factor;
+        _z *= factor;
+        return *this;
+    }
+
+    /**
+     * Division operator.
+     *
+     * @param divisor Scalar divisor.
+     * @return
+     * @throw std::domain_error Division by zero
+     */
+    Quaternion & operator /= (T divisor)
+    {
+        if (divisor == static_cast<T>(0))
+            throw std::domain_error("Mw.Math.Quaternion: Division by zero");
+
+        _w /= divisor;
+        _x /= divisor;
+        _y /= divisor;
+        _z /= divisor;
+        return *this;
+    }
+
+    bool operator == (const Quaternion & quat) const
+    {
+        return _w == quat._w && _x == quat._x && _y == quat._y && _z == quat._z;
+    }
+
+
+    // Computations
+
+    T dot(const Quaternion & quat) const
+    {
+        return _w * quat._w + _x * quat._x + _y * quat._y + _z * quat._z;
+    }
+
+    T getNorm() const
+    {
+        return std::sqrt(dot(*this));
+    }
+
+    Quaternion getConjugate() const
+    {
+        return Quaternion(_w, - _x, - _y, - _z);
+    }
+
+    /**
+     * Compute the multiplicative inverse.
+     *
+     * @return Inverse, the conjugate for unit quaternions.
+     * @throw std::domain_error The quaternion is null.
+     */
+    Quaternion getInverse() const
+    {
+        const T sq = dot(*this);
+        if (sq == static_cast<T>(0))
+            throw std::domain_error("Mw.Math.Quaternion: Inverse not defined for null quaternions");
+
+        return getConjugate() / sq;
+    }
+
+    /**
+     * Rotate a vector.
+     *
+     * Computes <tt>q * v * conj(q)</tt> without building the quaternion
+     * products.
+     *
+     * @param vec Vector to rotate.
+     * @return Rotated vector, scaled by the squared norm if not a unit
+     *         quaternion.
+     */
+    Vector<T, 3> rotate(const Vector<T, 3> & vec) const
+    {
+        // t = 2 u x v, v' = v + w t + u x t
+        const Vector<T, 3> u = getVectorPart();
+        const Vector<T, 3> t = u.cross(vec) * static_cast<T>(2);
+        return vec + t * _w + u.cross(t);
+    }
+
+    /**
+     * Get the rotation matrix of a unit quaternion.
+     *
+     * @return Rotation matrix, applied to column vectors.
+     */
+    Matrix<T, 3, 3> toMatrix() const
+    {
+        const T xx = _x * _x, yy = _y * _y, zz = _z * _z;
+        const T xy = _x * _y, xz = _x * _z, yz = _y * _z;
+        const T wx = _w * _x, wy = _w * _y, wz = _w * _z;
+        const T one = static_cast<T>(1), two = static_cast<T>(2);
+
+        Matrix<T, 3, 3> m;
+        m(0, 0) = one - two * (yy + zz);
+        m(0, 1) = two * (xy - wz);
+        m(0, 2) = two * (xz + wy);
+        m(1, 0) = two * (xy + wz);
+        m(1, 1) = one - two * (xx + zz);
+        m(1, 2) = two * (yz - wx);
+        m(2, 0) = two * (xz - wy);
+        m(2, 1) = two * (yz + wx);
+        m(2, 2) = one - two * (xx + yy);
+        return m;
+    }
+
+
+private:
+    // Serialization
+    friend class boost::serialization::access;
+    template<class Archive>
+    void serialize(Archive & ar, const unsigned int version)
+    {
+        using namespace boost::serialization;
+
+        ar & make_nvp("w", _w);
+        ar & make_nvp("x", _x);
+        ar & make_nvp("y", _y);
+        ar & make_nvp("z", _z);
+    }
+
+};
+// class Quaternion
+
+
+/**
+ * Normalize a quaternion.
+ *
+ * @param quat Quaternion to be normalized.
+ * @return Unit quaternion.
+ * @throw std::domain_error The quaternion is null.
+ */
+template<typename T>
+Quaternion<T> normalize(const Quaternion<T> & quat)
+{
+    const T norm = quat.getNorm();
+    if (norm == static_cast<T>(0))
+        throw std::domain_error("Mw.Math.Quaternion: Normalization not defined for null quaternions");
+
+    return quat / norm;
+}
+
+/**
+ * Interpolate between two rotations, normalizing a linear interpolation.
+ *
+ * Takes the shortest path. Cheaper than slerp, but the angular speed is
+ * not constant.
+ *
+ * @param q1 First unit quaternion.
+ * @param q2 Second unit quaternion.
+ * @param mu Position between the rotations. Value between 0 and 1.
+ * @return Unit quaternion.
+ */
+template<typename T>
+Quaternion<T> nlerp(const Quaternion<T> & q1, const Quaternion<T> & q2, T mu)
+{
+    const T w2 = q1.dot(q2) < static_cast<T>(0) ? - mu : mu;
+    Quaternion<T> q = q1 * (static_cast<T>(1) - mu) + q2 * w2;
+    return q / q.getNorm();
+}
+
+/**
+ * Interpolate between two rotations at constant angular speed.
+ *
+ * Takes the shortest path. Nearly identical rotations fall back to nlerp.
+ *
+ * @param q1 First unit quaternion.
+ * @param q2 Second unit quaternion.
+ * @param mu Position between the rotations. Value between 0 and 1.
+ * @return Unit quaternion.
+ */
+template<typename T>
+Quaternion<T> slerp(const Quaternion<T> & q1, const Quaternion<T> & q2, T mu)
+{
+    T d = q1.dot(q2);
+    T sign = static_cast<T>(1);
+    if (d < static_cast<T>(0))
+    {
+        d = - d;
+        sign = static_cast<T>(-1);
+    }
+
+    if (d > static_cast<T>(0.9995))
+        return nlerp(q1, q2, mu);
+
+    const T theta = std::acos(d);
+    const T s = std::sin(theta);
+    return q1 * (std::sin((static_cast<T>(1) - mu) * theta) / s) + q2 * (sign * std::sin(mu * theta) / s);
+}
+
+/**
+ * Stream insertion operator overload.
+ *
+ * @param ostr Output stream.
+ * @param quat Quaternion to insert into the stream.
+ * @return @c ostr Output stream.
+ */
+template <typename T>
+std::ostream & operator << (std::ostream & ostr, const Quaternion<T> & quat)
+{
+    return ostr << "Quaternion[" << quat.getW() << ", " << quat.getX() << ", "
+                << quat.getY() << ", " << quat.getZ() << "]";
+}
+
+MW_END_NAMESPACE(math)
+
+#endif // MW_QUATERNION_HPP
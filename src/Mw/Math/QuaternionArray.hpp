@@ -0,0 +1,577 @@
+/**
+ * @file   QuaternionArray.hpp
+ * @author Bastien Brunnenstein
+ */
+
+#ifndef MW_QUATERNIONARRAY_HPP
+#define MW_QUATERNIONARRAY_HPP
+
+#include <Mw/Config.hpp>
+
+#include <Mw/Math/Quaternion.hpp>
+#include <Mw/Math/Simd.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/align/aligned_allocator.hpp>
+#include <boost/assert.hpp>
+
+MW_BEGIN_NAMESPACE(math)
+
+namespace detail
+{
+
+/**
+ * Coefficients of the polynomial approximation of slerp.
+ *
+ * From D. Eberly, "A Fast and Accurate Algorithm for Computing SLERP":
+ * the slerp weights are written as series in <tt>cos(theta) - 1</tt>,
+ * truncated, the last term scaled to balance the error. With 14 terms the
+ * maximum error on the weights is 1.5e-7, reached for half turns, without
+ * any trigonometric function or division.
+ */
+template<typename T>
+struct SlerpSeries
+{
+    static const unsigned TERMS = 14;
+
+    T u[TERMS];
+    T v[TERMS];
+
+    SlerpSeries()
+    {
+        for (unsigned i = 0; i < TERMS; ++i)
+        {
+            const T s = static_cast<T>(i + 1);
+            u[i] = static_cast<T>(1) / (s * (2 * s + 1));
+            v[i] = s / (2 * s + 1);
+        }
+
+        const T correction = static_cast<T>(1.9066);
+        u[TERMS - 1] *= correction;
+        v[TERMS - 1] *= correction;
+    }
+
+    /**
+     * Compute the weight of one end of the interpolation.
+     *
+     * @param xm1 <tt>cos(theta) - 1</tt>, @c theta in [0, pi/2].
+     * @param t Position of the other end.
+     * @return Approximation of <tt>sin(t * theta) / sin(theta)</tt>.
+     */
+    T weight(T xm1, T t) const
+    {
+        const T sq = t * t;
+        T c = static_cast<T>(1) + (u[TERMS - 1] * sq - v[TERMS - 1]) * xm1;
+        for (unsigned i = TERMS - 1; i-- > 0;)
+            c = static_cast<T>(1) + (u[i] * sq - v[i]) * xm1 * c;
+        return t * c;
+    }
+};
+
+/**
+ * Interpolation loops over quaternion lanes.
+ *
+ * Lanes are given in w, x, y, z order. The interpolation position is read
+ * every @c muStep values, 0 for a single position. Outputs may alias the
+ * inputs.
+ *
+ * @tparam T Scalar type.
+ */
+template<typename T>
+struct QuaternionLerpLoops
+{
+    static void slerp(const T * const (&a)[4], const T * const (&b)[4], const T * mu, std::size_t muStep,
+                      T * const (&out)[4], std::size_t begin, std::size_t end)
+    {
+        const SlerpSeries<T> series;
+
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            T x = a[0][i] * b[0][i] + a[1][i] * b[1][i] + a[2][i] * b[2][i] + a[3][i] * b[3][i];
+            const bool negative = x < static_cast<T>(0);
+            if (negative)
+                x = - x;
+
+            const T t = mu[i * muStep];
+            const T xm1 = x - static_cast<T>(1);
+            const T wa = series.weight(xm1, static_cast<T>(1) - t);
+            T wb = series.weight(xm1, t);
+            if (negative)
+                wb = - wb;
+
+            for (unsigned c = 0; c < 4; ++c)
+                out[c][i] = a[c][i] * wa + b[c][i] * wb;
+        }
+    }
+
+    static void nlerp(const T * const (&a)[4], const T * const (&b)[4], const T * mu, std::size_t muStep,
+                      T * const (&out)[4], std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            const T x = a[0][i] * b[0][i] + a[1][i] * b[1][i] + a[2][i] * b[2][i] + a[3][i] * b[3][i];
+
+            const T t = mu[i * muStep];
+            const T wa = static_cast<T>(1) - t;
+            const T wb = x < static_cast<T>(0) ? - t : t;
+
+            T q[4];
+            for (unsigned c = 0; c < 4; ++c)
+                q[c] = a[c][i] * wa + b[c][i] * wb;
+
+            const T norm = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+            for (unsigned c = 0; c < 4; ++c)
+                out[c][i] = q[c] / norm;
+        }
+    }
+};
+
+/**
+ * Interpolation kernels over quaternion lanes.
+ *
+ * The generic kernels are the plain loops, float gets SSE kernels with the
+ * same operations. The results may differ by a few ulps with the SIMD
+ * support, as the compiler can contract the plain loops into FMAs.
+ *
+ * @tparam T Scalar type.
+ */
+template<typename T>
+struct QuaternionLerpKernel : QuaternionLerpLoops<T>
+{};
+
+#ifdef MW_SIMD_SSE
+
+template<>
+struct QuaternionLerpKernel<float>
+{
+    static void slerp(const float * const (&a)[4], const float * const (&b)[4], const float * mu,
+                      std::size_t muStep, float * const (&out)[4], std::size_t begin, std::size_t end)
+    {
+        const SlerpSeries<float> series;
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 signBit = _mm_set1_ps(-0.0f);
+
+        __m128 u[SlerpSeries<float>::TERMS], v[SlerpSeries<float>::TERMS];
+        for (unsigned k = 0; k < SlerpSeries<float>::TERMS; ++k)
+        {
+            u[k] = _mm_set1_ps(series.u[k]);
+            v[k] = _mm_set1_ps(series.v[k]);
+        }
+
+        std::size_t i = begin;
+        for (; i + 4 <= end; i += 4)
+        {
+            __m128 qa[4], qb[4];
+            for (unsigned c = 0; c < 4; ++c)
+            {
+                qa[c] = _mm_loadu_ps(a[c] + i);
+                qb[c] = _mm_loadu_ps(b[c] + i);
+            }
+
+            __m128 x = _mm_mul_ps(qa[0], qb[0]);
+            for (unsigned c = 1; c < 4; ++c)
+                x = _mm_add_ps(x, _mm_mul_ps(qa[c], qb[c]));
+
+            // Sign of the negative dot products, to take the shortest path
+            const __m128 sign = _mm_and_ps(_mm_cmplt_ps(x, _mm_setzero_ps()), signBit);
+            x = _mm_xor_ps(x, sign);
+
+            const __m128 t = muStep ? _mm_loadu_ps(mu + i) : _mm_set1_ps(*mu);
+            const __m128 d = _mm_sub_ps(one, t);
+            const __m128 xm1 = _mm_sub_ps(x, one);
+            const __m128 sqT = _mm_mul_ps(t, t);
+            const __m128 sqD = _mm_mul_ps(d, d);
+
+            const unsigned last = SlerpSeries<float>::TERMS - 1;
+            __m128 cT = _mm_add_ps(one, _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(u[last], sqT), v[last]), xm1));
+            __m128 cD = _mm_add_ps(one, _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(u[last], sqD), v[last]), xm1));
+            for (unsigned k = last; k-- > 0;)
+            {
+                cT = _mm_add_ps(one, _mm_mul_ps(_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(u[k], sqT), v[k]), xm1), cT));
+                cD = _mm_add_ps(one, _mm_mul_ps(_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(u[k], sqD), v[k]), xm1), cD));
+            }
+
+            const __m128 wa = _mm_mul_ps(d, cD);
+            const __m128 wb = _mm_xor_ps(_mm_mul_ps(t, cT), sign);
+
+            for (unsigned c = 0; c < 4; ++c)
+                _mm_storeu_ps(out[c] + i, _mm_add_ps(_mm_mul_ps(qa[c], wa), _mm_mul_ps(qb[c], wb)));
+        }
+
+        QuaternionLerpLoops<float>::slerp(a, b, mu, muStep, out, i, end);
+    }
+
+    static void nlerp(const float * const (&a)[4], const float * const (&b)[4], const float * mu,
+                      std::size_t muStep, float * const (&out)[4], std::size_t begin, std::size_t end)
+    {
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 signBit = _mm_set1_ps(-0.0f);
+
+        std::size_t i = begin;
+        for (; i + 4 <= end; i += 4)
+        {
+            __m128 qa[4], qb[4];
+            for (unsigned c = 0; c < 4; ++c)
+            {
+                qa[c] = _mm_loadu_ps(a[c] + i);
+                qb[c] = _mm_loadu_ps(b[c] + i);
+            }
+
+            __m128 x = _mm_mul_ps(qa[0], qb[0]);
+            for (unsigned c = 1; c < 4; ++c)
+                x = _mm_add_ps(x, _mm_mul_ps(qa[c], qb[c]));
+
+            const __m128 t = muStep ? _mm_loadu_ps(mu + i) : _mm_set1_ps(*mu);
+            const __m128 wa = _mm_sub_ps(one, t);
+            const __m128 wb = _mm_xor_ps(t, _mm_and_ps(_mm_cmplt_ps(x, _mm_setzero_ps()), signBit));
+
+            __m128 q[4];
+            for (unsigned c = 0; c < 4; ++c)
+                q[c] = _mm_add_ps(_mm_mul_ps(qa[c], wa), _mm_mul_ps(qb[c], wb));
+
+            __m128 sq = _mm_mul_ps(q[0], q[0]);
+            for (unsigned c = 1; c < 4; ++c)
+                sq = _mm_add_ps(sq, _mm_mul_ps(q[c], q[c]));
+            const __m128 norm = _mm_sqrt_ps(sq);
+
+            for (unsigned c = 0; c < 4; ++c)
+                _mm_storeu_ps(out[c] + i, _mm_div_ps(q[c], norm));
+        }
+
+        QuaternionLerpLoops<float>::nlerp(a, b, mu, muStep, out, i, end);
+    }
+};
+
+#endif // MW_SIMD_SSE
+
+} // namespace detail
+
+
+/**
+ * Array of quaternions stored as a structure of arrays.
+ *
+ * Each component is stored in its own contiguous and aligned lane, in
+ * w, x, y, z order, so the batch kernels can process several rotations per
+ * SIMD instruction.
+ *
+ * @tparam T Scalar type.
+ */
+template<typename T>
+class QuaternionArray
+{
+public:
+
+    /**
+     * Aligned storage of a lane.
+     */
+    typedef std::vector<T, boost::alignment::aligned_allocator<T, MW_SIMD_ALIGNMENT> > Lane;
+
+private:
+
+    /**
+     * One lane per component.
+     */
+    Lane _lanes[4];
+
+public:
+
+    // Constructors
+
+    /**
+     * Default constructor.
+     *
+     * The array is empty.
+     */
+    QuaternionArray()
+    {}
+
+    /**
+     * Constructor.
+     *
+     * @param size Number of identity quaternions in the array.
+     */
+    explicit QuaternionArray(std::size_t size)
+    {
+        resize(size);
+    }
+
+    /**
+     * Range constructor.
+     *
+     * Convert a range of Quaternion (array of structures) into this layout.
+     *
+     * @param first Beginning of the range.
+     * @param last End of the range.
+     */
+    template<class InputIterator>
+    QuaternionArray(InputIterator first, InputIterator last)
+    {
+        assign(first, last);
+    }
+
+
+    // Getters / setters
+
+    /**
+     * Get the number of quaternions in the array.
+     *
+     * @return Number of quaternions.
+     */
+    std::size_t size() const
+    {
+        return _lanes[0].size();
+    }
+
+    /**
+     * Check if the array is empty.
+     *
+     * @return @c true if the array has no quaternions.
+     */
+    bool empty() const
+    {
+        return _lanes[0].empty();
+    }
+
+    /**
+     * Change the number of quaternions in the array.
+     *
+     * New quaternions are identities.
+     *
+     * @param size New number of quaternions.
+     */
+    void resize(std::size_t size)
+    {
+        _lanes[0].resize(size, static_cast<T>(1));
+        for (unsigned c = 1; c < 4; ++c)
+            _lanes[c].resize(size, static_cast<T>(0));
+    }
+
+    /**
+     * Reserve memory for a number of quaternions.
+     *
+     * @param capacity Number of quaternions.
+     */
+    void reserve(std::size_t capacity)
+    {
+        for (unsigned c = 0; c < 4; ++c)
+            _lanes[c].reserve(capacity);
+    }
+
+    /**
+     * Remove all the quaternions.
+     */
+    void clear()
+    {
+        for (unsigned c = 0; c < 4; ++c)
+            _lanes[c].clear();
+    }
+
+    /**
+     * Append a quaternion at the end of the array.
+     *
+     * @param quat Quaternion to append.
+     */
+    void push_back(const Quaternion<T> & quat)
+    {
+        _lanes[0].push_back(quat.getW());
+        _lanes[1].push_back(quat.getX());
+        _lanes[2].push_back(quat.getY());
+        _lanes[3].push_back(quat.getZ());
+    }
+
+    /**
+     * Get a lane.
+     *
+     * @param component Component's index, in w, x, y, z order.
+     * @return Pointer to the first value of the lane.
+     */
+    T * lane(unsigned component)
+    {
+        BOOST_ASSERT_MSG(component < 4, "Mw.Math.QuaternionArray: Out of range");
+
+        return _lanes[component].empty() ? NULL : &_lanes[component][0];
+    }
+
+    /**
+     * Get a lane.
+     *
+     * @param component Component's index, in w, x, y, z order.
+     * @return Pointer to the first value of the lane.
+     */
+    const T * lane(unsigned component) const
+    {
+        BOOST_ASSERT_MSG(component < 4, "Mw.Math.QuaternionArray: Out of range");
+
+        return _lanes[component].empty() ? NULL : &_lanes[component][0];
+    }
+
+    /**
+     * Get a quaternion.
+     *
+     * @param index Quaternion's index.
+     * @return Copy of the quaternion at position @c index.
+     */
+    Quaternion<T> get(std::size_t index) const
+    {
+        if (index >= size())
+            throw std::out_of_range("Mw.Math.QuaternionArray: Out of range");
+
+        return (*this)[index];
+    }
+
+    /**
+     * Set a quaternion.
+     *
+     * @param index Quaternion's index.
+     * @param quat New value.
+     */
+    void set(std::size_t index, const Quaternion<T> & quat)
+    {
+        if (index >= size())
+            throw std::out_of_range("Mw.Math.QuaternionArray: Out of range");
+
+        _lanes[0][index] = quat.getW();
+        _lanes[1][index] = quat.getX();
+        _lanes[2][index] = quat.getY();
+        _lanes[3][index] = quat.getZ();
+    }
+
+    /**
+     * Access a quaternion without bounds checking.
+     *
+     * @param index Quaternion's index, must be lower than size().
+     * @return Copy of the quaternion at position @c index.
+     */
+    Quaternion<T> operator [] (std::size_t index) const
+    {
+        BOOST_ASSERT_MSG(index < size(), "Mw.Math.QuaternionArray: Out of range");
+
+        return Quaternion<T>(_lanes[0][index], _lanes[1][index], _lanes[2][index], _lanes[3][index]);
+    }
+
+
+    // Conversions
+
+    /**
+     * Replace the content of the array by a range of Quaternion.
+     *
+     * @param first Beginning of the range.
+     * @param last End of the range.
+     */
+    template<class InputIterator>
+    void assign(InputIterator first, InputIterator last)
+    {
+        clear();
+        for (; first != last; ++first)
+            push_back(*first);
+    }
+
+    /**
+     * Copy the quaternions to a range of Quaternion (array of structures).
+     *
+     * @param out Beginning of the output range.
+     * @return End of the output range.
+     */
+    template<class OutputIterator>
+    OutputIterator copyTo(OutputIterator out) const
+    {
+        const std::size_t count = size();
+        for (std::size_t i = 0; i < count; ++i, ++out)
+            *out = (*this)[i];
+
+        return out;
+    }
+
+};
+// class QuaternionArray
+
+
+namespace detail
+{
+
+/**
+ * Run an interpolation kernel on whole arrays.
+ */
+template<typename T, class Kernel>
+void interpolateQuaternions(const QuaternionArray<T> & from, const QuaternionArray<T> & to,
+                            const T * mu, std::size_t muStep, QuaternionArray<T> & out, Kernel kernel)
+{
+    BOOST_ASSERT(from.size() == to.size());
+
+    const std::size_t count = from.size();
+    out.resize(count);
+    if (!count)
+        return;
+
+    const T * const a[4] = { from.lane(0), from.lane(1), from.lane(2), from.lane(3) };
+    const T * const b[4] = { to.lane(0), to.lane(1), to.lane(2), to.lane(3) };
+    T * const o[4] = { out.lane(0), out.lane(1), out.lane(2), out.lane(3) };
+    kernel(a, b, mu, muStep, o, 0, count);
+}
+
+} // namespace detail
+
+
+/**
+ * Interpolate pairs of rotations at constant angular speed.
+ *
+ * Takes the shortest paths. Uses a polynomial approximation instead of
+ * trigonometric functions: the results differ from the Quaternion slerp
+ * by less than 1e-6.
+ *
+ * @param from First unit quaternions.
+ * @param to Second unit quaternions, same size as @c from.
+ * @param mu Position between the rotations of each pair, between 0 and 1.
+ * @param out Interpolated quaternions, may be @c from or @c to.
+ */
+template<typename T>
+void slerp(const QuaternionArray<T> & from, const QuaternionArray<T> & to, const T * mu, QuaternionArray<T> & out)
+{
+    detail::interpolateQuaternions(from, to, mu, 1, out, &detail::QuaternionLerpKernel<T>::slerp);
+}
+
+/**
+ * Interpolate pairs of rotations at the same position.
+ *
+ * @see slerp
+ */
+template<typename T>
+void slerp(const QuaternionArray<T> & from, const QuaternionArray<T> & to, T mu, QuaternionArray<T> & out)
+{
+    detail::interpolateQuaternions(from, to, &mu, 0, out, &detail::QuaternionLerpKernel<T>::slerp);
+}
+
+/**
+ * Interpolate pairs of rotations, normalizing linear interpolations.
+ *
+ * The results are within 4 ulps of the Quaternion nlerp.
+ *
+ * @param from First unit quaternions.
+ * @param to Second unit quaternions, same size as @c from.
+ * @param mu Position between the rotations of each pair, between 0 and 1.
+ * @param out Interpolated quaternions, may be @c from or @c to.
+ */
+template<typename T>
+void nlerp(const QuaternionArray<T> & from, const QuaternionArray<T> & to, const T * mu, QuaternionArray<T> & out)
+{
+    detail::interpolateQuaternions(from, to, mu, 1, out, &detail::QuaternionLerpKernel<T>::nlerp);
+}
+
+/**
+ * Interpolate pairs of rotations at the same position.
+ *
+ * @see nlerp
+ */
+template<typename T>
+void nlerp(const QuaternionArray<T> & from, const QuaternionArray<T> & to, T mu, QuaternionArray<T> & out)
+{
+    detail::interpolateQuaternions(from, to, &mu, 0, out, &detail::QuaternionLerpKernel<T>::nlerp);
+}
+
+MW_END_NAMESPACE(math)
+
+#endif // MW_QUATERNIONARRAY_HPP
@@ -8,72 +8,272 @@
 
 #include <Mw/Config.hpp>
 
+#include <Mw/Math/Bits.hpp>
+#include <Mw/Math/Overflow.hpp>
+
+#include <limits>
 #include <stdexcept>
 #include <ostream>
 
 #include <boost/serialization/nvp.hpp>
 #include <boost/assert.hpp>
 #include <boost/operators.hpp>
+#include <boost/type_traits/make_unsigned.hpp>
 
 MW_BEGIN_NAMESPACE(math)
 
+namespace detail
+{
+
 /**
- * Rational number.
+ * Operations on fractions shared by both implementations.
  *
- * @tparam T Integer type.
+ * Fractions are given as numerator and denominator, denominators are
+ * positive except for reduce().
  */
 template<typename T>
-class Rational : boost::arithmetic<Rational<T> >,
-                 boost::totally_ordered<Rational<T> >
+struct RationalBase
 {
-    /**
-     * Fraction's numerator.
-     */
-    T _numerator;
+    typedef typename boost::make_unsigned<T>::type U;
+
+    template<typename S>
+    static S toScalar(T numerator, T denominator)
+    {
+        return static_cast<S>(numerator) / static_cast<S>(denominator);
+    }
+
+    static U magnitude(T value)
+    {
+        return value < static_cast<T>(0) ? static_cast<U>(0) - static_cast<U>(value) : static_cast<U>(value);
+    }
 
     /**
-     * Fraction's denominator.
+     * Greatest common divisor, fits in T if one of the values is positive.
      */
-    T _denominator;
+    static T gcd(T a, T b)
+    {
+        return static_cast<T>(binaryGcd(magnitude(a), magnitude(b)));
+    }
 
     /**
-     * Compute gcd of 2 numbers.
+     * Reduce a fraction and make its denominator positive.
      *
-     * @param a First number.
-     * @param b Second number.
+     * @return @c false if the reduced fraction does not fit.
      */
-    static T computeGcd(T a, T b)
+    static bool reduce(T & numerator, T & denominator)
     {
-        a = (a >= static_cast<T>(0) ? a : - a);
-        b = (b >= static_cast<T>(0) ? b : - b);
-        T tmp;
+        if (denominator == static_cast<T>(1))
+            return true;
 
-        while(a)
+        if (numerator == static_cast<T>(0))
         {
-            if (!b) return a;
-            tmp = b;
-            b = a % b;
-            a = tmp;
+            denominator = static_cast<T>(1);
+            return true;
         }
-        return b;
+
+        // Reduced as unsigned values, so that the smallest value of T can
+        // be negated
+        const bool negative = (numerator < static_cast<T>(0)) != (denominator < static_cast<T>(0));
+        U n = magnitude(numerator), d = magnitude(denominator);
+        const U g = binaryGcd(n, d);
+        n /= g;
+        d /= g;
+
+        numerator = static_cast<T>(negative ? static_cast<U>(0) - n : n);
+        denominator = static_cast<T>(d);
+
+        const U max = static_cast<U>(std::numeric_limits<T>::max());
+        return d <= max && n <= (negative ? max + 1 : max);
     }
 
     /**
-     * Normalize the fraction.
+     * Exact comparison by continued fractions, never overflows.
      */
-    void normalize()
+    static bool lessByContinuedFraction(T n1, T d1, T n2, T d2)
+    {
+        // With the same integer part, n1 / d1 < n2 / d2 is r1 / d1 < r2 / d2,
+        // which is d1 / r1 > d2 / r2
+        bool swapped = false;
+        for (;;)
+        {
+            T q1 = n1 / d1, r1 = n1 % d1;
+            if (r1 < static_cast<T>(0))
+            {
+                r1 += d1;
+                --q1;
+            }
+
+            T q2 = n2 / d2, r2 = n2 % d2;
+            if (r2 < static_cast<T>(0))
+            {
+                r2 += d2;
+                --q2;
+            }
+
+            if (q1 != q2)
+                return swapped ? q2 < q1 : q1 < q2;
+            if (r2 == static_cast<T>(0))
+                return swapped && r1 != static_cast<T>(0);
+            if (r1 == static_cast<T>(0))
+                return !swapped;
+
+            n1 = d1;
+            d1 = r1;
+            n2 = d2;
+            d2 = r2;
+            swapped = !swapped;
+        }
+    }
+};
+
+/**
+ * Operations on fractions, with intermediate values in a wider integer
+ * type.
+ *
+ * Results are exact whenever they fit in T, comparisons are always exact.
+ */
+template<typename T, bool Wide = WideInteger<T>::EXISTS>
+struct RationalArithmetic : RationalBase<T>
+{
+    typedef RationalBase<T> Base;
+    typedef typename WideInteger<T>::Type W;
+
+    /**
+     * Narrow a result, making its denominator positive.
+     */
+    static bool narrow(W n, W d, T & numerator, T & denominator)
     {
-        // No negative denominator
-        if (_denominator < static_cast<T>(0))
+        if (d < static_cast<W>(0))
         {
-            _numerator = -_numerator;
-            _denominator = -_denominator;
+            n = - n;
+            d = - d;
         }
+        numerator = static_cast<T>(n);
+        denominator = static_cast<T>(d);
+        return fits<T>(n) && fits<T>(d);
+    }
+
+    static bool add(T n1, T d1, T n2, T d2, bool subtract, T & numerator, T & denominator)
+    {
+        const W s2 = subtract ? - static_cast<W>(n2) : static_cast<W>(n2);
+
+        // Knuth, the sum is reduced by the gcd of the denominators only
+        const T g1 = Base::gcd(d1, d2);
+        if (g1 == static_cast<T>(1))
+            return narrow(static_cast<W>(n1) * d2 + static_cast<W>(d1) * s2,
+                          static_cast<W>(d1) * d2, numerator, denominator);
+
+        const T a = d1 / g1, b = d2 / g1;
+        W t = static_cast<W>(n1) * b + static_cast<W>(a) * s2;
+        const T g2 = Base::gcd(static_cast<T>(t % g1), g1);
+        t /= g2;
+        return narrow(t, static_cast<W>(a) * (d2 / g2), numerator, denominator);
+    }
 
-        // Reduce fraction
-        T gcd = computeGcd(_numerator, _denominator);
-        _numerator /= gcd;
-        _denominator /= gcd;
+    static bool multiply(T n1, T d1, T n2, T d2, T & numerator, T & denominator)
+    {
+        const T g1 = Base::gcd(n1, d2);
+        const T g2 = Base::gcd(d1, n2);
+        return narrow(static_cast<W>(n1 / g1) * (n2 / g2), static_cast<W>(d1 / g2) * (d2 / g1),
+                      numerator, denominator);
+    }
+
+    static bool less(T n1, T d1, T n2, T d2)
+    {
+        return static_cast<W>(n1) * d2 < static_cast<W>(n2) * d1;
+    }
+};
+
+/**
+ * Operations on fractions without a wider integer type.
+ *
+ * Overflows of intermediate values are reported even if the result would
+ * fit, comparisons are exact.
+ */
+template<typename T>
+struct RationalArithmetic<T, false> : RationalBase<T>
+{
+    typedef RationalBase<T> Base;
+
+    static bool add(T n1, T d1, T n2, T d2, bool subtract, T & numerator, T & denominator)
+    {
+        const T g1 = Base::gcd(d1, d2);
+        const T a = d1 / g1, b = d2 / g1;
+
+        T x, y, t;
+        bool ok = checkedMultiply(n1, b, x);
+        ok &= checkedMultiply(a, n2, y);
+        ok &= subtract ? checkedSubtract(x, y, t) : checkedAdd(x, y, t);
+
+        const T g2 = g1 == static_cast<T>(1) ? g1 : Base::gcd(t, g1);
+        numerator = t / g2;
+        ok &= checkedMultiply(a, d2 / g2, denominator);
+        return ok;
+    }
+
+    static bool multiply(T n1, T d1, T n2, T d2, T & numerator, T & denominator)
+    {
+        const T g1 = Base::gcd(n1, d2);
+        const T g2 = Base::gcd(d1, n2);
+
+        bool ok = checkedMultiply(n1 / g1, n2 / g2, numerator);
+        ok &= checkedMultiply(d1 / g2, d2 / g1, denominator);
+        if (denominator < static_cast<T>(0))
+        {
+            ok &= checkedSubtract(static_cast<T>(0), numerator, numerator);
+            ok &= checkedSubtract(static_cast<T>(0), denominator, denominator);
+        }
+        return ok;
+    }
+
+    static bool less(T n1, T d1, T n2, T d2)
+    {
+        return Base::lessByContinuedFraction(n1, d1, n2, d2);
+    }
+};
+
+} // namespace detail
+
+/**
+ * Rational number.
+ *
+ * Fractions are always reduced, with a positive denominator. Intermediate
+ * values are computed in a wider integer type when there is one (up to 64
+ * bits integers with MW_HAS_INT128), so results are exact whenever they
+ * fit in @c T. Results that do not fit are given to the overflow policy.
+ *
+ * @tparam T Signed integer type.
+ * @tparam OverflowPolicy IgnoreOverflow, ThrowOnOverflow or
+ *                        AssertOnOverflow.
+ */
+template<typename T, class OverflowPolicy = IgnoreOverflow>
+class Rational : boost::arithmetic<Rational<T, OverflowPolicy> >,
+                 boost::totally_ordered<Rational<T, OverflowPolicy> >
+{
+    typedef detail::RationalArithmetic<T> Arithmetic;
+
+    /**
+     * Fraction's numerator.
+     */
+    T _numerator;
+
+    /**
+     * Fraction's denominator.
+     */
+    T _denominator;
+
+    static void check(bool fits)
+    {
+        if (!fits)
+            OverflowPolicy::overflow("Mw.Math.Rational: Overflow");
+    }
+
+    /**
+     * Normalize the fraction.
+     */
+    void normalize()
+    {
+        check(Arithmetic::reduce(_numerator, _denominator));
     }
 
 public:
@@ -98,7 +298,7 @@ public:
     explicit Rational(T numerator, T denominator = static_cast<T>(1))
         : _numerator(numerator), _denominator(denominator)
     {
-        BOOST_ASSERT(denominator);
+        BOOST_ASSERT(denominator != static_cast<T>(0));
 
         normalize();
     }
@@ -114,7 +314,7 @@ public:
     template<typename U>
     operator U () const
     {
-        return static_cast<U>(_numerator) / static_cast<U>(_denominator);
+        return Arithmetic::template toScalar<U>(_numerator, _denominator);
     }
 
     /**
@@ -145,7 +345,7 @@ public:
      */
     void set(T numerator, T denominator)
     {
-        BOOST_ASSERT(denominator);
+        BOOST_ASSERT(denominator != static_cast<T>(0));
 
         _numerator = numerator;
         _denominator = denominator;
@@ -174,7 +374,7 @@ public:
      */
     void setDenominator(T denominator)
     {
-        BOOST_ASSERT(denominator);
+        BOOST_ASSERT(denominator != static_cast<T>(0));
 
         _denominator = denominator;
         normalize();
@@ -185,52 +385,22 @@ public:
 
     Rational & operator += (const Rational & rat)
     {
-        T g1 = computeGcd(_denominator, rat._denominator);
-        if (g1 == static_cast<T>(1))
-        {
-            _numerator = _numerator * rat._denominator
-                       + _denominator * rat._numerator;
-            _denominator = _denominator * rat._denominator;
-        }
-        else
-        {
-            T t = _numerator * (rat._denominator / g1)
-                + (_denominator/g1) * rat._numerator;
-
-            T g2 = computeGcd(t, g1);
-            _numerator = t / g2;
-            _denominator = (_denominator / g1) * (rat._denominator / g2);
-        }
+        check(Arithmetic::add(_numerator, _denominator, rat._numerator, rat._denominator, false,
+                              _numerator, _denominator));
         return *this;
     }
 
     Rational & operator -= (const Rational & rat)
     {
-        T g1 = computeGcd(_denominator, rat._denominator);
-        if (g1 == static_cast<T>(1))
-        {
-            _numerator = _numerator * rat._denominator
-                       - _denominator * rat._numerator;
-            _denominator = _denominator * rat._denominator;
-        }
-        else
-        {
-            T t = _numerator * (rat._denominator / g1)
-                - (_denominator/g1) * rat._numerator;
-
-            T g2 = computeGcd(t, g1);
-            _numerator = t / g2;
-            _denominator = (_denominator / g1) * (rat._denominator / g2);
-        }
+        check(Arithmetic::add(_numerator, _denominator, rat._numerator, rat._denominator, true,
+                              _numerator, _denominator));
         return *this;
     }
 
     Rational & operator *= (const Rational & rat)
     {
-        T g1 = computeGcd(_numerator, rat._denominator);
-        T g2 = computeGcd(_denominator, rat._numerator);
-        _numerator = (_numerator / g1) * (rat._numerator / g2);
-        _denominator = (_denominator / g2) * (rat._denominator / g1);
+        check(Arithmetic::multiply(_numerator, _denominator, rat._numerator, rat._denominator,
+                                   _numerator, _denominator));
         return *this;
     }
 
@@ -239,19 +409,11 @@ public:
      */
     Rational & operator /= (const Rational & rat)
     {
-        if(!rat.getNumerator())
+        if(rat._numerator == static_cast<T>(0))
             throw std::invalid_argument("Mw.Math.Rational: Division by zero");
 
-        long g1 = computeGcd(_numerator, rat._numerator);
-        long g2 = computeGcd(_denominator, rat._denominator);
-        _numerator = (_numerator / g1) * (rat._denominator / g2);
-        _denominator = (_denominator / g2) * (rat._numerator / g1);
-
-        if (_denominator < static_cast<T>(0))
-        {
-            _numerator = -_numerator;
-            _denominator = -_denominator;
-        }
+        check(Arithmetic::multiply(_numerator, _denominator, rat._denominator, rat._numerator,
+                                   _numerator, _denominator));
         return *this;
     }
 
@@ -261,9 +423,12 @@ public:
             && (_denominator == rat._denominator);
     }
 
+    /**
+     * Exact comparison, never overflows.
+     */
     bool operator < (const Rational & rat) const
     {
-        return (_numerator * rat._denominator < _denominator * rat._numerator);
+        return Arithmetic::less(_numerator, _denominator, rat._numerator, rat._denominator);
     }
 
 
@@ -290,8 +455,8 @@ private:
  * @param vec Rational to insert into the stream.
  * @return @c ostr Output stream.
  */
-template <typename T>
-std::ostream & operator << (std::ostream & ostr, const Rational<T> & rat)
+template <typename T, class OverflowPolicy>
+std::ostream & operator << (std::ostream & ostr, const Rational<T, OverflowPolicy> & rat)
 {
     return ostr << rat.getNumerator() << '/' << rat.getDenominator();
 }
@@ -0,0 +1,288 @@
+/**
+ * @file   RationalAccumulator.hpp
+ * @author Bastien Brunnenstein
+ *
+ * @details Sums of rational numbers with deferred normalization.
+ *
+ * Rational reduces every intermediate result, which costs one or two gcds
+ * per addition. RationalAccumulator keeps its running sum unreduced, with
+ * intermediate values in a wider integer type when there is one, and only
+ * reduces it when the next term would overflow and when the sum is read.
+ * The fraction of a rational number is unique once reduced, so the results
+ * are the same as Rational's whenever Rational does not overflow.
+ */
+
+#ifndef MW_RATIONALACCUMULATOR_HPP
+#define MW_RATIONALACCUMULATOR_HPP
+
+#include <Mw/Config.hpp>
+
+#include <Mw/Math/Bits.hpp>
+#include <Mw/Math/Overflow.hpp>
+#include <Mw/Math/Rational.hpp>
+#include <Mw/Math/Vector.hpp>
+
+#include <cstddef>
+
+#include <boost/type_traits/make_unsigned.hpp>
+
+MW_BEGIN_NAMESPACE(math)
+
+/**
+ * Accumulator of sums of rational numbers.
+ *
+ * @tparam T Signed integer type.
+ * @tparam OverflowPolicy Overflow policy of the Rational values.
+ */
+template<typename T, class OverflowPolicy = IgnoreOverflow>
+class RationalAccumulator
+{
+public:
+
+    typedef Rational<T, OverflowPolicy> Value;
+
+private:
+
+    typedef detail::RationalArithmetic<T> Arithmetic;
+    typedef typename detail::WideInteger<T>::Type W;
+    typedef typename boost::make_unsigned<W>::type U;
+
+    /**
+     * Numerator of the running sum, not reduced.
+     */
+    W _numerator;
+
+    /**
+     * Positive denominator of the running sum, not reduced.
+     */
+    W _denominator;
+
+    static void check(bool fits)
+    {
+        if (!fits)
+            OverflowPolicy::overflow("Mw.Math.Rational: Overflow");
+    }
+
+    /**
+     * Product of two values of T, never overflows with a wider type.
+     */
+    static bool multiply(W a, W b, W & out)
+    {
+        if (detail::WideInteger<T>::EXISTS)
+        {
+            out = a * b;
+            return true;
+        }
+        return detail::checkedMultiply(a, b, out);
+    }
+
+    /**
+     * Reduce a fraction with a positive denominator.
+     */
+    static void reduce(W & numerator, W & denominator)
+    {
+        const U n = numerator < static_cast<W>(0) ? static_cast<U>(0) - static_cast<U>(numerator)
+                                                  : static_cast<U>(numerator);
+        const U g = binaryGcd(n, static_cast<U>(denominator));
+        if (g > static_cast<U>(1))
+        {
+            numerator /= static_cast<W>(g);
+            denominator /= static_cast<W>(g);
+        }
+    }
+
+    /**
+     * Add a term to the unreduced sum.
+     *
+     * @return @c false if an intermediate value would overflow, the sum is
+     *         then unchanged.
+     */
+    bool tryAdd(W numerator, W denominator, bool subtract)
+    {
+        W a, b, n, d;
+        if (denominator == _denominator)
+        {
+            a = _numerator;
+            b = numerator;
+            d = _denominator;
+        }
+        else if (!detail::checkedMultiply(_numerator, denominator, a)
+              || !detail::checkedMultiply(numerator, _denominator, b)
+              || !detail::checkedMultiply(_denominator, denominator, d))
+            return false;
+
+        if (!(subtract ? detail::checkedSubtract(a, b, n) : detail::checkedAdd(a, b, n)))
+            return false;
+
+        _numerator = n;
+        _denominator = d;
+        return true;
+    }
+
+    /**
+     * Add a term, reducing the sum first if it would overflow.
+     */
+    void add(W numerator, W denominator, bool subtract)
+    {
+        if (tryAdd(numerator, denominator, subtract))
+            return;
+
+        // Reduced, the sum and the term fit in T when Rational does not
+        // overflow, which leaves room for the next terms in W
+        reduce(_numerator, _denominator);
+        reduce(numerator, denominator);
+        if (tryAdd(numerator, denominator, subtract))
+            return;
+
+        // No wider type, one step of Rational
+        check(detail::fits<T>(_numerator) && detail::fits<T>(_denominator)
+              && detail::fits<T>(numerator) && detail::fits<T>(denominator));
+
+        T n, d;
+        check(Arithmetic::add(static_cast<T>(_numerator), static_cast<T>(_denominator),
+                              static_cast<T>(numerator), static_cast<T>(denominator), subtract, n, d));
+        _numerator = n;
+        _denominator = d;
+    }
+
+public:
+
+    // Constructors
+
+    /**
+     * Default constructor.
+     *
+     * The sum is initialized to 0.
+     */
+    RationalAccumulator()
+        : _numerator(0), _denominator(1)
+    {}
+
+    /**
+     * Constructor.
+     *
+     * @param value Initial sum.
+     */
+    explicit RationalAccumulator(const Value & value)
+        : _numerator(value.getNumerator()), _denominator(value.getDenominator())
+    {}
+
+
+    // Getters
+
+    /**
+     * Get the sum.
+     *
+     * The sum is reduced, as a Rational computed with the same operations.
+     *
+     * @return Reduced sum.
+     */
+    Value get() const
+    {
+        W n = _numerator, d = _denominator;
+        reduce(n, d);
+        check(detail::fits<T>(n) && detail::fits<T>(d));
+        return Value(static_cast<T>(n), static_cast<T>(d));
+    }
+
+    /**
+     * Reset the sum to 0.
+     */
+    void reset()
+    {
+        _numerator = 0;
+        _denominator = 1;
+    }
+
+
+    // Operations
+
+    RationalAccumulator & operator += (const Value & value)
+    {
+        add(value.getNumerator(), value.getDenominator(), false);
+        return *this;
+    }
+
+    RationalAccumulator & operator -= (const Value & value)
+    {
+        add(value.getNumerator(), value.getDenominator(), true);
+        return *this;
+    }
+
+    /**
+     * Add the product of two values.
+     *
+     * The product is not reduced either.
+     *
+     * @param a First value.
+     * @param b Second value.
+     */
+    void addProduct(const Value & a, const Value & b)
+    {
+        W n, d;
+        if (multiply(a.getNumerator(), b.getNumerator(), n) && multiply(a.getDenominator(), b.getDenominator(), d))
+            add(n, d, false);
+        else
+            *this += a * b;
+    }
+
+};
+// class RationalAccumulator
+
+
+/**
+ * Compute the sum of rational numbers.
+ *
+ * @param values First value.
+ * @param count Number of values.
+ * @return Sum of the values.
+ */
+template<typename T, class OverflowPolicy>
+Rational<T, OverflowPolicy> sum(const Rational<T, OverflowPolicy> * values, std::size_t count)
+{
+    RationalAccumulator<T, OverflowPolicy> accumulator;
+    for (std::size_t i = 0; i < count; ++i)
+        accumulator += values[i];
+    return accumulator.get();
+}
+
+/**
+ * Compute the dot product of arrays of rational numbers.
+ *
+ * @param a First value of the first array.
+ * @param b First value of the second array.
+ * @param count Number of values of each array.
+ * @return Sum of the products of the values.
+ */
+template<typename T, class OverflowPolicy>
+Rational<T, OverflowPolicy> dot(const Rational<T, OverflowPolicy> * a, const Rational<T, OverflowPolicy> * b,
+                                std::size_t count)
+{
+    RationalAccumulator<T, OverflowPolicy> accumulator;
+    for (std::size_t i = 0; i < count; ++i)
+        accumulator.addProduct(a[i], b[i]);
+    return accumulator.get();
+}
+
+/**
+ * Compute the dot product of 2 vectors of rational numbers.
+ *
+ * Same result as Vector::dot(), with deferred normalization.
+ *
+ * @param first First vector.
+ * @param second Second vector.
+ * @return Dot product.
+ */
+template<typename T, class OverflowPolicy, unsigned N>
+Rational<T, OverflowPolicy> dot(const Vector<Rational<T, OverflowPolicy>, N> & first,
+                                const Vector<Rational<T, OverflowPolicy>, N> & second)
+{
+    RationalAccumulator<T, OverflowPolicy> accumulator;
+    for (unsigned i = 0; i < N; ++i)
+        accumulator.addProduct(first[i], second[i]);
+    return accumulator.get();
+}
+
+MW_END_NAMESPACE(math)
+
+#endif // MW_RATIONALACCUMULATOR_HPP
@@ -0,0 +1,222 @@
+/**
+ * @file   Ray.hpp
+ * @author Bastien Brunnenstein
+ */
+
+#ifndef MW_RAY_HPP
+#define MW_RAY_HPP
+
+#include <Mw/Config.hpp>
+
+#include <Mw/Math/Bounds.hpp>
+#include <Mw/Math/Plane.hpp>
+#include <Mw/Math/Vector.hpp>
+
+#include <limits>
+
+MW_BEGIN_NAMESPACE(math)
+
+/**
+ * Half-line starting at an origin.
+ *
+ * The inverse of the direction is computed once, so the slab tests against
+ * Bounds only use multiplications. Null direction components get a
+ * positive infinite inverse: such a ray crosses a slab if its origin is
+ * inside it, boundaries included.
+ *
+ * Distances along the ray are given in @c direction units: the point at
+ * distance @c t is <tt>origin + direction * t</tt>. Maximum distances must
+ * be finite.
+ *
+ * @tparam T Scalar type.
+ * @tparam N Dimension (number of components).
+ */
+template<typename T, unsigned N>
+class Ray
+{
+    /**
+     * Starting point.
+     */
+    Vector<T, N> _origin;
+
+    /**
+     * Direction.
+     */
+    Vector<T, N> _direction;
+
+    /**
+     * Inverse of each component of the direction.
+     */
+    Vector<T, N> _invDirection;
+
+public:
+
+    // Constructors
+
+    /**
+     * Constructor.
+     *
+     * @param origin Starting point of the ray.
+     * @param direction Direction of the ray, need not be normalized.
+     */
+    Ray(const Vector<T, N> & origin, const Vector<T, N> & direction)
+    {
+        set(origin, direction);
+    }
+
+
+    // Getters / setters
+
+    /**
+     * Get the starting point of the ray.
+     *
+     * @return Origin.
+     */
+    const Vector<T, N> & getOrigin() const
+    {
+        return _origin;
+    }
+
+    /**
+     * Get the direction of the ray.
+     *
+     * @return Direction.
+     */
+    const Vector<T, N> & getDirection() const
+    {
+        return _direction;
+    }
+
+    /**
+     * Get the inverse of each component of the direction.
+     *
+     * @return Inverse direction.
+     */
+    const Vector<T, N> & getInverseDirection() const
+    {
+        return _invDirection;
+    }
+
+    /**
+     * Set the ray's values.
+     *
+     * @param origin Starting point of the ray.
+     * @param direction Direction of the ray, need not be normalized.
+     */
+    void set(const Vector<T, N> & origin, const Vector<T, N> & direction)
+    {
+        _origin = origin;
+        _direction = direction;
+
+        for (unsigned c = 0; c < N; ++c)
+            _invDirection[c] = inverse(direction[c]);
+    }
+
+    /**
+     * Get the point at a given distance along the ray.
+     *
+     * @param distance Distance, in @c direction units.
+     * @return The point.
+     */
+    Vector<T, N> getPoint(T distance) const
+    {
+        return _origin + _direction * distance;
+    }
+
+
+    // Intersections
+
+    /**
+     * Check if the ray crosses bounds before a given distance.
+     *
+     * @param bounds Bounds to check.
+     * @param maxDistance Length of the tested segment.
+     * @return @c true if the ray crosses the bounds.
+     */
+    template<class V>
+    bool isIntersecting(const Bounds<T, N, V> & bounds, T maxDistance = std::numeric_limits<T>::max()) const
+    {
+        T distance;
+        return intersect(bounds, maxDistance, distance);
+    }
+
+    /**
+     * Find where the ray enters bounds.
+     *
+     * @param bounds Bounds to check.
+     * @param maxDistance Length of the tested segment.
+     * @param distance Output, entry distance (0 if the origin is inside).
+     * @return @c true if the ray crosses the bounds.
+     */
+    template<class V>
+    bool intersect(const Bounds<T, N, V> & bounds, T maxDistance, T & distance) const
+    {
+        T tmin = static_cast<T>(0), tmax = maxDistance;
+
+        for (unsigned c = 0; c < N; ++c)
+            clipSlab(bounds.getLowerLimit().get(c), bounds.getUpperLimit().get(c),
+                     _origin[c], _invDirection[c], tmin, tmax);
+
+        distance = tmin;
+        return tmin <= tmax;
+    }
+
+    /**
+     * Find where the ray crosses a plane.
+     *
+     * A ray parallel to the plane never crosses it.
+     *
+     * @param plane Plane to check.
+     * @param maxDistance Length of the tested segment.
+     * @param distance Output, crossing distance.
+     * @return @c true if the ray crosses the plane.
+     */
+    bool intersect(const Plane<T, Vector<T, N> > & plane, T maxDistance, T & distance) const
+    {
+        const T speed = _direction.dot(plane.getNormal());
+        if (speed == static_cast<T>(0))
+            return false;
+
+        distance = plane.getSignedDistance(_origin) / - speed;
+        return distance >= static_cast<T>(0) && distance <= maxDistance;
+    }
+
+
+    /**
+     * Clip a distance interval to a slab.
+     *
+     * This is the reference test for the batch kernels: NaNs, from a null
+     * direction on a slab boundary, never shrink the interval.
+     *
+     * @param lower Lower limit of the slab.
+     * @param upper Upper limit of the slab.
+     * @param origin Origin of the ray.
+     * @param invDirection Inverse direction of the ray.
+     * @param tmin Start of the interval, updated.
+     * @param tmax End of the interval, updated.
+     */
+    static void clipSlab(T lower, T upper, T origin, T invDirection, T & tmin, T & tmax)
+    {
+        const T t0 = (lower - origin) * invDirection;
+        const T t1 = (upper - origin) * invDirection;
+        const T tnear = t1 < t0 ? t1 : t0;
+        const T tfar = t0 > t1 ? t0 : t1;
+        tmin = tnear > tmin ? tnear : tmin;
+        tmax = tfar < tmax ? tfar : tmax;
+    }
+
+    /**
+     * Inverse of a direction component, positive infinity for 0.
+     */
+    static T inverse(T component)
+    {
+        return component == static_cast<T>(0) ? std::numeric_limits<T>::infinity()
+                                              : static_cast<T>(1) / component;
+    }
+
+};
+// class Ray
+
+MW_END_NAMESPACE(math)
+
+#endif // MW_RAY_HPP
@@ -0,0 +1,324 @@
+/**
+ * @file   RayPacket.hpp
+ * @author Bastien Brunnenstein
+ */
+
+#ifndef MW_RAYPACKET_HPP
+#define MW_RAYPACKET_HPP
+
+#include <Mw/Config.hpp>
+
+#include <Mw/Math/Bounds.hpp>
+#include <Mw/Math/Plane.hpp>
+#include <Mw/Math/Ray.hpp>
+#include <Mw/Math/Simd.hpp>
+#include <Mw/Math/Vector.hpp>
+
+#include <stdexcept>
+
+#include <boost/static_assert.hpp>
+
+MW_BEGIN_NAMESPACE(math)
+
+namespace detail
+{
+
+/**
+ * Slab test of a packet of rays against one box.
+ *
+ * The generic kernel is a plain loop over the lanes. 4 and 8 float lanes
+ * get SSE and AVX kernels, with the same NaN handling as Ray::clipSlab.
+ *
+ * @tparam T Scalar type.
+ * @tparam N Dimension (number of components).
+ * @tparam W Number of rays.
+ */
+template<typename T, unsigned N, unsigned W>
+struct RaySlabKernel
+{
+    static unsigned intersect(const T (&origins)[N][W], const T (&invDirections)[N][W],
+                              const T * lower, const T * upper, const T * maxDistances, T * distances)
+    {
+        T tmin[W], tmax[W];
+        for (unsigned j = 0; j < W; ++j)
+        {
+            tmin[j] = static_cast<T>(0);
+            tmax[j] = maxDistances[j];
+        }
+
+        for (unsigned c = 0; c < N; ++c)
+            for (unsigned j = 0; j < W; ++j)
+                Ray<T, N>::clipSlab(lower[c], upper[c], origins[c][j], invDirections[c][j], tmin[j], tmax[j]);
+
+        unsigned mask = 0;
+        for (unsigned j = 0; j < W; ++j)
+        {
+            distances[j] = tmin[j];
+            mask |= static_cast<unsigned>(tmin[j] <= tmax[j]) << j;
+        }
+        return mask;
+    }
+};
+
+#ifdef MW_SIMD_SSE
+
+template<unsigned N>
+struct RaySlabKernel<float, N, 4>
+{
+    static unsigned intersect(const float (&origins)[N][4], const float (&invDirections)[N][4],
+                              const float * lower, const float * upper, const float * maxDistances, float * distances)
+    {
+        __m128 tmin = _mm_setzero_ps();
+        __m128 tmax = _mm_loadu_ps(maxDistances);
+
+        for (unsigned c = 0; c < N; ++c)
+        {
+            const __m128 o = _mm_loadu_ps(origins[c]);
+            const __m128 inv = _mm_loadu_ps(invDirections[c]);
+            const __m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(lower[c]), o), inv);
+            const __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(upper[c]), o), inv);
+
+            // minps / maxps return their second operand on NaN
+            tmin = _mm_max_ps(_mm_min_ps(t1, t0), tmin);
+            tmax = _mm_min_ps(_mm_max_ps(t0, t1), tmax);
+        }
+
+        _mm_storeu_ps(distances, tmin);
+        return static_cast<unsigned>(_mm_movemask_ps(_mm_cmple_ps(tmin, tmax)));
+    }
+};
+
+#endif // MW_SIMD_SSE
+
+#ifdef MW_SIMD_AVX
+
+template<unsigned N>
+struct RaySlabKernel<float, N, 8>
+{
+    static unsigned intersect(const float (&origins)[N][8], const float (&invDirections)[N][8],
+                              const float * lower, const float * upper, const float * maxDistances, float * distances)
+    {
+        __m256 tmin = _mm256_setzero_ps();
+        __m256 tmax = _mm256_loadu_ps(maxDistances);
+
+        for (unsigned c = 0; c < N; ++c)
+        {
+            const __m256 o = _mm256_loadu_ps(origins[c]);
+            const __m256 inv = _mm256_loadu_ps(invDirections[c]);
+            const __m256 t0 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(lower[c]), o), inv);
+            const __m256 t1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(upper[c]), o), inv);
+
+            tmin = _mm256_max_ps(_mm256_min_ps(t1, t0), tmin);
+            tmax = _mm256_min_ps(_mm256_max_ps(t0, t1), tmax);
+        }
+
+        _mm256_storeu_ps(distances, tmin);
+        return static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(tmin, tmax, _CMP_LE_OQ)));
+    }
+};
+
+#endif // MW_SIMD_AVX
+
+} // namespace detail
+
+
+/**
+ * Packet of rays tested together.
+ *
+ * Rays are stored as a structure of arrays, one lane per ray, so a box or
+ * a plane is tested against all the rays at once. The tests give the same
+ * results as the Ray functions.
+ *
+ * Results are given as lane masks: bit @c j is set when ray @c j matches.
+ *
+ * @tparam T Scalar type.
+ * @tparam N Dimension (number of components).
+ * @tparam W Number of rays (4 or 8 for the SIMD kernels).
+ */
+template<typename T, unsigned N, unsigned W = 4>
+class RayPacket
+{
+    BOOST_STATIC_ASSERT_MSG(W > 0 && W <= 32, "Mw.Math.RayPacket: width must be between 1 and 32");
+
+public:
+
+    /**
+     * Number of rays.
+     */
+    static const unsigned WIDTH = W;
+
+private:
+
+    T _origins[N][W];
+    T _directions[N][W];
+    T _invDirections[N][W];
+
+public:
+
+    // Constructors
+
+    /**
+     * Default constructor.
+     *
+     * Every ray starts at the origin, with a null direction.
+     */
+    RayPacket()
+    {
+        for (unsigned c = 0; c < N; ++c)
+            for (unsigned j = 0; j < W; ++j)
+            {
+                _origins[c][j] = static_cast<T>(0);
+                _directions[c][j] = static_cast<T>(0);
+                _invDirections[c][j] = Ray<T, N>::inverse(static_cast<T>(0));
+            }
+    }
+
+
+    // Getters / setters
+
+    /**
+     * Get a ray.
+     *
+     * @param lane Lane of the ray.
+     * @return The ray.
+     * @throw std::out_of_range if @c lane is not lower than @c W.
+     */
+    Ray<T, N> get(unsigned lane) const
+    {
+        if (lane >= W)
+            throw std::out_of_range("Mw.Math.RayPacket: Lane out of range");
+
+        Vector<T, N> origin, direction;
+        for (unsigned c = 0; c < N; ++c)
+        {
+            origin[c] = _origins[c][lane];
+            direction[c] = _directions[c][lane];
+        }
+        return Ray<T, N>(origin, direction);
+    }
+
+    /**
+     * Set a ray.
+     *
+     * @param lane Lane of the ray.
+     * @param ray The ray.
+     * @throw std::out_of_range if @c lane is not lower than @c W.
+     */
+    void set(unsigned lane, const Ray<T, N> & ray)
+    {
+        if (lane >= W)
+            throw std::out_of_range("Mw.Math.RayPacket: Lane out of range");
+
+        for (unsigned c = 0; c < N; ++c)
+        {
+            _origins[c][lane] = ray.getOrigin()[c];
+            _directions[c][lane] = ray.getDirection()[c];
+            _invDirections[c][lane] = ray.getInverseDirection()[c];
+        }
+    }
+
+    /**
+     * Check if the rays go the same way.
+     *
+     * Rays of a coherent packet have the same direction signs, and tend to
+     * visit the same nodes of a hierarchy.
+     *
+     * @return @c true if the packet is coherent.
+     */
+    bool isCoherent() const
+    {
+        for (unsigned c = 0; c < N; ++c)
+        {
+            const bool negative = _invDirections[c][0] < static_cast<T>(0);
+            for (unsigned j = 1; j < W; ++j)
+                if ((_invDirections[c][j] < static_cast<T>(0)) != negative)
+                    return false;
+        }
+        return true;
+    }
+
+
+    // Intersections
+
+    /**
+     * Find where the rays enter bounds.
+     *
+     * @param bounds Bounds to check.
+     * @param maxDistances Length of the tested segment of each ray.
+     * @param distances Output, entry distance of each ray.
+     * @return Mask of the rays crossing the bounds.
+     * @see Ray::intersect
+     */
+    template<class V>
+    unsigned intersect(const Bounds<T, N, V> & bounds, const T * maxDistances, T * distances) const
+    {
+        T lower[N], upper[N];
+        for (unsigned c = 0; c < N; ++c)
+        {
+            lower[c] = bounds.getLowerLimit().get(c);
+            upper[c] = bounds.getUpperLimit().get(c);
+        }
+        return intersect(lower, upper, maxDistances, distances);
+    }
+
+    /**
+     * Find where the rays enter a box given by its limits.
+     *
+     * @param lower Lower limits of the box.
+     * @param upper Upper limits of the box.
+     * @param maxDistances Length of the tested segment of each ray.
+     * @param distances Output, entry distance of each ray.
+     * @return Mask of the rays crossing the box.
+     */
+    unsigned intersect(const T * lower, const T * upper, const T * maxDistances, T * distances) const
+    {
+        return detail::RaySlabKernel<T, N, W>::intersect(_origins, _invDirections,
+                                                         lower, upper, maxDistances, distances);
+    }
+
+    /**
+     * Find where the rays cross a plane.
+     *
+     * @param plane Plane to check.
+     * @param maxDistances Length of the tested segment of each ray.
+     * @param distances Output, crossing distance of each ray.
+     * @return Mask of the rays crossing the plane.
+     * @see Ray::intersect
+     */
+    unsigned intersect(const Plane<T, Vector<T, N> > & plane, const T * maxDistances, T * distances) const
+    {
+        T speed[W], height[W];
+        for (unsigned j = 0; j < W; ++j)
+        {
+            speed[j] = static_cast<T>(0);
+            height[j] = static_cast<T>(0);
+        }
+
+        for (unsigned c = 0; c < N; ++c)
+        {
+            const T n = plane.getNormal()[c];
+            for (unsigned j = 0; j < W; ++j)
+            {
+                speed[j] += _directions[c][j] * n;
+                height[j] += _origins[c][j] * n;
+            }
+        }
+
+        unsigned mask = 0;
+        for (unsigned j = 0; j < W; ++j)
+        {
+            // Parallel rays give an infinite or NaN distance, and no hit
+            distances[j] = (height[j] - plane.getDistanceFromOrigin()) / - speed[j];
+            mask |= static_cast<unsigned>((speed[j] != static_cast<T>(0))
+                                          & (distances[j] >= static_cast<T>(0))
+                                          & (distances[j] <= maxDistances[j])) << j;
+        }
+        return mask;
+    }
+
+};
+// class RayPacket
+
+MW_END_NAMESPACE(math)
+
+#endif // MW_RAYPACKET_HPP
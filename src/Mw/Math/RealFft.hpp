@@ -0,0 +1,353 @@
+/**
+ * @file   RealFft.hpp
+ * @author Bastien Brunnenstein
+ *
+ * @details Fast Fourier transforms of real signals.
+ *
+ * The spectrum of a real signal is hermitian, <tt>X[N - k] = conj(X[k])</tt>,
+ * so only its first <tt>N / 2 + 1</tt> values are computed. Signals of even
+ * size are packed in a complex signal of half the size: the even samples
+ * as real parts, the odd samples as imaginary parts. One complex FFT of
+ * size <tt>N / 2</tt> and a linear pass then give the half spectrum.
+ * Signals of odd size use a complex FFT of size @c N.
+ */
+
+#ifndef MW_REALFFT_HPP
+#define MW_REALFFT_HPP
+
+#include <Mw/Config.hpp>
+
+#include <Mw/Math/Complex.hpp>
+#include <Mw/Math/ComplexArray.hpp>
+#include <Mw/Math/Fft.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+MW_BEGIN_NAMESPACE(math)
+
+/**
+ * Precomputed FFT of real signals of a given size.
+ *
+ * Spectra are the <tt>N / 2 + 1</tt> first values of the transform, given
+ * as split real and imaginary lanes or as Complex. The imaginary parts of
+ * the first value, and of the last one for even sizes, are ignored by the
+ * inverse transform.
+ *
+ * @tparam T Scalar type.
+ */
+template<typename T>
+class RealFftPlan : boost::noncopyable
+{
+public:
+
+    /**
+     * Aligned storage of a lane.
+     */
+    typedef typename ComplexArray<T>::Lane Lane;
+
+private:
+
+    std::size_t _size;
+
+    /**
+     * Complex transform, of half the size for even sizes.
+     */
+    boost::shared_ptr<const FftPlan<T> > _plan;
+
+    /**
+     * Roots <tt>exp(-2 pi i k / N)</tt> for <tt>k <= N / 2</tt>, even sizes only.
+     */
+    Lane _twiddleRe, _twiddleIm;
+
+public:
+
+    // Constructors
+
+    /**
+     * Constructor.
+     *
+     * @param size Number of samples of the signals.
+     * @throw std::invalid_argument if @c size is 0.
+     */
+    explicit RealFftPlan(std::size_t size)
+        : _size(size)
+    {
+        if (size == 0)
+            throw std::invalid_argument("Mw.Math.RealFftPlan: Size must not be 0");
+
+        if (size % 2)
+        {
+            _plan = FftPlan<T>::get(size);
+            return;
+        }
+
+        const std::size_t half = size / 2;
+        _plan = FftPlan<T>::get(half);
+
+        _twiddleRe.resize(half + 1);
+        _twiddleIm.resize(half + 1);
+        for (std::size_t k = 0; k <= half; ++k)
+        {
+            const double angle = -2.0 * M_PI * static_cast<double>(k) / static_cast<double>(size);
+            _twiddleRe[k] = static_cast<T>(std::cos(angle));
+            _twiddleIm[k] = static_cast<T>(std::sin(angle));
+        }
+    }
+
+    /**
+     * Get a shared plan.
+     *
+     * Plans are built on first use and kept for the lifetime of the program.
+     *
+     * @param size Number of samples of the signals.
+     * @return Plan for @c size.
+     * @throw std::invalid_argument if @c size is 0.
+     */
+    static boost::shared_ptr<const RealFftPlan> get(std::size_t size)
+    {
+        return detail::getCachedFftPlan<RealFftPlan>(size);
+    }
+
+
+    // Getters
+
+    /**
+     * Get the number of samples of the signals.
+     *
+     * @return Size.
+     */
+    std::size_t size() const
+    {
+        return _size;
+    }
+
+    /**
+     * Get the number of values of the spectra.
+     *
+     * @return <tt>N / 2 + 1</tt>.
+     */
+    std::size_t getSpectrumSize() const
+    {
+        return _size / 2 + 1;
+    }
+
+    /**
+     * Get the size of the work lanes of transform() and inverseTransform().
+     *
+     * @return Number of values of each work lane.
+     */
+    std::size_t getWorkSize() const
+    {
+        return _plan->size() + _plan->getWorkSize();
+    }
+
+
+    // Transforms
+
+    /**
+     * Compute the forward transform of a signal, with caller provided work
+     * memory.
+     *
+     * @param in Signal.
+     * @param outRe Real parts of the spectrum.
+     * @param outIm Imaginary parts of the spectrum.
+     * @param workRe Work lane of getWorkSize() values.
+     * @param workIm Work lane of getWorkSize() values.
+     */
+    void transform(const T * in, T * outRe, T * outIm, T * workRe, T * workIm) const
+    {
+        const std::size_t count = _plan->size();
+        T * subRe = workRe + count;
+        T * subIm = workIm + count;
+
+        if (_size % 2)
+        {
+            std::copy(in, in + _size, workRe);
+            std::fill(workIm, workIm + _size, static_cast<T>(0));
+            _plan->transform(workRe, workIm, workRe, workIm, subRe, subIm, false);
+
+            std::copy(workRe, workRe + getSpectrumSize(), outRe);
+            std::copy(workIm, workIm + getSpectrumSize(), outIm);
+            return;
+        }
+
+        for (std::size_t n = 0; n < count; ++n)
+        {
+            workRe[n] = in[2 * n];
+            workIm[n] = in[2 * n + 1];
+        }
+        _plan->transform(workRe, workIm, workRe, workIm, subRe, subIm, false);
+
+        // With z = Z[k] and c = conj(Z[N/2 - k]), the transforms of the even
+        // and odd samples are e = (z + c) / 2 and o = -i (z - c) / 2, and
+        // X[k] = e + w^k o
+        const T half = static_cast<T>(0.5);
+        for (std::size_t k = 0; k <= count; ++k)
+        {
+            const std::size_t j = k == count ? 0 : k;
+            const std::size_t l = k == 0 ? 0 : count - k;
+
+            const T zr = workRe[j], zi = workIm[j];
+            const T cr = workRe[l], ci = - workIm[l];
+
+            const T evenRe = (zr + cr) * half, evenIm = (zi + ci) * half;
+            const T oddRe = (zi - ci) * half, oddIm = (cr - zr) * half;
+
+            const T wr = _twiddleRe[k], wi = _twiddleIm[k];
+            outRe[k] = evenRe + (wr * oddRe - wi * oddIm);
+            outIm[k] = evenIm + (wr * oddIm + wi * oddRe);
+        }
+    }
+
+    /**
+     * Compute the inverse transform of a spectrum, with caller provided work
+     * memory.
+     *
+     * @param inRe Real parts of the spectrum.
+     * @param inIm Imaginary parts of the spectrum.
+     * @param out Signal, without the @c 1/N scale.
+     * @param workRe Work lane of getWorkSize() values.
+     * @param workIm Work lane of getWorkSize() values.
+     */
+    void inverseTransform(const T * inRe, const T * inIm, T * out, T * workRe, T * workIm) const
+    {
+        const std::size_t count = _plan->size();
+        T * subRe = workRe + count;
+        T * subIm = workIm + count;
+
+        if (_size % 2)
+        {
+            const std::size_t spectrum = getSpectrumSize();
+            workRe[0] = inRe[0];
+            workIm[0] = static_cast<T>(0);
+            for (std::size_t k = 1; k < spectrum; ++k)
+            {
+                workRe[k] = workRe[_size - k] = inRe[k];
+                workIm[k] = inIm[k];
+                workIm[_size - k] = - inIm[k];
+            }
+            _plan->transform(workRe, workIm, workRe, workIm, subRe, subIm, true);
+
+            std::copy(workRe, workRe + _size, out);
+            return;
+        }
+
+        // Z[k] = e + i o, with e = X[k] + c and o = conj(w^k) (X[k] - c)
+        // for c = conj(X[N/2 - k]), twice the values of the forward pass
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            const T xr = inRe[k], xi = k == 0 ? static_cast<T>(0) : inIm[k];
+            const T cr = inRe[count - k], ci = k == 0 ? static_cast<T>(0) : - inIm[count - k];
+
+            const T evenRe = xr + cr, evenIm = xi + ci;
+            const T dr = xr - cr, di = xi - ci;
+
+            const T wr = _twiddleRe[k], wi = - _twiddleIm[k];
+            const T oddRe = wr * dr - wi * di, oddIm = wr * di + wi * dr;
+
+            workRe[k] = evenRe - oddIm;
+            workIm[k] = evenIm + oddRe;
+        }
+        _plan->transform(workRe, workIm, workRe, workIm, subRe, subIm, true);
+
+        for (std::size_t n = 0; n < count; ++n)
+        {
+            out[2 * n] = workRe[n];
+            out[2 * n + 1] = workIm[n];
+        }
+    }
+
+    /**
+     * Compute the spectrum of a signal.
+     *
+     * @param in Signal.
+     * @param outRe Real parts of the spectrum.
+     * @param outIm Imaginary parts of the spectrum.
+     */
+    void forward(const T * in, T * outRe, T * outIm) const
+    {
+        Lane workRe(getWorkSize()), workIm(getWorkSize());
+        transform(in, outRe, outIm, &workRe[0], &workIm[0]);
+    }
+
+    /**
+     * Compute the spectrum of a signal.
+     *
+     * @param in Signal.
+     * @param out Spectrum, resized to getSpectrumSize().
+     */
+    void forward(const T * in, ComplexArray<T> & out) const
+    {
+        out.resize(getSpectrumSize());
+        forward(in, out.realLane(), out.imaginaryLane());
+    }
+
+    /**
+     * Compute the spectrum of a signal.
+     *
+     * @param in Signal.
+     * @param out First of the getSpectrumSize() values of the spectrum.
+     */
+    void forward(const T * in, Complex<T> * out) const
+    {
+        ComplexArray<T> array;
+        forward(in, array);
+        array.copyTo(out);
+    }
+
+    /**
+     * Compute the signal of a spectrum.
+     *
+     * @param inRe Real parts of the spectrum.
+     * @param inIm Imaginary parts of the spectrum.
+     * @param out Signal.
+     */
+    void inverse(const T * inRe, const T * inIm, T * out) const
+    {
+        Lane workRe(getWorkSize()), workIm(getWorkSize());
+        inverseTransform(inRe, inIm, out, &workRe[0], &workIm[0]);
+
+        const T factor = static_cast<T>(1) / static_cast<T>(_size);
+        for (std::size_t n = 0; n < _size; ++n)
+            out[n] *= factor;
+    }
+
+    /**
+     * Compute the signal of a spectrum.
+     *
+     * @param in Spectrum.
+     * @param out Signal.
+     * @throw std::invalid_argument if the size of @c in is not
+     *        getSpectrumSize().
+     */
+    void inverse(const ComplexArray<T> & in, T * out) const
+    {
+        if (in.size() != getSpectrumSize())
+            throw std::invalid_argument("Mw.Math.RealFftPlan: Invalid spectrum size");
+
+        inverse(in.realLane(), in.imaginaryLane(), out);
+    }
+
+    /**
+     * Compute the signal of a spectrum.
+     *
+     * @param in First of the getSpectrumSize() values of the spectrum.
+     * @param out Signal.
+     */
+    void inverse(const Complex<T> * in, T * out) const
+    {
+        inverse(ComplexArray<T>(in, in + getSpectrumSize()), out);
+    }
+
+};
+// class RealFftPlan
+
+MW_END_NAMESPACE(math)
+
+#endif // MW_REALFFT_HPP
@@ -0,0 +1,76 @@
+/**
+ * @file   Simd.hpp
+ * @author Bastien Brunnenstein
+ *
+ * @details SIMD instruction sets detection.
+ *
+ * The instruction sets are selected at compile time from the compiler's
+ * target flags (e.g. -msse2, -mavx, /arch:AVX).
+ * Define @c MW_NO_SIMD to force the portable scalar code paths.
+ */
+
+#ifndef MW_SIMD_HPP
+#define MW_SIMD_HPP
+
+#include <Mw/Config.hpp>
+
+#include <boost/config.hpp>
+
+/**
+ * @def MW_SIMD_SSE
+ * Defined when SSE instructions are available.
+ */
+/**
+ * @def MW_SIMD_SSE2
+ * Defined when SSE2 instructions are available.
+ */
+/**
+ * @def MW_SIMD_AVX
+ * Defined when AVX instructions are available.
+ */
+
+#ifndef MW_NO_SIMD
+#   if defined __SSE__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 1)
+#       define MW_SIMD_SSE
+#   endif
+#   if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#       define MW_SIMD_SSE2
+#   endif
+#   if defined __AVX__
+#       define MW_SIMD_AVX
+#   endif
+#endif
+
+#ifdef MW_SIMD_SSE
+#   include <xmmintrin.h>
+#endif
+#ifdef MW_SIMD_SSE2
+#   include <emmintrin.h>
+#endif
+#ifdef MW_SIMD_AVX
+#   include <immintrin.h>
+#endif
+
+/**
+ * @def MW_SIMD_ALIGNMENT
+ * Alignment, in bytes, of the widest available SIMD register.
+ */
+
+#ifdef MW_SIMD_AVX
+#   define MW_SIMD_ALIGNMENT 32
+#else
+#   define MW_SIMD_ALIGNMENT 16
+#endif
+
+/**
+ * @def MW_RESTRICT
+ * Pointer aliasing hint, used by the batch kernels.
+ */
+
+#if defined __GNUC__ || defined _MSC_VER
+#   define MW_RESTRICT __restrict
+#else
+#   define MW_RESTRICT
+#endif
+
+#endif // MW_SIMD_HPP
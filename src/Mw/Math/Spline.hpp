@@ -0,0 +1,402 @@
+/**
+ * @file   Spline.hpp
+ * @author Bastien Brunnenstein
+ *
+ * @details Curves through control points, with the polynomial of each
+ * segment precomputed.
+ *
+ * A curve through @c n points has <tt>n - 1</tt> segments, the parameter
+ * @c t goes from 0 to <tt>n - 1</tt> and the integer part of @c t is the
+ * segment. The first and last points are repeated to build the first and
+ * last segments, as the resample functions of Interpolation.hpp do.
+ *
+ * An arc length table, sampled at a fixed number of points per segment,
+ * maps distances along the curve to parameters for constant speed motion.
+ */
+
+#ifndef MW_SPLINE_HPP
+#define MW_SPLINE_HPP
+
+#include <Mw/Config.hpp>
+
+#include <Mw/Math/Simd.hpp>
+#include <Mw/Math/Vector.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/align/aligned_allocator.hpp>
+#include <boost/assert.hpp>
+
+MW_BEGIN_NAMESPACE(math)
+
+/**
+ * Polynomial through the control points.
+ */
+enum SplineType
+{
+    /**
+     * Catmull-rom, as catmullRomInterpolate().
+     */
+    SPLINE_CATMULL_ROM,
+
+    /**
+     * Cubic, as cubicInterpolate().
+     */
+    SPLINE_CUBIC
+};
+
+namespace detail
+{
+
+/**
+ * Scalar type of a curve's points, and distance between two points.
+ */
+template<class T>
+struct SplinePoint
+{
+    typedef T Scalar;
+
+    static Scalar distance(const T & a, const T & b)
+    {
+        return std::abs(a - b);
+    }
+};
+
+template<typename T, unsigned N>
+struct SplinePoint< Vector<T, N> >
+{
+    typedef T Scalar;
+
+    static Scalar distance(const Vector<T, N> & a, const Vector<T, N> & b)
+    {
+        return Vector<T, N>(a - b).getLength();
+    }
+};
+
+/**
+ * Polynomial of a curve segment, <tt>((c3 mu + c2) mu + c1) mu + c0</tt>.
+ */
+template<class T>
+struct CubicSegment
+{
+    T c3, c2, c1, c0;
+
+    template<typename U>
+    CubicSegment(const T & p0, const T & p1, const T & p2, const T & p3, SplineType type, U)
+    {
+        if (type == SPLINE_CUBIC)
+        {
+            c3 = p3 - p2 - p0 + p1;
+            c2 = p0 - p1 - c3;
+            c1 = p2 - p0;
+            c0 = p1;
+        }
+        else
+        {
+            const U half = static_cast<U>(0.5);
+            c3 = (p3 - p0 + (p1 - p2) * static_cast<U>(3)) * half;
+            c2 = (p0 * static_cast<U>(2) + p2 * static_cast<U>(4) - p1 * static_cast<U>(5) - p3) * half;
+            c1 = (p2 - p0) * half;
+            c0 = p1;
+        }
+    }
+
+    template<typename U>
+    T evaluate(U mu) const
+    {
+        return ((c3 * mu + c2) * mu + c1) * mu + c0;
+    }
+};
+
+} // namespace detail
+
+
+/**
+ * Curve through control points.
+ *
+ * @tparam T Points' type, a scalar or a Vector.
+ * @tparam U Parameter's type, the scalar type of @a T by default.
+ */
+template<class T, typename U = typename detail::SplinePoint<T>::Scalar>
+class Spline
+{
+public:
+
+    /**
+     * Polynomial of a segment, <tt>((c3 mu + c2) mu + c1) mu + c0</tt>.
+     */
+    typedef detail::CubicSegment<T> Segment;
+
+    typedef std::vector<Segment, boost::alignment::aligned_allocator<Segment, MW_SIMD_ALIGNMENT> > SegmentArray;
+
+private:
+
+    SegmentArray _segments;
+
+    /**
+     * Arc length at the parameters <tt>i / _resolution</tt>.
+     */
+    std::vector<U> _lengths;
+
+    unsigned _resolution;
+
+    SplineType _type;
+
+public:
+
+    // Constructors
+
+    /**
+     * Constructor.
+     *
+     * @param points Control points.
+     * @param count Number of points.
+     * @param type Polynomial through the points.
+     * @param resolution Number of arc length samples per segment.
+     * @throw std::invalid_argument if there are less than 2 points, or if
+     *        @a resolution is 0.
+     */
+    Spline(const T * points, std::size_t count, SplineType type = SPLINE_CATMULL_ROM, unsigned resolution = 16)
+        : _resolution(resolution), _type(type)
+    {
+        if (count < 2)
+            throw std::invalid_argument("Mw.Math.Spline: At least 2 points are required");
+        if (resolution == 0)
+            throw std::invalid_argument("Mw.Math.Spline: Resolution must be positive");
+
+        _segments.reserve(count - 1);
+        for (std::size_t i = 0; i + 1 < count; ++i)
+        {
+            const T & p0 = points[i > 0 ? i - 1 : 0];
+            const T & p3 = points[i + 2 < count ? i + 2 : count - 1];
+            _segments.push_back(Segment(p0, points[i], points[i + 1], p3, type, static_cast<U>(0)));
+        }
+
+        buildLengths();
+    }
+
+
+    // Getters
+
+    SplineType getType() const
+    {
+        return _type;
+    }
+
+    /**
+     * Get the polynomials of the segments.
+     */
+    const SegmentArray & getSegments() const
+    {
+        return _segments;
+    }
+
+    /**
+     * Get the end of the parameter range.
+     *
+     * @return Number of segments.
+     */
+    U getEnd() const
+    {
+        return static_cast<U>(_segments.size());
+    }
+
+    /**
+     * Get the length of the curve, from the arc length table.
+     */
+    U getLength() const
+    {
+        return _lengths.back();
+    }
+
+
+    // Evaluation
+
+    /**
+     * Compute a point of the curve.
+     *
+     * @param t Parameter, clamped to the curve.
+     */
+    T evaluate(U t) const
+    {
+        std::size_t segment;
+        const U mu = locate(t, segment);
+        return _segments[segment].evaluate(mu);
+    }
+
+    /**
+     * Compute points of the curve.
+     *
+     * @param t Parameters, clamped to the curve.
+     * @param out Points.
+     * @param count Number of points.
+     */
+    void evaluate(const U * t, T * out, std::size_t count) const
+    {
+        for (std::size_t i = 0; i < count; ++i)
+            out[i] = evaluate(t[i]);
+    }
+
+    /**
+     * Get the parameter at a distance along the curve.
+     *
+     * The arc length table is searched by bisection, and interpolated
+     * linearly between its samples.
+     *
+     * @param distance Distance from the start, clamped to the curve.
+     */
+    U getParameter(U distance) const
+    {
+        return parameterFrom(findSample(distance), distance);
+    }
+
+    /**
+     * Compute the point at a distance along the curve.
+     *
+     * @param distance Distance from the start, clamped to the curve.
+     */
+    T evaluateAt(U distance) const
+    {
+        return evaluate(getParameter(distance));
+    }
+
+    /**
+     * Compute the points at distances along the curve.
+     *
+     * Increasing distances are found by walking the arc length table from
+     * the previous one, other distances by bisection.
+     *
+     * @param distances Distances from the start, clamped to the curve.
+     * @param out Points.
+     * @param count Number of points.
+     */
+    void evaluateAt(const U * distances, T * out, std::size_t count) const
+    {
+        const std::size_t last = _lengths.size() - 1;
+
+        std::size_t cursor = 0;
+        U previous = static_cast<U>(0);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const U distance = distances[i];
+            if (distance < previous)
+                cursor = findSample(distance);
+            else
+            {
+                while (cursor < last && _lengths[cursor + 1] <= distance)
+                    ++cursor;
+            }
+
+            out[i] = evaluate(parameterFrom(cursor, distance));
+            previous = distance;
+        }
+    }
+
+    /**
+     * Compute evenly spaced points along the curve, from the start to the
+     * end.
+     *
+     * @param out Points.
+     * @param count Number of points, at least 2.
+     */
+    void sample(T * out, std::size_t count) const
+    {
+        BOOST_ASSERT(count >= 2);
+
+        const std::size_t last = _lengths.size() - 1;
+        const U step = getLength() / static_cast<U>(count - 1);
+
+        std::size_t cursor = 0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const U distance = step * static_cast<U>(i);
+            while (cursor < last && _lengths[cursor + 1] <= distance)
+                ++cursor;
+            out[i] = evaluate(parameterFrom(cursor, distance));
+        }
+    }
+
+private:
+
+    /**
+     * Find the segment of a parameter.
+     *
+     * @return Position in the segment.
+     */
+    U locate(U t, std::size_t & segment) const
+    {
+        const std::size_t last = _segments.size() - 1;
+        if (!(t > static_cast<U>(0)))
+        {
+            segment = 0;
+            return static_cast<U>(0);
+        }
+
+        segment = static_cast<std::size_t>(t);
+        if (segment > last)
+        {
+            segment = last;
+            return static_cast<U>(1);
+        }
+        return t - static_cast<U>(segment);
+    }
+
+    /**
+     * Find the last arc length sample before a distance, by bisection.
+     */
+    std::size_t findSample(U distance) const
+    {
+        const std::size_t sample = static_cast<std::size_t>(
+            std::upper_bound(_lengths.begin(), _lengths.end(), distance) - _lengths.begin());
+        return sample > 0 ? sample - 1 : 0;
+    }
+
+    /**
+     * Interpolate the parameter of a distance after an arc length sample.
+     */
+    U parameterFrom(std::size_t sample, U distance) const
+    {
+        const std::size_t last = _lengths.size() - 1;
+        const U step = static_cast<U>(1) / static_cast<U>(_resolution);
+
+        if (sample >= last)
+            return getEnd();
+        if (!(distance > _lengths[sample]))
+            return static_cast<U>(sample) * step;
+
+        const U span = _lengths[sample + 1] - _lengths[sample];
+        U fraction = span > static_cast<U>(0) ? (distance - _lengths[sample]) / span : static_cast<U>(0);
+        fraction = fraction < static_cast<U>(1) ? fraction : static_cast<U>(1);
+        return (static_cast<U>(sample) + fraction) * step;
+    }
+
+    void buildLengths()
+    {
+        _lengths.reserve(_segments.size() * _resolution + 1);
+        _lengths.push_back(static_cast<U>(0));
+
+        const U step = static_cast<U>(1) / static_cast<U>(_resolution);
+        U length = static_cast<U>(0);
+        for (std::size_t i = 0; i < _segments.size(); ++i)
+        {
+            T previous = _segments[i].c0;
+            for (unsigned j = 1; j <= _resolution; ++j)
+            {
+                const T point = _segments[i].evaluate(static_cast<U>(j) * step);
+                length += detail::SplinePoint<T>::distance(point, previous);
+                _lengths.push_back(length);
+                previous = point;
+            }
+        }
+    }
+
+};
+// class Spline
+
+MW_END_NAMESPACE(math)
+
+#endif // MW_SPLINE_HPP
@@ -0,0 +1,385 @@
+/**
+ * @file   Timebase.hpp
+ * @author Bastien Brunnenstein
+ *
+ * @details Conversion of timestamps between timebases.
+ *
+ * A timebase is the duration of a tick as a Rational, 1/90000 of a second
+ * for example. A timestamp @c t in the timebase @c from is
+ * <tt>t * from / to</tt> in the timebase @c to. TimebaseRescaler reduces
+ * the ratio <tt>from / to</tt> once, then each conversion is a 64x64 bits
+ * product and the division of the 128 bits result by an invariant divisor,
+ * done with a precomputed reciprocal (Moller and Granlund, "Improved
+ * division by invariant integers"). There is no gcd nor division per
+ * timestamp, and results are the exact quotients, rounded as requested.
+ */
+
+#ifndef MW_TIMEBASE_HPP
+#define MW_TIMEBASE_HPP
+
+#include <Mw/Config.hpp>
+
+#include <Mw/Math/Bits.hpp>
+#include <Mw/Math/Overflow.hpp>
+#include <Mw/Math/Rational.hpp>
+
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+
+#include <boost/cstdint.hpp>
+
+MW_BEGIN_NAMESPACE(math)
+
+/**
+ * Rounding of inexact quotients.
+ */
+enum RoundingMode
+{
+    /**
+     * Toward zero, as integer division.
+     */
+    ROUND_TOWARD_ZERO,
+
+    /**
+     * Away from zero.
+     */
+    ROUND_AWAY_FROM_ZERO,
+
+    /**
+     * Toward negative infinity.
+     */
+    ROUND_DOWN,
+
+    /**
+     * Toward positive infinity.
+     */
+    ROUND_UP,
+
+    /**
+     * To the nearest integer, halfway values away from zero.
+     */
+    ROUND_NEAREST
+};
+
+namespace detail
+{
+
+/**
+ * Division of a 128 bits value by an invariant 64 bits divisor.
+ */
+struct InvariantDivisor
+{
+    /**
+     * Divisor shifted so that its highest bit is set.
+     */
+    boost::uint64_t normalized;
+
+    /**
+     * <tt>floor((2^128 - 1) / normalized) - 2^64</tt>.
+     */
+    boost::uint64_t reciprocal;
+
+    unsigned shift;
+
+    explicit InvariantDivisor(boost::uint64_t divisor)
+    {
+        BOOST_ASSERT(divisor);
+
+        shift = countLeadingZeros(divisor);
+        normalized = divisor << shift;
+
+        // (2^128 - 1) - 2^64 normalized = (2^64 - 1 - normalized) 2^64 + 2^64 - 1
+        const boost::uint64_t high = ~normalized, low = ~static_cast<boost::uint64_t>(0);
+#ifdef MW_HAS_INT128
+        reciprocal = static_cast<boost::uint64_t>(((static_cast<uint128_t>(high) << 64) | low) / normalized);
+#else
+        // Once per divisor, bit by bit
+        boost::uint64_t remainder = high, quotient = 0;
+        for (int i = 63; i >= 0; --i)
+        {
+            const bool carry = (remainder >> 63) != 0;
+            remainder = (remainder << 1) | ((low >> i) & 1);
+            quotient <<= 1;
+            if (carry || remainder >= normalized)
+            {
+                remainder -= normalized;
+                quotient |= 1;
+            }
+        }
+        reciprocal = quotient;
+#endif
+    }
+
+    /**
+     * Divide <tt>high 2^64 + low</tt> by the normalized divisor, with
+     * <tt>high < normalized</tt>.
+     */
+    boost::uint64_t divideNormalized(boost::uint64_t high, boost::uint64_t low, boost::uint64_t & remainder) const
+    {
+        boost::uint64_t qh;
+        boost::uint64_t ql = multiplyWide(reciprocal, high, qh);
+
+        // (qh, ql) += (high + 1, low)
+        ql += low;
+        qh += high + 1 + (ql < low ? 1 : 0);
+
+        // Unpredictable, corrected without a branch
+        boost::uint64_t r = low - qh * normalized;
+        const boost::uint64_t mask = static_cast<boost::uint64_t>(0) - (r > ql ? 1 : 0);
+        qh += mask;
+        r += mask & normalized;
+
+        // Rare
+        if (r >= normalized)
+        {
+            ++qh;
+            r -= normalized;
+        }
+        remainder = r;
+        return qh;
+    }
+
+    /**
+     * Divide <tt>high 2^64 + low</tt> by the divisor.
+     *
+     * @return Low 64 bits of the quotient.
+     */
+    boost::uint64_t divide(boost::uint64_t high, boost::uint64_t low,
+                           boost::uint64_t & quotientHigh, boost::uint64_t & remainder) const
+    {
+        // Shifted as the divisor, in 3 words
+        const boost::uint64_t n2 = shift ? high >> (64 - shift) : 0;
+        const boost::uint64_t n1 = shift ? (high << shift) | (low >> (64 - shift)) : high;
+        const boost::uint64_t n0 = low << shift;
+
+        // The high word of the quotient is usually 0
+        boost::uint64_t r = n1;
+        quotientHigh = 0;
+        if (n2 != 0 || n1 >= normalized)
+            quotientHigh = divideNormalized(n2, n1, r);
+        const boost::uint64_t quotientLow = divideNormalized(r, n0, r);
+        remainder = r >> shift;
+        return quotientLow;
+    }
+};
+
+} // namespace detail
+
+
+/**
+ * Precomputed conversion of timestamps from a timebase to another.
+ *
+ * @tparam OverflowPolicy Called when a result does not fit in 64 bits,
+ *                        IgnoreOverflow, ThrowOnOverflow or
+ *                        AssertOnOverflow.
+ */
+template<class OverflowPolicy = IgnoreOverflow>
+class TimebaseRescaler
+{
+    /**
+     * Numerator of the reduced ratio.
+     */
+    boost::uint64_t _multiplier;
+
+    /**
+     * Denominator of the reduced ratio.
+     */
+    boost::uint64_t _divisor;
+
+    detail::InvariantDivisor _division;
+
+    RoundingMode _rounding;
+
+    template<RoundingMode Rounding>
+    boost::int64_t rescaleAs(boost::int64_t timestamp) const
+    {
+        const bool negative = timestamp < 0;
+        const boost::uint64_t magnitude = negative ? static_cast<boost::uint64_t>(0) - static_cast<boost::uint64_t>(timestamp)
+                                                   : static_cast<boost::uint64_t>(timestamp);
+
+        boost::uint64_t high, quotientHigh, remainder = 0;
+        const boost::uint64_t low = multiplyWide(magnitude, _multiplier, high);
+
+        // Conversions to a finer timebase are often exact products
+        boost::uint64_t quotient = low;
+        quotientHigh = high;
+        if (_divisor != 1)
+            quotient = _division.divide(high, low, quotientHigh, remainder);
+
+        // Rounding of the magnitude
+        bool increment = false;
+        switch (Rounding)
+        {
+        case ROUND_TOWARD_ZERO:
+            break;
+        case ROUND_AWAY_FROM_ZERO:
+            increment = remainder != 0;
+            break;
+        case ROUND_DOWN:
+            increment = negative && remainder != 0;
+            break;
+        case ROUND_UP:
+            increment = !negative && remainder != 0;
+            break;
+        case ROUND_NEAREST:
+            increment = remainder >= _divisor - remainder;
+            break;
+        }
+        quotient += increment ? 1 : 0;
+        quotientHigh += increment && quotient == 0 ? 1 : 0;
+
+        const boost::uint64_t max = static_cast<boost::uint64_t>(std::numeric_limits<boost::int64_t>::max());
+        if (quotientHigh != 0 || quotient > (negative ? max + 1 : max))
+            OverflowPolicy::overflow("Mw.Math.TimebaseRescaler: Overflow");
+
+        return static_cast<boost::int64_t>(negative ? static_cast<boost::uint64_t>(0) - quotient : quotient);
+    }
+
+    template<RoundingMode Rounding>
+    void rescaleAs(const boost::int64_t * in, boost::int64_t * out, std::size_t count) const
+    {
+        for (std::size_t i = 0; i < count; ++i)
+            out[i] = rescaleAs<Rounding>(in[i]);
+    }
+
+public:
+
+    // Constructors
+
+    /**
+     * Constructor.
+     *
+     * @param from Timebase of the timestamps to convert.
+     * @param to Timebase of the converted timestamps.
+     * @param rounding Rounding of inexact results.
+     * @throw std::invalid_argument if a timebase is not positive, or if the
+     *        reduced ratio of the timebases does not fit in 64 bits.
+     */
+    template<typename T, class P>
+    TimebaseRescaler(const Rational<T, P> & from, const Rational<T, P> & to,
+                     RoundingMode rounding = ROUND_NEAREST)
+        : _multiplier(getRatio(from, to, true)), _divisor(getRatio(from, to, false)),
+          _division(_divisor), _rounding(rounding)
+    {}
+
+
+    // Getters / setters
+
+    /**
+     * Get the numerator of the reduced ratio of the timebases.
+     *
+     * @return Numerator of <tt>from / to</tt>.
+     */
+    boost::uint64_t getMultiplier() const
+    {
+        return _multiplier;
+    }
+
+    /**
+     * Get the denominator of the reduced ratio of the timebases.
+     *
+     * @return Denominator of <tt>from / to</tt>.
+     */
+    boost::uint64_t getDivisor() const
+    {
+        return _divisor;
+    }
+
+    RoundingMode getRounding() const
+    {
+        return _rounding;
+    }
+
+    void setRounding(RoundingMode rounding)
+    {
+        _rounding = rounding;
+    }
+
+
+    // Conversions
+
+    /**
+     * Convert a timestamp.
+     *
+     * @param timestamp Timestamp in the source timebase.
+     * @return Timestamp in the destination timebase.
+     */
+    boost::int64_t rescale(boost::int64_t timestamp) const
+    {
+        switch (_rounding)
+        {
+        case ROUND_TOWARD_ZERO:
+            return rescaleAs<ROUND_TOWARD_ZERO>(timestamp);
+        case ROUND_AWAY_FROM_ZERO:
+            return rescaleAs<ROUND_AWAY_FROM_ZERO>(timestamp);
+        case ROUND_DOWN:
+            return rescaleAs<ROUND_DOWN>(timestamp);
+        case ROUND_UP:
+            return rescaleAs<ROUND_UP>(timestamp);
+        default:
+            return rescaleAs<ROUND_NEAREST>(timestamp);
+        }
+    }
+
+    /**
+     * Convert an array of timestamps.
+     *
+     * @param in Timestamps in the source timebase.
+     * @param out Timestamps in the destination timebase, may be @c in.
+     * @param count Number of timestamps.
+     */
+    void rescale(const boost::int64_t * in, boost::int64_t * out, std::size_t count) const
+    {
+        switch (_rounding)
+        {
+        case ROUND_TOWARD_ZERO:
+            rescaleAs<ROUND_TOWARD_ZERO>(in, out, count);
+            break;
+        case ROUND_AWAY_FROM_ZERO:
+            rescaleAs<ROUND_AWAY_FROM_ZERO>(in, out, count);
+            break;
+        case ROUND_DOWN:
+            rescaleAs<ROUND_DOWN>(in, out, count);
+            break;
+        case ROUND_UP:
+            rescaleAs<ROUND_UP>(in, out, count);
+            break;
+        default:
+            rescaleAs<ROUND_NEAREST>(in, out, count);
+            break;
+        }
+    }
+
+private:
+
+    /**
+     * Get a term of the reduced ratio <tt>from / to</tt>.
+     */
+    template<typename T, class P>
+    static boost::uint64_t getRatio(const Rational<T, P> & from, const Rational<T, P> & to, bool numerator)
+    {
+        typedef detail::RationalBase<boost::int64_t> Base;
+
+        const boost::int64_t fn = from.getNumerator(), fd = from.getDenominator();
+        const boost::int64_t tn = to.getNumerator(), td = to.getDenominator();
+        if (fn <= 0 || tn <= 0)
+            throw std::invalid_argument("Mw.Math.TimebaseRescaler: Timebases must be positive");
+
+        // Both fractions are reduced
+        const boost::int64_t g1 = Base::gcd(fn, tn), g2 = Base::gcd(fd, td);
+
+        boost::int64_t ratio;
+        const bool fits = numerator ? detail::checkedMultiply(fn / g1, td / g2, ratio)
+                                    : detail::checkedMultiply(fd / g2, tn / g1, ratio);
+        if (!fits)
+            throw std::invalid_argument("Mw.Math.TimebaseRescaler: Ratio does not fit in 64 bits");
+        return static_cast<boost::uint64_t>(ratio);
+    }
+
+};
+// class TimebaseRescaler
+
+MW_END_NAMESPACE(math)
+
+#endif // MW_TIMEBASE_HPP
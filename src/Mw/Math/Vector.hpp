@@ -8,16 +8,17 @@
 
 #include <Mw/Config.hpp>
 
+#include <Mw/Math/VectorExpression.hpp>
+#include <Mw/Math/VectorKernels.hpp>
+
 #include <cmath>
-#include <limits>
-#include <ostream>
 #include <stdexcept>
 
+#include <boost/config.hpp>
 #include <boost/serialization/nvp.hpp>
 #include <boost/utility/enable_if.hpp>
 #include <boost/static_assert.hpp>
 #include <boost/assert.hpp>
-#include <boost/operators.hpp>
 
 #ifndef BOOST_NO_CXX11_HDR_INITIALIZER_LIST
 #include <initializer_list>
@@ -28,20 +29,23 @@ MW_BEGIN_NAMESPACE(math)
 /**
  * Generic vector.
  *
+ * Binary arithmetic operators (+, -, * and / by a scalar) are lazy, see
+ * VectorExpression.hpp.
+ *
  * @tparam T Scalar type.
  * @tparam N Dimension (number of components).
  */
 template<typename T, unsigned N>
-class Vector : boost::additive<Vector<T, N> >,
-               boost::multiplicative<Vector<T, N>, T>,
-               boost::equality_comparable<Vector<T, N> >
+class Vector : public VectorExpression<Vector<T, N>, T, N>
 {
     BOOST_STATIC_ASSERT_MSG(N > 0, "Mw.Math.Vector: Invalid template number of components");
 
+    typedef detail::VectorKernels<T, N> Kernels;
+
     /**
      * Vector's components.
      */
-    T _components[N];
+    detail::VectorStorage<T, N> _storage;
 
 public:
 
@@ -52,8 +56,8 @@ public:
      *
      * Vector components are initialized to 0 (null vector).
      */
-    Vector()
-        : _components(static_cast<T>(0))
+    BOOST_CONSTEXPR Vector()
+        : _storage()
     {}
 
     /**
@@ -63,9 +67,26 @@ public:
      */
     template <typename U>
     Vector(const Vector<U, N> & vec)
+        : _storage()
+    {
+        for (unsigned i = 0; i < N; ++i)
+            _storage.components[i] = static_cast<T>(vec[i]);
+    }
+
+    /**
+     * Expression constructor.
+     *
+     * Evaluate a vector expression in a single pass.
+     *
+     * @param expr Expression to evaluate.
+     */
+    template <class E>
+    Vector(const VectorExpression<E, T, N> & expr)
+        : _storage()
     {
+        const E & e = expr.derived();
         for (unsigned i = 0; i < N; ++i)
-            set(i, vec.get(i));
+            _storage.components[i] = e[i];
     }
 
 #ifndef BOOST_NO_CXX11_HDR_INITIALIZER_LIST
@@ -75,12 +96,13 @@ public:
      * @param list Initializer list.
      */
     explicit Vector(const std::initializer_list<T> & list)
+        : _storage()
     {
         BOOST_ASSERT_MSG(list.size() == N, "Mw.Math.Vector: Invalid initializer list size");
 
         unsigned i = 0;
         for (T v : list)
-            set(i++, v);
+            _storage.components[i++] = v;
     }
 #endif
 
@@ -97,7 +119,7 @@ public:
     bool isNull() const
     {
         for (unsigned i = 0; i < N; ++i)
-            if (get(i) != static_cast<T>(0))
+            if (_storage.components[i] != static_cast<T>(0))
                 return false;
 
         return true;
@@ -114,7 +136,7 @@ public:
         if (index >= N)
             throw std::out_of_range("Mw.Math.Vector: Out of range");
 
-        return _components[index];
+        return _storage.components[index];
     }
 
     /**
@@ -128,7 +150,61 @@ public:
         if (index >= N)
             throw std::out_of_range("Mw.Math.Vector: Out of range");
 
-        _components[index] = value;
+        _storage.components[index] = value;
+    }
+
+    /**
+     * Get a component, index checked at compile time.
+     *
+     * @tparam I Component's index.
+     * @return Component at position I.
+     */
+    template<unsigned I>
+    BOOST_CONSTEXPR T get() const
+    {
+        BOOST_STATIC_ASSERT_MSG(I < N, "Mw.Math.Vector: Out of range");
+
+        return _storage.components[I];
+    }
+
+    /**
+     * Set a component, index checked at compile time.
+     *
+     * @tparam I Component's index.
+     * @param value New value.
+     */
+    template<unsigned I>
+    void set(T value)
+    {
+        BOOST_STATIC_ASSERT_MSG(I < N, "Mw.Math.Vector: Out of range");
+
+        _storage.components[I] = value;
+    }
+
+    /**
+     * Access a component without bounds checking.
+     *
+     * @param index Component's index, must be lower than N.
+     * @return Component at position @c index.
+     */
+    const T & operator [] (unsigned index) const
+    {
+        BOOST_ASSERT_MSG(index < N, "Mw.Math.Vector: Out of range");
+
+        return _storage.components[index];
+    }
+
+    /**
+     * Access a component without bounds checking.
+     *
+     * @param index Component's index, must be lower than N.
+     * @return Component at position @c index.
+     */
+    T & operator [] (unsigned index)
+    {
+        BOOST_ASSERT_MSG(index < N, "Mw.Math.Vector: Out of range");
+
+        return _storage.components[index];
     }
 
 
@@ -142,12 +218,7 @@ public:
      */
     T dot(const Vector & vec) const
     {
-        T sum = static_cast<T>(0);
-
-        for (unsigned i = 0; i < N; ++i)
-            sum += get(i) * vec.get(i);
-
-        return sum;
+        return Kernels::dot(_storage, vec._storage);
     }
 
     /**
@@ -167,22 +238,25 @@ public:
     cross(const Vector<T, M> & vec) const
     {
         Vector t;
-        t.set(0, get(1) * vec.get(2) - get(2) * vec.get(1));
-        t.set(1, get(2) * vec.get(0) - get(0) * vec.get(2));
-        t.set(2, get(0) * vec.get(1) - get(1) * vec.get(0));
+        Kernels::cross(t._storage, _storage, vec._storage);
         return t;
     }
 
     /**
-     * Affectation operator.
+     * Expression affectation operator.
      *
-     * @param vec
+     * Evaluate a vector expression in a single pass. The expression may
+     * refer to this vector.
+     *
+     * @param expr
      * @return
      */
-    Vector & operator = (const Vector & vec)
+    template <class E>
+    Vector & operator = (const VectorExpression<E, T, N> & expr)
     {
+        const E & e = expr.derived();
         for (unsigned i = 0; i < N; ++i)
-            set(i, vec.get(i));
+            _storage.components[i] = e[i];
 
         return *this;
     }
@@ -195,8 +269,23 @@ public:
      */
     Vector & operator += (const Vector & vec)
     {
+        Kernels::add(_storage, vec._storage);
+
+        return *this;
+    }
+
+    /**
+     * Expression addition operator.
+     *
+     * @param expr
+     * @return
+     */
+    template <class E>
+    Vector & operator += (const VectorExpression<E, T, N> & expr)
+    {
+        const E & e = expr.derived();
         for (unsigned i = 0; i < N; ++i)
-            set(i, get(i) + vec.get(i));
+            _storage.components[i] += e[i];
 
         return *this;
     }
@@ -209,25 +298,25 @@ public:
      */
     Vector & operator -= (const Vector & vec)
     {
-        for (unsigned i = 0; i < N; ++i)
-            set(i, get(i) - vec.get(i));
+        Kernels::sub(_storage, vec._storage);
 
         return *this;
     }
 
     /**
-     * Get the inverse of this vector.
+     * Expression substraction operator.
      *
-     * @return Invert of this vector.
+     * @param expr
+     * @return
      */
-    Vector operator - () const
+    template <class E>
+    Vector & operator -= (const VectorExpression<E, T, N> & expr)
     {
-        Vector tmp (*this);
-
+        const E & e = expr.derived();
         for (unsigned i = 0; i < N; ++i)
-            tmp.set(i, -get(i));
+            _storage.components[i] -= e[i];
 
-        return tmp;
+        return *this;
     }
 
     /**
@@ -238,8 +327,7 @@ public:
      */
     Vector & operator *= (T factor)
     {
-        for (unsigned i = 0; i < N; ++i)
-            set(i, get(i) * factor);
+        Kernels::scale(_storage, factor);
 
         return *this;
     }
@@ -256,29 +344,11 @@ public:
         if (divisor == static_cast<T>(0))
             throw std::domain_error("Mw.Math.Vector: Division by zero");
 
-        for (unsigned i = 0; i < N; ++i)
-            set(i, get(i) / divisor);
+        Kernels::divide(_storage, divisor);
 
         return *this;
     }
 
-    /**
-     * Equality comparator.
-     *
-     * @param vec
-     * @return
-     */
-    bool operator == (const Vector & vec) const
-    {
-        for (unsigned i = 0; i < N; ++i)
-            // TODO Should the equal operation be strict?
-            if (std::abs(get(i) - vec.get(i)) > std::numeric_limits<T>::epsilon())
-                return false;
-
-        return true;
-    }
-
-
     // Computations
 
     /**
@@ -288,12 +358,7 @@ public:
      */
     T getLength() const
     {
-        T len = static_cast<T>(0);
-
-        for (unsigned i = 0; i < N; ++i)
-            len += get(i)^2;
-
-        return std::sqrt(len);
+        return std::sqrt(dot(*this));
     }
 
 
@@ -305,7 +370,7 @@ private:
     {
         using namespace boost::serialization;
 
-        ar & make_nvp("components", _components);
+        ar & make_nvp("components", _storage.components);
     }
 
 };
@@ -328,15 +393,10 @@ Vector<T, N> project(const Vector<T, N> & first, const Vector<T, N> & second)
         return Vector<T, N>();
 
     // prod = dot(A, B) / B.length ^ 2
-    T prod = static_cast<T>(0);
-    for (unsigned i = 0; i < N; ++i)
-        prod += second.get(i)^2;
+    T prod = first.dot(second) / second.dot(second);
 
-    prod = first.dot(second) / prod;
-
-    Vector<T, N> t;
-    for (unsigned i = 0; i < N; ++i)
-        t.set(i, second.get(i) * prod);
+    Vector<T, N> t(second);
+    t *= prod;
     return t;
 }
 
@@ -350,7 +410,7 @@ Vector<T, N> project(const Vector<T, N> & first, const Vector<T, N> & second)
 template<typename T, unsigned N>
 T scalarProject(const Vector<T, N> & first, const Vector<T, N> & second)
 {
-    return first.dot(second.getNormalization());
+    return first.dot(normalize(second));
 }
 
 /**
@@ -365,32 +425,11 @@ Vector<T, N> normalize(const Vector<T, N> & vector)
     if (vector.isNull())
         throw std::domain_error("Mw.Math.Vector: Normalization not defined for null vectors");
 
-    T len = vector.getLength();
-
-    Vector<T, N> t;
-    for (unsigned i = 0; i < N; ++i)
-        t.set(i, vector.get(i) / len); // TODO Use fast invert sqrt? Precision loss...
+    Vector<T, N> t(vector);
+    t /= vector.getLength(); // TODO Use fast invert sqrt? Precision loss...
     return t;
 }
 
-/**
- * Stream insertion operator overload.
- *
- * @param ostr Output stream.
- * @param vec Vector to insert into the stream.
- * @return @c ostr Output stream.
- */
-template <typename T, unsigned N>
-std::ostream & operator << (std::ostream & ostr, const Vector<T, N> & vec)
-{
-    ostr << "Vector<" << N << ">[" << vec.get(0);
-
-    for (unsigned i = 0; i < N; ++i)
-        ostr << ", " << vec.get(i);
-
-    return ostr << "]";
-}
-
 MW_END_NAMESPACE(math)
 
 #endif // MW_VECTOR_HPP
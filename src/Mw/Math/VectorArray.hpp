@@ -0,0 +1,516 @@
+/**
+ * @file   VectorArray.hpp
+ * @author Bastien Brunnenstein
+ */
+
+#ifndef MW_VECTORARRAY_HPP
+#define MW_VECTORARRAY_HPP
+
+#include <Mw/Config.hpp>
+
+#include <Mw/Math/Simd.hpp>
+#include <Mw/Math/Vector.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/align/aligned_allocator.hpp>
+#include <boost/assert.hpp>
+
+MW_BEGIN_NAMESPACE(math)
+
+/**
+ * Array of vectors stored as a structure of arrays.
+ *
+ * Each component is stored in its own contiguous and aligned lane, so the
+ * batch kernels can process several vectors per SIMD instruction.
+ * The kernels give results close to the equivalent Vector operations, not
+ * always identical: the SIMD Vector kernels sum the components pairwise.
+ *
+ * @tparam T Scalar type.
+ * @tparam N Dimension (number of components).
+ */
+template<typename T, unsigned N>
+class VectorArray
+{
+public:
+
+    /**
+     * Aligned storage of a lane.
+     */
+    typedef std::vector<T, boost::alignment::aligned_allocator<T, MW_SIMD_ALIGNMENT> > Lane;
+
+    /**
+     * Proxy to a vector stored in a VectorArray.
+     *
+     * Can be used as a vector expression, and assigned from any vector
+     * expression.
+     */
+    class Reference : public VectorExpression<Reference, T, N>
+    {
+        VectorArray * _array;
+        std::size_t _index;
+
+    public:
+
+        Reference(VectorArray & array, std::size_t index)
+            : _array(&array), _index(index)
+        {}
+
+        T & operator [] (unsigned component) const
+        {
+            BOOST_ASSERT_MSG(component < N, "Mw.Math.VectorArray: Out of range");
+
+            return _array->_lanes[component][_index];
+        }
+
+        template<class E>
+        const Reference & operator = (const VectorExpression<E, T, N> & expr) const
+        {
+            const E & e = expr.derived();
+            for (unsigned c = 0; c < N; ++c)
+                (*this)[c] = e[c];
+
+            return *this;
+        }
+
+        const Reference & operator = (const Reference & ref) const
+        {
+            for (unsigned c = 0; c < N; ++c)
+                (*this)[c] = ref[c];
+
+            return *this;
+        }
+    };
+    // class Reference
+
+private:
+
+    /**
+     * One lane per component.
+     */
+    Lane _lanes[N];
+
+public:
+
+    // Constructors
+
+    /**
+     * Default constructor.
+     *
+     * The array is empty.
+     */
+    VectorArray()
+    {}
+
+    /**
+     * Constructor.
+     *
+     * @param size Number of null vectors in the array.
+     */
+    explicit VectorArray(std::size_t size)
+    {
+        resize(size);
+    }
+
+    /**
+     * Range constructor.
+     *
+     * Convert a range of Vector (array of structures) into this layout.
+     *
+     * @param first Beginning of the range.
+     * @param last End of the range.
+     */
+    template<class InputIterator>
+    VectorArray(InputIterator first, InputIterator last)
+    {
+        assign(first, last);
+    }
+
+
+    // Getters / setters
+
+    /**
+     * Get the number of vectors in the array.
+     *
+     * @return Number of vectors.
+     */
+    std::size_t size() const
+    {
+        return _lanes[0].size();
+    }
+
+    /**
+     * Check if the array is empty.
+     *
+     * @return @c true if the array has no vectors.
+     */
+    bool empty() const
+    {
+        return _lanes[0].empty();
+    }
+
+    /**
+     * Change the number of vectors in the array.
+     *
+     * New vectors are null.
+     *
+     * @param size New number of vectors.
+     */
+    void resize(std::size_t size)
+    {
+        for (unsigned c = 0; c < N; ++c)
+            _lanes[c].resize(size, static_cast<T>(0));
+    }
+
+    /**
+     * Reserve memory for a number of vectors.
+     *
+     * @param capacity Number of vectors.
+     */
+    void reserve(std::size_t capacity)
+    {
+        for (unsigned c = 0; c < N; ++c)
+            _lanes[c].reserve(capacity);
+    }
+
+    /**
+     * Remove all the vectors.
+     */
+    void clear()
+    {
+        for (unsigned c = 0; c < N; ++c)
+            _lanes[c].clear();
+    }
+
+    /**
+     * Append a vector at the end of the array.
+     *
+     * @param vec Vector to append.
+     */
+    void push_back(const Vector<T, N> & vec)
+    {
+        for (unsigned c = 0; c < N; ++c)
+            _lanes[c].push_back(vec[c]);
+    }
+
+    /**
+     * Get a lane.
+     *
+     * @param component Component's index.
+     * @return Pointer to the first value of the lane.
+     */
+    T * lane(unsigned component)
+    {
+        BOOST_ASSERT_MSG(component < N, "Mw.Math.VectorArray: Out of range");
+
+        return _lanes[component].empty() ? NULL : &_lanes[component][0];
+    }
+
+    /**
+     * Get a lane.
+     *
+     * @param component Component's index.
+     * @return Pointer to the first value of the lane.
+     */
+    const T * lane(unsigned component) const
+    {
+        BOOST_ASSERT_MSG(component < N, "Mw.Math.VectorArray: Out of range");
+
+        return _lanes[component].empty() ? NULL : &_lanes[component][0];
+    }
+
+    /**
+     * Get a vector.
+     *
+     * @param index Vector's index.
+     * @return Copy of the vector at position @c index.
+     */
+    Vector<T, N> get(std::size_t index) const
+    {
+        if (index >= size())
+            throw std::out_of_range("Mw.Math.VectorArray: Out of range");
+
+        return (*this)[index];
+    }
+
+    /**
+     * Set a vector.
+     *
+     * @param index Vector's index.
+     * @param vec New value.
+     */
+    void set(std::size_t index, const Vector<T, N> & vec)
+    {
+        if (index >= size())
+            throw std::out_of_range("Mw.Math.VectorArray: Out of range");
+
+        (*this)[index] = vec;
+    }
+
+    /**
+     * Access a vector without bounds checking.
+     *
+     * @param index Vector's index, must be lower than size().
+     * @return Proxy to the vector at position @c index.
+     */
+    Reference operator [] (std::size_t index)
+    {
+        BOOST_ASSERT_MSG(index < size(), "Mw.Math.VectorArray: Out of range");
+
+        return Reference(*this, index);
+    }
+
+    /**
+     * Access a vector without bounds checking.
+     *
+     * @param index Vector's index, must be lower than size().
+     * @return Copy of the vector at position @c index.
+     */
+    Vector<T, N> operator [] (std::size_t index) const
+    {
+        BOOST_ASSERT_MSG(index < size(), "Mw.Math.VectorArray: Out of range");
+
+        Vector<T, N> vec;
+        for (unsigned c = 0; c < N; ++c)
+            vec[c] = _lanes[c][index];
+        return vec;
+    }
+
+
+    // Conversions
+
+    /**
+     * Replace the content of the array by a range of Vector.
+     *
+     * @param first Beginning of the range.
+     * @param last End of the range.
+     */
+    template<class InputIterator>
+    void assign(InputIterator first, InputIterator last)
+    {
+        clear();
+        for (; first != last; ++first)
+            push_back(*first);
+    }
+
+    /**
+     * Copy the vectors to a range of Vector (array of structures).
+     *
+     * @param out Beginning of the output range.
+     * @return End of the output range.
+     */
+    template<class OutputIterator>
+    OutputIterator copyTo(OutputIterator out) const
+    {
+        const std::size_t count = size();
+        for (std::size_t i = 0; i < count; ++i, ++out)
+            *out = (*this)[i];
+
+        return out;
+    }
+
+
+    // Operations
+
+    /**
+     * Add the vectors of another array, one by one.
+     *
+     * @param array Array of the same size.
+     * @return
+     */
+    VectorArray & operator += (const VectorArray & array)
+    {
+        BOOST_ASSERT(array.size() == size());
+
+        const std::size_t count = size();
+        for (unsigned c = 0; c < N; ++c)
+        {
+            T * a = lane(c);
+            const T * b = array.lane(c);
+            for (std::size_t i = 0; i < count; ++i)
+                a[i] += b[i];
+        }
+        return *this;
+    }
+
+    /**
+     * Substract the vectors of another array, one by one.
+     *
+     * @param array Array of the same size.
+     * @return
+     */
+    VectorArray & operator -= (const VectorArray & array)
+    {
+        BOOST_ASSERT(array.size() == size());
+
+        const std::size_t count = size();
+        for (unsigned c = 0; c < N; ++c)
+        {
+            T * a = lane(c);
+            const T * b = array.lane(c);
+            for (std::size_t i = 0; i < count; ++i)
+                a[i] -= b[i];
+        }
+        return *this;
+    }
+
+    /**
+     * Add a vector to all the vectors of the array.
+     *
+     * @param vec Vector to add.
+     * @return
+     */
+    VectorArray & operator += (const Vector<T, N> & vec)
+    {
+        const std::size_t count = size();
+        for (unsigned c = 0; c < N; ++c)
+        {
+            T * a = lane(c);
+            const T v = vec[c];
+            for (std::size_t i = 0; i < count; ++i)
+                a[i] += v;
+        }
+        return *this;
+    }
+
+    /**
+     * Scale all the vectors of the array.
+     *
+     * @param factor Scalar factor.
+     * @return
+     */
+    VectorArray & operator *= (T factor)
+    {
+        const std::size_t count = size();
+        for (unsigned c = 0; c < N; ++c)
+        {
+            T * a = lane(c);
+            for (std::size_t i = 0; i < count; ++i)
+                a[i] *= factor;
+        }
+        return *this;
+    }
+
+};
+// class VectorArray
+
+
+/**
+ * Compute the dot product of each vector of an array with a vector.
+ *
+ * @param array Array of vectors.
+ * @param vec Second vector.
+ * @param out Output, one value per vector of @c array.
+ */
+template<typename T, unsigned N>
+void dot(const VectorArray<T, N> & array, const Vector<T, N> & vec, T * MW_RESTRICT out)
+{
+    const std::size_t count = array.size();
+
+    for (std::size_t i = 0; i < count; ++i)
+        out[i] = static_cast<T>(0);
+
+    // Components are summed in order, one lane at a time
+    for (unsigned c = 0; c < N; ++c)
+    {
+        const T * MW_RESTRICT a = array.lane(c);
+        const T v = vec[c];
+        for (std::size_t i = 0; i < count; ++i)
+            out[i] += a[i] * v;
+    }
+}
+
+/**
+ * Compute the length of each vector of an array.
+ *
+ * @param array Array of vectors.
+ * @param out Output, one value per vector of @c array.
+ */
+template<typename T, unsigned N>
+void getLengths(const VectorArray<T, N> & array, T * MW_RESTRICT out)
+{
+    const std::size_t count = array.size();
+
+    for (std::size_t i = 0; i < count; ++i)
+        out[i] = static_cast<T>(0);
+
+    for (unsigned c = 0; c < N; ++c)
+    {
+        const T * MW_RESTRICT a = array.lane(c);
+        for (std::size_t i = 0; i < count; ++i)
+            out[i] += a[i] * a[i];
+    }
+
+    for (std::size_t i = 0; i < count; ++i)
+        out[i] = std::sqrt(out[i]);
+}
+
+/**
+ * Normalize each vector of an array.
+ *
+ * @param array Array of vectors to be normalized.
+ * @param out Normalized vectors, may be @c array itself.
+ * @throw std::domain_error One of the vectors is null, @c out is unchanged.
+ */
+template<typename T, unsigned N>
+void normalize(const VectorArray<T, N> & array, VectorArray<T, N> & out)
+{
+    const std::size_t count = array.size();
+
+    typename VectorArray<T, N>::Lane lengths(count);
+    if (count)
+        getLengths(array, &lengths[0]);
+
+    for (std::size_t i = 0; i < count; ++i)
+        if (lengths[i] == static_cast<T>(0))
+            throw std::domain_error("Mw.Math.Vector: Normalization not defined for null vectors");
+
+    out.resize(count);
+    for (unsigned c = 0; c < N; ++c)
+    {
+        const T * a = array.lane(c);
+        T * o = out.lane(c);
+        for (std::size_t i = 0; i < count; ++i)
+            o[i] = a[i] / lengths[i];
+    }
+}
+
+/**
+ * Compute the projection of each vector of an array on a vector.
+ *
+ * @param array Vectors to be projected.
+ * @param second Vector to project on, must not be null.
+ * @param out Projections, may be @c array itself.
+ */
+template<typename T, unsigned N>
+void project(const VectorArray<T, N> & array, const Vector<T, N> & second, VectorArray<T, N> & out)
+{
+    BOOST_ASSERT(!second.isNull());
+
+    const std::size_t count = array.size();
+
+    // prod = dot(A, B) / B.length ^ 2
+    typename VectorArray<T, N>::Lane prod(count);
+    if (count)
+        dot(array, second, &prod[0]);
+
+    const T sq = second.dot(second);
+    for (std::size_t i = 0; i < count; ++i)
+        prod[i] /= sq;
+
+    out.resize(count);
+    for (unsigned c = 0; c < N; ++c)
+    {
+        T * o = out.lane(c);
+        const T s = second[c];
+        for (std::size_t i = 0; i < count; ++i)
+            o[i] = s * prod[i];
+    }
+}
+
+MW_END_NAMESPACE(math)
+
+#endif // MW_VECTORARRAY_HPP
@@ -0,0 +1,277 @@
+/**
+ * @file   VectorExpression.hpp
+ * @author Bastien Brunnenstein
+ *
+ * @details Lazy vector arithmetic.
+ *
+ * The arithmetic operators of Vector return lightweight expression objects
+ * instead of vectors. A whole expression such as @c a + b * s - c is then
+ * evaluated component by component, in a single loop, when it is assigned
+ * to a Vector.
+ *
+ * Expressions keep references to the vectors they use, they must not
+ * outlive them (do not store an expression in an @c auto variable).
+ */
+
+#ifndef MW_VECTOREXPRESSION_HPP
+#define MW_VECTOREXPRESSION_HPP
+
+#include <Mw/Config.hpp>
+
+#include <cmath>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+
+#include <boost/type_traits/type_identity.hpp>
+
+MW_BEGIN_NAMESPACE(math)
+
+template<typename T, unsigned N>
+class Vector;
+
+/**
+ * Base of every vector expression.
+ *
+ * @tparam E Derived expression type.
+ * @tparam T Scalar type.
+ * @tparam N Dimension (number of components).
+ */
+template<class E, typename T, unsigned N>
+class VectorExpression
+{
+public:
+
+    /**
+     * Get the derived expression.
+     *
+     * @return Derived expression.
+     */
+    const E & derived() const
+    {
+        return static_cast<const E &>(*this);
+    }
+
+    /**
+     * Evaluate a component of this expression.
+     *
+     * @param index Component's index, must be lower than N.
+     * @return Value of the component at position @c index.
+     */
+    T operator [] (unsigned index) const
+    {
+        return derived()[index];
+    }
+};
+// class VectorExpression
+
+
+namespace detail
+{
+
+/**
+ * Type used by an expression to hold one of its operands.
+ *
+ * Vectors are held by reference, expressions by value.
+ */
+template<class E>
+struct VectorOperand
+{
+    typedef const E Type;
+};
+
+template<typename T, unsigned N>
+struct VectorOperand<Vector<T, N> >
+{
+    typedef const Vector<T, N> & Type;
+};
+
+struct VectorPlus
+{
+    template<typename T>
+    static T apply(T a, T b) { return a + b; }
+};
+
+struct VectorMinus
+{
+    template<typename T>
+    static T apply(T a, T b) { return a - b; }
+};
+
+struct VectorMultiplies
+{
+    template<typename T>
+    static T apply(T a, T b) { return a * b; }
+};
+
+struct VectorDivides
+{
+    template<typename T>
+    static T apply(T a, T b) { return a / b; }
+};
+
+} // namespace detail
+
+
+/**
+ * Component-wise operation between two vector expressions.
+ */
+template<class L, class R, class Op, typename T, unsigned N>
+class VectorBinaryExpression
+    : public VectorExpression<VectorBinaryExpression<L, R, Op, T, N>, T, N>
+{
+    typename detail::VectorOperand<L>::Type _left;
+    typename detail::VectorOperand<R>::Type _right;
+
+public:
+
+    VectorBinaryExpression(const L & left, const R & right)
+        : _left(left), _right(right)
+    {}
+
+    T operator [] (unsigned index) const
+    {
+        return Op::apply(_left[index], _right[index]);
+    }
+};
+// class VectorBinaryExpression
+
+/**
+ * Operation between each component of a vector expression and a scalar.
+ */
+template<class E, class Op, typename T, unsigned N>
+class VectorScalarExpression
+    : public VectorExpression<VectorScalarExpression<E, Op, T, N>, T, N>
+{
+    typename detail::VectorOperand<E>::Type _expr;
+    T _scalar;
+
+public:
+
+    VectorScalarExpression(const E & expr, T scalar)
+        : _expr(expr), _scalar(scalar)
+    {}
+
+    T operator [] (unsigned index) const
+    {
+        return Op::apply(_expr[index], _scalar);
+    }
+};
+// class VectorScalarExpression
+
+/**
+ * Negation of a vector expression.
+ */
+template<class E, typename T, unsigned N>
+class VectorNegation
+    : public VectorExpression<VectorNegation<E, T, N>, T, N>
+{
+    typename detail::VectorOperand<E>::Type _expr;
+
+public:
+
+    explicit VectorNegation(const E & expr)
+        : _expr(expr)
+    {}
+
+    T operator [] (unsigned index) const
+    {
+        return - _expr[index];
+    }
+};
+// class VectorNegation
+
+
+// Operators
+
+template<class L, class R, typename T, unsigned N>
+VectorBinaryExpression<L, R, detail::VectorPlus, T, N>
+operator + (const VectorExpression<L, T, N> & left, const VectorExpression<R, T, N> & right)
+{
+    return VectorBinaryExpression<L, R, detail::VectorPlus, T, N>(left.derived(), right.derived());
+}
+
+template<class L, class R, typename T, unsigned N>
+VectorBinaryExpression<L, R, detail::VectorMinus, T, N>
+operator - (const VectorExpression<L, T, N> & left, const VectorExpression<R, T, N> & right)
+{
+    return VectorBinaryExpression<L, R, detail::VectorMinus, T, N>(left.derived(), right.derived());
+}
+
+template<class E, typename T, unsigned N>
+VectorNegation<E, T, N>
+operator - (const VectorExpression<E, T, N> & expr)
+{
+    return VectorNegation<E, T, N>(expr.derived());
+}
+
+template<class E, typename T, unsigned N>
+VectorScalarExpression<E, detail::VectorMultiplies, T, N>
+operator * (const VectorExpression<E, T, N> & expr, typename boost::type_identity<T>::type factor)
+{
+    return VectorScalarExpression<E, detail::VectorMultiplies, T, N>(expr.derived(), factor);
+}
+
+template<class E, typename T, unsigned N>
+VectorScalarExpression<E, detail::VectorMultiplies, T, N>
+operator * (typename boost::type_identity<T>::type factor, const VectorExpression<E, T, N> & expr)
+{
+    return VectorScalarExpression<E, detail::VectorMultiplies, T, N>(expr.derived(), factor);
+}
+
+/**
+ * @throw std::domain_error Division by zero
+ */
+template<class E, typename T, unsigned N>
+VectorScalarExpression<E, detail::VectorDivides, T, N>
+operator / (const VectorExpression<E, T, N> & expr, typename boost::type_identity<T>::type divisor)
+{
+    if (divisor == static_cast<T>(0))
+        throw std::domain_error("Mw.Math.Vector: Division by zero");
+
+    return VectorScalarExpression<E, detail::VectorDivides, T, N>(expr.derived(), divisor);
+}
+
+/**
+ * Equality comparator.
+ *
+ * Components are compared with an epsilon tolerance.
+ */
+template<class L, class R, typename T, unsigned N>
+bool operator == (const VectorExpression<L, T, N> & left, const VectorExpression<R, T, N> & right)
+{
+    for (unsigned i = 0; i < N; ++i)
+        // TODO Should the equal operation be strict?
+        if (std::abs(left[i] - right[i]) > std::numeric_limits<T>::epsilon())
+            return false;
+
+    return true;
+}
+
+template<class L, class R, typename T, unsigned N>
+bool operator != (const VectorExpression<L, T, N> & left, const VectorExpression<R, T, N> & right)
+{
+    return !(left == right);
+}
+
+/**
+ * Stream insertion operator overload.
+ *
+ * @param ostr Output stream.
+ * @param expr Vector expression to insert into the stream.
+ * @return @c ostr Output stream.
+ */
+template <class E, typename T, unsigned N>
+std::ostream & operator << (std::ostream & ostr, const VectorExpression<E, T, N> & expr)
+{
+    ostr << "Vector<" << N << ">[" << expr[0];
+
+    for (unsigned i = 1; i < N; ++i)
+        ostr << ", " << expr[i];
+
+    return ostr << "]";
+}
+
+MW_END_NAMESPACE(math)
+
+#endif // MW_VECTOREXPRESSION_HPP
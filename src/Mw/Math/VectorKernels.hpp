@@ -0,0 +1,336 @@
+/**
+ * @file   VectorKernels.hpp
+ * @author Bastien Brunnenstein
+ *
+ * @details Storage layout and arithmetic kernels used by Vector.
+ *
+ * The generic kernels are plain loops. Vector<float, 4>, Vector<double, 4>
+ * and (opt-in) Vector<float, 3> get SSE/AVX kernels when the instruction
+ * sets are enabled, see Simd.hpp.
+ *
+ * Define @c MW_MATH_PAD_VECTOR3F to pad Vector<float, 3> to 16 bytes, so it
+ * can use 128-bit lanes. This changes sizeof(Vector<float, 3>), but not its
+ * serialized form.
+ */
+
+#ifndef MW_VECTORKERNELS_HPP
+#define MW_VECTORKERNELS_HPP
+
+#include <Mw/Config.hpp>
+
+#include <Mw/Math/Simd.hpp>
+
+#include <boost/config.hpp>
+
+MW_BEGIN_NAMESPACE(math)
+
+namespace detail
+{
+
+/**
+ * Components storage of a Vector.
+ *
+ * @tparam T Scalar type.
+ * @tparam N Dimension (number of components).
+ */
+template<typename T, unsigned N>
+struct VectorStorage
+{
+    T components[N];
+};
+
+/**
+ * Arithmetic kernels of a Vector, working on its storage.
+ *
+ * @tparam T Scalar type.
+ * @tparam N Dimension (number of components).
+ */
+template<typename T, unsigned N>
+struct VectorKernels
+{
+    typedef VectorStorage<T, N> Storage;
+
+    static void add(Storage & a, const Storage & b)
+    {
+        for (unsigned i = 0; i < N; ++i)
+            a.components[i] += b.components[i];
+    }
+
+    static void sub(Storage & a, const Storage & b)
+    {
+        for (unsigned i = 0; i < N; ++i)
+            a.components[i] -= b.components[i];
+    }
+
+    static void scale(Storage & a, T factor)
+    {
+        for (unsigned i = 0; i < N; ++i)
+            a.components[i] *= factor;
+    }
+
+    static void divide(Storage & a, T divisor)
+    {
+        for (unsigned i = 0; i < N; ++i)
+            a.components[i] /= divisor;
+    }
+
+    static T dot(const Storage & a, const Storage & b)
+    {
+        T sum = static_cast<T>(0);
+
+        for (unsigned i = 0; i < N; ++i)
+            sum += a.components[i] * b.components[i];
+
+        return sum;
+    }
+
+    static void cross(Storage & out, const Storage & a, const Storage & b)
+    {
+        out.components[0] = a.components[1] * b.components[2] - a.components[2] * b.components[1];
+        out.components[1] = a.components[2] * b.components[0] - a.components[0] * b.components[2];
+        out.components[2] = a.components[0] * b.components[1] - a.components[1] * b.components[0];
+    }
+};
+
+
+#ifdef MW_SIMD_SSE
+
+/**
+ * Horizontal sum of the first three lanes.
+ */
+inline float sumLanes3(__m128 v)
+{
+    __m128 y = _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1));
+    __m128 z = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
+    return _mm_cvtss_f32(_mm_add_ss(_mm_add_ss(v, y), z));
+}
+
+/**
+ * Horizontal sum of the four lanes.
+ */
+inline float sumLanes4(__m128 v)
+{
+    __m128 hi = _mm_movehl_ps(v, v);
+    __m128 s = _mm_add_ps(v, hi);
+    return _mm_cvtss_f32(_mm_add_ss(s, _mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 1, 1, 1))));
+}
+
+/**
+ * Shared SSE kernels for 4 float lanes.
+ */
+struct Float4Kernels
+{
+    static void add(float * a, const float * b)
+    {
+        _mm_store_ps(a, _mm_add_ps(_mm_load_ps(a), _mm_load_ps(b)));
+    }
+
+    static void sub(float * a, const float * b)
+    {
+        _mm_store_ps(a, _mm_sub_ps(_mm_load_ps(a), _mm_load_ps(b)));
+    }
+
+    static void scale(float * a, float factor)
+    {
+        _mm_store_ps(a, _mm_mul_ps(_mm_load_ps(a), _mm_set1_ps(factor)));
+    }
+
+    static void divide(float * a, float divisor)
+    {
+        _mm_store_ps(a, _mm_div_ps(_mm_load_ps(a), _mm_set1_ps(divisor)));
+    }
+};
+
+template<>
+struct VectorStorage<float, 4>
+{
+    BOOST_ALIGNMENT(16) float components[4];
+};
+
+template<>
+struct VectorKernels<float, 4>
+{
+    typedef VectorStorage<float, 4> Storage;
+
+    static void add(Storage & a, const Storage & b)
+    {
+        Float4Kernels::add(a.components, b.components);
+    }
+
+    static void sub(Storage & a, const Storage & b)
+    {
+        Float4Kernels::sub(a.components, b.components);
+    }
+
+    static void scale(Storage & a, float factor)
+    {
+        Float4Kernels::scale(a.components, factor);
+    }
+
+    static void divide(Storage & a, float divisor)
+    {
+        Float4Kernels::divide(a.components, divisor);
+    }
+
+    static float dot(const Storage & a, const Storage & b)
+    {
+        return sumLanes4(_mm_mul_ps(_mm_load_ps(a.components), _mm_load_ps(b.components)));
+    }
+};
+
+#ifdef MW_MATH_PAD_VECTOR3F
+
+template<>
+struct VectorStorage<float, 3>
+{
+    BOOST_ALIGNMENT(16) float components[3];
+
+    /**
+     * Fourth lane, never read as a component.
+     */
+    float padding;
+};
+
+template<>
+struct VectorKernels<float, 3>
+{
+    typedef VectorStorage<float, 3> Storage;
+
+    static void add(Storage & a, const Storage & b)
+    {
+        Float4Kernels::add(a.components, b.components);
+    }
+
+    static void sub(Storage & a, const Storage & b)
+    {
+        Float4Kernels::sub(a.components, b.components);
+    }
+
+    static void scale(Storage & a, float factor)
+    {
+        Float4Kernels::scale(a.components, factor);
+    }
+
+    static void divide(Storage & a, float divisor)
+    {
+        Float4Kernels::divide(a.components, divisor);
+    }
+
+    static float dot(const Storage & a, const Storage & b)
+    {
+        return sumLanes3(_mm_mul_ps(_mm_load_ps(a.components), _mm_load_ps(b.components)));
+    }
+
+    static void cross(Storage & out, const Storage & a, const Storage & b)
+    {
+        __m128 va = _mm_load_ps(a.components);
+        __m128 vb = _mm_load_ps(b.components);
+
+        // a.yzx * b.zxy - a.zxy * b.yzx
+        __m128 a_yzx = _mm_shuffle_ps(va, va, _MM_SHUFFLE(3, 0, 2, 1));
+        __m128 b_yzx = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(3, 0, 2, 1));
+        __m128 a_zxy = _mm_shuffle_ps(va, va, _MM_SHUFFLE(3, 1, 0, 2));
+        __m128 b_zxy = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(3, 1, 0, 2));
+
+        _mm_store_ps(out.components, _mm_sub_ps(_mm_mul_ps(a_yzx, b_zxy), _mm_mul_ps(a_zxy, b_yzx)));
+    }
+};
+
+#endif // MW_MATH_PAD_VECTOR3F
+
+#endif // MW_SIMD_SSE
+
+
+#ifdef MW_SIMD_SSE2
+
+template<>
+struct VectorStorage<double, 4>
+{
+    BOOST_ALIGNMENT(16) double components[4];
+};
+
+template<>
+struct VectorKernels<double, 4>
+{
+    typedef VectorStorage<double, 4> Storage;
+
+#ifdef MW_SIMD_AVX
+    // Storage is only 16-bytes aligned, use unaligned 256-bit accesses
+
+    static void add(Storage & a, const Storage & b)
+    {
+        _mm256_storeu_pd(a.components, _mm256_add_pd(_mm256_loadu_pd(a.components), _mm256_loadu_pd(b.components)));
+    }
+
+    static void sub(Storage & a, const Storage & b)
+    {
+        _mm256_storeu_pd(a.components, _mm256_sub_pd(_mm256_loadu_pd(a.components), _mm256_loadu_pd(b.components)));
+    }
+
+    static void scale(Storage & a, double factor)
+    {
+        _mm256_storeu_pd(a.components, _mm256_mul_pd(_mm256_loadu_pd(a.components), _mm256_set1_pd(factor)));
+    }
+
+    static void divide(Storage & a, double divisor)
+    {
+        _mm256_storeu_pd(a.components, _mm256_div_pd(_mm256_loadu_pd(a.components), _mm256_set1_pd(divisor)));
+    }
+
+    static double dot(const Storage & a, const Storage & b)
+    {
+        __m256d m = _mm256_mul_pd(_mm256_loadu_pd(a.components), _mm256_loadu_pd(b.components));
+        __m128d s = _mm_add_pd(_mm256_castpd256_pd128(m), _mm256_extractf128_pd(m, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+    }
+#else
+    static void add(Storage & a, const Storage & b)
+    {
+        double * pa = a.components;
+        const double * pb = b.components;
+        _mm_store_pd(pa,     _mm_add_pd(_mm_load_pd(pa),     _mm_load_pd(pb)));
+        _mm_store_pd(pa + 2, _mm_add_pd(_mm_load_pd(pa + 2), _mm_load_pd(pb + 2)));
+    }
+
+    static void sub(Storage & a, const Storage & b)
+    {
+        double * pa = a.components;
+        const double * pb = b.components;
+        _mm_store_pd(pa,     _mm_sub_pd(_mm_load_pd(pa),     _mm_load_pd(pb)));
+        _mm_store_pd(pa + 2, _mm_sub_pd(_mm_load_pd(pa + 2), _mm_load_pd(pb + 2)));
+    }
+
+    static void scale(Storage & a, double factor)
+    {
+        double * pa = a.components;
+        __m128d f = _mm_set1_pd(factor);
+        _mm_store_pd(pa,     _mm_mul_pd(_mm_load_pd(pa),     f));
+        _mm_store_pd(pa + 2, _mm_mul_pd(_mm_load_pd(pa + 2), f));
+    }
+
+    static void divide(Storage & a, double divisor)
+    {
+        double * pa = a.components;
+        __m128d d = _mm_set1_pd(divisor);
+        _mm_store_pd(pa,     _mm_div_pd(_mm_load_pd(pa),     d));
+        _mm_store_pd(pa + 2, _mm_div_pd(_mm_load_pd(pa + 2), d));
+    }
+
+    static double dot(const Storage & a, const Storage & b)
+    {
+        const double * pa = a.components;
+        const double * pb = b.components;
+        __m128d s = _mm_add_pd(_mm_mul_pd(_mm_load_pd(pa),     _mm_load_pd(pb)),
+                               _mm_mul_pd(_mm_load_pd(pa + 2), _mm_load_pd(pb + 2)));
+        return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+    }
+#endif
+};
+
+#endif // MW_SIMD_SSE2
+
+} // namespace detail
+
+MW_END_NAMESPACE(math)
+
+#endif // MW_VECTORKERNELS_HPP
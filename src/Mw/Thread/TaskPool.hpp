@@ -0,0 +1,515 @@
+/**
+ * @file   TaskPool.hpp
+ * @author Bastien Brunnenstein
+ *
+ * @details Work-stealing task pool, used by the parallel algorithms of the
+ * Math module.
+ *
+ * Each worker thread owns a task queue. Workers take their own tasks in
+ * LIFO order and steal tasks from the other queues in FIFO order. A thread
+ * waiting for a TaskGroup executes pending tasks instead of blocking, so
+ * tasks can spawn and wait for sub-tasks (fork/join).
+ *
+ * An exception thrown by a task is caught and rethrown by TaskGroup::wait,
+ * the other tasks of the group still run.
+ *
+ * Threads require C++11 (or define @c MW_NO_THREADS). Without them, tasks
+ * run immediately on the calling thread.
+ */
+
+#ifndef MW_TASKPOOL_HPP
+#define MW_TASKPOOL_HPP
+
+#include <Mw/Config.hpp>
+
+#include <algorithm>
+#include <cstddef>
+
+#include <boost/config.hpp>
+#include <boost/noncopyable.hpp>
+
+/**
+ * @def MW_NO_THREADS
+ * Defined when the task pool runs everything on the calling thread.
+ */
+
+#if !defined MW_NO_THREADS && (defined BOOST_NO_CXX11_HDR_THREAD \
+                            || defined BOOST_NO_CXX11_HDR_MUTEX \
+                            || defined BOOST_NO_CXX11_HDR_CONDITION_VARIABLE \
+                            || defined BOOST_NO_CXX11_HDR_ATOMIC \
+                            || defined BOOST_NO_CXX11_HDR_EXCEPTION \
+                            || defined BOOST_NO_CXX11_HDR_FUNCTIONAL \
+                            || defined BOOST_NO_CXX11_THREAD_LOCAL)
+#   define MW_NO_THREADS
+#endif
+
+#ifndef MW_NO_THREADS
+#   include <atomic>
+#   include <condition_variable>
+#   include <deque>
+#   include <exception>
+#   include <functional>
+#   include <memory>
+#   include <mutex>
+#   include <thread>
+#   include <vector>
+#endif
+
+MW_BEGIN_NAMESPACE(thread)
+
+#ifndef MW_NO_THREADS
+
+/**
+ * Pool of worker threads.
+ */
+class TaskPool : boost::noncopyable
+{
+public:
+
+    class TaskGroup;
+
+private:
+
+    typedef std::function<void ()> Task;
+
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    /**
+     * One queue per worker, plus one for tasks submitted from outside.
+     */
+    std::vector<std::unique_ptr<Queue> > _queues;
+
+    std::vector<std::thread> _threads;
+
+    std::mutex _sleepMutex;
+    std::condition_variable _sleep;
+
+    /**
+     * Number of queued tasks, in all queues.
+     */
+    std::atomic<std::size_t> _queued;
+
+    bool _stop;
+
+    /**
+     * Queue owned by the current thread.
+     */
+    struct Owner
+    {
+        const TaskPool * pool;
+        std::size_t queue;
+    };
+
+    static Owner & currentOwner()
+    {
+        static thread_local Owner owner = { NULL, 0 };
+        return owner;
+    }
+
+    /**
+     * Get the queue owned by the current thread.
+     *
+     * @return Queue index plus one, 0 if the thread is not a worker.
+     */
+    std::size_t currentQueue() const
+    {
+        const Owner & owner = currentOwner();
+        return owner.pool == this ? owner.queue : 0;
+    }
+
+    std::size_t externalQueue() const
+    {
+        return _queues.size() - 1;
+    }
+
+    void push(Task task)
+    {
+        std::size_t q = currentQueue();
+        if (q == 0)
+            q = externalQueue();
+        else
+            q -= 1;
+
+        // Counted before it can be taken, so pop never decrements first
+        {
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+            ++_queued;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_queues[q]->mutex);
+            _queues[q]->tasks.push_back(task);
+        }
+        _sleep.notify_one();
+    }
+
+    /**
+     * Wake the threads waiting for a TaskGroup, and the idle workers.
+     */
+    void notifyAll()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+        }
+        _sleep.notify_all();
+    }
+
+    /**
+     * Take a task, from the own queue first, then from the other ones.
+     */
+    bool pop(Task & task)
+    {
+        if (_queued.load() == 0)
+            return false;
+
+        std::size_t own = currentQueue();
+        const std::size_t count = _queues.size();
+
+        if (own != 0)
+        {
+            Queue & queue = *_queues[own - 1];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty())
+            {
+                task = queue.tasks.back();
+                queue.tasks.pop_back();
+                --_queued;
+                return true;
+            }
+        }
+
+        const std::size_t start = own != 0 ? own : 0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            Queue & queue = *_queues[(start + i) % count];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty())
+            {
+                task = queue.tasks.front();
+                queue.tasks.pop_front();
+                --_queued;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void work(std::size_t index)
+    {
+        Owner & owner = currentOwner();
+        owner.pool = this;
+        owner.queue = index + 1;
+
+        for (;;)
+        {
+            Task task;
+            if (pop(task))
+            {
+                task();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(_sleepMutex);
+            _sleep.wait(lock, [this] { return _stop || _queued.load() != 0; });
+            if (_stop && _queued.load() == 0)
+                return;
+        }
+    }
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param threads Number of threads taking part in the work, including
+     *                the thread waiting for the tasks. 0 to use the number
+     *                of hardware threads.
+     */
+    explicit TaskPool(unsigned threads = 0)
+        : _queued(0), _stop(false)
+    {
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+
+        const unsigned workers = threads - 1;
+        for (unsigned i = 0; i < workers + 1; ++i)
+            _queues.push_back(std::unique_ptr<Queue>(new Queue));
+
+        for (unsigned i = 0; i < workers; ++i)
+            _threads.push_back(std::thread(&TaskPool::work, this, i));
+    }
+
+    /**
+     * Destructor.
+     *
+     * Remaining tasks are executed before the workers are joined.
+     */
+    ~TaskPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+            _stop = true;
+        }
+        _sleep.notify_all();
+
+        for (std::size_t i = 0; i < _threads.size(); ++i)
+            _threads[i].join();
+
+        // Without workers, run what is left here
+        Task task;
+        while (pop(task))
+            task();
+    }
+
+    /**
+     * Get the number of threads taking part in the work.
+     *
+     * @return Number of worker threads, plus one.
+     */
+    unsigned getThreadCount() const
+    {
+        return static_cast<unsigned>(_threads.size() + 1);
+    }
+
+
+    /**
+     * Set of tasks that can be waited for.
+     */
+    class TaskGroup : boost::noncopyable
+    {
+        /**
+         * State shared with the queued tasks.
+         */
+        struct State
+        {
+            TaskPool & pool;
+
+            std::atomic<std::size_t> pending;
+
+            std::mutex errorMutex;
+            std::exception_ptr error;
+
+            explicit State(TaskPool & pool)
+                : pool(pool), pending(0)
+            {}
+        };
+
+        /**
+         * Marks a task done, even when it throws.
+         */
+        struct Done
+        {
+            State & state;
+
+            ~Done()
+            {
+                if (--state.pending == 0)
+                    state.pool.notifyAll();
+            }
+        };
+
+        TaskPool & _pool;
+        std::shared_ptr<State> _state;
+
+        /**
+         * Run pending tasks, and sleep while the last ones run on other
+         * threads. New tasks in the pool wake the thread up too.
+         */
+        void waitTasks()
+        {
+            const State & state = *_state;
+            while (state.pending.load() != 0)
+            {
+                Task task;
+                if (_pool.pop(task))
+                {
+                    task();
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock(_pool._sleepMutex);
+                _pool._sleep.wait(lock, [this, &state]
+                {
+                    return state.pending.load() == 0 || _pool._queued.load() != 0;
+                });
+            }
+        }
+
+    public:
+
+        explicit TaskGroup(TaskPool & pool)
+            : _pool(pool), _state(std::make_shared<State>(pool))
+        {}
+
+        /**
+         * Destructor, waits for the tasks.
+         *
+         * An exception not collected by wait() is discarded.
+         */
+        ~TaskGroup()
+        {
+            waitTasks();
+        }
+
+        /**
+         * Queue a task.
+         *
+         * If the task throws, the first exception of the group is kept and
+         * rethrown by wait().
+         *
+         * @param f Function object called without arguments.
+         */
+        template<class F>
+        void run(F f)
+        {
+            std::shared_ptr<State> state = _state;
+            ++state->pending;
+            _pool.push([state, f] () mutable
+            {
+                Done done = { *state };
+                try
+                {
+                    f();
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(state->errorMutex);
+                    if (!state->error)
+                        state->error = std::current_exception();
+                }
+            });
+        }
+
+        /**
+         * Wait for all the queued tasks, executing pending tasks meanwhile.
+         *
+         * @throw Rethrows the first exception thrown by a task of the group.
+         */
+        void wait()
+        {
+            waitTasks();
+
+            std::exception_ptr error;
+            {
+                std::lock_guard<std::mutex> lock(_state->errorMutex);
+                std::swap(error, _state->error);
+            }
+            if (error)
+                std::rethrow_exception(error);
+        }
+    };
+    // class TaskGroup
+
+};
+// class TaskPool
+
+#else // MW_NO_THREADS
+
+/**
+ * Pool of worker threads.
+ *
+ * Threads are disabled, tasks run immediately on the calling thread.
+ */
+class TaskPool : boost::noncopyable
+{
+public:
+
+    explicit TaskPool(unsigned threads = 0)
+    {
+        (void) threads;
+    }
+
+    unsigned getThreadCount() const
+    {
+        return 1;
+    }
+
+    class TaskGroup : boost::noncopyable
+    {
+    public:
+
+        explicit TaskGroup(TaskPool &)
+        {}
+
+        /**
+         * Run a task immediately, its exceptions propagate from here.
+         */
+        template<class F>
+        void run(F f)
+        {
+            f();
+        }
+
+        void wait()
+        {}
+    };
+    // class TaskGroup
+
+};
+// class TaskPool
+
+#endif // MW_NO_THREADS
+
+
+namespace detail
+{
+
+template<class F>
+struct ParallelChunk
+{
+    F f;
+    std::size_t begin;
+    std::size_t end;
+
+    ParallelChunk(const F & f, std::size_t begin, std::size_t end)
+        : f(f), begin(begin), end(end)
+    {}
+
+    void operator () ()
+    {
+        f(begin, end);
+    }
+};
+
+} // namespace detail
+
+
+/**
+ * Process a range of indices in parallel.
+ *
+ * The range is cut in chunks of @c grain indices. The chunks do not depend
+ * on the number of threads, so a deterministic @c f gives deterministic
+ * results.
+ *
+ * @param pool Task pool.
+ * @param begin First index.
+ * @param end Last index (excluded).
+ * @param grain Number of indices per chunk.
+ * @param f Function object called as @c f(chunkBegin, chunkEnd).
+ */
+template<class F>
+void parallelFor(TaskPool & pool, std::size_t begin, std::size_t end, std::size_t grain, F f)
+{
+    if (grain == 0)
+        grain = 1;
+
+    TaskPool::TaskGroup group(pool);
+    for (std::size_t b = begin; b < end; b += grain)
+    {
+        std::size_t e = std::min(end, b + grain);
+        if (e == end)
+            f(b, e);
+        else
+            group.run(detail::ParallelChunk<F>(f, b, e));
+    }
+    group.wait();
+}
+
+MW_END_NAMESPACE(thread)
+
+#endif // MW_TASKPOOL_HPP
@@ -0,0 +1,204 @@
+/**
+ * @file   Easing.hpp
+ * @author Bastien Brunnenstein
+ *
+ * @details Easing functions, mapping the progress of a tween in [0, 1] to
+ * the position of its value between the start and the end.
+ *
+ * See http://easings.net/ for the curves. The functions have no branch,
+ * the in-out variants select one of their two halves, so loops over them
+ * can be vectorized.
+ */
+
+#ifndef MW_EASING_HPP
+#define MW_EASING_HPP
+
+#include <Mw/Config.hpp>
+
+#include <Mw/Math/FastMath.hpp>
+
+#include <stdexcept>
+
+MW_BEGIN_NAMESPACE(tween)
+
+/**
+ * Easing functions.
+ */
+enum Easing
+{
+    EASE_LINEAR,
+    EASE_IN_QUAD,
+    EASE_OUT_QUAD,
+    EASE_IN_OUT_QUAD,
+    EASE_IN_CUBIC,
+    EASE_OUT_CUBIC,
+    EASE_IN_OUT_CUBIC,
+    EASE_IN_SINE,
+    EASE_OUT_SINE,
+    EASE_IN_OUT_SINE,
+    EASE_SMOOTHSTEP,
+
+    /**
+     * Number of easing functions.
+     */
+    EASING_COUNT
+};
+
+/**
+ * Easing function.
+ *
+ * @c apply(t) maps a progress @c t in [0, 1] to a position, 0 at the start
+ * and 1 at the end.
+ *
+ * @tparam E Easing.
+ */
+template<Easing E>
+struct Ease;
+
+template<>
+struct Ease<EASE_LINEAR>
+{
+    template<typename U>
+    static U apply(U t)
+    {
+        return t;
+    }
+};
+
+template<>
+struct Ease<EASE_IN_QUAD>
+{
+    template<typename U>
+    static U apply(U t)
+    {
+        return t * t;
+    }
+};
+
+template<>
+struct Ease<EASE_OUT_QUAD>
+{
+    template<typename U>
+    static U apply(U t)
+    {
+        return t * (static_cast<U>(2) - t);
+    }
+};
+
+template<>
+struct Ease<EASE_IN_OUT_QUAD>
+{
+    template<typename U>
+    static U apply(U t)
+    {
+        // Distance to the closest end
+        const U u = t < static_cast<U>(0.5) ? t : static_cast<U>(1) - t;
+        const U s = static_cast<U>(2) * u * u;
+        return t < static_cast<U>(0.5) ? s : static_cast<U>(1) - s;
+    }
+};
+
+template<>
+struct Ease<EASE_IN_CUBIC>
+{
+    template<typename U>
+    static U apply(U t)
+    {
+        return t * t * t;
+    }
+};
+
+template<>
+struct Ease<EASE_OUT_CUBIC>
+{
+    template<typename U>
+    static U apply(U t)
+    {
+        const U u = static_cast<U>(1) - t;
+        return static_cast<U>(1) - u * u * u;
+    }
+};
+
+template<>
+struct Ease<EASE_IN_OUT_CUBIC>
+{
+    template<typename U>
+    static U apply(U t)
+    {
+        const U u = t < static_cast<U>(0.5) ? t : static_cast<U>(1) - t;
+        const U s = static_cast<U>(4) * u * u * u;
+        return t < static_cast<U>(0.5) ? s : static_cast<U>(1) - s;
+    }
+};
+
+template<>
+struct Ease<EASE_IN_SINE>
+{
+    template<typename U>
+    static U apply(U t)
+    {
+        return static_cast<U>(1) - math::FastMath<>::cos(t * static_cast<U>(M_PI / 2));
+    }
+};
+
+template<>
+struct Ease<EASE_OUT_SINE>
+{
+    template<typename U>
+    static U apply(U t)
+    {
+        return math::FastMath<>::sin(t * static_cast<U>(M_PI / 2));
+    }
+};
+
+template<>
+struct Ease<EASE_IN_OUT_SINE>
+{
+    template<typename U>
+    static U apply(U t)
+    {
+        return (static_cast<U>(1) - math::FastMath<>::cos(t * static_cast<U>(M_PI))) / 2;
+    }
+};
+
+template<>
+struct Ease<EASE_SMOOTHSTEP>
+{
+    template<typename U>
+    static U apply(U t)
+    {
+        return t * t * (static_cast<U>(3) - static_cast<U>(2) * t);
+    }
+};
+
+/**
+ * Apply an easing function chosen at runtime.
+ *
+ * @param easing Easing function.
+ * @param t Progress, in [0, 1].
+ * @return Position, 0 at the start and 1 at the end.
+ */
+template<typename U>
+U ease(Easing easing, U t)
+{
+    switch (easing)
+    {
+    case EASE_LINEAR:       return Ease<EASE_LINEAR>::apply(t);
+    case EASE_IN_QUAD:      return Ease<EASE_IN_QUAD>::apply(t);
+    case EASE_OUT_QUAD:     return Ease<EASE_OUT_QUAD>::apply(t);
+    case EASE_IN_OUT_QUAD:  return Ease<EASE_IN_OUT_QUAD>::apply(t);
+    case EASE_IN_CUBIC:     return Ease<EASE_IN_CUBIC>::apply(t);
+    case EASE_OUT_CUBIC:    return Ease<EASE_OUT_CUBIC>::apply(t);
+    case EASE_IN_OUT_CUBIC: return Ease<EASE_IN_OUT_CUBIC>::apply(t);
+    case EASE_IN_SINE:      return Ease<EASE_IN_SINE>::apply(t);
+    case EASE_OUT_SINE:     return Ease<EASE_OUT_SINE>::apply(t);
+    case EASE_IN_OUT_SINE:  return Ease<EASE_IN_OUT_SINE>::apply(t);
+    case EASE_SMOOTHSTEP:   return Ease<EASE_SMOOTHSTEP>::apply(t);
+    default:
+        throw std::invalid_argument("Mw.Tween.Easing: Invalid easing");
+    }
+}
+
+MW_END_NAMESPACE(tween)
+
+#endif // MW_EASING_HPP
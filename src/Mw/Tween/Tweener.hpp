@@ -0,0 +1,706 @@
+/**
+ * @file   Tweener.hpp
+ * @author Bastien Brunnenstein
+ *
+ * @details Engine running large numbers of tweens on values of one type.
+ *
+ * The active tweens are stored in one structure-of-arrays group per easing
+ * function, so a tick is one loop per group without any branch on the
+ * easing or on the state of the tweens. Finished tweens are compacted out
+ * of the loop by index, then removed by swapping the last tween of the
+ * group in their place.
+ */
+
+#ifndef MW_TWEENER_HPP
+#define MW_TWEENER_HPP
+
+#include <Mw/Config.hpp>
+
+#include <Mw/Math/Complex.hpp>
+#include <Mw/Math/Quaternion.hpp>
+#include <Mw/Math/Vector.hpp>
+#include <Mw/Tween/Easing.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/assert.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/mpl/int.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_floating_point.hpp>
+
+MW_BEGIN_NAMESPACE(tween)
+
+namespace detail
+{
+
+/**
+ * Decomposition of a tweened value into scalar components.
+ *
+ * @tparam T Value's type, a scalar.
+ */
+template<class T>
+struct TweenValue
+{
+    typedef T Scalar;
+
+    static const unsigned COMPONENTS = 1;
+
+    static Scalar get(const T & value, unsigned)
+    {
+        return value;
+    }
+
+    static void set(T & value, const Scalar (&components)[COMPONENTS])
+    {
+        value = components[0];
+    }
+
+    /**
+     * Value interpolated toward, from @a from to @a to.
+     */
+    static T end(const T &, const T & to)
+    {
+        return to;
+    }
+};
+
+template<typename T, unsigned N>
+struct TweenValue< math::Vector<T, N> >
+{
+    typedef T Scalar;
+
+    static const unsigned COMPONENTS = N;
+
+    static Scalar get(const math::Vector<T, N> & value, unsigned component)
+    {
+        return value[component];
+    }
+
+    static void set(math::Vector<T, N> & value, const Scalar (&components)[COMPONENTS])
+    {
+        for (unsigned c = 0; c < N; ++c)
+            value[c] = components[c];
+    }
+
+    static math::Vector<T, N> end(const math::Vector<T, N> &, const math::Vector<T, N> & to)
+    {
+        return to;
+    }
+};
+
+template<typename T, class Math>
+struct TweenValue< math::Complex<T, Math> >
+{
+    typedef T Scalar;
+
+    static const unsigned COMPONENTS = 2;
+
+    static Scalar get(const math::Complex<T, Math> & value, unsigned component)
+    {
+        return component == 0 ? value.getRealPart() : value.getImaginaryPart();
+    }
+
+    static void set(math::Complex<T, Math> & value, const Scalar (&components)[COMPONENTS])
+    {
+        value.set(components[0], components[1]);
+    }
+
+    static math::Complex<T, Math> end(const math::Complex<T, Math> &, const math::Complex<T, Math> & to)
+    {
+        return to;
+    }
+};
+
+/**
+ * Quaternions are interpolated as nlerp: the components are interpolated
+ * linearly, then normalized.
+ */
+template<typename T>
+struct TweenValue< math::Quaternion<T> >
+{
+    typedef T Scalar;
+
+    static const unsigned COMPONENTS = 4;
+
+    static Scalar get(const math::Quaternion<T> & value, unsigned component)
+    {
+        switch (component)
+        {
+        case 0:  return value.getW();
+        case 1:  return value.getX();
+        case 2:  return value.getY();
+        default: return value.getZ();
+        }
+    }
+
+    static void set(math::Quaternion<T> & value, const Scalar (&components)[COMPONENTS])
+    {
+        const T w = components[0], x = components[1], y = components[2], z = components[3];
+        const T norm = std::sqrt(w * w + x * x + y * y + z * z);
+        value.set(w / norm, x / norm, y / norm, z / norm);
+    }
+
+    /**
+     * The end on the shortest arc, @a to or its opposite.
+     */
+    static math::Quaternion<T> end(const math::Quaternion<T> & from, const math::Quaternion<T> & to)
+    {
+        return from.dot(to) < static_cast<T>(0) ? - to : to;
+    }
+};
+
+} // namespace detail
+
+
+/**
+ * Engine running tweens on values of type @a T.
+ *
+ * A tween moves a target value from a start to an end over a duration,
+ * following an easing function. The targets are written by tick(), they
+ * must stay valid until their tween is finished or cancelled.
+ *
+ * Tweens are referenced by handles, that become invalid when the tween is
+ * finished. The tweens and their handles are stored in pools, there is no
+ * allocation once the pools are large enough.
+ *
+ * @tparam T Value's type: a floating point scalar, or a Vector, a Complex or
+ *           a Quaternion of floating point scalars.
+ * @tparam P Payload type, given back when the tween is finished.
+ */
+template<class T, class P = std::size_t>
+class Tweener
+{
+    typedef detail::TweenValue<T> Value;
+
+    static const unsigned COMPONENTS = Value::COMPONENTS;
+
+public:
+
+    typedef typename Value::Scalar Scalar;
+
+    // Progress and rates are stored as scalars, 1 / duration needs fractions
+    BOOST_STATIC_ASSERT_MSG(boost::is_floating_point<Scalar>::value,
+                            "Mw.Tween.Tweener: Scalar type must be a floating point type");
+
+    /**
+     * Reference to a tween.
+     */
+    struct Handle
+    {
+        boost::uint32_t index;
+        boost::uint32_t generation;
+
+        bool operator == (const Handle & handle) const
+        {
+            return index == handle.index && generation == handle.generation;
+        }
+
+        bool operator != (const Handle & handle) const
+        {
+            return !(*this == handle);
+        }
+    };
+
+    /**
+     * Finished tween.
+     */
+    struct Completion
+    {
+        Handle handle;
+        P payload;
+    };
+
+private:
+
+    static const boost::uint32_t NONE = 0xFFFFFFFFu;
+
+    /**
+     * Tweens of an easing function, in structure of arrays.
+     */
+    struct Group
+    {
+        /**
+         * Progress, from 0 to 1.
+         */
+        std::vector<Scalar> progress;
+
+        /**
+         * Progress per time unit, the inverse of the duration.
+         */
+        std::vector<Scalar> rate;
+
+        /**
+         * Start and distance to the end of each component.
+         */
+        std::vector<Scalar> from[COMPONENTS];
+        std::vector<Scalar> delta[COMPONENTS];
+
+        std::vector<T *> targets;
+
+        /**
+         * Slot of each tween.
+         */
+        std::vector<boost::uint32_t> slots;
+    };
+
+    struct Slot
+    {
+        P payload;
+
+        /**
+         * Group of the tween, NONE when the slot is free.
+         */
+        boost::uint32_t group;
+
+        /**
+         * Index of the tween in its group.
+         */
+        boost::uint32_t index;
+
+        boost::uint32_t generation;
+    };
+
+    Group _groups[EASING_COUNT];
+
+    std::vector<Slot> _slots;
+    std::vector<boost::uint32_t> _freeSlots;
+
+    /**
+     * Eased positions and indices of the finished tweens of the group
+     * being ticked.
+     */
+    std::vector<Scalar> _positions;
+    std::vector<boost::uint32_t> _finished;
+
+    /**
+     * Finished tweens not delivered yet, and the ones being delivered.
+     */
+    std::vector<Completion> _completions;
+    std::vector<Completion> _delivered;
+
+public:
+
+    // Constructors
+
+    /**
+     * Default constructor.
+     */
+    Tweener()
+    {}
+
+
+    // Getters
+
+    /**
+     * Get the number of running tweens.
+     */
+    std::size_t size() const
+    {
+        return _slots.size() - _freeSlots.size();
+    }
+
+    /**
+     * Check if there are no running tweens.
+     */
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    /**
+     * Get the number of running tweens of an easing function.
+     *
+     * @param easing Easing function.
+     */
+    std::size_t size(Easing easing) const
+    {
+        return _groups[checkEasing(easing)].targets.size();
+    }
+
+    /**
+     * Check if a handle references a running tween.
+     *
+     * @param handle A handle.
+     * @return @c false once the tween is finished or cancelled.
+     */
+    bool contains(Handle handle) const
+    {
+        return handle.index < _slots.size()
+            && _slots[handle.index].generation == handle.generation
+            && _slots[handle.index].group != NONE;
+    }
+
+    /**
+     * Get the progress of a tween.
+     *
+     * @param handle Tween's handle.
+     * @return Progress, from 0 to 1.
+     */
+    Scalar getProgress(Handle handle) const
+    {
+        const Slot & slot = _slots[check(handle)];
+        return _groups[slot.group].progress[slot.index];
+    }
+
+    /**
+     * Get the payload of a tween.
+     *
+     * @param handle Tween's handle.
+     * @return Payload of the tween.
+     */
+    const P & getPayload(Handle handle) const
+    {
+        return _slots[check(handle)].payload;
+    }
+
+
+    // Modifiers
+
+    /**
+     * Start a tween.
+     *
+     * The target is first written by the next tick.
+     *
+     * @param target Tweened value.
+     * @param from Start value.
+     * @param to End value.
+     * @param duration Duration, in the unit of the ticks, greater than 0.
+     * @param easing Easing function.
+     * @param payload Payload of the tween.
+     * @return Handle of the tween.
+     */
+    Handle start(T & target, const T & from, const T & to, Scalar duration,
+                 Easing easing = EASE_LINEAR, const P & payload = P())
+    {
+        checkEasing(easing);
+        if (!(duration > static_cast<Scalar>(0)))
+            throw std::invalid_argument("Mw.Tween.Tweener: Duration must be greater than 0");
+
+        boost::uint32_t index;
+        if (_freeSlots.empty())
+        {
+            index = static_cast<boost::uint32_t>(_slots.size());
+            if (index == NONE)
+                throw std::length_error("Mw.Tween.Tweener: Too many tweens");
+
+            Slot slot = Slot();
+            slot.group = NONE;
+            slot.generation = 0;
+            _slots.push_back(slot);
+        }
+        else
+        {
+            index = _freeSlots.back();
+            _freeSlots.pop_back();
+        }
+
+        Group & group = _groups[easing];
+        const T end = Value::end(from, to);
+
+        Slot & slot = _slots[index];
+        slot.payload = payload;
+        slot.group = static_cast<boost::uint32_t>(easing);
+        slot.index = static_cast<boost::uint32_t>(group.targets.size());
+
+        group.progress.push_back(static_cast<Scalar>(0));
+        group.rate.push_back(static_cast<Scalar>(1) / duration);
+        for (unsigned c = 0; c < COMPONENTS; ++c)
+        {
+            const Scalar start = Value::get(from, c);
+            group.from[c].push_back(start);
+            group.delta[c].push_back(Value::get(end, c) - start);
+        }
+        group.targets.push_back(&target);
+        group.slots.push_back(index);
+
+        Handle handle = { index, slot.generation };
+        return handle;
+    }
+
+    /**
+     * Start a tween from the current value of its target.
+     *
+     * @param target Tweened value, and start value.
+     * @param to End value.
+     * @param duration Duration, in the unit of the ticks, greater than 0.
+     * @param easing Easing function.
+     * @param payload Payload of the tween.
+     * @return Handle of the tween.
+     */
+    Handle startTo(T & target, const T & to, Scalar duration,
+                   Easing easing = EASE_LINEAR, const P & payload = P())
+    {
+        const T from = target;
+        return start(target, from, to, duration, easing, payload);
+    }
+
+    /**
+     * Stop a tween, leaving its target as it is.
+     *
+     * @param handle Tween's handle, invalid after the call.
+     * @return @c false if the tween was already finished or cancelled.
+     */
+    bool cancel(Handle handle)
+    {
+        if (!contains(handle))
+            return false;
+
+        remove(handle.index);
+        return true;
+    }
+
+    /**
+     * Finish a tween now: write the end value to its target, and deliver
+     * its completion with the next tick.
+     *
+     * @param handle Tween's handle, invalid after the call.
+     * @return @c false if the tween was already finished or cancelled.
+     */
+    bool complete(Handle handle)
+    {
+        if (!contains(handle))
+            return false;
+
+        const Slot & slot = _slots[handle.index];
+        const Group & group = _groups[slot.group];
+
+        Scalar values[COMPONENTS];
+        for (unsigned c = 0; c < COMPONENTS; ++c)
+            values[c] = group.from[c][slot.index] + group.delta[c][slot.index];
+        Value::set(*group.targets[slot.index], values);
+
+        Completion completion = { handle, slot.payload };
+        _completions.push_back(completion);
+
+        remove(handle.index);
+        return true;
+    }
+
+    /**
+     * Cancel all the tweens.
+     *
+     * Handles of the tweens become invalid, pending completions are
+     * dropped.
+     */
+    void clear()
+    {
+        for (std::size_t i = 0; i < _slots.size(); ++i)
+            if (_slots[i].group != NONE)
+            {
+                _slots[i].group = NONE;
+                ++_slots[i].generation;
+                _freeSlots.push_back(static_cast<boost::uint32_t>(i));
+            }
+
+        for (unsigned e = 0; e < EASING_COUNT; ++e)
+        {
+            Group & group = _groups[e];
+            group.progress.clear();
+            group.rate.clear();
+            for (unsigned c = 0; c < COMPONENTS; ++c)
+            {
+                group.from[c].clear();
+                group.delta[c].clear();
+            }
+            group.targets.clear();
+            group.slots.clear();
+        }
+
+        _completions.clear();
+    }
+
+
+    // Ticking
+
+    /**
+     * Advance all the tweens and write their targets.
+     *
+     * Completions of the finished tweens are dropped.
+     *
+     * @param elapsed Elapsed time, not negative.
+     */
+    void tick(Scalar elapsed)
+    {
+        advanceGroups(elapsed, boost::mpl::int_<0>());
+        _completions.clear();
+    }
+
+    /**
+     * Advance all the tweens, write their targets, and deliver the
+     * completions of the finished tweens in one call.
+     *
+     * The callback may start, cancel and complete tweens, but must not
+     * tick. Tweens it completes are delivered with the next tick.
+     *
+     * @param elapsed Elapsed time, not negative.
+     * @param callback Function object called as
+     *                 <tt>callback(const Completion * completions, std::size_t count)</tt>,
+     *                 only when tweens finished, in no particular order.
+     */
+    template<class F>
+    void tick(Scalar elapsed, F callback)
+    {
+        BOOST_ASSERT_MSG(_delivered.empty(), "Mw.Tween.Tweener: Tick from a completion callback");
+
+        advanceGroups(elapsed, boost::mpl::int_<0>());
+        if (_completions.empty())
+            return;
+
+        _delivered.swap(_completions);
+        callback(&_delivered[0], _delivered.size());
+        _delivered.clear();
+    }
+
+private:
+
+    boost::uint32_t check(Handle handle) const
+    {
+        if (!contains(handle))
+            throw std::invalid_argument("Mw.Tween.Tweener: Invalid handle");
+
+        return handle.index;
+    }
+
+    static unsigned checkEasing(Easing easing)
+    {
+        if (static_cast<unsigned>(easing) >= EASING_COUNT)
+            throw std::invalid_argument("Mw.Tween.Tweener: Invalid easing");
+
+        return static_cast<unsigned>(easing);
+    }
+
+    template<int E>
+    void advanceGroups(Scalar elapsed, boost::mpl::int_<E>)
+    {
+        advance< Ease<static_cast<Easing>(E)> >(_groups[E], elapsed);
+        advanceGroups(elapsed, boost::mpl::int_<E + 1>());
+    }
+
+    void advanceGroups(Scalar, boost::mpl::int_<EASING_COUNT>)
+    {}
+
+    /**
+     * Advance the tweens of a group, write their targets and remove the
+     * finished ones.
+     */
+    template<class E>
+    void advance(Group & group, Scalar elapsed)
+    {
+        BOOST_ASSERT(elapsed >= static_cast<Scalar>(0));
+
+        const std::size_t count = group.targets.size();
+        if (!count)
+            return;
+
+        if (_finished.size() < count)
+        {
+            _finished.resize(count);
+            _positions.resize(count);
+        }
+
+        Scalar * progress = &group.progress[0];
+        const Scalar * rate = &group.rate[0];
+        Scalar * positions = &_positions[0];
+        boost::uint32_t * finished = &_finished[0];
+
+        // Progress and easing, apart from the writes to the targets that
+        // may alias the arrays
+        const Scalar one = static_cast<Scalar>(1);
+        std::size_t finishedCount = 0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            Scalar t = progress[i] + elapsed * rate[i];
+            t = t < one ? t : one;
+            progress[i] = t;
+
+            // Exactly at the end when finished, whatever the easing's rounding
+            positions[i] = t < one ? E::apply(t) : one;
+
+            finished[finishedCount] = static_cast<boost::uint32_t>(i);
+            finishedCount += t < one ? 0 : 1;
+        }
+
+        write(group, positions, count);
+
+        // From the last one, so the tweens swapped in place are still running
+        while (finishedCount-- > 0)
+        {
+            const boost::uint32_t index = group.slots[finished[finishedCount]];
+            Completion completion = { { index, _slots[index].generation }, _slots[index].payload };
+            _completions.push_back(completion);
+            remove(index);
+        }
+    }
+
+    /**
+     * Write the targets of a group, at their eased positions.
+     */
+    static void write(const Group & group, const Scalar * positions, std::size_t count)
+    {
+        const Scalar * from[COMPONENTS];
+        const Scalar * delta[COMPONENTS];
+        for (unsigned c = 0; c < COMPONENTS; ++c)
+        {
+            from[c] = &group.from[c][0];
+            delta[c] = &group.delta[c][0];
+        }
+        T * const * targets = &group.targets[0];
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            Scalar values[COMPONENTS];
+            for (unsigned c = 0; c < COMPONENTS; ++c)
+                values[c] = from[c][i] + delta[c][i] * positions[i];
+            Value::set(*targets[i], values);
+        }
+    }
+
+    /**
+     * Remove a tween from its group and free its slot.
+     */
+    void remove(boost::uint32_t index)
+    {
+        Slot & slot = _slots[index];
+        Group & group = _groups[slot.group];
+
+        const std::size_t last = group.targets.size() - 1;
+        if (slot.index != last)
+        {
+            const std::size_t i = slot.index;
+            group.progress[i] = group.progress[last];
+            group.rate[i] = group.rate[last];
+            for (unsigned c = 0; c < COMPONENTS; ++c)
+            {
+                group.from[c][i] = group.from[c][last];
+                group.delta[c][i] = group.delta[c][last];
+            }
+            group.targets[i] = group.targets[last];
+            group.slots[i] = group.slots[last];
+            _slots[group.slots[i]].index = slot.index;
+        }
+
+        group.progress.pop_back();
+        group.rate.pop_back();
+        for (unsigned c = 0; c < COMPONENTS; ++c)
+        {
+            group.from[c].pop_back();
+            group.delta[c].pop_back();
+        }
+        group.targets.pop_back();
+        group.slots.pop_back();
+
+        slot.group = NONE;
+        ++slot.generation;
+        _freeSlots.push_back(index);
+    }
+
+};
+// class Tweener
+
+MW_END_NAMESPACE(tween)
+
+#endif // MW_TWEENER_HPP
@@ -0,0 +1,318 @@
+/**
+ * @file   BigIntegerTest.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <Mw/Math/BigInteger.hpp>
+
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+namespace {
+
+typedef mw::math::BigInteger Big;
+typedef mw::math::detail::BigMagnitude Magnitude;
+
+boost::int64_t random64()
+{
+    boost::uint64_t value = 0;
+    for (int i = 0; i < 4; ++i)
+        value = (value << 16) ^ static_cast<boost::uint64_t>(std::rand());
+
+    // Mixed magnitudes
+    return static_cast<boost::int64_t>(value) >> (std::rand() % 63);
+}
+
+/**
+ * Random value of @c limbs limbs.
+ */
+Big randomBig(std::size_t limbs)
+{
+    Big value = 1 + std::rand() % 0xFFFF;
+    for (std::size_t i = 0; i < limbs; ++i)
+        value = value * Big(boost::int64_t(1) << 32) + Big(static_cast<boost::int64_t>(std::rand()) * 2 + std::rand() % 2);
+    return std::rand() % 2 ? value : - value;
+}
+
+Big power(Big value, unsigned exponent)
+{
+    Big result = 1;
+    for (unsigned i = 0; i < exponent; ++i)
+        result *= value;
+    return result;
+}
+
+Big euclidGcd(Big a, Big b)
+{
+    while (b != Big())
+    {
+        const Big tmp = a % b;
+        a = b;
+        b = tmp;
+    }
+    return a < Big() ? - a : a;
+}
+
+#ifdef MW_HAS_INT128
+
+std::string toString(mw::math::int128_t value)
+{
+    if (value == 0)
+        return "0";
+
+    const bool negative = value < 0;
+    std::string digits;
+    while (value != 0)
+    {
+        const int digit = static_cast<int>(value % 10);
+        digits.insert(digits.begin(), static_cast<char>('0' + (negative ? - digit : digit)));
+        value /= 10;
+    }
+    return negative ? "-" + digits : digits;
+}
+
+#endif // MW_HAS_INT128
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(BigInteger)
+
+BOOST_AUTO_TEST_CASE(Inline)
+{
+    const boost::int64_t max = std::numeric_limits<boost::int64_t>::max();
+    const boost::int64_t min = std::numeric_limits<boost::int64_t>::min();
+
+    Big a = max;
+    BOOST_CHECK(a.isInline());
+    BOOST_CHECK_EQUAL(a.toInt64(), max);
+
+    a += 1;
+    BOOST_CHECK(!a.isInline());
+    BOOST_CHECK_EQUAL(a.toString(), "9223372036854775808");
+    BOOST_CHECK_THROW(a.toInt64(), std::overflow_error);
+    BOOST_CHECK(a > Big(max));
+
+    a -= 1;
+    BOOST_CHECK(a.isInline());
+    BOOST_CHECK_EQUAL(a, Big(max));
+
+    Big b = min;
+    BOOST_CHECK(b.isInline());
+    BOOST_CHECK(!(- b).isInline());
+    BOOST_CHECK_EQUAL(- - b, b);
+    BOOST_CHECK(Big(-1) - Big(min) == Big(max));
+    BOOST_CHECK_EQUAL((b / -1).toString(), "9223372036854775808");
+    BOOST_CHECK_EQUAL((b * b).toString(), "85070591730234615865843651857942052864");
+    BOOST_CHECK(((b * b) / b).isInline());
+    BOOST_CHECK(b - 1 < b);
+    BOOST_CHECK(- b > Big(max));
+
+    BOOST_CHECK_THROW(a / Big(), std::domain_error);
+    BOOST_CHECK_THROW(power(a, 3) % Big(), std::domain_error);
+}
+
+#ifdef MW_HAS_INT128
+
+BOOST_AUTO_TEST_CASE(Native)
+{
+    typedef mw::math::int128_t W;
+
+    std::srand(7);
+    for (int i = 0; i < 20000; ++i)
+    {
+        const boost::int64_t x = random64(), y = random64(), z = random64();
+        const Big a = x, b = y;
+
+        BOOST_CHECK_EQUAL((a + b).toString(), toString(W(x) + y));
+        BOOST_CHECK_EQUAL((a - b).toString(), toString(W(x) - y));
+        BOOST_CHECK_EQUAL((a * b).toString(), toString(W(x) * y));
+        BOOST_CHECK_EQUAL(a < b, x < y);
+
+        if (z != 0)
+        {
+            const W product = W(x) * y;
+            BOOST_CHECK_EQUAL((a * b / Big(z)).toString(), toString(product / z));
+            BOOST_CHECK_EQUAL((a * b % Big(z)).toString(), toString(product % z));
+            BOOST_CHECK_EQUAL((a * b).toDouble(), static_cast<double>(product));
+        }
+    }
+}
+
+#endif // MW_HAS_INT128
+
+BOOST_AUTO_TEST_CASE(Division)
+{
+    const std::size_t sizes[] = { 1, 2, 3, 5, 17, 31, 32, 33, 47, 64, 100, 131 };
+    const std::size_t count = sizeof(sizes) / sizeof(sizes[0]);
+
+    std::srand(11);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        for (std::size_t j = 0; j < count; ++j)
+        {
+            const Big a = randomBig(sizes[i]), b = randomBig(sizes[j]);
+
+            Big q, r;
+            Big::divide(a, b, &q, &r);
+            BOOST_CHECK_EQUAL(q * b + r, a);
+            BOOST_CHECK((r < Big() ? - r : r) < (b < Big() ? - b : b));
+            BOOST_CHECK(r == Big() || (r < Big()) == (a < Big()));
+
+            BOOST_CHECK_EQUAL((a * b) / b, a);
+            BOOST_CHECK_EQUAL((a * b) % a, Big());
+        }
+    }
+
+    // Quotient limbs of all bits set
+    const Big base = power(Big(2), 96);
+    const Big divisor = base - Big(1);
+    const Big dividend = divisor * power(Big(2), 64) + divisor - Big(1);
+    BOOST_CHECK_EQUAL(dividend / divisor, power(Big(2), 64));
+    BOOST_CHECK_EQUAL(dividend % divisor, divisor - Big(1));
+}
+
+BOOST_AUTO_TEST_CASE(Karatsuba)
+{
+    std::srand(13);
+    const std::size_t sizes[] = { 32, 33, 63, 64, 65, 100, 257 };
+    for (std::size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+    {
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            const std::size_t n = sizes[i], m = sizes[i] * (j + 1) + j;
+
+            Magnitude::Limbs a(n), b(m);
+            for (std::size_t k = 0; k < n; ++k)
+                a[k] = static_cast<Magnitude::Limb>(std::rand()) * 4 + (k == 0 ? 0xFFFFFFFFu : 3u);
+            for (std::size_t k = 0; k < m; ++k)
+                b[k] = k % 7 ? 0xFFFFFFFFu : static_cast<Magnitude::Limb>(std::rand()) + 1;
+
+            Magnitude::Limbs expected(n + m), product;
+            Magnitude::multiplySchool(&a[0], n, &b[0], m, &expected[0]);
+            Magnitude::trim(expected);
+
+            Magnitude::multiply(a, b, product);
+            BOOST_CHECK(product == expected);
+            Magnitude::multiply(b, a, product);
+            BOOST_CHECK(product == expected);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(String)
+{
+    const char * values[] = {
+        "0", "1", "-1", "999999999", "1000000000", "-1000000000000000000000000000001",
+        "9223372036854775807", "-9223372036854775808", "18446744073709551616",
+        "123456789012345678901234567890123456789012345678901234567890"
+    };
+    for (std::size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i)
+        BOOST_CHECK_EQUAL(Big::fromString(values[i]).toString(), values[i]);
+
+    BOOST_CHECK_EQUAL(Big::fromString("+0042"), Big(42));
+    BOOST_CHECK_EQUAL(Big::fromString("-0"), Big());
+    BOOST_CHECK_EQUAL(power(Big(10), 30).toString(), "1" + std::string(30, '0'));
+    BOOST_CHECK_EQUAL(power(Big(-3), 41).toString(), "-36472996377170786403");
+
+    BOOST_CHECK_THROW(Big::fromString(""), std::invalid_argument);
+    BOOST_CHECK_THROW(Big::fromString("-"), std::invalid_argument);
+    BOOST_CHECK_THROW(Big::fromString("12a"), std::invalid_argument);
+
+    BOOST_CHECK_EQUAL(power(Big(2), 100).toDouble(), std::ldexp(1.0, 100));
+    BOOST_CHECK_EQUAL((- power(Big(2), 64)).toDouble(), - std::ldexp(1.0, 64));
+}
+
+BOOST_AUTO_TEST_CASE(Gcd)
+{
+    BOOST_CHECK_EQUAL(Big::gcd(Big(), Big()), Big());
+    BOOST_CHECK_EQUAL(Big::gcd(Big(-12), Big()), Big(12));
+    BOOST_CHECK_EQUAL(Big::gcd(Big(std::numeric_limits<boost::int64_t>::min()), Big()).toString(),
+                      "9223372036854775808");
+
+    std::srand(17);
+    const std::size_t sizes[] = { 1, 2, 3, 4, 8, 20, 50 };
+    for (std::size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+    {
+        for (std::size_t j = 0; j <= i; ++j)
+        {
+            const Big a = randomBig(sizes[i]), b = randomBig(sizes[j]), g = randomBig(sizes[j]);
+            const Big expected = euclidGcd(a, b);
+
+            BOOST_CHECK_EQUAL(Big::gcd(a, b), expected);
+            BOOST_CHECK_EQUAL(Big::gcd(b, a), expected);
+            BOOST_CHECK_EQUAL(Big::gcd(a * g, b * g), expected * (g < Big() ? - g : g));
+        }
+    }
+
+    // Consecutive Fibonacci numbers, worst case of Euclid
+    Big f1 = 1, f2 = 1;
+    for (int i = 0; i < 500; ++i)
+    {
+        const Big f3 = f1 + f2;
+        f1 = f2;
+        f2 = f3;
+    }
+    BOOST_CHECK_EQUAL(Big::gcd(f1, f2), Big(1));
+    BOOST_CHECK_EQUAL(Big::gcd(f1 * f1, f2 * f1), f1);
+}
+
+BOOST_AUTO_TEST_CASE(Rational)
+{
+    typedef mw::math::BigRational Rat;
+
+    Rat harmonic;
+    for (int k = 1; k <= 30; ++k)
+        harmonic += Rat(1, k);
+    BOOST_CHECK_EQUAL(harmonic.getNumerator().toString(), "9304682830147");
+    BOOST_CHECK_EQUAL(harmonic.getDenominator().toString(), "2329089562800");
+
+    for (int k = 31; k <= 100; ++k)
+        harmonic += Rat(1, k);
+    BOOST_CHECK_EQUAL(harmonic.getNumerator().toString(), "14466636279520351160221518043104131447711");
+    BOOST_CHECK_EQUAL(harmonic.getDenominator().toString(), "2788815009188499086581352357412492142272");
+    BOOST_CHECK_CLOSE((double) harmonic, 5.187377517639621, 1e-12);
+
+    for (int k = 100; k >= 1; --k)
+        harmonic -= Rat(1, k);
+    BOOST_CHECK_EQUAL(harmonic, Rat());
+
+    const boost::int64_t max = std::numeric_limits<boost::int64_t>::max();
+    const Rat big = Rat(max) * Rat(max) / Rat(3, max);
+    BOOST_CHECK_EQUAL(big.getNumerator(), power(Big(max), 3));
+    BOOST_CHECK_EQUAL(big.getDenominator(), Big(3));
+    BOOST_CHECK(big > Rat(max));
+    BOOST_CHECK(Rat() - big < Rat(- max));
+    BOOST_CHECK_EQUAL(big * Rat(3) / Rat(max) / Rat(max), Rat(max));
+    BOOST_CHECK_THROW(big / Rat(), std::invalid_argument);
+
+    // Same results as 64 bits fractions when they fit
+    typedef mw::math::Rational<boost::int64_t, mw::math::ThrowOnOverflow> Small;
+    std::srand(19);
+    for (int i = 0; i < 5000; ++i)
+    {
+        const boost::int64_t n1 = std::rand() - RAND_MAX / 2, d1 = std::rand() + 1;
+        const boost::int64_t n2 = std::rand() - RAND_MAX / 2, d2 = std::rand() + 1;
+        const Small a(n1, d1), b(n2, d2);
+        const Rat x(n1, d1), y(n2, d2);
+
+        const Small sum = a + b, product = a * b;
+        BOOST_CHECK_EQUAL((x + y).getNumerator(), Big(sum.getNumerator()));
+        BOOST_CHECK_EQUAL((x + y).getDenominator(), Big(sum.getDenominator()));
+        BOOST_CHECK_EQUAL((x * y).getNumerator(), Big(product.getNumerator()));
+        BOOST_CHECK_EQUAL((x * y).getDenominator(), Big(product.getDenominator()));
+        BOOST_CHECK_EQUAL(x < y, a < b);
+        BOOST_CHECK(x.getNumerator().isInline());
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
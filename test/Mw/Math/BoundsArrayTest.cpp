@@ -0,0 +1,146 @@
+/**
+ * @file   BoundsArrayTest.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <boost/mpl/list.hpp>
+
+#include <Mw/Math/BoundsArray.hpp>
+
+#include <vector>
+
+typedef boost::mpl::list<float, double> test_types;
+
+namespace {
+
+template<typename T>
+mw::math::Vector<T, 2> vec2(T x, T y)
+{
+    mw::math::Vector<T, 2> v;
+    v[0] = x;
+    v[1] = y;
+    return v;
+}
+
+template<typename T>
+std::vector<mw::math::Bounds<T, 2> > makeBounds(unsigned count)
+{
+    std::vector<mw::math::Bounds<T, 2> > bounds;
+    for (unsigned i = 0; i < count; ++i)
+    {
+        T x = static_cast<T>(i % 11);
+        T y = static_cast<T>(i % 7);
+        bounds.push_back(mw::math::Bounds<T, 2>(vec2(x, y), vec2(x + static_cast<T>(i % 3), y + 2)));
+    }
+    return bounds;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(BoundsArray)
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(IsIntersecting, T, test_types)
+{
+    using mw::math::Bounds;
+
+    Bounds<T, 2> a(vec2<T>(0, 0), vec2<T>(2, 2));
+    Bounds<T, 2> b(vec2<T>(1, 1), vec2<T>(3, 3));
+    Bounds<T, 2> c(vec2<T>(2, 0), vec2<T>(3, 1));
+    Bounds<T, 2> empty(vec2<T>(1, 1), vec2<T>(1, 2));
+
+    BOOST_CHECK(a.isIntersecting(b));
+    BOOST_CHECK(b.isIntersecting(a));
+    BOOST_CHECK(!a.isIntersecting(c));
+    BOOST_CHECK(!a.isIntersecting(empty));
+
+    BOOST_CHECK_EQUAL(a.isIntersecting(b), !a.getIntersection(b).isEmpty());
+    BOOST_CHECK_EQUAL(a.isIntersecting(c), !a.getIntersection(c).isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Queries, T, test_types)
+{
+    using mw::math::Bounds;
+    using mw::math::BoundsArray;
+
+    std::vector<Bounds<T, 2> > bounds = makeBounds<T>(100);
+    BoundsArray<T, 2> array(bounds.begin(), bounds.end());
+    BOOST_CHECK_EQUAL(array.size(), 100u);
+
+    Bounds<T, 2> query(vec2<T>(2.5, 1), vec2<T>(5, 3.5));
+
+    typename BoundsArray<T, 2>::Mask mask;
+    typename BoundsArray<T, 2>::Indices indices;
+    array.testIntersecting(query, mask);
+    array.findIntersecting(query, indices);
+
+    BOOST_REQUIRE_EQUAL(mask.size(), 4u);
+    std::size_t expected = 0;
+    for (std::size_t i = 0; i < bounds.size(); ++i)
+    {
+        bool hit = bounds[i].isIntersecting(query);
+        BOOST_CHECK_EQUAL(((mask[i / 32] >> (i % 32)) & 1u) != 0, hit);
+        if (hit)
+        {
+            BOOST_REQUIRE(expected < indices.size());
+            BOOST_CHECK_EQUAL(indices[expected++], i);
+        }
+    }
+    BOOST_CHECK_EQUAL(indices.size(), expected);
+
+    mw::math::Vector<T, 2> point = vec2<T>(3, 4);
+    array.testPointInside(point, mask);
+    indices.clear();
+    array.findPointInside(point, indices);
+
+    expected = 0;
+    for (std::size_t i = 0; i < bounds.size(); ++i)
+    {
+        bool hit = bounds[i].hasPointInside(point);
+        BOOST_CHECK_EQUAL(((mask[i / 32] >> (i % 32)) & 1u) != 0, hit);
+        if (hit)
+            BOOST_CHECK_EQUAL(indices[expected++], i);
+    }
+    BOOST_CHECK_EQUAL(indices.size(), expected);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(ManyQueries, T, test_types)
+{
+    using mw::math::Bounds;
+    using mw::math::BoundsArray;
+
+    std::vector<Bounds<T, 2> > bounds = makeBounds<T>(70);
+    std::vector<Bounds<T, 2> > queries = makeBounds<T>(45);
+    BoundsArray<T, 2> array(bounds.begin(), bounds.end());
+    BoundsArray<T, 2> queryArray(queries.begin(), queries.end());
+
+    typename BoundsArray<T, 2>::Pairs pairs;
+    array.findIntersecting(queryArray, pairs);
+
+    std::size_t expected = 0;
+    for (std::size_t q = 0; q < queries.size(); ++q)
+        for (std::size_t i = 0; i < bounds.size(); ++i)
+            if (queries[q].isIntersecting(bounds[i]))
+            {
+                BOOST_REQUIRE(expected < pairs.size());
+                BOOST_CHECK_EQUAL(pairs[expected].first, q);
+                BOOST_CHECK_EQUAL(pairs[expected].second, i);
+                ++expected;
+            }
+    BOOST_CHECK_EQUAL(pairs.size(), expected);
+
+    // Pairwise test
+    BoundsArray<T, 2> shifted(queries.begin(), queries.end());
+    BoundsArray<T, 2> head(bounds.begin(), bounds.begin() + 45);
+    typename BoundsArray<T, 2>::Mask mask;
+    head.testIntersecting(shifted, mask);
+    for (std::size_t i = 0; i < 45; ++i)
+        BOOST_CHECK_EQUAL(((mask[i / 32] >> (i % 32)) & 1u) != 0, bounds[i].isIntersecting(queries[i]));
+
+    BOOST_CHECK(array.get(3).getLowerLimit() == bounds[3].getLowerLimit());
+    BOOST_CHECK_THROW(array.get(70), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,219 @@
+/**
+ * @file   BvhTest.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <boost/iterator/counting_iterator.hpp>
+#include <boost/mpl/list.hpp>
+
+#include <Mw/Math/Bvh.hpp>
+#include <Mw/Thread/TaskPool.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+typedef boost::mpl::list<float, double> test_types;
+
+namespace {
+
+template<typename T>
+mw::math::Vector<T, 3> vec3(T x, T y, T z)
+{
+    mw::math::Vector<T, 3> v;
+    v[0] = x;
+    v[1] = y;
+    v[2] = z;
+    return v;
+}
+
+template<typename T>
+std::vector<mw::math::Bounds<T, 3> > makeBounds(unsigned count)
+{
+    std::vector<mw::math::Bounds<T, 3> > bounds;
+    for (unsigned i = 0; i < count; ++i)
+    {
+        mw::math::Vector<T, 3> p = vec3<T>(i % 17, (i * 7) % 13, (i * 3) % 11);
+        mw::math::Vector<T, 3> s = vec3<T>(1 + i % 3, 1 + i % 2, 0.5);
+        bounds.push_back(mw::math::Bounds<T, 3>(p, p + s));
+    }
+    return bounds;
+}
+
+template<typename T>
+bool rayCrosses(const mw::math::Bounds<T, 3> & b, const mw::math::Vector<T, 3> & origin,
+                const mw::math::Vector<T, 3> & direction, T maxDistance)
+{
+    T tmin = 0, tmax = maxDistance;
+    for (unsigned c = 0; c < 3; ++c)
+    {
+        if (direction[c] == 0)
+        {
+            if (origin[c] < b.getLowerLimit()[c] || origin[c] > b.getUpperLimit()[c])
+                return false;
+            continue;
+        }
+        T t0 = (b.getLowerLimit()[c] - origin[c]) / direction[c];
+        T t1 = (b.getUpperLimit()[c] - origin[c]) / direction[c];
+        tmin = std::max(tmin, std::min(t0, t1));
+        tmax = std::min(tmax, std::max(t0, t1));
+    }
+    return tmin <= tmax;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(Bvh)
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Queries, T, test_types)
+{
+    using mw::math::Bounds;
+    using mw::math::Vector;
+
+    std::vector<Bounds<T, 3> > bounds = makeBounds<T>(500);
+    mw::math::Bvh<T, 3> bvh;
+    bvh.build(bounds.begin(), bounds.end());
+    BOOST_CHECK_EQUAL(bvh.size(), 500u);
+
+    Bounds<T, 3> box(vec3<T>(3, 2, 1), vec3<T>(6.5, 5, 4));
+    Vector<T, 3> point = vec3<T>(8, 4.5, 2);
+    Vector<T, 3> origin = vec3<T>(-1, 3.5, 2.25);
+    Vector<T, 3> direction = vec3<T>(1, 0.25, 0);
+
+    for (unsigned pass = 0; pass < 2; ++pass)
+    {
+        std::vector<std::size_t> boxHits, pointHits, rayHits;
+        bvh.queryBounds(box, std::back_inserter(boxHits));
+        bvh.queryPoint(point, std::back_inserter(pointHits));
+        bvh.queryRay(origin, direction, static_cast<T>(10), std::back_inserter(rayHits));
+
+        std::sort(boxHits.begin(), boxHits.end());
+        std::sort(pointHits.begin(), pointHits.end());
+        std::sort(rayHits.begin(), rayHits.end());
+
+        std::vector<std::size_t> boxExpected, pointExpected, rayExpected;
+        for (std::size_t i = 0; i < bounds.size(); ++i)
+        {
+            if (bounds[i].isIntersecting(box))
+                boxExpected.push_back(i);
+            if (bounds[i].hasPointInside(point))
+                pointExpected.push_back(i);
+            if (rayCrosses(bounds[i], origin, direction, static_cast<T>(10)))
+                rayExpected.push_back(i);
+        }
+
+        BOOST_CHECK(!boxExpected.empty());
+        BOOST_CHECK(!pointExpected.empty());
+        BOOST_CHECK(boxHits == boxExpected);
+        BOOST_CHECK(pointHits == pointExpected);
+        BOOST_CHECK(!rayExpected.empty());
+        BOOST_CHECK(rayHits == rayExpected);
+
+        // Move every item and refit
+        for (std::size_t i = 0; i < bounds.size(); ++i)
+        {
+            Vector<T, 3> offset = vec3<T>(static_cast<T>(i % 5) - 2, 1, static_cast<T>(i % 2));
+            bounds[i] = Bounds<T, 3>(bounds[i].getLowerLimit() + offset, bounds[i].getUpperLimit() + offset);
+            bvh.setBounds(i, bounds[i]);
+        }
+        bvh.refit();
+    }
+
+    BOOST_CHECK_THROW(bvh.setBounds(500, box), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(Payloads)
+{
+    using mw::math::Bounds;
+
+    std::vector<Bounds<float, 3> > bounds = makeBounds<float>(3);
+    const char * names[] = { "a", "b", "c" };
+
+    mw::math::Bvh<float, 3, const char *> bvh(bounds.begin(), bounds.end(), names);
+
+    std::vector<const char *> hits;
+    bvh.queryPoint(bounds[1].getLowerLimit(), std::back_inserter(hits));
+    BOOST_CHECK(std::find(hits.begin(), hits.end(), names[1]) != hits.end());
+
+    mw::math::Bvh<float, 3> empty;
+    std::vector<std::size_t> none;
+    BOOST_CHECK(empty.empty());
+    empty.queryPoint(bounds[0].getLowerLimit(), std::back_inserter(none));
+    BOOST_CHECK(none.empty());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Morton, T, test_types)
+{
+    using mw::math::Bounds;
+
+    typedef mw::math::Bvh<T, 3> Bvh;
+
+    std::vector<Bounds<T, 3> > bounds = makeBounds<T>(500);
+    Bvh bvh;
+    bvh.build(bounds.begin(), bounds.end(), Bvh::BUILD_MORTON);
+
+    Bounds<T, 3> box(vec3<T>(3, 2, 1), vec3<T>(6.5, 5, 4));
+
+    std::vector<std::size_t> hits, expected;
+    bvh.queryBounds(box, std::back_inserter(hits));
+    std::sort(hits.begin(), hits.end());
+
+    for (std::size_t i = 0; i < bounds.size(); ++i)
+        if (bounds[i].isIntersecting(box))
+            expected.push_back(i);
+
+    BOOST_CHECK(!expected.empty());
+    BOOST_CHECK(hits == expected);
+}
+
+BOOST_AUTO_TEST_CASE(ParallelBuild)
+{
+    using mw::math::Bounds;
+
+    typedef mw::math::Bvh<float, 3> Bvh;
+
+    // Large enough to be split between tasks
+    std::vector<Bounds<float, 3> > bounds;
+    for (unsigned i = 0; i < 50000; ++i)
+    {
+        mw::math::Vector<float, 3> p = vec3<float>(i % 97, (i * 31) % 89, (i * 7) % 83);
+        bounds.push_back(Bounds<float, 3>(p, p + vec3<float>(1.5f, 1, 0.5f + i % 3)));
+    }
+
+    const Bvh::BuildMethod methods[] = { Bvh::BUILD_SAH, Bvh::BUILD_MORTON };
+    for (unsigned m = 0; m < 2; ++m)
+    {
+        Bvh sequential;
+        sequential.build(bounds.begin(), bounds.end(), boost::counting_iterator<std::size_t>(0), methods[m]);
+
+        for (unsigned threads = 1; threads <= 4; ++threads)
+        {
+            mw::thread::TaskPool pool(threads);
+            Bvh parallel;
+            // Index payloads, the same as the counting iterator
+            parallel.build(bounds.begin(), bounds.end(), pool, methods[m]);
+
+            // Same tree, whatever the number of threads
+            const std::vector<Bvh::Node> & a = sequential.getNodes();
+            const std::vector<Bvh::Node> & b = parallel.getNodes();
+            BOOST_REQUIRE_EQUAL(a.size(), b.size());
+            for (std::size_t n = 0; n < a.size(); ++n)
+            {
+                BOOST_CHECK_EQUAL(a[n].offset, b[n].offset);
+                BOOST_CHECK_EQUAL(a[n].count, b[n].count);
+                BOOST_CHECK(std::equal(a[n].lower, a[n].lower + 3, b[n].lower));
+                BOOST_CHECK(std::equal(a[n].upper, a[n].upper + 3, b[n].upper));
+            }
+
+            std::vector<std::size_t> x, y;
+            sequential.queryPoint(vec3<float>(10, 20, 30), std::back_inserter(x));
+            parallel.queryPoint(vec3<float>(10, 20, 30), std::back_inserter(y));
+            BOOST_CHECK(x == y);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
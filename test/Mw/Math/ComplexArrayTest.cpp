@@ -0,0 +1,137 @@
+/**
+ * @file   ComplexArrayTest.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <boost/mpl/list.hpp>
+
+#include <Mw/Math/ComplexArray.hpp>
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+typedef boost::mpl::list<float, double> test_types;
+
+namespace {
+
+template<typename T>
+std::vector<mw::math::Complex<T> > makeComplexes(unsigned count, unsigned seed)
+{
+    std::vector<mw::math::Complex<T> > numbers(count);
+    for (unsigned i = 0; i < count; ++i)
+        numbers[i].set(static_cast<T>((i * seed) % 13) - 6,
+                       static_cast<T>((i * seed + 5) % 11) * static_cast<T>(0.25) - 1);
+    return numbers;
+}
+
+/**
+ * Sign bit test, -0 is negative.
+ */
+template<typename T>
+bool isNegative(T value)
+{
+    return value < 0 || (value == 0 && 1 / value < 0);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(ComplexArray)
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Conversions, T, test_types)
+{
+    using mw::math::Complex;
+    using mw::math::ComplexArray;
+
+    std::vector<Complex<T> > aos = makeComplexes<T>(37, 3);
+    ComplexArray<T> soa(aos.begin(), aos.end());
+
+    BOOST_CHECK_EQUAL(soa.size(), 37u);
+    BOOST_CHECK_EQUAL(soa.realLane()[5], aos[5].getRealPart());
+    BOOST_CHECK_EQUAL(soa.imaginaryLane()[5], aos[5].getImaginaryPart());
+    BOOST_CHECK_EQUAL(soa.get(11), aos[11]);
+    BOOST_CHECK_THROW(soa.get(37), std::out_of_range);
+    BOOST_CHECK_THROW(soa.set(37, Complex<T>()), std::out_of_range);
+
+    std::vector<Complex<T> > back(soa.size());
+    soa.copyTo(back.begin());
+    for (unsigned i = 0; i < back.size(); ++i)
+        BOOST_CHECK_EQUAL(back[i], aos[i]);
+
+    soa.set(3, Complex<T>(1.0, 2.0));
+    BOOST_CHECK_EQUAL(soa[3], Complex<T>(1.0, 2.0));
+
+    soa.resize(40);
+    BOOST_CHECK_EQUAL(soa[39], Complex<T>());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Products, T, test_types)
+{
+    using mw::math::Complex;
+    using mw::math::ComplexArray;
+
+    // Odd size, for the SIMD kernels tails
+    const unsigned count = 103;
+    std::vector<Complex<T> > va = makeComplexes<T>(count, 3), vb = makeComplexes<T>(count, 7);
+    ComplexArray<T> a(va.begin(), va.end());
+    ComplexArray<T> b(vb.begin(), vb.end());
+
+    ComplexArray<T> out;
+    mw::math::multiply(a, b, out);
+    BOOST_REQUIRE_EQUAL(out.size(), count);
+    for (unsigned i = 0; i < count; ++i)
+        BOOST_CHECK_EQUAL(out[i], va[i] * vb[i]);
+
+    mw::math::multiplyConjugate(a, b, out);
+    for (unsigned i = 0; i < count; ++i)
+        BOOST_CHECK_EQUAL(out[i], va[i] * vb[i].getConjugate());
+
+    ComplexArray<T> acc(a);
+    mw::math::multiplyAdd(a, b, acc);
+    for (unsigned i = 0; i < count; ++i)
+        BOOST_CHECK_EQUAL(acc[i], va[i] + va[i] * vb[i]);
+
+    // In place
+    mw::math::multiply(a, b, a);
+    for (unsigned i = 0; i < count; ++i)
+        BOOST_CHECK_EQUAL(a[i], va[i] * vb[i]);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Coordinates, T, test_types)
+{
+    using mw::math::Complex;
+    using mw::math::ComplexArray;
+
+    std::vector<Complex<T> > values = makeComplexes<T>(101, 5);
+
+    // Axes and signed zeros
+    values.push_back(Complex<T>(0.0, 0.0));
+    values.push_back(Complex<T>(-0.0, 0.0));
+    values.push_back(Complex<T>(-0.0, -0.0));
+    values.push_back(Complex<T>(-1.0, 0.0));
+    values.push_back(Complex<T>(-1.0, -0.0));
+    values.push_back(Complex<T>(0.0, 1.0));
+    values.push_back(Complex<T>(0.0, -1.0));
+    values.push_back(Complex<T>(-3.0, 3.0));
+
+    ComplexArray<T> array(values.begin(), values.end());
+    std::vector<T> radial(values.size()), angular(values.size());
+    mw::math::getRadialCoords(array, &radial[0]);
+    mw::math::getAngularCoords(array, &angular[0]);
+
+    const T tolerance = std::numeric_limits<T>::epsilon() * 4;
+    for (unsigned i = 0; i < values.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(radial[i], values[i].getRadialCoord());
+
+        const T expected = values[i].getAngularCoord();
+        BOOST_CHECK_SMALL(angular[i] - expected, tolerance * (std::abs(expected) + 1));
+        BOOST_CHECK_EQUAL(isNegative(angular[i]), isNegative(expected));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
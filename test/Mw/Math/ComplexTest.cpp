@@ -9,6 +9,8 @@
 #include <Mw/Math/Complex.hpp>
 
 #include <cmath>
+#include <limits>
+#include <stdexcept>
 
 #define EPSILON std::numeric_limits<T>::epsilon() * 100
 
@@ -73,9 +75,49 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(Operations, T, test_types)
 
     BOOST_CHECK_EQUAL(c + c2,   Complex<T>(1.0, 1.0));
     BOOST_CHECK_EQUAL(c - c2,   Complex<T>(1.0, -1.0));
-    //BOOST_CHECK_EQUAL(c2 * c,  Complex<T>(2.0, 0.0)); // TODO Testing bad values
-    //BOOST_CHECK_EQUAL(c / c2,  Complex<T>(0.5, 0.0)); // TODO Testing bad values
+    BOOST_CHECK_EQUAL(c2 * c,   Complex<T>(0.0, 1.0));
+    BOOST_CHECK_EQUAL(c / c2,   Complex<T>(0.0, -1.0));
     BOOST_CHECK_EQUAL( - c ,    Complex<T>(-1.0, 0.0));
+    BOOST_CHECK_EQUAL(c2.getConjugate(), Complex<T>(0.0, -1.0));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Products, T, test_types)
+{
+    using mw::math::Complex;
+
+    Complex<T> c(1.0, 2.0);
+    Complex<T> c2(3.0, 4.0);
+
+    BOOST_CHECK_EQUAL(c * c2,   Complex<T>(-5.0, 10.0));
+    BOOST_CHECK_EQUAL(c2 * c,   Complex<T>(-5.0, 10.0));
+    BOOST_CHECK_EQUAL(Complex<T>(-5.0, 10.0) / c2, c);
+    BOOST_CHECK_EQUAL(Complex<T>(-5.0, 10.0) / c,  c2);
+    BOOST_CHECK_EQUAL(c * c.getConjugate(), Complex<T>(5.0, 0.0));
+
+    // No overflow of the intermediate products
+    const T big = std::numeric_limits<T>::max() / 4;
+    BOOST_CHECK_EQUAL(Complex<T>(big, big) / Complex<T>(big, big), Complex<T>(1.0, 0.0));
+    BOOST_CHECK_EQUAL(Complex<T>(big, 0.0) / Complex<T>(0.0, big), Complex<T>(0.0, -1.0));
+
+    BOOST_CHECK_THROW(c / Complex<T>(), std::domain_error);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(MathPolicy, T, test_types)
+{
+    using mw::math::Complex;
+    typedef mw::math::FastMath<mw::math::FAST_MATH_MEDIUM> Fast;
+
+    const Complex<T> exact(3.0, -4.0);
+    const Complex<T, Fast> fast(exact);
+    BOOST_CHECK_EQUAL(fast.getRealPart(), exact.getRealPart());
+    BOOST_CHECK_CLOSE(fast.getRadialCoord(), exact.getRadialCoord(), 1e-3);
+    BOOST_CHECK_SMALL(fast.getAngularCoord() - exact.getAngularCoord(), static_cast<T>(1e-5));
+
+    // Arithmetic is the same
+    BOOST_CHECK_EQUAL(Complex<T>(fast * fast), exact * exact);
+    const Complex<T, Fast> zero;
+    BOOST_CHECK_EQUAL(zero.getRadialCoord(), 0.0);
+    BOOST_CHECK_EQUAL(zero.getAngularCoord(), 0.0);
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,177 @@
+/**
+ * @file   ConvolutionTest.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <boost/mpl/list.hpp>
+
+#include <Mw/Math/Convolution.hpp>
+
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+typedef boost::mpl::list<float, double> test_types;
+
+namespace {
+
+template<typename T>
+std::vector<T> makeSignal(std::size_t size)
+{
+    std::vector<T> signal(size);
+    for (std::size_t i = 0; i < size; ++i)
+        signal[i] = static_cast<T>(std::rand() % 2001 - 1000) / 1000;
+    return signal;
+}
+
+/**
+ * Direct convolution in double precision.
+ */
+template<typename T>
+std::vector<double> directConvolution(const std::vector<T> & a, const std::vector<T> & b)
+{
+    std::vector<double> out(a.size() + b.size() - 1);
+    for (std::size_t i = 0; i < a.size(); ++i)
+        for (std::size_t j = 0; j < b.size(); ++j)
+            out[i + j] += static_cast<double>(a[i]) * b[j];
+    return out;
+}
+
+template<typename T>
+double maxDistance(const std::vector<T> & a, const std::vector<double> & b, std::size_t count)
+{
+    double distance = 0;
+    for (std::size_t i = 0; i < count; ++i)
+        distance = std::max(distance, std::abs(a[i] - b[i]));
+    return distance;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(Convolution)
+
+BOOST_AUTO_TEST_CASE(FastSizes)
+{
+    BOOST_CHECK_EQUAL(mw::math::getFastFftSize(0), 1u);
+    BOOST_CHECK_EQUAL(mw::math::getFastFftSize(1), 1u);
+    BOOST_CHECK_EQUAL(mw::math::getFastFftSize(7), 8u);
+    BOOST_CHECK_EQUAL(mw::math::getFastFftSize(11), 12u);
+    BOOST_CHECK_EQUAL(mw::math::getFastFftSize(1001), 1024u);
+    BOOST_CHECK_EQUAL(mw::math::getFastFftSize(1025), 1080u);
+    BOOST_CHECK_EQUAL(mw::math::getFastFftSize(4097), 4320u);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Signals, T, test_types)
+{
+    const std::size_t sizes[][2] = { { 1, 1 }, { 5, 1 }, { 1, 5 }, { 17, 4 }, { 100, 31 }, { 257, 257 }, { 1000, 3 } };
+
+    std::srand(11);
+    for (std::size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+    {
+        const std::vector<T> a = makeSignal<T>(sizes[i][0]);
+        const std::vector<T> b = makeSignal<T>(sizes[i][1]);
+        const std::size_t count = a.size() + b.size() - 1;
+        const double tolerance = std::numeric_limits<T>::epsilon() * 64 * std::sqrt(static_cast<double>(count));
+
+        std::vector<T> out(count);
+        mw::math::convolve(&a[0], a.size(), &b[0], b.size(), &out[0]);
+        BOOST_CHECK_SMALL(maxDistance(out, directConvolution(a, b), count), tolerance);
+
+        // Correlation is the convolution with the reversed kernel
+        const std::vector<T> reversed(b.rbegin(), b.rend());
+        mw::math::correlate(&a[0], a.size(), &b[0], b.size(), &out[0]);
+        BOOST_CHECK_SMALL(maxDistance(out, directConvolution(a, reversed), count), tolerance);
+    }
+
+    std::vector<T> signal(4);
+    BOOST_CHECK_THROW(mw::math::convolve(&signal[0], 0, &signal[0], 4, &signal[0]), std::invalid_argument);
+    BOOST_CHECK_THROW(mw::math::correlate(&signal[0], 4, &signal[0], 0, &signal[0]), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Correlation, T, test_types)
+{
+    // Find a pattern in a signal
+    std::srand(13);
+    const std::vector<T> pattern = makeSignal<T>(32);
+    std::vector<T> signal(500);
+    std::copy(pattern.begin(), pattern.end(), signal.begin() + 300);
+
+    std::vector<T> out(signal.size() + pattern.size() - 1);
+    mw::math::correlate(&signal[0], signal.size(), &pattern[0], pattern.size(), &out[0]);
+
+    const std::size_t peak = std::max_element(out.begin(), out.end()) - out.begin();
+    BOOST_CHECK_EQUAL(peak, 300 + pattern.size() - 1);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Streaming, T, test_types)
+{
+    // Kernels shorter and longer than the blocks
+    const std::size_t sizes[][2] = { { 1, 0 }, { 31, 0 }, { 100, 0 }, { 5, 16 }, { 64, 16 }, { 65, 1 } };
+
+    std::srand(17);
+    for (std::size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+    {
+        const std::vector<T> kernel = makeSignal<T>(sizes[i][0]);
+
+        mw::math::OverlapAddFilter<T> overlapAdd(&kernel[0], kernel.size(), sizes[i][1]);
+        mw::math::OverlapSaveFilter<T> overlapSave(&kernel[0], kernel.size(), sizes[i][1]);
+        BOOST_CHECK_EQUAL(overlapAdd.getKernelSize(), kernel.size());
+        BOOST_CHECK_EQUAL(overlapSave.getKernelSize(), kernel.size());
+        if (sizes[i][1])
+        {
+            BOOST_CHECK_EQUAL(overlapAdd.getBlockSize(), sizes[i][1]);
+            BOOST_CHECK_EQUAL(overlapSave.getBlockSize(), sizes[i][1]);
+        }
+
+        const std::size_t blocks = 7;
+        const std::vector<T> stream = makeSignal<T>(overlapAdd.getBlockSize() * blocks);
+        const std::vector<double> expected = directConvolution(stream, kernel);
+        const double tolerance = std::numeric_limits<T>::epsilon() * 64 * std::sqrt(static_cast<double>(kernel.size()));
+
+        // Block by block, then several blocks at once in place
+        std::vector<T> out(stream.size());
+        for (std::size_t b = 0; b < blocks; ++b)
+        {
+            const std::size_t offset = b * overlapAdd.getBlockSize();
+            overlapAdd.process(&stream[offset], &out[offset]);
+        }
+        BOOST_CHECK_SMALL(maxDistance(out, expected, out.size()), tolerance);
+
+        overlapAdd.reset();
+        out = stream;
+        overlapAdd.process(&out[0], out.size(), &out[0]);
+        BOOST_CHECK_SMALL(maxDistance(out, expected, out.size()), tolerance);
+
+        const std::vector<T> stream2 = makeSignal<T>(overlapSave.getBlockSize() * blocks);
+        const std::vector<double> expected2 = directConvolution(stream2, kernel);
+
+        out.resize(stream2.size());
+        for (std::size_t b = 0; b < blocks; ++b)
+        {
+            const std::size_t offset = b * overlapSave.getBlockSize();
+            overlapSave.process(&stream2[offset], &out[offset]);
+        }
+        BOOST_CHECK_SMALL(maxDistance(out, expected2, out.size()), tolerance);
+
+        overlapSave.reset();
+        out = stream2;
+        overlapSave.process(&out[0], out.size(), &out[0]);
+        BOOST_CHECK_SMALL(maxDistance(out, expected2, out.size()), tolerance);
+    }
+
+    std::vector<T> kernel(4), out(32);
+    BOOST_CHECK_THROW(mw::math::OverlapAddFilter<T>(&kernel[0], 0), std::invalid_argument);
+    BOOST_CHECK_THROW(mw::math::OverlapSaveFilter<T>(&kernel[0], 0), std::invalid_argument);
+
+    mw::math::OverlapAddFilter<T> overlapAdd(&kernel[0], kernel.size(), 16);
+    mw::math::OverlapSaveFilter<T> overlapSave(&kernel[0], kernel.size(), 16);
+    BOOST_CHECK_THROW(overlapAdd.process(&out[0], 17, &out[0]), std::invalid_argument);
+    BOOST_CHECK_THROW(overlapSave.process(&out[0], 17, &out[0]), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,136 @@
+/**
+ * @file   CubicStepperTest.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <Mw/Math/CubicStepper.hpp>
+#include <Mw/Math/Interpolation.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+typedef mw::math::Vector<double, 3> Vec3;
+
+/**
+ * Maximum error of the stepped values against the interpolation.
+ */
+float maxError(mw::math::SplineType type, unsigned count, unsigned interval)
+{
+    const float p0 = -1.3f, p1 = 0.7f, p2 = 2.1f, p3 = -0.4f;
+    const float step = 1.0f / count;
+
+    std::vector<float> values(count + 1);
+    mw::math::CubicStepper<float> stepper(p0, p1, p2, p3, type, step, 0.0f, interval);
+    stepper.fill(&values[0], values.size());
+
+    float error = 0;
+    for (unsigned i = 0; i <= count; ++i)
+    {
+        const double mu = static_cast<double>(i) / count;
+        const double expected = type == mw::math::SPLINE_CUBIC
+            ? mw::math::cubicInterpolate<double>(p0, p1, p2, p3, mu)
+            : mw::math::catmullRomInterpolate<double>(p0, p1, p2, p3, mu);
+        error = std::max(error, static_cast<float>(std::fabs(values[i] - expected)));
+    }
+    return error;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(CubicStepper)
+
+BOOST_AUTO_TEST_CASE(Step)
+{
+    using namespace mw::math;
+
+    const double p0 = 1.0, p1 = -2.0, p2 = 0.5, p3 = 3.0;
+    mw::math::CubicStepper<double> cubic(p0, p1, p2, p3, SPLINE_CUBIC, 0.125);
+    mw::math::CubicStepper<double> catmullRom(p0, p1, p2, p3, SPLINE_CATMULL_ROM, 0.125, -0.5, 5);
+
+    for (unsigned i = 0; i < 20; ++i)
+    {
+        BOOST_CHECK_EQUAL(cubic.getIndex(), i);
+        BOOST_CHECK_CLOSE(cubic.getPosition(), i * 0.125, 1e-12);
+        BOOST_CHECK_CLOSE(cubic.get(), cubicInterpolate(p0, p1, p2, p3, i * 0.125), 1e-9);
+        BOOST_CHECK_CLOSE(catmullRom.get(), catmullRomInterpolate(p0, p1, p2, p3, i * 0.125 - 0.5), 1e-9);
+        cubic.next();
+        catmullRom.next();
+    }
+
+    catmullRom.seek(3);
+    BOOST_CHECK_CLOSE(catmullRom.get(), catmullRomInterpolate(p0, p1, p2, p3, -0.125), 1e-9);
+
+    // Filling steps and synchronizes as next() does
+    mw::math::CubicStepper<double> stepped(p0, p1, p2, p3, SPLINE_CATMULL_ROM, 0.125, -0.5, 5);
+    mw::math::CubicStepper<double> filled(stepped);
+    double block[23];
+    filled.fill(block, 3);
+    filled.fill(block + 3, 20);
+    for (unsigned i = 0; i < 23; ++i)
+    {
+        BOOST_CHECK_EQUAL(block[i], stepped.get());
+        stepped.next();
+    }
+    BOOST_CHECK_EQUAL(filled.get(), stepped.get());
+
+    // Vectors
+    Vec3 points[4];
+    for (unsigned i = 0; i < 4; ++i)
+        for (unsigned j = 0; j < 3; ++j)
+            points[i][j] = std::sin(i * 3.0 + j);
+
+    std::vector<Vec3> values(9);
+    mw::math::CubicStepper<Vec3> stepper(points[0], points[1], points[2], points[3], SPLINE_CATMULL_ROM, 0.125);
+    stepper.fill(&values[0], values.size());
+    BOOST_CHECK_EQUAL(stepper.getIndex(), 9u);
+    for (unsigned i = 0; i < values.size(); ++i)
+    {
+        const Vec3 expected = catmullRomInterpolate(points[0], points[1], points[2], points[3], i * 0.125);
+        for (unsigned j = 0; j < 3; ++j)
+            BOOST_CHECK_CLOSE(values[i][j], expected[j], 1e-9);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Drift)
+{
+    using namespace mw::math;
+
+    // Synchronized, the error stays within a few tens of ulps
+    BOOST_CHECK_LT(maxError(SPLINE_CUBIC, 1 << 16, 64), 1e-5f);
+    BOOST_CHECK_LT(maxError(SPLINE_CATMULL_ROM, 1 << 16, 64), 1e-5f);
+    BOOST_CHECK_LT(maxError(SPLINE_CATMULL_ROM, 1 << 16, 1), 2e-6f);
+
+    // Never synchronized, the sums drift
+    BOOST_CHECK_GT(maxError(SPLINE_CATMULL_ROM, 1 << 16, 0), maxError(SPLINE_CATMULL_ROM, 1 << 16, 64));
+}
+
+BOOST_AUTO_TEST_CASE(Tessellate)
+{
+    using namespace mw::math;
+
+    std::vector<Vec3> points(6);
+    for (unsigned i = 0; i < points.size(); ++i)
+        for (unsigned j = 0; j < 3; ++j)
+            points[i][j] = std::cos(i * 1.7 + j * 0.3) * 4;
+
+    const mw::math::Spline<Vec3> curve(&points[0], points.size());
+    const unsigned steps = 10;
+    std::vector<Vec3> out(steps * 5 + 1);
+    mw::math::tessellate(curve, &out[0], steps);
+
+    for (unsigned i = 0; i < out.size(); ++i)
+    {
+        const Vec3 expected = curve.evaluate(static_cast<double>(i) / steps);
+        for (unsigned j = 0; j < 3; ++j)
+            BOOST_CHECK_SMALL(out[i][j] - expected[j], 1e-12);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
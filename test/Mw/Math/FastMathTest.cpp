@@ -0,0 +1,144 @@
+/**
+ * @file   FastMathTest.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <boost/mpl/list.hpp>
+
+#include <Mw/Math/FastMath.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+/**
+ * Maximum errors of a policy on float, against double results.
+ */
+struct Errors
+{
+    double trigonometric;
+    double atan2;
+    double sqrt;
+};
+
+template<class Math>
+Errors measureScalar()
+{
+    Errors e = { 0, 0, 0 };
+    for (int i = 0; i < 20000; ++i)
+    {
+        const float x = static_cast<float>((i / 20000.0 - 0.5) * 2000.0);
+        e.trigonometric = std::max(e.trigonometric, std::fabs(Math::sin(x) - std::sin(static_cast<double>(x))));
+        e.trigonometric = std::max(e.trigonometric, std::fabs(Math::cos(x) - std::cos(static_cast<double>(x))));
+
+        const float y = static_cast<float>(std::sin(i * 0.37) * 3), z = static_cast<float>(std::cos(i * 0.11) * 2);
+        e.atan2 = std::max(e.atan2, std::fabs(Math::atan2(y, z) - std::atan2(static_cast<double>(y), z)));
+
+        const float v = static_cast<float>(1e-6 + i * 73.1);
+        e.sqrt = std::max(e.sqrt, std::fabs(Math::sqrt(v) / std::sqrt(static_cast<double>(v)) - 1));
+        e.sqrt = std::max(e.sqrt, std::fabs(Math::rsqrt(v) * std::sqrt(static_cast<double>(v)) - 1));
+    }
+    return e;
+}
+
+#ifdef MW_SIMD_SSE2
+
+float lane(__m128 v, int index)
+{
+    BOOST_ALIGNMENT(16) float values[4];
+    _mm_store_ps(values, v);
+    return values[index];
+}
+
+template<class Math>
+Errors measureSimd()
+{
+    Errors e = { 0, 0, 0 };
+    for (int i = 0; i < 20000; i += 4)
+    {
+        BOOST_ALIGNMENT(16) float x[4], y[4], z[4], v[4];
+        for (int j = 0; j < 4; ++j)
+        {
+            x[j] = static_cast<float>(((i + j) / 20000.0 - 0.5) * 2000.0);
+            y[j] = static_cast<float>(std::sin((i + j) * 0.37) * 3);
+            z[j] = static_cast<float>(std::cos((i + j) * 0.11) * 2);
+            v[j] = static_cast<float>(1e-6 + (i + j) * 73.1);
+        }
+
+        const __m128 sin = Math::sin(_mm_load_ps(x)), cos = Math::cos(_mm_load_ps(x));
+        const __m128 atan2 = Math::atan2(_mm_load_ps(y), _mm_load_ps(z));
+        const __m128 sqrt = Math::sqrt(_mm_load_ps(v)), rsqrt = Math::rsqrt(_mm_load_ps(v));
+        for (int j = 0; j < 4; ++j)
+        {
+            e.trigonometric = std::max(e.trigonometric, std::fabs(lane(sin, j) - std::sin(static_cast<double>(x[j]))));
+            e.trigonometric = std::max(e.trigonometric, std::fabs(lane(cos, j) - std::cos(static_cast<double>(x[j]))));
+            e.atan2 = std::max(e.atan2, std::fabs(lane(atan2, j) - std::atan2(static_cast<double>(y[j]), z[j])));
+            e.sqrt = std::max(e.sqrt, std::fabs(lane(sqrt, j) / std::sqrt(static_cast<double>(v[j])) - 1));
+            e.sqrt = std::max(e.sqrt, std::fabs(lane(rsqrt, j) * std::sqrt(static_cast<double>(v[j])) - 1));
+        }
+    }
+    return e;
+}
+
+#endif // MW_SIMD_SSE2
+
+template<class Math>
+void checkTier(double trigonometric, double atan2, double sqrt)
+{
+    const Errors scalar = measureScalar<Math>();
+    BOOST_CHECK_LE(scalar.trigonometric, trigonometric);
+    BOOST_CHECK_LE(scalar.atan2, atan2);
+    BOOST_CHECK_LE(scalar.sqrt, sqrt);
+
+#ifdef MW_SIMD_SSE2
+    const Errors simd = measureSimd<Math>();
+    BOOST_CHECK_LE(simd.trigonometric, trigonometric);
+    BOOST_CHECK_LE(simd.atan2, atan2);
+    BOOST_CHECK_LE(simd.sqrt, sqrt);
+#endif
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(FastMath)
+
+BOOST_AUTO_TEST_CASE(Tiers)
+{
+    using namespace mw::math;
+
+    // Bounds documented in FastMath.hpp
+    checkTier<ExactMath>(4e-8, 3e-7, 1e-7);
+    checkTier< mw::math::FastMath<FAST_MATH_LOW> >(2.8e-4, 1.1e-3, 1.8e-3);
+    checkTier< mw::math::FastMath<FAST_MATH_MEDIUM> >(1.1e-5, 7.3e-6, 5e-6);
+    checkTier< mw::math::FastMath<FAST_MATH_HIGH> >(8.3e-8, 2.8e-7, 1.9e-7);
+}
+
+BOOST_AUTO_TEST_CASE(Special)
+{
+    typedef mw::math::FastMath<> Fast;
+
+    // Signed zeros and axes, as std::atan2
+    const float pi = 3.14159265f;
+    BOOST_CHECK_EQUAL(Fast::atan2(0.0f, 0.0f), 0.0f);
+    BOOST_CHECK_CLOSE(Fast::atan2(0.0f, -0.0f), pi, 1e-5f);
+    BOOST_CHECK_CLOSE(Fast::atan2(-0.0f, -1.0f), -pi, 1e-5f);
+    BOOST_CHECK_CLOSE(Fast::atan2(1.0f, 0.0f), pi / 2, 1e-5f);
+    BOOST_CHECK_CLOSE(Fast::atan2(-2.0f, 0.0f), -pi / 2, 1e-5f);
+
+    BOOST_CHECK_EQUAL(Fast::sqrt(0.0f), 0.0f);
+    BOOST_CHECK_EQUAL(Fast::sqrt(0.0), 0.0);
+    BOOST_CHECK_CLOSE(Fast::sqrt(2.0), std::sqrt(2.0), 1e-5);
+    BOOST_CHECK_CLOSE(Fast::cos(0.5), std::cos(0.5), 1e-5);
+    BOOST_CHECK_EQUAL(Fast::sin(0.0f), 0.0f);
+
+#ifdef MW_SIMD_SSE2
+    BOOST_CHECK_EQUAL(lane(Fast::sqrt(_mm_setzero_ps()), 0), 0.0f);
+    BOOST_CHECK_CLOSE(lane(Fast::atan2(_mm_set1_ps(0.0f), _mm_set1_ps(-0.0f)), 0), pi, 1e-5f);
+#endif
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
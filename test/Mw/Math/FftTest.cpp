@@ -0,0 +1,179 @@
+/**
+ * @file   FftTest.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <boost/mpl/list.hpp>
+
+#include <Mw/Math/Fft.hpp>
+#include <Mw/Thread/TaskPool.hpp>
+
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+typedef boost::mpl::list<float, double> test_types;
+
+namespace {
+
+template<typename T>
+mw::math::ComplexArray<T> makeSignal(std::size_t size)
+{
+    mw::math::ComplexArray<T> signal;
+    for (std::size_t i = 0; i < size; ++i)
+        signal.push_back(mw::math::Complex<T>(static_cast<T>(std::rand() % 2001 - 1000) / 1000,
+                                              static_cast<T>(std::rand() % 2001 - 1000) / 1000));
+    return signal;
+}
+
+/**
+ * Naive DFT in double precision.
+ */
+template<typename T>
+std::vector<mw::math::Complex<double> > dft(const mw::math::ComplexArray<T> & signal)
+{
+    const std::size_t size = signal.size();
+    std::vector<mw::math::Complex<double> > out(size);
+    for (std::size_t k = 0; k < size; ++k)
+        for (std::size_t n = 0; n < size; ++n)
+        {
+            const double angle = -2 * M_PI * static_cast<double>(n * k % size) / static_cast<double>(size);
+            out[k] += mw::math::Complex<double>(signal[n]) * mw::math::Complex<double>(std::cos(angle), std::sin(angle));
+        }
+    return out;
+}
+
+template<typename T>
+double maxDistance(const mw::math::ComplexArray<T> & a, const std::vector<mw::math::Complex<double> > & b)
+{
+    double distance = 0;
+    for (std::size_t i = 0; i < a.size(); ++i)
+        distance = std::max(distance, (mw::math::Complex<double>(a[i]) - b[i]).getRadialCoord());
+    return distance;
+}
+
+template<typename T>
+double maxDistance(const mw::math::ComplexArray<T> & a, const mw::math::ComplexArray<T> & b)
+{
+    std::vector<mw::math::Complex<double> > values(b.size());
+    b.copyTo(values.begin());
+    return maxDistance(a, values);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(Fft)
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Plans, T, test_types)
+{
+    typedef mw::math::FftPlan<T> Plan;
+
+    BOOST_CHECK_THROW(Plan(0), std::invalid_argument);
+    BOOST_CHECK(Plan::get(64) == Plan::get(64));
+    BOOST_CHECK_EQUAL(Plan::get(64)->size(), 64u);
+    BOOST_CHECK(!Plan::get(360)->isBluestein());
+    BOOST_CHECK(Plan::get(37)->isBluestein());
+
+    mw::math::ComplexArray<T> signal(10);
+    BOOST_CHECK_THROW(Plan::get(4)->forward(signal, signal), std::invalid_argument);
+
+    // Impulse and constant
+    signal = mw::math::ComplexArray<T>(8);
+    signal.set(0, mw::math::Complex<T>(1, 0));
+    Plan::get(8)->forward(signal, signal);
+    for (std::size_t i = 0; i < 8; ++i)
+        BOOST_CHECK_EQUAL(signal[i], mw::math::Complex<T>(1, 0));
+
+    Plan::get(8)->forward(signal, signal);
+    BOOST_CHECK_EQUAL(signal[0], mw::math::Complex<T>(8, 0));
+    for (std::size_t i = 1; i < 8; ++i)
+        BOOST_CHECK_SMALL(signal[i].getRadialCoord(), std::numeric_limits<T>::epsilon() * 8);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Transform, T, test_types)
+{
+    // Powers of 2 and 4, mixed radices, primes up to the largest radix,
+    // and Bluestein sizes
+    const std::size_t sizes[] = { 1, 2, 3, 4, 5, 7, 8, 12, 16, 30, 31, 32, 37, 60, 64, 97,
+                                  100, 128, 243, 256, 360, 512, 1000, 1024, 1031, 2048 };
+
+    std::srand(3);
+    for (std::size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+    {
+        const std::size_t size = sizes[i];
+        const boost::shared_ptr<const mw::math::FftPlan<T> > plan = mw::math::FftPlan<T>::get(size);
+
+        const mw::math::ComplexArray<T> signal = makeSignal<T>(size);
+        const double tolerance = std::numeric_limits<T>::epsilon() * std::sqrt(static_cast<double>(size)) * 8;
+
+        // Out of place
+        mw::math::ComplexArray<T> spectrum;
+        plan->forward(signal, spectrum);
+        BOOST_CHECK_SMALL(maxDistance(spectrum, dft(signal)), tolerance * size);
+
+        // In place, back to the signal
+        mw::math::ComplexArray<T> back(spectrum);
+        plan->inverse(back, back);
+        BOOST_CHECK_SMALL(maxDistance(back, signal), tolerance);
+
+        // Lanes and Complex interfaces
+        mw::math::ComplexArray<T> lanes(size);
+        plan->forward(signal.realLane(), signal.imaginaryLane(), lanes.realLane(), lanes.imaginaryLane());
+        BOOST_CHECK_EQUAL(maxDistance(lanes, spectrum), 0.0);
+
+        std::vector<mw::math::Complex<T> > values(size);
+        signal.copyTo(values.begin());
+        plan->forward(&values[0], &values[0]);
+        plan->inverse(&values[0], &values[0]);
+        BOOST_CHECK_SMALL(maxDistance(mw::math::ComplexArray<T>(values.begin(), values.end()), signal), tolerance);
+    }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Batch, T, test_types)
+{
+    const std::size_t sizes[] = { 16, 60, 97 };
+
+    std::srand(5);
+    for (std::size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+    {
+        const std::size_t size = sizes[i];
+        const std::size_t count = 301;
+        const mw::math::FftPlan<T> plan(size);
+
+        const mw::math::ComplexArray<T> signals = makeSignal<T>(size * count);
+
+        // Same results as the transforms of each signal
+        mw::math::ComplexArray<T> spectra;
+        plan.forward(signals, spectra);
+        BOOST_REQUIRE_EQUAL(spectra.size(), size * count);
+        for (std::size_t s = 0; s < count; s += 50)
+        {
+            mw::math::ComplexArray<T> spectrum(size);
+            plan.forward(signals.realLane() + s * size, signals.imaginaryLane() + s * size,
+                         spectrum.realLane(), spectrum.imaginaryLane());
+            for (std::size_t k = 0; k < size; ++k)
+                BOOST_CHECK_EQUAL(spectra[s * size + k], spectrum[k]);
+        }
+
+        for (unsigned threads = 1; threads <= 3; ++threads)
+        {
+            mw::thread::TaskPool pool(threads);
+
+            mw::math::ComplexArray<T> parallel(signals);
+            plan.forward(parallel, parallel, pool);
+            BOOST_CHECK_EQUAL(maxDistance(parallel, spectra), 0.0);
+
+            plan.inverse(parallel, parallel, pool);
+            mw::math::ComplexArray<T> back;
+            plan.inverse(spectra, back);
+            BOOST_CHECK_EQUAL(maxDistance(parallel, back), 0.0);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,134 @@
+/**
+ * @file   HashGridTest.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <Mw/Math/HashGrid.hpp>
+#include <Mw/Thread/TaskPool.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <vector>
+
+namespace {
+
+template<unsigned N>
+std::vector<mw::math::Vector<float, N> > randomPoints(unsigned count, float range)
+{
+    std::vector<mw::math::Vector<float, N> > points;
+    for (unsigned i = 0; i < count; ++i)
+    {
+        mw::math::Vector<float, N> p;
+        for (unsigned c = 0; c < N; ++c)
+            p[c] = static_cast<float>(std::rand() % 10000) / 10000 * range - range / 2;
+        points.push_back(p);
+    }
+    return points;
+}
+
+template<unsigned N>
+void checkQueries(std::size_t tableSize)
+{
+    typedef mw::math::HashGrid<float, N> Grid;
+
+    std::srand(3);
+    std::vector<mw::math::Vector<float, N> > points = randomPoints<N>(2000, 40);
+    std::vector<mw::math::Vector<float, N> > queries = randomPoints<N>(100, 44);
+
+    Grid grid(2, tableSize);
+    grid.rebuild(points.begin(), points.end());
+    BOOST_CHECK_EQUAL(grid.size(), points.size());
+
+    const float radii[] = { 0, 1.5f, 2, 5 };
+    for (unsigned r = 0; r < 4; ++r)
+    {
+        typename Grid::Indices offsets, neighbours;
+        grid.queryRadius(queries.begin(), queries.end(), radii[r], offsets, neighbours);
+        BOOST_REQUIRE_EQUAL(offsets.size(), queries.size() + 1);
+        BOOST_CHECK_EQUAL(offsets.back(), neighbours.size());
+
+        for (std::size_t q = 0; q < queries.size(); ++q)
+        {
+            std::vector<boost::uint32_t> expected;
+            for (std::size_t i = 0; i < points.size(); ++i)
+            {
+                mw::math::Vector<float, N> d = points[i] - queries[q];
+                if (d.dot(d) <= radii[r] * radii[r])
+                    expected.push_back(static_cast<boost::uint32_t>(i));
+            }
+
+            std::vector<boost::uint32_t> found;
+            grid.queryRadius(queries[q], radii[r], std::back_inserter(found));
+            std::sort(found.begin(), found.end());
+            BOOST_CHECK(found == expected);
+
+            std::vector<boost::uint32_t> batch(neighbours.begin() + offsets[q], neighbours.begin() + offsets[q + 1]);
+            std::sort(batch.begin(), batch.end());
+            BOOST_CHECK(batch == expected);
+        }
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(HashGrid)
+
+BOOST_AUTO_TEST_CASE(Queries)
+{
+    checkQueries<2>(0);
+    checkQueries<3>(0);
+
+    // Many cells per bucket
+    checkQueries<2>(16);
+    checkQueries<3>(4);
+}
+
+BOOST_AUTO_TEST_CASE(Parallel)
+{
+    typedef mw::math::HashGrid<float, 3> Grid;
+
+    std::srand(5);
+    std::vector<mw::math::Vector<float, 3> > points = randomPoints<3>(300000, 500);
+
+    Grid sequential(4);
+    sequential.rebuild(points.begin(), points.end());
+
+    Grid::Indices offsets, neighbours;
+    sequential.queryRadius(points.begin(), points.begin() + 5000, 4, offsets, neighbours);
+
+    for (unsigned threads = 1; threads <= 4; ++threads)
+    {
+        mw::thread::TaskPool pool(threads);
+
+        // Same order of the points, so the same results in the same order
+        Grid parallel(4);
+        parallel.rebuild(points.begin(), points.end(), pool);
+
+        Grid::Indices parallelOffsets, parallelNeighbours;
+        parallel.queryRadius(points.begin(), points.begin() + 5000, 4, parallelOffsets, parallelNeighbours, pool);
+        BOOST_CHECK(parallelOffsets == offsets);
+        BOOST_CHECK(parallelNeighbours == neighbours);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Empty)
+{
+    mw::math::HashGrid<float, 2> grid(1);
+    std::vector<mw::math::Vector<float, 2> > points;
+    grid.rebuild(points.begin(), points.end());
+    BOOST_CHECK(grid.empty());
+
+    std::vector<boost::uint32_t> found;
+    grid.queryRadius(mw::math::Vector<float, 2>(), 10, std::back_inserter(found));
+    BOOST_CHECK(found.empty());
+
+    typedef mw::math::HashGrid<float, 2> Grid;
+    BOOST_CHECK_THROW(Grid(0), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,166 @@
+/**
+ * @file   InterpolationTest.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <Mw/Math/Interpolation.hpp>
+
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+const unsigned COUNT = 103;
+
+template<typename T>
+std::vector<T> randomValues(unsigned count, T min, T max)
+{
+    std::vector<T> values;
+    for (unsigned i = 0; i < count; ++i)
+        values.push_back(min + (max - min) * static_cast<T>(std::rand()) / static_cast<T>(RAND_MAX));
+    return values;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(Interpolation)
+
+BOOST_AUTO_TEST_CASE(Scalar)
+{
+    using namespace mw::math;
+
+    BOOST_CHECK_CLOSE(linearInterpolate(2.0f, 4.0f, 0.25f), 2.5f, 1e-4f);
+    BOOST_CHECK_CLOSE(cosineInterpolate(2.0, 4.0, 0.5), 3.0, 1e-10);
+    BOOST_CHECK_CLOSE(cubicInterpolate(0.0, 1.0, 2.0, 3.0, 0.5), 1.5, 1e-10);
+    BOOST_CHECK_CLOSE(catmullRomInterpolate(0.0f, 1.0f, 2.0f, 3.0f, 0.5f), 1.5f, 1e-4f);
+
+    // Coefficients are computed in T
+    BOOST_CHECK_EQUAL(cubicInterpolate(1.0f, 2.0f, 4.0f, 8.0f, 0.0f), 2.0f);
+    BOOST_CHECK_EQUAL(cubicInterpolate(1.0f, 2.0f, 4.0f, 8.0f, 1.0f), 4.0f);
+}
+
+BOOST_AUTO_TEST_CASE(Batch)
+{
+    using namespace mw::math;
+
+    std::srand(7);
+    const std::vector<float> p0 = randomValues(COUNT, -10.0f, 10.0f), p1 = randomValues(COUNT, -10.0f, 10.0f);
+    const std::vector<float> p2 = randomValues(COUNT, -10.0f, 10.0f), p3 = randomValues(COUNT, -10.0f, 10.0f);
+    std::vector<float> mu = randomValues(COUNT, 0.0f, 1.0f);
+    mu[0] = 0.0f;
+    mu[1] = 1.0f;
+
+    std::vector<float> out(COUNT);
+
+    // SSE kernels are not bit exact, compare with a tolerance on the range
+    linearInterpolate(&p1[0], &p2[0], &mu[0], &out[0], COUNT);
+    for (unsigned i = 0; i < COUNT; ++i)
+        BOOST_CHECK_SMALL(out[i] - linearInterpolate(p1[i], p2[i], mu[i]), 1e-5f);
+
+    cosineInterpolate(&p1[0], &p2[0], &mu[0], &out[0], COUNT);
+    for (unsigned i = 0; i < COUNT; ++i)
+        BOOST_CHECK_SMALL(out[i] - cosineInterpolate(p1[i], p2[i], mu[i]), 1e-5f);
+
+    cubicInterpolate(&p0[0], &p1[0], &p2[0], &p3[0], &mu[0], &out[0], COUNT);
+    for (unsigned i = 0; i < COUNT; ++i)
+        BOOST_CHECK_SMALL(out[i] - cubicInterpolate(p0[i], p1[i], p2[i], p3[i], mu[i]), 1e-4f);
+
+    catmullRomInterpolate(&p0[0], &p1[0], &p2[0], &p3[0], &mu[0], &out[0], COUNT);
+    for (unsigned i = 0; i < COUNT; ++i)
+        BOOST_CHECK_SMALL(out[i] - catmullRomInterpolate(p0[i], p1[i], p2[i], p3[i], mu[i]), 1e-4f);
+
+    // Math policies, scalar and batch
+    const mw::math::FastMath<FAST_MATH_LOW> fast;
+    cosineInterpolate(&p1[0], &p2[0], &mu[0], &out[0], COUNT, fast);
+    for (unsigned i = 0; i < COUNT; ++i)
+    {
+        const float expected = cosineInterpolate(p1[i], p2[i], mu[i]);
+        BOOST_CHECK_SMALL(cosineInterpolate(p1[i], p2[i], mu[i], fast) - expected, 1e-2f);
+        BOOST_CHECK_SMALL(out[i] - expected, 1e-2f);
+        BOOST_CHECK_SMALL(cosineInterpolate(p1[i], p2[i], mu[i], ExactMath()) - expected, 1e-5f);
+    }
+
+    catmullRomInterpolate(&p0[0], &p1[0], &p2[0], &p3[0], &mu[0], &out[0], COUNT);
+
+    // Samples at the ends of the range
+    BOOST_CHECK_EQUAL(out[0], p1[0]);
+    BOOST_CHECK_CLOSE(out[1], p2[1], 1e-4f);
+
+    // Generic loops, in place
+    std::vector<double> a(p1.begin(), p1.end()), b(p2.begin(), p2.end()), t(mu.begin(), mu.end());
+    linearInterpolate(&a[0], &b[0], &t[0], &a[0], COUNT);
+    for (unsigned i = 0; i < COUNT; ++i)
+        BOOST_CHECK_EQUAL(a[i], linearInterpolate<double>(p1[i], p2[i], t[i]));
+}
+
+BOOST_AUTO_TEST_CASE(Resample)
+{
+    using namespace mw::math;
+
+    std::srand(11);
+    const std::vector<float> samples = randomValues(50u, -1.0f, 1.0f);
+    const unsigned n = static_cast<unsigned>(samples.size());
+
+    // Upsampling past both ends, more values than a block
+    const float start = -1.5f, step = 0.37f;
+    const unsigned count = 160;
+    std::vector<float> linear(count), cosine(count), cubic(count), catmullRom(count);
+    linearResample(&samples[0], n, start, step, &linear[0], count);
+    cosineResample(&samples[0], n, start, step, &cosine[0], count);
+    cubicResample(&samples[0], n, start, step, &cubic[0], count);
+    catmullRomResample(&samples[0], n, start, step, &catmullRom[0], count);
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+        double x = start + static_cast<double>(i) * step;
+        x = x < 0 ? 0 : (x > n - 1 ? n - 1 : x);
+        unsigned k = static_cast<unsigned>(x);
+        if (k > n - 2)
+            k = n - 2;
+        const float mu = static_cast<float>(x - k);
+
+        const float s0 = samples[k > 0 ? k - 1 : 0], s1 = samples[k];
+        const float s2 = samples[k + 1], s3 = samples[k + 2 < n ? k + 2 : n - 1];
+
+        BOOST_CHECK_SMALL(linear[i] - linearInterpolate(s1, s2, mu), 1e-5f);
+        BOOST_CHECK_SMALL(cosine[i] - cosineInterpolate(s1, s2, mu), 1e-5f);
+        BOOST_CHECK_SMALL(cubic[i] - cubicInterpolate(s0, s1, s2, s3, mu), 1e-5f);
+        BOOST_CHECK_SMALL(catmullRom[i] - catmullRomInterpolate(s0, s1, s2, s3, mu), 1e-5f);
+    }
+
+    // Clamped to the signal
+    BOOST_CHECK_EQUAL(linear[0], samples[0]);
+    BOOST_CHECK_CLOSE(linear[count - 1], samples[n - 1], 1e-4f);
+
+    // A single sample
+    float value;
+    cubicResample(&samples[0], 1u, 0.5f, 1.0f, &value, 1u);
+    BOOST_CHECK_EQUAL(value, samples[0]);
+
+    BOOST_CHECK_THROW(linearResample(&samples[0], 0u, 0.0f, 1.0f, &value, 1u), std::invalid_argument);
+
+    // Long float signal, the step is not rounded to float
+    const std::size_t length = 1u << 22;
+    std::vector<float> ramp(length);
+    for (std::size_t i = 0; i < length; ++i)
+        ramp[i] = static_cast<float>(i % 1024);
+
+    const double rate = 44100.0 / 48000.0;
+    std::vector<float> resampled(length);
+    linearResample(&ramp[0], length, 0.0, rate, &resampled[0], length);
+    for (std::size_t i = length - 4096; i < length; i += 97)
+    {
+        const double x = static_cast<double>(i) * rate;
+        const double expected = std::fmod(x, 1024.0);
+        if (expected < 1023.0)
+            BOOST_CHECK_SMALL(resampled[i] - expected, 1e-3);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
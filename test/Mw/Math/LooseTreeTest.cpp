@@ -0,0 +1,186 @@
+/**
+ * @file   LooseTreeTest.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <boost/mpl/list.hpp>
+
+#include <Mw/Math/LooseTree.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+typedef boost::mpl::list<float, double> test_types;
+
+namespace {
+
+template<typename T, unsigned N>
+mw::math::Bounds<T, N> randomBounds(T world, T size)
+{
+    mw::math::Vector<T, N> p, s;
+    for (unsigned c = 0; c < N; ++c)
+    {
+        p[c] = static_cast<T>(std::rand() % 1000) / 1000 * world;
+        s[c] = static_cast<T>(std::rand() % 1000) / 1000 * size + static_cast<T>(0.01);
+    }
+    return mw::math::Bounds<T, N>(p, p + s);
+}
+
+template<typename T, unsigned N>
+T squaredDistance(const mw::math::Bounds<T, N> & b, const mw::math::Vector<T, N> & p)
+{
+    T d = 0;
+    for (unsigned c = 0; c < N; ++c)
+    {
+        T x = std::max(std::max(b.getLowerLimit()[c] - p[c], p[c] - b.getUpperLimit()[c]), static_cast<T>(0));
+        d += x * x;
+    }
+    return d;
+}
+
+/**
+ * Move, insert and remove items, then compare the queries to brute force.
+ */
+template<typename T, unsigned N>
+void checkChurn()
+{
+    typedef mw::math::LooseTree<T, N> Tree;
+    typedef mw::math::Bounds<T, N> Box;
+
+    std::srand(7);
+
+    mw::math::Vector<T, N> lower, upper;
+    for (unsigned c = 0; c < N; ++c)
+        upper[c] = 100;
+    Tree tree(Box(lower, upper));
+
+    // Some items are partly or fully outside of the world
+    std::vector<Box> bounds;
+    std::vector<typename Tree::Handle> handles;
+    std::vector<bool> alive;
+    for (unsigned i = 0; i < 400; ++i)
+    {
+        bounds.push_back(randomBounds<T, N>(120, i % 10 ? 3 : 40));
+        handles.push_back(tree.insert(bounds[i], i));
+        alive.push_back(true);
+    }
+
+    for (unsigned step = 0; step < 4; ++step)
+    {
+        for (unsigned i = 0; i < bounds.size(); ++i)
+        {
+            if (i % 7 == step)
+            {
+                if (alive[i])
+                    tree.remove(handles[i]);
+                else
+                    handles[i] = tree.insert(bounds[i], i);
+                alive[i] = !alive[i];
+            }
+            else if (alive[i])
+            {
+                bounds[i] = randomBounds<T, N>(120, i % 10 ? 3 : 40);
+                tree.move(handles[i], bounds[i]);
+            }
+        }
+
+        std::size_t count = std::count(alive.begin(), alive.end(), true);
+        BOOST_CHECK_EQUAL(tree.size(), count);
+
+        for (unsigned q = 0; q < 20; ++q)
+        {
+            Box box = randomBounds<T, N>(100, 30);
+            mw::math::Vector<T, N> point = randomBounds<T, N>(110, 1).getLowerLimit();
+
+            std::vector<std::size_t> boxHits, pointHits;
+            tree.queryBounds(box, std::back_inserter(boxHits));
+            tree.queryPoint(point, std::back_inserter(pointHits));
+            std::sort(boxHits.begin(), boxHits.end());
+            std::sort(pointHits.begin(), pointHits.end());
+
+            std::vector<std::size_t> boxExpected, pointExpected;
+            T nearest = std::numeric_limits<T>::max();
+            for (std::size_t i = 0; i < bounds.size(); ++i)
+                if (alive[i])
+                {
+                    if (bounds[i].isIntersecting(box))
+                        boxExpected.push_back(i);
+                    if (bounds[i].hasPointInside(point))
+                        pointExpected.push_back(i);
+                    nearest = std::min(nearest, squaredDistance(bounds[i], point));
+                }
+
+            BOOST_CHECK(boxHits == boxExpected);
+            BOOST_CHECK(pointHits == pointExpected);
+
+            typename Tree::Handle handle;
+            BOOST_REQUIRE(tree.findNearest(point, handle));
+            BOOST_CHECK_EQUAL(squaredDistance(tree.getBounds(handle), point), nearest);
+        }
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(LooseTree)
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Quadtree, T, test_types)
+{
+    checkChurn<T, 2>();
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Octree, T, test_types)
+{
+    checkChurn<T, 3>();
+}
+
+BOOST_AUTO_TEST_CASE(Handles)
+{
+    typedef mw::math::LooseTree<float, 2, const char *> Tree;
+    typedef mw::math::Bounds<float, 2> Box;
+
+    mw::math::Vector<float, 2> a, b, c;
+    b[0] = b[1] = 64;
+    c[0] = c[1] = 1;
+
+    Tree tree(Box(a, b));
+    BOOST_CHECK(tree.empty());
+    BOOST_CHECK_EQUAL(tree.getNodeCount(), 1u);
+
+    Tree::Handle first = tree.insert(Box(a, c), "first");
+    BOOST_CHECK(tree.contains(first));
+    BOOST_CHECK_EQUAL(tree.getPayload(first), "first");
+    BOOST_CHECK(tree.getNodeCount() > 1);
+
+    // Removed items' handles are invalid, even when the slot is reused
+    tree.remove(first);
+    BOOST_CHECK(!tree.contains(first));
+    BOOST_CHECK_EQUAL(tree.getNodeCount(), 1u);
+    BOOST_CHECK_THROW(tree.remove(first), std::invalid_argument);
+    BOOST_CHECK_THROW(tree.getPayload(first), std::invalid_argument);
+
+    Tree::Handle second = tree.insert(Box(a, c), "second");
+    BOOST_CHECK(second != first);
+    BOOST_CHECK(!tree.contains(first));
+    BOOST_CHECK_EQUAL(tree.getPayload(second), "second");
+
+    // Nearest item farther than the maximum distance
+    Tree::Handle found;
+    BOOST_CHECK(!tree.findNearest(b, found, 10));
+    BOOST_CHECK(tree.findNearest(b, found));
+    BOOST_CHECK(found == second);
+
+    tree.clear();
+    BOOST_CHECK(tree.empty());
+    BOOST_CHECK(!tree.contains(second));
+
+    BOOST_CHECK_THROW(Tree(Box(a, a)), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
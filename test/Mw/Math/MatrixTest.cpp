@@ -0,0 +1,297 @@
+/**
+ * @file   MatrixTest.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <boost/mpl/list.hpp>
+
+#include <Mw/Math/Matrix.hpp>
+#include <Mw/Math/MatrixTransform.hpp>
+#include <Mw/Thread/TaskPool.hpp>
+
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+typedef boost::mpl::list<float, double> test_types;
+
+namespace {
+
+template<typename T, unsigned R, unsigned C>
+mw::math::Matrix<T, R, C> randomMatrix()
+{
+    mw::math::Matrix<T, R, C> m;
+    for (unsigned r = 0; r < R; ++r)
+        for (unsigned c = 0; c < C; ++c)
+            m(r, c) = static_cast<T>(std::rand() % 2000 - 1000) / 100;
+    return m;
+}
+
+template<typename T, unsigned R, unsigned K, unsigned C>
+mw::math::Matrix<T, R, C> naiveProduct(const mw::math::Matrix<T, R, K> & a, const mw::math::Matrix<T, K, C> & b)
+{
+    mw::math::Matrix<T, R, C> m;
+    for (unsigned r = 0; r < R; ++r)
+        for (unsigned c = 0; c < C; ++c)
+        {
+            T sum = a(r, 0) * b(0, c);
+            for (unsigned k = 1; k < K; ++k)
+                sum += a(r, k) * b(k, c);
+            m(r, c) = sum;
+        }
+    return m;
+}
+
+template<typename T, unsigned R, unsigned C>
+mw::math::Matrix<T, R, C> absMatrix(const mw::math::Matrix<T, R, C> & m)
+{
+    mw::math::Matrix<T, R, C> a;
+    for (unsigned r = 0; r < R; ++r)
+        for (unsigned c = 0; c < C; ++c)
+            a(r, c) = std::abs(m(r, c));
+    return a;
+}
+
+template<typename T, unsigned N>
+mw::math::Vector<T, N> absVector(const mw::math::Vector<T, N> & v)
+{
+    mw::math::Vector<T, N> a;
+    for (unsigned i = 0; i < N; ++i)
+        a[i] = std::abs(v[i]);
+    return a;
+}
+
+// Kernels may contract products into FMAs differently, so results are only
+// compared within a few ulps of scale, the sum of the absolute terms
+template<typename T>
+T sumTolerance(T scale)
+{
+    return std::numeric_limits<T>::epsilon() * 16 * scale;
+}
+
+template<typename T, unsigned R, unsigned C>
+void checkClose(const mw::math::Matrix<T, R, C> & actual, const mw::math::Matrix<T, R, C> & expected,
+                const mw::math::Matrix<T, R, C> & scale)
+{
+    for (unsigned r = 0; r < R; ++r)
+        for (unsigned c = 0; c < C; ++c)
+            BOOST_CHECK_SMALL(actual(r, c) - expected(r, c), sumTolerance(scale(r, c)));
+}
+
+template<typename T, unsigned N>
+void checkClose(const mw::math::Vector<T, N> & actual, const mw::math::Vector<T, N> & expected,
+                const mw::math::Vector<T, N> & scale)
+{
+    for (unsigned i = 0; i < N; ++i)
+        BOOST_CHECK_SMALL(actual[i] - expected[i], sumTolerance(scale[i]));
+}
+
+template<typename T, unsigned N>
+void checkIdentity(const mw::math::Matrix<T, N, N> & m, T tolerance)
+{
+    for (unsigned r = 0; r < N; ++r)
+        for (unsigned c = 0; c < N; ++c)
+            BOOST_CHECK_SMALL(m(r, c) - (r == c ? static_cast<T>(1) : static_cast<T>(0)), tolerance);
+}
+
+template<typename T, unsigned N>
+void checkInverse()
+{
+    typedef mw::math::Matrix<T, N, N> M;
+
+    const T tolerance = std::numeric_limits<T>::epsilon() * 1000;
+
+    for (unsigned i = 0; i < 50; ++i)
+    {
+        M m = randomMatrix<T, N, N>();
+        if (std::abs(m.getDeterminant()) < static_cast<T>(1))
+            continue;
+
+        M inv = m.getInverse();
+        checkIdentity(m * inv, tolerance);
+        checkIdentity(inv * m, tolerance);
+        BOOST_CHECK_CLOSE(inv.getDeterminant() * m.getDeterminant(), static_cast<T>(1), 1e-2);
+    }
+
+    // Singular, with a null first pivot
+    M singular = randomMatrix<T, N, N>();
+    for (unsigned c = 0; c < N; ++c)
+    {
+        singular(0, c) = static_cast<T>(0);
+        singular(1, c) = static_cast<T>(c + 1);
+    }
+    singular.setRow(N - 1, singular.getRow(1) * static_cast<T>(2));
+    BOOST_CHECK_EQUAL(singular.getDeterminant(), static_cast<T>(0));
+    BOOST_CHECK_THROW(singular.getInverse(), std::domain_error);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(Matrix)
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Elements, T, test_types)
+{
+    typedef mw::math::Matrix<T, 2, 3> M;
+
+    const T values[2][3] = { { 1, 2, 3 }, { 4, 5, 6 } };
+    M m(values);
+    BOOST_CHECK_EQUAL(m.get(1, 2), static_cast<T>(6));
+    BOOST_CHECK_EQUAL(m(0, 1), static_cast<T>(2));
+    BOOST_CHECK_THROW(m.get(2, 0), std::out_of_range);
+    BOOST_CHECK_THROW(m.set(0, 3, 1), std::out_of_range);
+
+    m.set(0, 0, 7);
+    BOOST_CHECK_EQUAL(m(0, 0), static_cast<T>(7));
+    BOOST_CHECK_EQUAL(m.getRow(1)[2], static_cast<T>(6));
+    BOOST_CHECK_EQUAL(m.getColumn(1)[1], static_cast<T>(5));
+
+    mw::math::Matrix<T, 3, 2> t = m.getTransposed();
+    BOOST_CHECK_EQUAL(t(2, 1), static_cast<T>(6));
+    BOOST_CHECK(t.getTransposed() == m);
+
+    typedef mw::math::Matrix<T, 3, 3> M3;
+    BOOST_CHECK(M3::identity() * M3::identity() == M3::identity());
+
+    std::ostringstream oss;
+    oss << M(values);
+    BOOST_CHECK_EQUAL(oss.str(), "Matrix<2, 3>[[1, 2, 3], [4, 5, 6]]");
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Arithmetic, T, test_types)
+{
+    typedef mw::math::Matrix<T, 2, 2> M;
+
+    const T va[2][2] = { { 1, 2 }, { 3, 4 } };
+    const T vb[2][2] = { { 5, 6 }, { 7, 8 } };
+    M a(va), b(vb);
+
+    const T sum[2][2] = { { 6, 8 }, { 10, 12 } };
+    BOOST_CHECK(a + b == M(sum));
+    BOOST_CHECK(M(sum) - b == a);
+    BOOST_CHECK(a * static_cast<T>(2) + a == static_cast<T>(3) * a);
+    BOOST_CHECK(a * static_cast<T>(2) / static_cast<T>(2) == a);
+    BOOST_CHECK(-a + a == M());
+    BOOST_CHECK(a != b);
+    BOOST_CHECK_THROW(a / static_cast<T>(0), std::domain_error);
+
+    const T product[2][2] = { { 19, 22 }, { 43, 50 } };
+    BOOST_CHECK(a * b == M(product));
+    a *= b;
+    BOOST_CHECK(a == M(product));
+
+    // Products of several shapes against the naive one, for the SIMD kernels
+    for (unsigned i = 0; i < 20; ++i)
+    {
+        mw::math::Matrix<T, 3, 3> a3 = randomMatrix<T, 3, 3>(), b3 = randomMatrix<T, 3, 3>();
+        mw::math::Matrix<T, 4, 4> a4 = randomMatrix<T, 4, 4>(), b4 = randomMatrix<T, 4, 4>();
+        mw::math::Matrix<T, 2, 3> a23 = randomMatrix<T, 2, 3>();
+        mw::math::Matrix<T, 3, 4> b34 = randomMatrix<T, 3, 4>();
+
+        checkClose(a3 * b3, naiveProduct(a3, b3), naiveProduct(absMatrix(a3), absMatrix(b3)));
+        checkClose(a4 * b4, naiveProduct(a4, b4), naiveProduct(absMatrix(a4), absMatrix(b4)));
+        checkClose(a23 * b34, naiveProduct(a23, b34), naiveProduct(absMatrix(a23), absMatrix(b34)));
+    }
+
+    // Vector product
+    const T vm[2][3] = { { 1, 0, 2 }, { 0, 3, 1 } };
+    mw::math::Vector<T, 3> v;
+    v[0] = 1;
+    v[1] = 2;
+    v[2] = 3;
+    mw::math::Vector<T, 2> mv = mw::math::Matrix<T, 2, 3>(vm) * v;
+    BOOST_CHECK_EQUAL(mv[0], static_cast<T>(7));
+    BOOST_CHECK_EQUAL(mv[1], static_cast<T>(9));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Inverse, T, test_types)
+{
+    std::srand(3);
+
+    checkInverse<T, 2>();
+    checkInverse<T, 3>();
+    checkInverse<T, 4>();
+    checkInverse<T, 5>();
+
+    const T values[3][3] = { { 2, 0, 0 }, { 0, 4, 0 }, { 1, 0, 1 } };
+    typedef mw::math::Matrix<T, 3, 3> M3;
+    typedef mw::math::Matrix<T, 4, 4> M4;
+    BOOST_CHECK_CLOSE(M3(values).getDeterminant(), static_cast<T>(8), 1e-4);
+    BOOST_CHECK_CLOSE(M4::identity().getDeterminant(), static_cast<T>(1), 1e-4);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Transform, T, test_types)
+{
+    typedef mw::math::Vector<T, 3> V3;
+    typedef mw::math::Vector<T, 4> V4;
+
+    std::srand(5);
+
+    mw::math::Matrix<T, 4, 4> m = randomMatrix<T, 4, 4>();
+    mw::math::Matrix<T, 3, 3> m3 = randomMatrix<T, 3, 3>();
+
+    // Single vectors
+    const T translation[4][4] = { { 1, 0, 0, 5 }, { 0, 1, 0, 6 }, { 0, 0, 1, 7 }, { 0, 0, 0, 1 } };
+    V3 p;
+    p[0] = 1;
+    p[1] = 2;
+    p[2] = 3;
+    V3 tp = mw::math::transformPoint(mw::math::Matrix<T, 4, 4>(translation), p);
+    V3 td = mw::math::transformDirection(mw::math::Matrix<T, 4, 4>(translation), p);
+    BOOST_CHECK_EQUAL(tp[0], static_cast<T>(6));
+    BOOST_CHECK_EQUAL(tp[2], static_cast<T>(10));
+    BOOST_CHECK(td == p);
+
+    // Batches, with a partial last block and chunk
+    const std::size_t count = 40000 + 37;
+    std::vector<V3> points(count);
+    std::vector<V4> vectors(count);
+    for (std::size_t i = 0; i < count; ++i)
+        for (unsigned c = 0; c < 4; ++c)
+        {
+            const T value = static_cast<T>(std::rand() % 2000 - 1000) / 10;
+            if (c < 3)
+                points[i][c] = value;
+            vectors[i][c] = value;
+        }
+
+    std::vector<V3> outPoints(count), outDirections(count), out3(count);
+    std::vector<V4> out4(count);
+    mw::math::transformPoints(m, &points[0], &outPoints[0], count);
+    mw::math::transformDirections(m, &points[0], &outDirections[0], count);
+    mw::math::transform(m3, &points[0], &out3[0], count);
+    mw::math::transform(m, &vectors[0], &out4[0], count);
+
+    const mw::math::Matrix<T, 4, 4> absM = absMatrix(m);
+    const mw::math::Matrix<T, 3, 3> absM3 = absMatrix(m3);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const V3 absP = absVector(points[i]);
+        checkClose(outPoints[i], mw::math::transformPoint(m, points[i]), mw::math::transformPoint(absM, absP));
+        checkClose(outDirections[i], mw::math::transformDirection(m, points[i]),
+                   mw::math::transformDirection(absM, absP));
+        checkClose(out3[i], V3(m3 * points[i]), V3(absM3 * absP));
+        checkClose(out4[i], V4(m * vectors[i]), V4(absM * absVector(vectors[i])));
+    }
+
+    // Parallel and in place
+    for (unsigned threads = 1; threads <= 3; ++threads)
+    {
+        mw::thread::TaskPool pool(threads);
+
+        std::vector<V3> inPlace(points);
+        mw::math::transformPoints(m, &inPlace[0], &inPlace[0], count, pool);
+        BOOST_CHECK(inPlace == outPoints);
+
+        std::vector<V4> parallel(count);
+        mw::math::transform(m, &vectors[0], &parallel[0], count, pool);
+        BOOST_CHECK(parallel == out4);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
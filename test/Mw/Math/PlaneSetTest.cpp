@@ -0,0 +1,150 @@
+/**
+ * @file   PlaneSetTest.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <boost/mpl/list.hpp>
+
+#include <Mw/Math/BoundsArray.hpp>
+#include <Mw/Math/Frustum.hpp>
+#include <Mw/Math/Plane.hpp>
+#include <Mw/Math/PlaneSet.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+typedef boost::mpl::list<float, double> test_types;
+
+namespace {
+
+template<typename T>
+mw::math::Vector<T, 3> vec3(T x, T y, T z)
+{
+    mw::math::Vector<T, 3> v;
+    v[0] = x;
+    v[1] = y;
+    v[2] = z;
+    return v;
+}
+
+template<typename T>
+T random(T range)
+{
+    return static_cast<T>(std::rand() % 10000) / 10000 * range;
+}
+
+template<typename T>
+mw::math::Frustum<T> makeFrustum()
+{
+    // Looking down -z, 90 degrees field of view
+    return mw::math::Frustum<T>(vec3<T>(0, 0, 0), vec3<T>(0, 0, -2), vec3<T>(0, 1, 0),
+                                static_cast<T>(1.5707963267948966), 2, 1, 100);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(PlaneSet)
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Plane, T, test_types)
+{
+    typedef mw::math::Vector<T, 3> V;
+
+    mw::math::Plane<T, V> plane(vec3<T>(0, 0, 2), vec3<T>(5, 5, 1));
+    BOOST_CHECK(plane.getNormal() == vec3<T>(0, 0, 1));
+    BOOST_CHECK_CLOSE(plane.getDistanceFromOrigin(), static_cast<T>(1), 1e-4);
+
+    BOOST_CHECK(plane.isOver(vec3<T>(0, 0, 3)));
+    BOOST_CHECK(plane.isUnder(vec3<T>(0, 0, -3)));
+    BOOST_CHECK(plane.isOn(vec3<T>(7, -2, 1)));
+    BOOST_CHECK_CLOSE(plane.getDistance(vec3<T>(1, 1, -3)), static_cast<T>(4), 1e-4);
+    BOOST_CHECK_CLOSE(plane.getSignedDistance(vec3<T>(1, 1, -3)), static_cast<T>(-4), 1e-4);
+    BOOST_CHECK(plane.getProjection(vec3<T>(1, 2, 4)) == vec3<T>(1, 2, 1));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Classify, T, test_types)
+{
+    typedef mw::math::Bounds<T, 3> Box;
+    typedef mw::math::PlaneSet<T, 3> Set;
+
+    mw::math::Frustum<T> frustum = makeFrustum<T>();
+    BOOST_CHECK_EQUAL(frustum.size(), 6u);
+
+    BOOST_CHECK(frustum.hasPointInside(vec3<T>(0, 0, -10)));
+    BOOST_CHECK(frustum.hasPointInside(vec3<T>(19, 0, -10)));
+    BOOST_CHECK(!frustum.hasPointInside(vec3<T>(0, 11, -10)));
+    BOOST_CHECK(!frustum.hasPointInside(vec3<T>(0, 0, -0.5)));
+    BOOST_CHECK(!frustum.hasPointInside(vec3<T>(0, 0, -101)));
+
+    BOOST_CHECK_EQUAL(frustum.classify(Box(vec3<T>(-1, -1, -11), vec3<T>(1, 1, -9))), Set::INSIDE);
+    BOOST_CHECK_EQUAL(frustum.classify(Box(vec3<T>(-1, 9, -11), vec3<T>(1, 12, -9))), Set::INTERSECTING);
+    BOOST_CHECK_EQUAL(frustum.classify(Box(vec3<T>(-1, -1, 1), vec3<T>(1, 1, 2))), Set::OUTSIDE);
+    BOOST_CHECK_EQUAL(frustum.classify(Box(vec3<T>(-1, -1, -200), vec3<T>(1, 1, -150))), Set::OUTSIDE);
+
+    BOOST_CHECK_EQUAL(frustum.classify(vec3<T>(0, 0, -10), 1), Set::INSIDE);
+    BOOST_CHECK_EQUAL(frustum.classify(vec3<T>(0, 10, -10), 1), Set::INTERSECTING);
+    BOOST_CHECK_EQUAL(frustum.classify(vec3<T>(0, 20, -10), 1), Set::OUTSIDE);
+
+    // Coherency
+    unsigned char last = 0;
+    BOOST_CHECK_EQUAL(frustum.classify(Box(vec3<T>(-1, -1, -200), vec3<T>(1, 1, -150)), last), Set::OUTSIDE);
+    BOOST_CHECK_EQUAL(last, 5);
+    BOOST_CHECK_EQUAL(frustum.classify(Box(vec3<T>(-1, -1, -11), vec3<T>(1, 1, -9)), last), Set::INSIDE);
+    BOOST_CHECK_EQUAL(last, 5);
+
+    BOOST_CHECK_THROW(frustum.get(6), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Batch, T, test_types)
+{
+    typedef mw::math::Bounds<T, 3> Box;
+    typedef mw::math::PlaneSet<T, 3> Set;
+
+    std::srand(11);
+    mw::math::Frustum<T> frustum = makeFrustum<T>();
+
+    std::vector<Box> boxes;
+    mw::math::VectorArray<T, 3> centers;
+    std::vector<T> radii;
+    for (unsigned i = 0; i < 1000; ++i)
+    {
+        mw::math::Vector<T, 3> p = vec3<T>(random<T>(200) - 100, random<T>(200) - 100, random<T>(200) - 150);
+        boxes.push_back(Box(p, p + vec3<T>(random<T>(10), random<T>(10), random<T>(10))));
+        centers.push_back(p);
+        radii.push_back(random<T>(10));
+    }
+
+    mw::math::BoundsArray<T, 3> array(boxes.begin(), boxes.end());
+    typename Set::Coherency coherency;
+
+    std::vector<typename Set::Classification> classes(boxes.size());
+    frustum.classify(array, &classes[0]);
+
+    for (unsigned frame = 0; frame < 2; ++frame)
+    {
+        typename Set::Indices visible, coherent, spheres;
+        frustum.cull(array, visible);
+        frustum.cull(array, coherency, coherent);
+        frustum.cull(centers, &radii[0], spheres);
+
+        typename Set::Indices expected, expectedSpheres;
+        for (std::size_t i = 0; i < boxes.size(); ++i)
+        {
+            BOOST_CHECK_EQUAL(classes[i], frustum.classify(boxes[i]));
+            if (frustum.classify(boxes[i]) != Set::OUTSIDE)
+                expected.push_back(i);
+            if (frustum.classify(centers[i], radii[i]) != Set::OUTSIDE)
+                expectedSpheres.push_back(i);
+        }
+
+        BOOST_CHECK(!expected.empty());
+        BOOST_CHECK(expected.size() < boxes.size());
+        BOOST_CHECK(visible == expected);
+        BOOST_CHECK(coherent == expected);
+        BOOST_CHECK(spheres == expectedSpheres);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,243 @@
+/**
+ * @file   QuaternionTest.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <boost/mpl/list.hpp>
+
+#include <Mw/Math/Quaternion.hpp>
+#include <Mw/Math/QuaternionArray.hpp>
+
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#define EPSILON std::numeric_limits<T>::epsilon() * 100
+
+typedef boost::mpl::list<float, double> test_types;
+
+namespace {
+
+template<typename T>
+mw::math::Vector<T, 3> makeVector(T x, T y, T z)
+{
+    mw::math::Vector<T, 3> v;
+    v[0] = x;
+    v[1] = y;
+    v[2] = z;
+    return v;
+}
+
+template<typename T>
+mw::math::Quaternion<T> randomRotation()
+{
+    mw::math::Quaternion<T> q;
+    do
+    {
+        q.set(static_cast<T>(std::rand() % 2001 - 1000), static_cast<T>(std::rand() % 2001 - 1000),
+              static_cast<T>(std::rand() % 2001 - 1000), static_cast<T>(std::rand() % 2001 - 1000));
+    } while (q.getNorm() < static_cast<T>(1));
+    return normalize(q);
+}
+
+template<typename T>
+T distance(const mw::math::Quaternion<T> & q1, const mw::math::Quaternion<T> & q2)
+{
+    return (q1 - q2).getNorm();
+}
+
+template<typename T>
+T distance(const mw::math::Vector<T, 3> & v1, const mw::math::Vector<T, 3> & v2)
+{
+    return mw::math::Vector<T, 3>(v1 - v2).getLength();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(Quaternion)
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Constructor, T, test_types)
+{
+    using mw::math::Quaternion;
+
+    Quaternion<T> q;
+    BOOST_CHECK_EQUAL(q.getW(), 0.0);
+    BOOST_CHECK_EQUAL(q.getNorm(), 0.0);
+
+    Quaternion<T> q2(1.0, 2.0, 3.0, 4.0);
+    BOOST_CHECK_EQUAL(q2.getW(), 1.0);
+    BOOST_CHECK_EQUAL(q2.getX(), 2.0);
+    BOOST_CHECK_EQUAL(q2.getY(), 3.0);
+    BOOST_CHECK_EQUAL(q2.getZ(), 4.0);
+    BOOST_CHECK_EQUAL(q2.getVectorPart()[2], 4.0);
+
+    Quaternion<double> copy(q2);
+    BOOST_CHECK_EQUAL(copy.getZ(), 4.0);
+
+    BOOST_CHECK_EQUAL(Quaternion<T>::identity(), Quaternion<T>(1.0, 0.0, 0.0, 0.0));
+
+    std::ostringstream oss;
+    oss << q2;
+    BOOST_CHECK_EQUAL(oss.str(), "Quaternion[1, 2, 3, 4]");
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Operations, T, test_types)
+{
+    using mw::math::Quaternion;
+
+    const Quaternion<T> one = Quaternion<T>::identity();
+    const Quaternion<T> i(0.0, 1.0, 0.0, 0.0), j(0.0, 0.0, 1.0, 0.0), k(0.0, 0.0, 0.0, 1.0);
+
+    BOOST_CHECK_EQUAL(i * j, k);
+    BOOST_CHECK_EQUAL(j * k, i);
+    BOOST_CHECK_EQUAL(k * i, j);
+    BOOST_CHECK_EQUAL(j * i, - k);
+    BOOST_CHECK_EQUAL(i * i, - one);
+    BOOST_CHECK_EQUAL(i * j * k, - one);
+
+    const Quaternion<T> q(1.0, 2.0, 3.0, 4.0);
+    BOOST_CHECK_EQUAL(q + q, q * static_cast<T>(2));
+    BOOST_CHECK_EQUAL(q - q, Quaternion<T>());
+    BOOST_CHECK_EQUAL(q * static_cast<T>(2) / static_cast<T>(2), q);
+    BOOST_CHECK_EQUAL(q.getConjugate(), Quaternion<T>(1.0, -2.0, -3.0, -4.0));
+    BOOST_CHECK_EQUAL(q.dot(q), 30.0);
+    BOOST_CHECK_SMALL(distance(q * q.getInverse(), one), EPSILON);
+    BOOST_CHECK_CLOSE(normalize(q).getNorm(), static_cast<T>(1), EPSILON);
+
+    BOOST_CHECK_THROW(q / static_cast<T>(0), std::domain_error);
+    BOOST_CHECK_THROW(Quaternion<T>().getInverse(), std::domain_error);
+    BOOST_CHECK_THROW(normalize(Quaternion<T>()), std::domain_error);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Rotation, T, test_types)
+{
+    using mw::math::Quaternion;
+    typedef mw::math::Vector<T, 3> V;
+
+    const T halfPi = static_cast<T>(std::acos(0.0));
+
+    const Quaternion<T> qz = Quaternion<T>::fromAxisAngle(makeVector<T>(0, 0, 2), halfPi);
+    BOOST_CHECK_SMALL(distance(qz.rotate(makeVector<T>(1, 0, 0)), makeVector<T>(0, 1, 0)), EPSILON);
+    BOOST_CHECK_SMALL(distance(qz.rotate(makeVector<T>(0, 0, 1)), makeVector<T>(0, 0, 1)), EPSILON);
+    BOOST_CHECK_THROW(Quaternion<T>::fromAxisAngle(V(), halfPi), std::domain_error);
+
+    std::srand(7);
+    for (unsigned n = 0; n < 100; ++n)
+    {
+        const Quaternion<T> q1 = randomRotation<T>(), q2 = randomRotation<T>();
+        const V v = makeVector<T>(std::rand() % 21 - 10, std::rand() % 21 - 10, std::rand() % 21 - 10);
+
+        // Same rotation as the matrix and as the quaternion products
+        BOOST_CHECK_SMALL(distance(q1.rotate(v), V(q1.toMatrix() * v)), EPSILON * 10);
+        const Quaternion<T> p = q1 * Quaternion<T>(0, v[0], v[1], v[2]) * q1.getConjugate();
+        BOOST_CHECK_SMALL(distance(q1.rotate(v), p.getVectorPart()), EPSILON * 10);
+
+        // Composition
+        BOOST_CHECK_SMALL(distance((q1 * q2).rotate(v), q1.rotate(q2.rotate(v))), EPSILON * 10);
+    }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Interpolation, T, test_types)
+{
+    using mw::math::Quaternion;
+
+    const T halfPi = static_cast<T>(std::acos(0.0));
+    const Quaternion<T> q1 = Quaternion<T>::identity();
+    const Quaternion<T> q2 = Quaternion<T>::fromAxisAngle(makeVector<T>(1, 0, 0), halfPi);
+    const Quaternion<T> half = Quaternion<T>::fromAxisAngle(makeVector<T>(1, 0, 0), halfPi / 2);
+
+    BOOST_CHECK_SMALL(distance(mw::math::slerp(q1, q2, static_cast<T>(0)), q1), EPSILON);
+    BOOST_CHECK_SMALL(distance(mw::math::slerp(q1, q2, static_cast<T>(1)), q2), EPSILON);
+    BOOST_CHECK_SMALL(distance(mw::math::slerp(q1, q2, static_cast<T>(0.5)), half), EPSILON);
+    BOOST_CHECK_SMALL(distance(mw::math::nlerp(q1, q2, static_cast<T>(0.5)), half), EPSILON);
+
+    // Shortest path, -q2 is the same rotation as q2
+    BOOST_CHECK_SMALL(distance(mw::math::slerp(q1, - q2, static_cast<T>(0.5)), half), EPSILON);
+    BOOST_CHECK_SMALL(distance(mw::math::nlerp(q1, - q2, static_cast<T>(0.5)), half), EPSILON);
+
+    // Constant angular speed
+    const Quaternion<T> quarter = mw::math::slerp(q1, q2, static_cast<T>(0.25));
+    BOOST_CHECK_CLOSE(quarter.getW(), std::cos(halfPi / 8), EPSILON * 10);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Array, T, test_types)
+{
+    using mw::math::Quaternion;
+    using mw::math::QuaternionArray;
+
+    QuaternionArray<T> array(3);
+    BOOST_CHECK_EQUAL(array.size(), 3u);
+    BOOST_CHECK_EQUAL(array[2], Quaternion<T>::identity());
+    BOOST_CHECK_THROW(array.get(3), std::out_of_range);
+    BOOST_CHECK_THROW(array.set(3, Quaternion<T>()), std::out_of_range);
+
+    array.set(1, Quaternion<T>(1.0, 2.0, 3.0, 4.0));
+    BOOST_CHECK_EQUAL(array.get(1), Quaternion<T>(1.0, 2.0, 3.0, 4.0));
+    BOOST_CHECK_EQUAL(array.lane(3)[1], 4.0);
+
+    std::vector<Quaternion<T> > copy(3);
+    array.copyTo(copy.begin());
+    BOOST_CHECK_EQUAL(copy[1], array[1]);
+    QuaternionArray<T> array2(copy.begin(), copy.end());
+    BOOST_CHECK_EQUAL(array2[1], array[1]);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(BatchInterpolation, T, test_types)
+{
+    using mw::math::Quaternion;
+    using mw::math::QuaternionArray;
+
+    // Odd size, for the SIMD kernels tails
+    const std::size_t count = 1003;
+
+    std::srand(11);
+    QuaternionArray<T> from, to;
+    std::vector<T> mu(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        from.push_back(randomRotation<T>());
+        to.push_back(randomRotation<T>());
+        mu[i] = static_cast<T>(std::rand() % 1001) / 1000;
+    }
+
+    // Within a few ulps of the scalar nlerp, which may be contracted to FMAs
+    const T tolerance = std::numeric_limits<T>::epsilon() * 4;
+
+    QuaternionArray<T> out;
+    mw::math::nlerp(from, to, &mu[0], out);
+    BOOST_REQUIRE_EQUAL(out.size(), count);
+    for (std::size_t i = 0; i < count; ++i)
+        BOOST_CHECK_SMALL(distance(out[i], mw::math::nlerp(from[i], to[i], mu[i])), tolerance);
+
+    mw::math::nlerp(from, to, static_cast<T>(0.3), out);
+    for (std::size_t i = 0; i < count; ++i)
+        BOOST_CHECK_SMALL(distance(out[i], mw::math::nlerp(from[i], to[i], static_cast<T>(0.3))), tolerance);
+
+    // Polynomial approximation, checked against double precision slerp
+    mw::math::slerp(from, to, &mu[0], out);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        // Opposite quaternions have no shortest path
+        if (std::abs(from[i].dot(to[i])) < static_cast<T>(1e-3))
+            continue;
+
+        const Quaternion<double> expected = mw::math::slerp(Quaternion<double>(from[i]), Quaternion<double>(to[i]),
+                                                            static_cast<double>(mu[i]));
+        BOOST_CHECK_SMALL(distance(Quaternion<double>(out[i]), expected), 1e-6);
+    }
+
+    // In place
+    QuaternionArray<T> inPlace(from);
+    mw::math::slerp(inPlace, to, static_cast<T>(0.5), inPlace);
+    mw::math::slerp(from, to, static_cast<T>(0.5), out);
+    for (std::size_t i = 0; i < count; ++i)
+        BOOST_CHECK_EQUAL(inPlace[i], out[i]);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,113 @@
+/**
+ * @file   RationalAccumulatorTest.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <boost/mpl/list.hpp>
+
+#include <Mw/Math/RationalAccumulator.hpp>
+
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+typedef boost::mpl::list<int, boost::int16_t, boost::int64_t> test_types;
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(RationalAccumulator)
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Sum, T, test_types)
+{
+    typedef mw::math::Rational<T> Rat;
+
+    // Small denominators, so that the eager sums fit
+    std::srand(5);
+    std::vector<Rat> values;
+    for (int i = 0; i < 200; ++i)
+        values.push_back(Rat(static_cast<T>(std::rand() % 21 - 10), static_cast<T>(1 << (std::rand() % 6))));
+
+    Rat eager;
+    mw::math::RationalAccumulator<T> accumulator;
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+        eager += values[i];
+        accumulator += values[i];
+        BOOST_CHECK_EQUAL(accumulator.get(), eager);
+    }
+    BOOST_CHECK_EQUAL(mw::math::sum(&values[0], values.size()), eager);
+
+    for (std::size_t i = 0; i < values.size(); ++i)
+        accumulator -= values[i];
+    BOOST_CHECK_EQUAL(accumulator.get(), Rat());
+
+    mw::math::RationalAccumulator<T> initial(Rat(3, 4));
+    initial += Rat(1, 4);
+    BOOST_CHECK_EQUAL(initial.get(), Rat(1));
+    initial.reset();
+    BOOST_CHECK_EQUAL(initial.get(), Rat());
+}
+
+BOOST_AUTO_TEST_CASE(Dot)
+{
+    typedef mw::math::Rational<boost::int64_t> Rat;
+
+    std::srand(9);
+    std::vector<Rat> a, b;
+    for (int i = 0; i < 1000; ++i)
+    {
+        a.push_back(Rat(std::rand() % 2001 - 1000, std::rand() % 12 + 1));
+        b.push_back(Rat(std::rand() % 2001 - 1000, std::rand() % 12 + 1));
+    }
+
+    Rat eager;
+    for (std::size_t i = 0; i < a.size(); ++i)
+        eager += a[i] * b[i];
+    BOOST_CHECK_EQUAL(mw::math::dot(&a[0], &b[0], a.size()), eager);
+
+    mw::math::Vector<Rat, 4> u, v;
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        u[i] = a[i];
+        v[i] = b[i];
+    }
+    BOOST_CHECK_EQUAL(mw::math::dot(u, v), u.dot(v));
+}
+
+BOOST_AUTO_TEST_CASE(Overflow)
+{
+    typedef mw::math::Rational<boost::int64_t, mw::math::ThrowOnOverflow> Rat;
+    typedef mw::math::RationalAccumulator<boost::int64_t, mw::math::ThrowOnOverflow> Accumulator;
+
+    // 1 / (k (k + 1)) = 1 / k - 1 / (k + 1), the unreduced denominators
+    // overflow after a few terms, the sum is n / (n + 1)
+    Accumulator telescoping;
+    for (boost::int64_t k = 1; k <= 1000; ++k)
+        telescoping += Rat(1, k * (k + 1));
+    BOOST_CHECK_EQUAL(telescoping.get(), Rat(1000, 1001));
+
+    // Large products, the reduced sum fits
+    const boost::int64_t max = std::numeric_limits<boost::int64_t>::max();
+    const Rat big(max / 2, 3), small(2, max / 2);
+    std::vector<Rat> a(100, big), b(100, small);
+    BOOST_CHECK_EQUAL(mw::math::dot(&a[0], &b[0], a.size()), Rat(200, 3));
+
+    Accumulator overflow;
+    overflow += Rat(max);
+#ifdef MW_HAS_INT128
+    // Only the read sum must fit
+    BOOST_CHECK_NO_THROW(overflow += Rat(1));
+    BOOST_CHECK_THROW(overflow.get(), std::overflow_error);
+
+    overflow -= Rat(2);
+    BOOST_CHECK_EQUAL(overflow.get(), Rat(max - 1));
+#else
+    BOOST_CHECK_THROW(overflow += Rat(1), std::overflow_error);
+#endif // MW_HAS_INT128
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -8,7 +8,39 @@
 
 #include <Mw/Math/Rational.hpp>
 
-typedef boost::mpl::list<int> test_types;
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+
+#include <boost/cstdint.hpp>
+
+typedef boost::mpl::list<int, boost::int16_t, boost::int64_t> test_types;
+
+namespace {
+
+template<typename U>
+U euclidGcd(U a, U b)
+{
+    while (b)
+    {
+        const U tmp = a % b;
+        a = b;
+        b = tmp;
+    }
+    return a;
+}
+
+boost::int64_t random64()
+{
+    boost::uint64_t value = 0;
+    for (int i = 0; i < 4; ++i)
+        value = (value << 16) ^ static_cast<boost::uint64_t>(std::rand());
+
+    // Mixed magnitudes
+    return static_cast<boost::int64_t>(value) >> (std::rand() % 63);
+}
+
+} // namespace
 
 BOOST_AUTO_TEST_SUITE(Math)
 BOOST_AUTO_TEST_SUITE(Rational)
@@ -95,5 +127,105 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(Operations, T, test_types)
     BOOST_CHECK_THROW(a / Rational<T>(0), std::invalid_argument);
 }
 
+BOOST_AUTO_TEST_CASE(Gcd)
+{
+    BOOST_CHECK_EQUAL(mw::math::binaryGcd(0u, 0u), 0u);
+    BOOST_CHECK_EQUAL(mw::math::binaryGcd(0u, 12u), 12u);
+    BOOST_CHECK_EQUAL(mw::math::binaryGcd(12u, 0u), 12u);
+    BOOST_CHECK_EQUAL(mw::math::binaryGcd(12u, 18u), 6u);
+    BOOST_CHECK_EQUAL(mw::math::binaryGcd(1u << 31, 1u << 20), 1u << 20);
+
+    std::srand(19);
+    for (int i = 0; i < 10000; ++i)
+    {
+        const boost::uint64_t a = static_cast<boost::uint64_t>(random64());
+        const boost::uint64_t b = static_cast<boost::uint64_t>(random64()) << (std::rand() % 8);
+        BOOST_CHECK_EQUAL(mw::math::binaryGcd(a, b), euclidGcd(a, b));
+
+        const boost::uint32_t c = static_cast<boost::uint32_t>(a), d = static_cast<boost::uint32_t>(b);
+        BOOST_CHECK_EQUAL(mw::math::binaryGcd(c, d), euclidGcd(c, d));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Overflow)
+{
+    typedef mw::math::Rational<int> Rat;
+    typedef mw::math::Rational<int, mw::math::ThrowOnOverflow> Checked;
+
+    const int max = std::numeric_limits<int>::max();
+    const int min = std::numeric_limits<int>::min();
+
+    // Intermediate values do not fit, results do
+    BOOST_CHECK_EQUAL(Rat(max - 2, max - 1) + Rat(max, max - 1), Rat(2));
+    BOOST_CHECK_EQUAL(Checked(max - 2, max - 1) + Checked(max, max - 1), Checked(2));
+    BOOST_CHECK_EQUAL(Checked(max, 2) - Checked(-max, 2), Checked(max));
+    BOOST_CHECK_EQUAL(Checked(min) / Checked(min), Checked(1));
+    BOOST_CHECK_EQUAL(Checked(min, 3) * Checked(3, 2), Checked(min / 2));
+    BOOST_CHECK_EQUAL(Checked(min, min), Checked(1));
+    BOOST_CHECK_EQUAL(Checked(min, -2), Checked(-(min / 2)));
+
+    // Comparisons are exact
+    BOOST_CHECK(Rat(max, max - 1) < Rat(max - 1, max - 2));
+    BOOST_CHECK(Rat(-max, max - 1) > Rat(-(max - 1), max - 2));
+    BOOST_CHECK(Rat(min) < Rat(max));
+    BOOST_CHECK(Rat(min, max) < Rat(-max, max));
+
+    BOOST_CHECK_THROW(Checked(max) + Checked(1), std::overflow_error);
+    BOOST_CHECK_THROW(Checked(min) - Checked(1), std::overflow_error);
+    BOOST_CHECK_THROW(Checked(max) * Checked(2), std::overflow_error);
+    BOOST_CHECK_THROW(Checked(1, max) / Checked(2), std::overflow_error);
+    BOOST_CHECK_THROW(Checked(1, min), std::overflow_error);
+    BOOST_CHECK_THROW(Checked(1) / Checked(min), std::overflow_error);
+    BOOST_CHECK_NO_THROW(Rat(max) + Rat(1));
+}
+
+#ifdef MW_HAS_INT128
+
+BOOST_AUTO_TEST_CASE(Narrow)
+{
+    // Same results without the wider type, overflows of intermediate
+    // values are reported
+    typedef mw::math::detail::RationalArithmetic<boost::int64_t, true> Wide;
+    typedef mw::math::detail::RationalArithmetic<boost::int64_t, false> Narrow;
+
+    std::srand(23);
+    for (int i = 0; i < 20000; ++i)
+    {
+        boost::int64_t n1 = random64(), d1 = random64(), n2 = random64(), d2 = random64();
+        if (i % 4 == 0)
+            n2 = n1 + std::rand() % 3 - 1;
+        if (i % 8 == 0)
+            d2 = d1;
+        if (d1 <= 0 || d2 <= 0)
+            continue;
+        Wide::reduce(n1, d1);
+        Wide::reduce(n2, d2);
+
+        BOOST_CHECK_EQUAL(Narrow::less(n1, d1, n2, d2), Wide::less(n1, d1, n2, d2));
+        BOOST_CHECK_EQUAL(Narrow::less(n2, d2, n1, d1), Wide::less(n2, d2, n1, d1));
+        BOOST_CHECK(!Narrow::less(n1, d1, n1, d1));
+
+        const bool subtract = i % 2 != 0;
+        boost::int64_t wn, wd, nn, nd;
+        const bool wideFits = Wide::add(n1, d1, n2, d2, subtract, wn, wd);
+        if (Narrow::add(n1, d1, n2, d2, subtract, nn, nd))
+        {
+            BOOST_CHECK(wideFits);
+            BOOST_CHECK_EQUAL(nn, wn);
+            BOOST_CHECK_EQUAL(nd, wd);
+        }
+
+        const bool wideProductFits = Wide::multiply(n1, d1, n2, d2, wn, wd);
+        if (Narrow::multiply(n1, d1, n2, d2, nn, nd))
+        {
+            BOOST_CHECK(wideProductFits);
+            BOOST_CHECK_EQUAL(nn, wn);
+            BOOST_CHECK_EQUAL(nd, wd);
+        }
+    }
+}
+
+#endif // MW_HAS_INT128
+
 BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE_END()
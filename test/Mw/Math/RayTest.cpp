@@ -0,0 +1,298 @@
+/**
+ * @file   RayTest.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <boost/mpl/list.hpp>
+
+#include <Mw/Math/BoundsArray.hpp>
+#include <Mw/Math/Bvh.hpp>
+#include <Mw/Math/Plane.hpp>
+#include <Mw/Math/Ray.hpp>
+#include <Mw/Math/RayPacket.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+typedef boost::mpl::list<float, double> test_types;
+
+namespace {
+
+template<typename T>
+mw::math::Vector<T, 3> vec3(T x, T y, T z)
+{
+    mw::math::Vector<T, 3> v;
+    v[0] = x;
+    v[1] = y;
+    v[2] = z;
+    return v;
+}
+
+/**
+ * Random boxes on an integer grid, so rays often start on their faces.
+ */
+template<typename T>
+std::vector<mw::math::Bounds<T, 3> > makeBoxes(unsigned count)
+{
+    std::vector<mw::math::Bounds<T, 3> > boxes;
+    for (unsigned i = 0; i < count; ++i)
+    {
+        mw::math::Vector<T, 3> p, s;
+        for (unsigned c = 0; c < 3; ++c)
+        {
+            p[c] = static_cast<T>(std::rand() % 40 - 20);
+            s[c] = static_cast<T>(std::rand() % 4 + 1);
+        }
+        boxes.push_back(mw::math::Bounds<T, 3>(p, p + s));
+    }
+    return boxes;
+}
+
+/**
+ * Random rays, with some null direction components.
+ */
+template<typename T>
+mw::math::Ray<T, 3> makeRay()
+{
+    mw::math::Vector<T, 3> origin, direction;
+    for (unsigned c = 0; c < 3; ++c)
+    {
+        origin[c] = static_cast<T>(std::rand() % 40 - 20);
+        direction[c] = std::rand() % 3 ? static_cast<T>(std::rand() % 200 - 100) / 50 : static_cast<T>(0);
+    }
+    return mw::math::Ray<T, 3>(origin, direction);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(Ray)
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Ray, T, test_types)
+{
+    using mw::math::Bounds;
+
+    mw::math::Ray<T, 3> ray(vec3<T>(-2, 1, 1), vec3<T>(2, 0, 0));
+    BOOST_CHECK(ray.getInverseDirection() == vec3<T>(0.5, std::numeric_limits<T>::infinity(),
+                                                     std::numeric_limits<T>::infinity()));
+    BOOST_CHECK(ray.getPoint(1.5) == vec3<T>(1, 1, 1));
+
+    Bounds<T, 3> box(vec3<T>(0, 0, 0), vec3<T>(2, 2, 2));
+    T distance;
+    BOOST_CHECK(ray.intersect(box, 10, distance));
+    BOOST_CHECK_EQUAL(distance, static_cast<T>(1));
+    BOOST_CHECK(!ray.isIntersecting(box, static_cast<T>(0.5)));
+    BOOST_CHECK(ray.isIntersecting(box, 1));
+
+    // Origin inside
+    mw::math::Ray<T, 3> inside(vec3<T>(1, 1, 1), vec3<T>(0, 0, -1));
+    BOOST_CHECK(inside.intersect(box, 10, distance));
+    BOOST_CHECK_EQUAL(distance, static_cast<T>(0));
+
+    // Box behind the ray
+    mw::math::Ray<T, 3> away(vec3<T>(-2, 1, 1), vec3<T>(-1, 0, 0));
+    BOOST_CHECK(!away.isIntersecting(box));
+
+    // Parallel to a face, boundaries included
+    mw::math::Ray<T, 3> lower(vec3<T>(-2, 0, 1), vec3<T>(1, 0, 0));
+    mw::math::Ray<T, 3> upper(vec3<T>(-2, 2, 1), vec3<T>(1, 0, 0));
+    mw::math::Ray<T, 3> outside(vec3<T>(-2, 3, 1), vec3<T>(1, 0, 0));
+    BOOST_CHECK(lower.isIntersecting(box));
+    BOOST_CHECK(upper.isIntersecting(box));
+    BOOST_CHECK(!outside.isIntersecting(box));
+
+    // Negative null direction component
+    mw::math::Ray<T, 3> negative(vec3<T>(-2, 2, 1), vec3<T>(1, -static_cast<T>(0), 0));
+    BOOST_CHECK(negative.isIntersecting(box));
+
+    // Planes
+    mw::math::Plane<T, mw::math::Vector<T, 3> > plane(vec3<T>(-1, 0, 0), vec3<T>(3, 0, 0));
+    BOOST_CHECK(ray.intersect(plane, 10, distance));
+    BOOST_CHECK_CLOSE(distance, static_cast<T>(2.5), 1e-4);
+    BOOST_CHECK(!ray.intersect(plane, 2, distance));
+    BOOST_CHECK(!away.intersect(plane, 10, distance));
+    BOOST_CHECK(!inside.intersect(plane, 10, distance));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(BoundsArray, T, test_types)
+{
+    std::srand(7);
+
+    std::vector<mw::math::Bounds<T, 3> > boxes = makeBoxes<T>(1000);
+    mw::math::BoundsArray<T, 3> array(boxes.begin(), boxes.end());
+
+    std::size_t total = 0;
+    for (unsigned r = 0; r < 200; ++r)
+    {
+        mw::math::Ray<T, 3> ray = makeRay<T>();
+        const T maxDistance = static_cast<T>(std::rand() % 20);
+
+        typename mw::math::BoundsArray<T, 3>::Mask mask;
+        typename mw::math::BoundsArray<T, 3>::Indices indices, expected;
+        array.testRayIntersecting(ray, maxDistance, mask);
+        array.findRayIntersecting(ray, maxDistance, indices);
+
+        bool found = false;
+        std::size_t nearest = 0;
+        T nearestDistance = 0;
+        for (std::size_t i = 0; i < boxes.size(); ++i)
+        {
+            T distance;
+            const bool hit = ray.intersect(boxes[i], maxDistance, distance);
+            BOOST_CHECK_EQUAL(hit, ((mask[i / 32] >> (i % 32)) & 1) != 0);
+            if (hit)
+            {
+                expected.push_back(i);
+                if (!found || distance < nearestDistance)
+                {
+                    found = true;
+                    nearest = i;
+                    nearestDistance = distance;
+                }
+            }
+        }
+        BOOST_CHECK(indices == expected);
+        total += expected.size();
+
+        std::size_t index = 0;
+        T distance = 0;
+        BOOST_CHECK_EQUAL(array.findNearest(ray, index, distance, maxDistance), found);
+        if (found)
+        {
+            BOOST_CHECK_EQUAL(index, nearest);
+            BOOST_CHECK_EQUAL(distance, nearestDistance);
+        }
+    }
+    BOOST_CHECK(total > 0);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Packet, T, test_types)
+{
+    typedef mw::math::RayPacket<T, 3, 4> Packet4;
+    typedef mw::math::RayPacket<T, 3, 8> Packet8;
+
+    std::srand(11);
+
+    std::vector<mw::math::Bounds<T, 3> > boxes = makeBoxes<T>(200);
+    mw::math::Plane<T, mw::math::Vector<T, 3> > plane(vec3<T>(1, 2, -1), vec3<T>(1, 0, 3));
+
+    Packet4 packet4;
+    Packet8 packet8;
+    std::vector<mw::math::Ray<T, 3> > rays;
+    T maxDistances[8];
+    for (unsigned j = 0; j < 8; ++j)
+    {
+        rays.push_back(makeRay<T>());
+        maxDistances[j] = static_cast<T>(std::rand() % 40);
+        packet8.set(j, rays[j]);
+        if (j < 4)
+            packet4.set(j, rays[j]);
+    }
+
+    BOOST_CHECK(packet8.get(3).getOrigin() == rays[3].getOrigin());
+    BOOST_CHECK(packet8.get(3).getDirection() == rays[3].getDirection());
+    BOOST_CHECK_THROW(packet4.get(4), std::out_of_range);
+    BOOST_CHECK_THROW(packet8.set(8, rays[0]), std::out_of_range);
+
+    unsigned hits = 0;
+    for (std::size_t i = 0; i < boxes.size(); ++i)
+    {
+        T distances4[4], distances8[8];
+        const unsigned mask4 = packet4.intersect(boxes[i], maxDistances, distances4);
+        const unsigned mask8 = packet8.intersect(boxes[i], maxDistances, distances8);
+
+        for (unsigned j = 0; j < 8; ++j)
+        {
+            T distance;
+            const bool hit = rays[j].intersect(boxes[i], maxDistances[j], distance);
+            BOOST_CHECK_EQUAL(hit, ((mask8 >> j) & 1) != 0);
+            if (hit)
+            {
+                ++hits;
+                BOOST_CHECK_EQUAL(distances8[j], distance);
+            }
+            if (j < 4)
+            {
+                BOOST_CHECK_EQUAL(hit, ((mask4 >> j) & 1) != 0);
+                if (hit)
+                    BOOST_CHECK_EQUAL(distances4[j], distance);
+            }
+        }
+    }
+    BOOST_CHECK(hits > 0);
+
+    T distances[8];
+    const unsigned planeMask = packet8.intersect(plane, maxDistances, distances);
+    for (unsigned j = 0; j < 8; ++j)
+    {
+        T distance;
+        const bool hit = rays[j].intersect(plane, maxDistances[j], distance);
+        BOOST_CHECK_EQUAL(hit, ((planeMask >> j) & 1) != 0);
+        if (hit)
+            BOOST_CHECK_CLOSE(distances[j], distance, 1e-4);
+    }
+
+    // Coherency
+    Packet4 coherent;
+    for (unsigned j = 0; j < 4; ++j)
+        coherent.set(j, mw::math::Ray<T, 3>(vec3<T>(0, 0, static_cast<T>(j)), vec3<T>(1, static_cast<T>(j), -1)));
+    BOOST_CHECK(coherent.isCoherent());
+    coherent.set(2, mw::math::Ray<T, 3>(vec3<T>(0, 0, 0), vec3<T>(1, -1, -1)));
+    BOOST_CHECK(!coherent.isCoherent());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(BvhPacket, T, test_types)
+{
+    typedef std::pair<unsigned, std::size_t> Hit;
+
+    std::srand(13);
+
+    std::vector<mw::math::Bounds<T, 3> > boxes = makeBoxes<T>(2000);
+    mw::math::Bvh<T, 3> bvh;
+    bvh.build(boxes.begin(), boxes.end());
+
+    std::size_t total = 0;
+    for (unsigned p = 0; p < 20; ++p)
+    {
+        mw::math::RayPacket<T, 3, 8> packet;
+        std::vector<mw::math::Ray<T, 3> > rays;
+        T maxDistances[8];
+        for (unsigned j = 0; j < 8; ++j)
+        {
+            rays.push_back(makeRay<T>());
+            maxDistances[j] = static_cast<T>(std::rand() % 20);
+            packet.set(j, rays[j]);
+        }
+
+        std::vector<Hit> hits, expected;
+        bvh.queryRays(packet, maxDistances, std::back_inserter(hits));
+
+        for (unsigned j = 0; j < 8; ++j)
+        {
+            std::vector<std::size_t> single;
+            bvh.queryRay(rays[j], maxDistances[j], std::back_inserter(single));
+            for (std::size_t i = 0; i < single.size(); ++i)
+                expected.push_back(Hit(j, single[i]));
+
+            std::size_t brute = 0;
+            for (std::size_t i = 0; i < boxes.size(); ++i)
+                brute += rays[j].isIntersecting(boxes[i], maxDistances[j]);
+            BOOST_CHECK_EQUAL(single.size(), brute);
+        }
+
+        std::sort(hits.begin(), hits.end());
+        std::sort(expected.begin(), expected.end());
+        BOOST_CHECK(hits == expected);
+        total += hits.size();
+    }
+    BOOST_CHECK(total > 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
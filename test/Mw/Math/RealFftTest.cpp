@@ -0,0 +1,90 @@
+/**
+ * @file   RealFftTest.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <boost/mpl/list.hpp>
+
+#include <Mw/Math/RealFft.hpp>
+
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+typedef boost::mpl::list<float, double> test_types;
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(RealFft)
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Plans, T, test_types)
+{
+    typedef mw::math::RealFftPlan<T> Plan;
+
+    BOOST_CHECK_THROW(Plan(0), std::invalid_argument);
+    BOOST_CHECK(Plan::get(64) == Plan::get(64));
+    BOOST_CHECK_EQUAL(Plan::get(64)->getSpectrumSize(), 33u);
+    BOOST_CHECK_EQUAL(Plan::get(63)->getSpectrumSize(), 32u);
+
+    mw::math::ComplexArray<T> spectrum(10);
+    std::vector<T> signal(16);
+    BOOST_CHECK_THROW(Plan::get(16)->inverse(spectrum, &signal[0]), std::invalid_argument);
+
+    // Constant
+    std::fill(signal.begin(), signal.end(), static_cast<T>(1));
+    Plan::get(16)->forward(&signal[0], spectrum);
+    BOOST_REQUIRE_EQUAL(spectrum.size(), 9u);
+    BOOST_CHECK_EQUAL(spectrum[0], mw::math::Complex<T>(16, 0));
+    for (std::size_t k = 1; k < 9; ++k)
+        BOOST_CHECK_SMALL(spectrum[k].getRadialCoord(), std::numeric_limits<T>::epsilon() * 16);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Transform, T, test_types)
+{
+    // Even sizes use the packed transform, odd ones the complex transform
+    const std::size_t sizes[] = { 1, 2, 3, 4, 6, 7, 10, 16, 30, 31, 64, 74, 97, 100, 256, 1000, 1024, 2062 };
+
+    std::srand(7);
+    for (std::size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+    {
+        const std::size_t size = sizes[i];
+        const boost::shared_ptr<const mw::math::RealFftPlan<T> > plan = mw::math::RealFftPlan<T>::get(size);
+        const double tolerance = std::numeric_limits<T>::epsilon() * std::sqrt(static_cast<double>(size)) * 8;
+
+        std::vector<T> signal(size);
+        mw::math::ComplexArray<T> complexSignal;
+        for (std::size_t n = 0; n < size; ++n)
+        {
+            signal[n] = static_cast<T>(std::rand() % 2001 - 1000) / 1000;
+            complexSignal.push_back(mw::math::Complex<T>(signal[n], 0));
+        }
+
+        // Same values as the first half of the complex transform
+        mw::math::ComplexArray<T> expected;
+        mw::math::FftPlan<T>::get(size)->forward(complexSignal, expected);
+
+        std::vector<mw::math::Complex<T> > spectrum(plan->getSpectrumSize());
+        plan->forward(&signal[0], &spectrum[0]);
+        for (std::size_t k = 0; k < spectrum.size(); ++k)
+            BOOST_CHECK_SMALL((spectrum[k] - expected[k]).getRadialCoord(), static_cast<T>(tolerance * size));
+
+        std::vector<T> back(size);
+        plan->inverse(&spectrum[0], &back[0]);
+        for (std::size_t n = 0; n < size; ++n)
+            BOOST_CHECK_SMALL(back[n] - signal[n], static_cast<T>(tolerance));
+
+        // Imaginary parts of the first and last values are ignored
+        spectrum.front() += mw::math::Complex<T>(0, 1);
+        if (size % 2 == 0)
+            spectrum.back() += mw::math::Complex<T>(0, 1);
+        std::vector<T> ignored(size);
+        plan->inverse(&spectrum[0], &ignored[0]);
+        for (std::size_t n = 0; n < size; ++n)
+            BOOST_CHECK_EQUAL(ignored[n], back[n]);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
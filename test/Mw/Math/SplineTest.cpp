@@ -0,0 +1,147 @@
+/**
+ * @file   SplineTest.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <Mw/Math/Interpolation.hpp>
+#include <Mw/Math/Spline.hpp>
+
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+typedef mw::math::Vector<double, 2> Vec2;
+
+double random(double range)
+{
+    return static_cast<double>(std::rand()) / RAND_MAX * range;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(Spline)
+
+BOOST_AUTO_TEST_CASE(Evaluate)
+{
+    using namespace mw::math;
+
+    std::srand(5);
+    std::vector<double> points;
+    for (int i = 0; i < 10; ++i)
+        points.push_back(random(10.0) - 5.0);
+
+    const mw::math::Spline<double> catmullRom(&points[0], points.size());
+    const mw::math::Spline<double> cubic(&points[0], points.size(), SPLINE_CUBIC);
+    BOOST_CHECK_EQUAL(catmullRom.getType(), SPLINE_CATMULL_ROM);
+    BOOST_CHECK_EQUAL(catmullRom.getSegments().size(), 9u);
+    BOOST_CHECK_EQUAL(catmullRom.getEnd(), 9.0);
+
+    // Same values as the interpolation functions, ends repeated
+    for (int i = 0; i < 200; ++i)
+    {
+        const double t = random(9.0);
+        const std::size_t k = static_cast<std::size_t>(t);
+        const double mu = t - static_cast<double>(k);
+        const double p0 = points[k > 0 ? k - 1 : 0], p3 = points[k + 2 < 10 ? k + 2 : 9];
+
+        BOOST_CHECK_CLOSE(catmullRom.evaluate(t), catmullRomInterpolate(p0, points[k], points[k + 1], p3, mu), 1e-9);
+        BOOST_CHECK_CLOSE(cubic.evaluate(t), cubicInterpolate(p0, points[k], points[k + 1], p3, mu), 1e-9);
+    }
+
+    // Through the points, clamped
+    for (int i = 0; i < 10; ++i)
+        BOOST_CHECK_CLOSE(catmullRom.evaluate(static_cast<double>(i)), points[i], 1e-9);
+    BOOST_CHECK_EQUAL(catmullRom.evaluate(-1.0), points[0]);
+    BOOST_CHECK_CLOSE(catmullRom.evaluate(12.0), points[9], 1e-9);
+
+    const double t[] = { 0.5, 8.25, 3.0, 1.75 };
+    double out[4];
+    cubic.evaluate(t, out, 4);
+    for (int i = 0; i < 4; ++i)
+        BOOST_CHECK_EQUAL(out[i], cubic.evaluate(t[i]));
+
+    BOOST_CHECK_THROW(mw::math::Spline<double>(&points[0], 1), std::invalid_argument);
+    BOOST_CHECK_THROW(mw::math::Spline<double>(&points[0], 2, SPLINE_CUBIC, 0), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(ArcLength)
+{
+    using namespace mw::math;
+
+    // Evenly spaced points on a line, the curve is the line at constant speed
+    std::vector<Vec2> line;
+    for (int i = 0; i < 5; ++i)
+    {
+        Vec2 p;
+        p[0] = 3.0 * i;
+        p[1] = 4.0 * i;
+        line.push_back(p);
+    }
+
+    const mw::math::Spline<Vec2> straight(&line[0], line.size(), SPLINE_CATMULL_ROM, 64);
+    BOOST_CHECK_CLOSE(straight.getLength(), 20.0, 1e-9);
+    BOOST_CHECK_CLOSE(straight.getParameter(10.0), 2.0, 1e-9);
+    BOOST_CHECK_CLOSE(straight.evaluateAt(2.5)[0], 1.5, 0.1);
+    BOOST_CHECK_CLOSE(straight.evaluateAt(12.5)[1], 10.0, 0.1);
+    BOOST_CHECK_EQUAL(straight.getParameter(-1.0), 0.0);
+    BOOST_CHECK_EQUAL(straight.getParameter(21.0), 4.0);
+
+    // A curve, measured finely
+    std::srand(9);
+    std::vector<Vec2> points;
+    for (int i = 0; i < 12; ++i)
+    {
+        Vec2 p;
+        p[0] = random(10.0);
+        p[1] = random(10.0);
+        points.push_back(p);
+    }
+
+    const mw::math::Spline<Vec2> curve(&points[0], points.size(), SPLINE_CATMULL_ROM, 64);
+    const double fineStep = curve.getEnd() / 100000;
+    double length = 0;
+    Vec2 previous = curve.evaluate(0.0);
+    for (int i = 1; i <= 100000; ++i)
+    {
+        const Vec2 point = curve.evaluate(i * fineStep);
+        length += Vec2(point - previous).getLength();
+        previous = point;
+
+        if (i % 10000 == 0)
+            BOOST_CHECK_CLOSE(curve.getParameter(length), i * fineStep, 0.5);
+    }
+    BOOST_CHECK_CLOSE(curve.getLength(), length, 0.1);
+
+    // Evenly spaced
+    const unsigned count = 200;
+    std::vector<Vec2> samples(count);
+    curve.sample(&samples[0], count);
+
+    const double step = curve.getLength() / (count - 1);
+    for (unsigned i = 0; i < count; ++i)
+    {
+        const Vec2 expected = curve.evaluateAt(step * i);
+        BOOST_CHECK_CLOSE(samples[i][0], expected[0], 1e-9);
+        BOOST_CHECK_CLOSE(samples[i][1], expected[1], 1e-9);
+    }
+    BOOST_CHECK_CLOSE(samples[count - 1][0], points.back()[0], 1e-9);
+
+    // Batch, increasing then not
+    const double distances[] = { 0.0, 1.0, 1.5, 30.0, 2.0, 2.1, 1000.0, -3.0 };
+    Vec2 out[8];
+    curve.evaluateAt(distances, out, 8);
+    for (int i = 0; i < 8; ++i)
+    {
+        const Vec2 expected = curve.evaluateAt(distances[i]);
+        BOOST_CHECK_EQUAL(out[i][0], expected[0]);
+        BOOST_CHECK_EQUAL(out[i][1], expected[1]);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,180 @@
+/**
+ * @file   TimebaseTest.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <Mw/Math/Timebase.hpp>
+
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+namespace {
+
+typedef mw::math::Rational<boost::int64_t> Rat;
+
+boost::int64_t random64()
+{
+    boost::uint64_t value = 0;
+    for (int i = 0; i < 4; ++i)
+        value = (value << 16) ^ static_cast<boost::uint64_t>(std::rand());
+
+    // Mixed magnitudes
+    return static_cast<boost::int64_t>(value) >> (std::rand() % 63);
+}
+
+const mw::math::RoundingMode roundings[] = {
+    mw::math::ROUND_TOWARD_ZERO, mw::math::ROUND_AWAY_FROM_ZERO,
+    mw::math::ROUND_DOWN, mw::math::ROUND_UP, mw::math::ROUND_NEAREST
+};
+
+#ifdef MW_HAS_INT128
+
+typedef mw::math::int128_t W;
+
+/**
+ * Exact rounded quotient, with a positive divisor.
+ */
+W divide(W n, W d, mw::math::RoundingMode rounding)
+{
+    const W q = n / d, r = n % d;
+    if (r == 0)
+        return q;
+
+    const bool negative = n < 0;
+    const W magnitude = negative ? - r : r;
+    switch (rounding)
+    {
+    case mw::math::ROUND_TOWARD_ZERO:
+        return q;
+    case mw::math::ROUND_AWAY_FROM_ZERO:
+        return negative ? q - 1 : q + 1;
+    case mw::math::ROUND_DOWN:
+        return negative ? q - 1 : q;
+    case mw::math::ROUND_UP:
+        return negative ? q : q + 1;
+    default:
+        return 2 * magnitude >= d ? (negative ? q - 1 : q + 1) : q;
+    }
+}
+
+#endif // MW_HAS_INT128
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(Timebase)
+
+BOOST_AUTO_TEST_CASE(Rescale)
+{
+    using mw::math::TimebaseRescaler;
+
+    const TimebaseRescaler<> toTicks(Rat(1, 1000), Rat(1, 90000));
+    BOOST_CHECK_EQUAL(toTicks.getMultiplier(), 90u);
+    BOOST_CHECK_EQUAL(toTicks.getDivisor(), 1u);
+    BOOST_CHECK_EQUAL(toTicks.rescale(1), 90);
+    BOOST_CHECK_EQUAL(toTicks.rescale(-1000), -90000);
+
+    TimebaseRescaler<> toMilliseconds(Rat(1, 90000), Rat(1, 1000));
+    BOOST_CHECK_EQUAL(toMilliseconds.getMultiplier(), 1u);
+    BOOST_CHECK_EQUAL(toMilliseconds.getDivisor(), 90u);
+    BOOST_CHECK_EQUAL(toMilliseconds.getRounding(), mw::math::ROUND_NEAREST);
+
+    const boost::int64_t halves[] = { 45, -45, 44, -44, 46, -46 };
+    const boost::int64_t expected[][6] = {
+        { 0, 0, 0, 0, 0, 0 },       // ROUND_TOWARD_ZERO
+        { 1, -1, 1, -1, 1, -1 },    // ROUND_AWAY_FROM_ZERO
+        { 0, -1, 0, -1, 0, -1 },    // ROUND_DOWN
+        { 1, 0, 1, 0, 1, 0 },       // ROUND_UP
+        { 1, -1, 0, 0, 1, -1 }      // ROUND_NEAREST
+    };
+    for (unsigned r = 0; r < 5; ++r)
+    {
+        toMilliseconds.setRounding(roundings[r]);
+        for (unsigned i = 0; i < 6; ++i)
+            BOOST_CHECK_EQUAL(toMilliseconds.rescale(halves[i]), expected[r][i]);
+        BOOST_CHECK_EQUAL(toMilliseconds.rescale(90 * 1234), 1234);
+        BOOST_CHECK_EQUAL(toMilliseconds.rescale(0), 0);
+    }
+
+    // Same timestamps as the Rational path
+    const Rat from(1001, 30000), to(1, 48000);
+    const TimebaseRescaler<> video(from, to, mw::math::ROUND_TOWARD_ZERO);
+    std::srand(3);
+    for (int i = 0; i < 1000; ++i)
+    {
+        const boost::int64_t timestamp = std::rand() - RAND_MAX / 2;
+        const Rat exact = Rat(timestamp) * from / to;
+        BOOST_CHECK_EQUAL(video.rescale(timestamp), exact.getNumerator() / exact.getDenominator());
+    }
+
+    BOOST_CHECK_THROW(TimebaseRescaler<>(Rat(0), Rat(1)), std::invalid_argument);
+    BOOST_CHECK_THROW(TimebaseRescaler<>(Rat(1), Rat(-1, 3)), std::invalid_argument);
+
+    const boost::int64_t max = std::numeric_limits<boost::int64_t>::max();
+    BOOST_CHECK_THROW(TimebaseRescaler<>(Rat(max), Rat(1, max)), std::invalid_argument);
+    BOOST_CHECK_NO_THROW(TimebaseRescaler<>(Rat(max), Rat(max, 3)));
+
+    const TimebaseRescaler<mw::math::ThrowOnOverflow> checked(Rat(2), Rat(1));
+    BOOST_CHECK_EQUAL(checked.rescale(max / 2), max - 1);
+    BOOST_CHECK_EQUAL(checked.rescale(- (max / 2) - 1), - max - 1);
+    BOOST_CHECK_THROW(checked.rescale(max / 2 + 1), std::overflow_error);
+    BOOST_CHECK_THROW(checked.rescale(- (max / 2) - 2), std::overflow_error);
+}
+
+#ifdef MW_HAS_INT128
+
+BOOST_AUTO_TEST_CASE(Exact)
+{
+    using mw::math::TimebaseRescaler;
+
+    std::srand(29);
+    for (int i = 0; i < 200; ++i)
+    {
+        // Ratios of all magnitudes, up to 62 bits
+        boost::int64_t b = 0, c = 0;
+        while (b <= 0 || c <= 0 || mw::math::detail::RationalBase<boost::int64_t>::gcd(b, c) != 1)
+        {
+            b = random64() >> 1;
+            c = random64() >> 1;
+        }
+
+        const Rat from(b), to(c);
+        TimebaseRescaler<mw::math::ThrowOnOverflow> rescaler(from, to);
+        BOOST_CHECK_EQUAL(rescaler.getMultiplier(), static_cast<boost::uint64_t>(b));
+        BOOST_CHECK_EQUAL(rescaler.getDivisor(), static_cast<boost::uint64_t>(c));
+
+        std::vector<boost::int64_t> in, out(100);
+        for (int j = 0; j < 100; ++j)
+            in.push_back(random64());
+
+        for (unsigned r = 0; r < 5; ++r)
+        {
+            rescaler.setRounding(roundings[r]);
+            for (int j = 0; j < 100; ++j)
+            {
+                const W exact = divide(static_cast<W>(in[j]) * b, c, roundings[r]);
+                if (exact >= std::numeric_limits<boost::int64_t>::min() && exact <= std::numeric_limits<boost::int64_t>::max())
+                    BOOST_CHECK(rescaler.rescale(in[j]) == exact);
+                else
+                    BOOST_CHECK_THROW(rescaler.rescale(in[j]), std::overflow_error);
+            }
+        }
+
+        // Batch
+        const TimebaseRescaler<> unchecked(from, to, mw::math::ROUND_DOWN);
+        unchecked.rescale(&in[0], &out[0], in.size());
+        for (int j = 0; j < 100; ++j)
+            BOOST_CHECK_EQUAL(out[j], unchecked.rescale(in[j]));
+    }
+}
+
+#endif // MW_HAS_INT128
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
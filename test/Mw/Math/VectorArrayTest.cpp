@@ -0,0 +1,113 @@
+/**
+ * @file   VectorArrayTest.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <boost/mpl/list.hpp>
+
+#include <Mw/Math/VectorArray.hpp>
+
+#include <limits>
+#include <vector>
+
+#define EPSILON std::numeric_limits<T>::epsilon() * 100
+
+typedef boost::mpl::list<float, double> test_types;
+
+namespace {
+
+template<typename T>
+std::vector<mw::math::Vector<T, 3> > makeVectors(unsigned count)
+{
+    std::vector<mw::math::Vector<T, 3> > vectors(count);
+    for (unsigned i = 0; i < count; ++i)
+    {
+        vectors[i][0] = static_cast<T>(i % 7) - 3;
+        vectors[i][1] = static_cast<T>(i % 5) + 1;
+        vectors[i][2] = static_cast<T>(i % 3) * static_cast<T>(0.5);
+    }
+    return vectors;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(VectorArray)
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Conversions, T, test_types)
+{
+    using mw::math::Vector;
+    using mw::math::VectorArray;
+
+    std::vector<Vector<T, 3> > aos = makeVectors<T>(37);
+    VectorArray<T, 3> soa(aos.begin(), aos.end());
+
+    BOOST_CHECK_EQUAL(soa.size(), 37u);
+    BOOST_CHECK_EQUAL(soa.lane(1)[5], aos[5][1]);
+    BOOST_CHECK_EQUAL(soa.get(11), aos[11]);
+    BOOST_CHECK_THROW(soa.get(37), std::out_of_range);
+
+    std::vector<Vector<T, 3> > back(soa.size());
+    soa.copyTo(back.begin());
+    for (unsigned i = 0; i < back.size(); ++i)
+        BOOST_CHECK_EQUAL(back[i], aos[i]);
+
+    Vector<T, 3> v = soa[3];
+    BOOST_CHECK_EQUAL(v, aos[3]);
+
+    soa[3] = aos[4] * static_cast<T>(2);
+    BOOST_CHECK_EQUAL(soa.get(3), aos[4] * static_cast<T>(2));
+
+    soa[0][2] = 9.0;
+    BOOST_CHECK_EQUAL(soa.lane(2)[0], 9.0);
+
+    VectorArray<T, 3> empty(4);
+    BOOST_CHECK(empty.get(2).isNull());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Kernels, T, test_types)
+{
+    using mw::math::Vector;
+    using mw::math::VectorArray;
+
+    std::vector<Vector<T, 3> > aos = makeVectors<T>(53);
+    VectorArray<T, 3> soa(aos.begin(), aos.end());
+
+    Vector<T, 3> w;
+    w[0] = 1.0; w[1] = -2.0; w[2] = 0.5;
+
+    std::vector<T> out(aos.size());
+
+    dot(soa, w, &out[0]);
+    for (unsigned i = 0; i < aos.size(); ++i)
+        BOOST_CHECK_EQUAL(out[i], aos[i].dot(w));
+
+    getLengths(soa, &out[0]);
+    for (unsigned i = 0; i < aos.size(); ++i)
+        BOOST_CHECK_EQUAL(out[i], aos[i].getLength());
+
+    VectorArray<T, 3> n;
+    normalize(soa, n);
+    for (unsigned i = 0; i < aos.size(); ++i)
+        BOOST_CHECK_EQUAL(n.get(i), normalize(aos[i]));
+
+    VectorArray<T, 3> p;
+    project(soa, w, p);
+    for (unsigned i = 0; i < aos.size(); ++i)
+        BOOST_CHECK_EQUAL(p.get(i), project(aos[i], w));
+
+    VectorArray<T, 3> sum(soa);
+    sum += soa;
+    sum *= static_cast<T>(0.5);
+    sum += w;
+    sum -= soa;
+    for (unsigned i = 0; i < aos.size(); ++i)
+        BOOST_CHECK_EQUAL(sum.get(i), w);
+
+    soa.push_back(Vector<T, 3>());
+    BOOST_CHECK_THROW(normalize(soa, n), std::domain_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
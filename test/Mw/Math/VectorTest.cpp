@@ -0,0 +1,190 @@
+/**
+ * @file   VectorTest.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <boost/mpl/list.hpp>
+
+#include <Mw/Math/Vector.hpp>
+#include <Mw/Math/Interpolation.hpp>
+
+#include <cmath>
+#include <limits>
+
+#define EPSILON std::numeric_limits<T>::epsilon() * 100
+
+typedef boost::mpl::list<float, double> test_types;
+
+BOOST_AUTO_TEST_SUITE(Math)
+BOOST_AUTO_TEST_SUITE(Vector)
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Constructor, T, test_types)
+{
+    using mw::math::Vector;
+
+    Vector<T, 3> v;
+    BOOST_CHECK(v.isNull());
+    BOOST_CHECK_EQUAL(v.get(0), 0.0);
+    BOOST_CHECK_EQUAL(v.get(1), 0.0);
+    BOOST_CHECK_EQUAL(v.get(2), 0.0);
+
+    v.set(1, 2.0);
+    Vector<double, 3> copy(v);
+    BOOST_CHECK(!copy.isNull());
+    BOOST_CHECK_EQUAL(copy.get(1), 2.0);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Accessors, T, test_types)
+{
+    using mw::math::Vector;
+
+    Vector<T, 3> v;
+    v.set(0, 1.0);
+    v.template set<1>(2.0);
+    v[2] = 3.0;
+
+    BOOST_CHECK_EQUAL(v.get(0), 1.0);
+    BOOST_CHECK_EQUAL(v.template get<1>(), 2.0);
+    BOOST_CHECK_EQUAL(v[2], 3.0);
+
+    BOOST_CHECK_THROW(v.get(3), std::out_of_range);
+    BOOST_CHECK_THROW(v.set(3, 0.0), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Operations, T, test_types)
+{
+    using mw::math::Vector;
+
+    Vector<T, 3> a;
+    a[0] = 1.0; a[1] = 2.0; a[2] = 3.0;
+
+    Vector<T, 3> b;
+    b[0] = 4.0; b[1] = 5.0; b[2] = 6.0;
+
+    BOOST_CHECK_EQUAL(a.dot(b), 32.0);
+
+    Vector<T, 3> c = a.cross(b);
+    BOOST_CHECK_EQUAL(c[0], -3.0);
+    BOOST_CHECK_EQUAL(c[1], 6.0);
+    BOOST_CHECK_EQUAL(c[2], -3.0);
+
+    Vector<T, 3> sum = a + b;
+    BOOST_CHECK_EQUAL(sum[0], 5.0);
+    BOOST_CHECK_EQUAL(sum[2], 9.0);
+
+    BOOST_CHECK_EQUAL(b - a + a, b);
+    BOOST_CHECK_EQUAL(a * static_cast<T>(2) / static_cast<T>(2), a);
+    BOOST_CHECK_EQUAL((-a)[1], -2.0);
+
+    BOOST_CHECK_THROW(a / static_cast<T>(0), std::domain_error);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Computations, T, test_types)
+{
+    using mw::math::Vector;
+
+    Vector<T, 2> a;
+    a[0] = 3.0; a[1] = 4.0;
+    BOOST_CHECK_CLOSE(a.getLength(), 5.0, EPSILON);
+
+    Vector<T, 2> n = normalize(a);
+    BOOST_CHECK_CLOSE(n[0], 0.6, EPSILON);
+    BOOST_CHECK_CLOSE(n[1], 0.8, EPSILON);
+
+    Vector<T, 2> x;
+    x[0] = 2.0;
+    Vector<T, 2> p = project(a, x);
+    BOOST_CHECK_CLOSE(p[0], 3.0, EPSILON);
+    BOOST_CHECK_EQUAL(p[1], 0.0);
+
+    BOOST_CHECK_CLOSE(scalarProject(a, x), 3.0, EPSILON);
+
+    BOOST_CHECK_THROW(normalize(Vector<T, 2>()), std::domain_error);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Dimension4, T, test_types)
+{
+    using mw::math::Vector;
+
+    Vector<T, 4> a;
+    a[0] = 1.0; a[1] = 2.0; a[2] = 3.0; a[3] = 4.0;
+
+    Vector<T, 4> b;
+    b[0] = 4.0; b[1] = 3.0; b[2] = 2.0; b[3] = 1.0;
+
+    BOOST_CHECK_EQUAL(a.dot(b), 20.0);
+
+    Vector<T, 4> sum = a + b;
+    for (unsigned i = 0; i < 4; ++i)
+        BOOST_CHECK_EQUAL(sum[i], 5.0);
+
+    Vector<T, 4> diff = a - b;
+    BOOST_CHECK_EQUAL(diff[0], -3.0);
+    BOOST_CHECK_EQUAL(diff[3], 3.0);
+
+    Vector<T, 4> scaled = a * static_cast<T>(0.5);
+    BOOST_CHECK_EQUAL(scaled[1], 1.0);
+    BOOST_CHECK_EQUAL(scaled[3], 2.0);
+
+    BOOST_CHECK_CLOSE(a.getLength(), std::sqrt(static_cast<T>(30)), EPSILON);
+    BOOST_CHECK_CLOSE(normalize(a).getLength(), 1.0, EPSILON);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Expressions, T, test_types)
+{
+    using mw::math::Vector;
+
+    Vector<T, 3> a;
+    a[0] = 1.0; a[1] = 2.0; a[2] = 3.0;
+
+    Vector<T, 3> b;
+    b[0] = 4.0; b[1] = 5.0; b[2] = 6.0;
+
+    Vector<T, 3> c;
+    c[0] = 1.0; c[1] = 1.0; c[2] = 1.0;
+
+    Vector<T, 3> r = a + b * static_cast<T>(2) - c;
+    BOOST_CHECK_EQUAL(r[0], 8.0);
+    BOOST_CHECK_EQUAL(r[1], 11.0);
+    BOOST_CHECK_EQUAL(r[2], 14.0);
+
+    // Expressions may refer to the assigned vector
+    r = b - r / static_cast<T>(2);
+    BOOST_CHECK_EQUAL(r[0], 0.0);
+    BOOST_CHECK_EQUAL(r[1], -0.5);
+    BOOST_CHECK_EQUAL(r[2], -1.0);
+
+    r += -(a - c);
+    BOOST_CHECK_EQUAL(r[0], 0.0);
+    BOOST_CHECK_EQUAL(r[1], -1.5);
+    BOOST_CHECK_EQUAL(r[2], -3.0);
+
+    BOOST_CHECK_EQUAL(a + b, b + a);
+    BOOST_CHECK_NE(a + b, a - b);
+
+    Vector<T, 3> lerp = mw::math::linearInterpolate(a, b, static_cast<T>(0.5));
+    BOOST_CHECK_CLOSE(lerp[0], 2.5, EPSILON);
+    BOOST_CHECK_CLOSE(lerp[2], 4.5, EPSILON);
+
+    Vector<T, 3> cr = mw::math::catmullRomInterpolate(c, a, b, c, static_cast<T>(1));
+    BOOST_CHECK_CLOSE(cr[0], 4.0, EPSILON);
+    BOOST_CHECK_CLOSE(cr[1], 5.0, EPSILON);
+}
+
+BOOST_AUTO_TEST_CASE(Layout)
+{
+    using mw::math::Vector;
+
+    BOOST_CHECK_EQUAL(sizeof(Vector<float, 4>), 4 * sizeof(float));
+    BOOST_CHECK_EQUAL(sizeof(Vector<double, 4>), 4 * sizeof(double));
+
+#if defined MW_SIMD_SSE && defined MW_MATH_PAD_VECTOR3F
+    BOOST_CHECK_EQUAL(sizeof(Vector<float, 3>), 4 * sizeof(float));
+#else
+    BOOST_CHECK_EQUAL(sizeof(Vector<float, 3>), 3 * sizeof(float));
+#endif
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,122 @@
+/**
+ * @file   TaskPoolTest.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <Mw/Thread/TaskPool.hpp>
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#ifndef MW_NO_THREADS
+#   include <atomic>
+#endif
+
+namespace {
+
+struct Fill
+{
+    std::vector<unsigned> * values;
+
+    void operator () (std::size_t begin, std::size_t end) const
+    {
+        for (std::size_t i = begin; i < end; ++i)
+            (*values)[i] += static_cast<unsigned>(i);
+    }
+};
+
+struct Nested
+{
+    mw::thread::TaskPool * pool;
+    std::vector<unsigned> * values;
+
+    void operator () (std::size_t begin, std::size_t end) const
+    {
+        Fill fill = { values };
+        mw::thread::parallelFor(*pool, begin, end, 7, fill);
+    }
+};
+
+#ifndef MW_NO_THREADS
+
+struct Throw
+{
+    std::atomic<unsigned> * count;
+    unsigned index;
+
+    void operator () () const
+    {
+        ++*count;
+        if (index % 3 == 0)
+            throw std::runtime_error("task failed");
+    }
+};
+
+#endif // MW_NO_THREADS
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Thread)
+BOOST_AUTO_TEST_SUITE(TaskPool)
+
+BOOST_AUTO_TEST_CASE(ParallelFor)
+{
+    for (unsigned threads = 1; threads <= 4; ++threads)
+    {
+        mw::thread::TaskPool pool(threads);
+        BOOST_CHECK(pool.getThreadCount() >= 1);
+
+        std::vector<unsigned> values(1000, 0);
+        Fill fill = { &values };
+        mw::thread::parallelFor(pool, 0, values.size(), 64, fill);
+
+        // Tasks waiting for sub-tasks
+        Nested nested = { &pool, &values };
+        mw::thread::parallelFor(pool, 0, values.size(), 100, nested);
+
+        bool valid = true;
+        for (std::size_t i = 0; i < values.size(); ++i)
+            valid = valid && values[i] == 2 * i;
+        BOOST_CHECK(valid);
+
+        // Empty range
+        mw::thread::parallelFor(pool, 10, 10, 64, fill);
+    }
+}
+
+#ifndef MW_NO_THREADS
+
+// Without threads, run lets the exceptions through
+BOOST_AUTO_TEST_CASE(Exceptions)
+{
+    for (unsigned threads = 1; threads <= 4; ++threads)
+    {
+        mw::thread::TaskPool pool(threads);
+
+        // The other tasks still run, the first exception reaches wait
+        std::atomic<unsigned> count(0);
+        mw::thread::TaskPool::TaskGroup group(pool);
+        for (unsigned i = 0; i < 20; ++i)
+        {
+            Throw task = { &count, i };
+            BOOST_CHECK_NO_THROW(group.run(task));
+        }
+        BOOST_CHECK_THROW(group.wait(), std::runtime_error);
+        BOOST_CHECK_EQUAL(count.load(), 20u);
+
+        // Collected once, the group is reusable
+        BOOST_CHECK_NO_THROW(group.wait());
+        Throw task = { &count, 1 };
+        group.run(task);
+        BOOST_CHECK_NO_THROW(group.wait());
+        BOOST_CHECK_EQUAL(count.load(), 21u);
+    }
+}
+
+#endif // MW_NO_THREADS
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
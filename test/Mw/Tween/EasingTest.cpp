@@ -0,0 +1,72 @@
+/**
+ * @file   EasingTest.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <boost/mpl/list.hpp>
+
+#include <Mw/Tween/Easing.hpp>
+
+#include <cmath>
+#include <stdexcept>
+
+typedef boost::mpl::list<float, double> test_types;
+
+BOOST_AUTO_TEST_SUITE(Tween)
+BOOST_AUTO_TEST_SUITE(Easing)
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(Functions, T, test_types)
+{
+    using namespace mw::tween;
+
+    const T tolerance = static_cast<T>(1e-6);
+
+    for (unsigned e = 0; e < EASING_COUNT; ++e)
+    {
+        const mw::tween::Easing easing = static_cast<mw::tween::Easing>(e);
+
+        // From 0 to 1, never going back
+        BOOST_CHECK_SMALL(ease(easing, static_cast<T>(0)), tolerance);
+        BOOST_CHECK_SMALL(ease(easing, static_cast<T>(1)) - 1, tolerance);
+
+        T previous = ease(easing, static_cast<T>(0));
+        for (unsigned i = 1; i <= 100; ++i)
+        {
+            const T value = ease(easing, static_cast<T>(i) / 100);
+            BOOST_CHECK_GE(value, previous - tolerance);
+            previous = value;
+        }
+    }
+
+    // The in-out functions are symmetric, continuous at the middle
+    const mw::tween::Easing symmetric[] = { EASE_LINEAR, EASE_IN_OUT_QUAD, EASE_IN_OUT_CUBIC,
+                                            EASE_IN_OUT_SINE, EASE_SMOOTHSTEP };
+    for (unsigned e = 0; e < 5; ++e)
+    {
+        BOOST_CHECK_SMALL(ease(symmetric[e], static_cast<T>(0.5)) - static_cast<T>(0.5), tolerance);
+        for (unsigned i = 0; i <= 20; ++i)
+        {
+            const T t = static_cast<T>(i) / 20;
+            BOOST_CHECK_SMALL(ease(symmetric[e], t) + ease(symmetric[e], 1 - t) - 1, tolerance);
+        }
+    }
+
+    // Reference values
+    const T t = static_cast<T>(0.3);
+    BOOST_CHECK_SMALL(ease(EASE_IN_QUAD, t) - static_cast<T>(0.09), tolerance);
+    BOOST_CHECK_SMALL(ease(EASE_OUT_QUAD, t) - static_cast<T>(0.51), tolerance);
+    BOOST_CHECK_SMALL(ease(EASE_IN_OUT_QUAD, t) - static_cast<T>(0.18), tolerance);
+    BOOST_CHECK_SMALL(ease(EASE_IN_CUBIC, t) - static_cast<T>(0.027), tolerance);
+    BOOST_CHECK_SMALL(ease(EASE_OUT_CUBIC, t) - static_cast<T>(0.657), tolerance);
+    BOOST_CHECK_SMALL(ease(EASE_IN_OUT_CUBIC, t) - static_cast<T>(0.108), tolerance);
+    BOOST_CHECK_SMALL(ease(EASE_IN_SINE, t) - static_cast<T>(1 - std::cos(0.3 * M_PI / 2)), tolerance);
+    BOOST_CHECK_SMALL(ease(EASE_OUT_SINE, t) - static_cast<T>(std::sin(0.3 * M_PI / 2)), tolerance);
+    BOOST_CHECK_SMALL(ease(EASE_IN_OUT_SINE, t) - static_cast<T>((1 - std::cos(0.3 * M_PI)) / 2), tolerance);
+    BOOST_CHECK_SMALL(ease(EASE_SMOOTHSTEP, t) - static_cast<T>(0.216), tolerance);
+
+    BOOST_CHECK_THROW(ease(EASING_COUNT, t), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,205 @@
+/**
+ * @file   TweenerTest.cpp
+ * @author Bastien Brunnenstein
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <Mw/Tween/Tweener.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+typedef mw::tween::Tweener<double, int> Tweener;
+
+/**
+ * Completion callback collecting the payloads.
+ */
+struct Collect
+{
+    std::vector<int> * payloads;
+    std::size_t * batches;
+
+    void operator () (const Tweener::Completion * completions, std::size_t count) const
+    {
+        ++*batches;
+        for (std::size_t i = 0; i < count; ++i)
+            payloads->push_back(completions[i].payload);
+    }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Tween)
+BOOST_AUTO_TEST_SUITE(Tweener)
+
+BOOST_AUTO_TEST_CASE(Scalar)
+{
+    using namespace mw::tween;
+
+    double values[4] = { 0, 0, 0, 0 };
+    ::Tweener tweener;
+    const ::Tweener::Handle linear = tweener.start(values[0], 1.0, 3.0, 4.0, EASE_LINEAR, 0);
+    tweener.start(values[1], 0.0, 1.0, 2.0, EASE_IN_QUAD, 1);
+    tweener.start(values[2], 0.0, 1.0, 2.0, EASE_SMOOTHSTEP, 2);
+    values[3] = 5;
+    tweener.startTo(values[3], -5.0, 1.0, EASE_OUT_CUBIC, 3);
+
+    BOOST_CHECK_EQUAL(tweener.size(), 4u);
+    BOOST_CHECK_EQUAL(tweener.size(EASE_IN_QUAD), 1u);
+    BOOST_CHECK_EQUAL(tweener.getPayload(linear), 0);
+
+    std::vector<int> payloads;
+    std::size_t batches = 0;
+    const Collect collect = { &payloads, &batches };
+
+    tweener.tick(0.5, collect);
+    BOOST_CHECK_CLOSE(values[0], 1.25, 1e-9);
+    BOOST_CHECK_CLOSE(values[1], 0.0625, 1e-9);
+    BOOST_CHECK_CLOSE(values[2], ease(EASE_SMOOTHSTEP, 0.25), 1e-9);
+    BOOST_CHECK_CLOSE(values[3], 5 - 10 * ease(EASE_OUT_CUBIC, 0.5), 1e-9);
+    BOOST_CHECK_CLOSE(tweener.getProgress(linear), 0.125, 1e-9);
+    BOOST_CHECK_EQUAL(batches, 0u);
+
+    // The last one finishes, exactly on its end value
+    tweener.tick(0.75, collect);
+    BOOST_CHECK_EQUAL(values[3], -5.0);
+    BOOST_CHECK_EQUAL(batches, 1u);
+    BOOST_CHECK_EQUAL(payloads.size(), 1u);
+    BOOST_CHECK_EQUAL(payloads[0], 3);
+    BOOST_CHECK_EQUAL(tweener.size(), 3u);
+
+    // Two finish in the same tick, delivered in one batch
+    tweener.tick(1.0, collect);
+    BOOST_CHECK_EQUAL(values[1], 1.0);
+    BOOST_CHECK_EQUAL(values[2], 1.0);
+    BOOST_CHECK_EQUAL(batches, 2u);
+    BOOST_CHECK_EQUAL(payloads.size(), 3u);
+    std::sort(payloads.begin() + 1, payloads.end());
+    BOOST_CHECK_EQUAL(payloads[1], 1);
+    BOOST_CHECK_EQUAL(payloads[2], 2);
+
+    // Overshooting clamps to the end
+    BOOST_CHECK(tweener.contains(linear));
+    tweener.tick(100.0);
+    BOOST_CHECK_EQUAL(values[0], 3.0);
+    BOOST_CHECK(!tweener.contains(linear));
+    BOOST_CHECK(tweener.empty());
+
+    BOOST_CHECK_THROW(tweener.getProgress(linear), std::invalid_argument);
+    BOOST_CHECK_THROW(tweener.start(values[0], 0.0, 1.0, 0.0), std::invalid_argument);
+    BOOST_CHECK_THROW(tweener.start(values[0], 0.0, 1.0, 1.0, EASING_COUNT), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(Handles)
+{
+    using namespace mw::tween;
+
+    std::vector<double> values(100, 0.0);
+    ::Tweener tweener;
+    std::vector< ::Tweener::Handle> handles;
+    for (int i = 0; i < 100; ++i)
+        handles.push_back(tweener.start(values[i], 0.0, 1.0, 1.0 + i, static_cast<Easing>(i % EASING_COUNT), i));
+
+    // Cancel leaves the target, complete writes the end
+    tweener.tick(0.5);
+    for (int i = 0; i < 100; i += 3)
+        BOOST_CHECK(tweener.cancel(handles[i]));
+    for (int i = 1; i < 100; i += 3)
+        BOOST_CHECK(tweener.complete(handles[i]));
+    for (int i = 0; i < 100; i += 3)
+        BOOST_CHECK(!tweener.cancel(handles[i]));
+    BOOST_CHECK(!tweener.complete(handles[1]));
+    BOOST_CHECK_EQUAL(tweener.size(), 33u);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        BOOST_CHECK_EQUAL(tweener.contains(handles[i]), i % 3 == 2);
+        if (i % 3 == 1)
+            BOOST_CHECK_EQUAL(values[i], 1.0);
+        else
+            BOOST_CHECK_CLOSE(values[i], ease(static_cast<Easing>(i % EASING_COUNT), 0.5 / (1.0 + i)), 1e-6);
+    }
+
+    // The remaining tweens keep their handles and payloads after the swaps
+    for (int i = 2; i < 100; i += 3)
+    {
+        BOOST_CHECK_EQUAL(tweener.getPayload(handles[i]), i);
+        BOOST_CHECK_CLOSE(tweener.getProgress(handles[i]), 0.5 / (1.0 + i), 1e-9);
+    }
+
+    // Completed tweens are delivered with the next tick, slots are reused
+    // with new generations
+    std::vector<int> payloads;
+    std::size_t batches = 0;
+    const Collect collect = { &payloads, &batches };
+    tweener.tick(0.0, collect);
+    BOOST_CHECK_EQUAL(batches, 1u);
+    BOOST_CHECK_EQUAL(payloads.size(), 33u);
+
+    const ::Tweener::Handle reused = tweener.start(values[0], 0.0, 1.0, 1.0);
+    BOOST_CHECK(tweener.contains(reused));
+    for (int i = 0; i < 100; ++i)
+        if (handles[i].index == reused.index)
+            BOOST_CHECK(handles[i] != reused);
+
+    tweener.clear();
+    BOOST_CHECK(tweener.empty());
+    BOOST_CHECK(!tweener.contains(reused));
+    BOOST_CHECK(!tweener.contains(handles[2]));
+}
+
+BOOST_AUTO_TEST_CASE(Values)
+{
+    using namespace mw::tween;
+
+    typedef mw::math::Vector<float, 3> Vec3;
+    typedef mw::math::Complex<double> Cpx;
+    typedef mw::math::Quaternion<double> Quat;
+
+    // Vectors
+    Vec3 from, to, vec;
+    from[0] = 1;
+    to[1] = 2;
+    to[2] = -4;
+    mw::tween::Tweener<Vec3> vectors;
+    vectors.start(vec, from, to, 2.0f, EASE_IN_OUT_QUAD);
+    vectors.tick(0.5f);
+    const float mu = ease(EASE_IN_OUT_QUAD, 0.25f);
+    for (unsigned c = 0; c < 3; ++c)
+        BOOST_CHECK_CLOSE(vec[c], from[c] + (to[c] - from[c]) * mu, 1e-4f);
+
+    // Complex numbers
+    Cpx cpx(1, 1);
+    mw::tween::Tweener<Cpx> complexes;
+    complexes.startTo(cpx, Cpx(3, -1), 1.0);
+    complexes.tick(0.25);
+    BOOST_CHECK_CLOSE(cpx.getRealPart(), 1.5, 1e-9);
+    BOOST_CHECK_CLOSE(cpx.getImaginaryPart(), 0.5, 1e-9);
+
+    // Quaternions, on the shortest arc, normalized
+    Vec3 axis;
+    axis[2] = 1;
+    const Quat q1 = Quat::identity();
+    const Quat q2 = - Quat::fromAxisAngle(mw::math::Vector<double, 3>(axis), 1.0);
+    Quat quat;
+    mw::tween::Tweener<Quat> quaternions;
+    quaternions.start(quat, q1, q2, 1.0);
+    quaternions.tick(0.5);
+    const Quat expected = nlerp(q1, q2, 0.5);
+    BOOST_CHECK_CLOSE(quat.getNorm(), 1.0, 1e-9);
+    BOOST_CHECK_CLOSE(quat.getW(), expected.getW(), 1e-9);
+    BOOST_CHECK_CLOSE(quat.getZ(), expected.getZ(), 1e-9);
+    BOOST_CHECK_CLOSE(std::atan2(quat.getZ(), quat.getW()) * 2, 0.5, 1e-9);
+
+    quaternions.tick(0.5);
+    BOOST_CHECK_CLOSE(std::fabs(quat.dot(q2)), 1.0, 1e-9);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()